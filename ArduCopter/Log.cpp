@@ -354,6 +354,8 @@ struct PACKED log_Rate_Thread_Dt {
     float dtAvg;
     float dtMax;
     float dtMin;
+    float latAvg;
+    float latMax;
 };
 
 // Write a Guided mode position target
@@ -403,7 +405,7 @@ void Copter::Log_Write_Guided_Attitude_Target(ModeGuided::SubMode target_type, f
     logger.WriteBlock(&pkt, sizeof(pkt));
 }
 
-void Copter::Log_Write_Rate_Thread_Dt(float dt, float dtAvg, float dtMax, float dtMin)
+void Copter::Log_Write_Rate_Thread_Dt(float dt, float dtAvg, float dtMax, float dtMin, float latAvg, float latMax)
 {
 #if AP_INERTIALSENSOR_FAST_SAMPLE_WINDOW_ENABLED
     const log_Rate_Thread_Dt pkt {
@@ -412,7 +414,9 @@ void Copter::Log_Write_Rate_Thread_Dt(float dt, float dtAvg, float dtMax, float
         dt              : dt,
         dtAvg           : dtAvg,
         dtMax           : dtMax,
-        dtMin           : dtMin
+        dtMin           : dtMin,
+        latAvg          : latAvg,
+        latMax          : latMax
     };
     logger.WriteBlock(&pkt, sizeof(pkt));
 #endif
@@ -568,9 +572,11 @@ const struct LogStructure Copter::log_structure[] = {
 // @Field: dtAvg: current time delta average
 // @Field: dtMax: Max time delta since last log output
 // @Field: dtMin: Min time delta since last log output
+// @Field: LatAvg: Average time from the gyro sample being read from the sensor to the motor outputs being pushed, since last log output
+// @Field: LatMax: Max time from the gyro sample being read from the sensor to the motor outputs being pushed, since last log output
 
     { LOG_RATE_THREAD_DT_MSG, sizeof(log_Rate_Thread_Dt),
-      "RTDT", "Qffff", "TimeUS,dt,dtAvg,dtMax,dtMin", "sssss", "F----" , true },
+      "RTDT", "Qffffff", "TimeUS,dt,dtAvg,dtMax,dtMin,LatAvg,LatMax", "sssssss", "F------" , true },
 
 };
 
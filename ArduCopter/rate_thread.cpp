@@ -68,6 +68,8 @@
  Design:
 
  1. Filtered gyro samples are (sub-sampled and) pushed into an ObjectBuffer from the INS backend.
+    Each sample carries the time the backend read it from the sensor. The rate thread is the only
+    reader and pops without taking a lock.
  2. The pushed sample is published to the INS front-end so that the rest of the vehicle only
     sees published values that have been used by the rate controller. When the rate thread is not 
     in use the filtered samples are effectively sub-sampled at the main loop rate. The EKF is unaffected
@@ -81,7 +83,7 @@
  5. The rcout dshot thread is blocked waiting for a new pwm value. When it is signalled by the
     rate thread it wakes up and runs the dshot motor output logic.
  6. Periodically the rate thread:
-    6a. Logs the rate outputs (1Khz)
+    6a. Logs the rate outputs (1Khz) and the gyro read to motor push latency (RTDT, 10Hz)
     6b. Updates the notch filter centers (Gyro rate/2)
     6c. Checks the ObjectBuffer length and main loop delay (10Hz)
         If the ObjectBuffer length has been longer than 2 for the last 5 cycles or the main loop has
@@ -180,6 +182,12 @@ void Copter::rate_controller_thread()
     uint32_t last_run_us = AP_HAL::micros();
     float max_dt = 0.0;
     float min_dt = 1.0;
+#if HAL_LOGGING_ENABLED
+    // gyro read to motor output latency
+    uint32_t latency_sum_us = 0;
+    uint32_t latency_max_us = 0;
+    uint32_t latency_count = 0;
+#endif
     uint32_t now_ms = AP_HAL::millis();
     uint32_t last_rate_check_ms = 0;
     uint32_t last_rate_increase_ms = 0;
@@ -233,7 +241,8 @@ void Copter::rate_controller_thread()
 
         // wait for an IMU sample
         Vector3f gyro;
-        if (!ins.get_next_gyro_sample(gyro)) {
+        uint32_t gyro_sample_us;
+        if (!ins.get_next_gyro_sample(gyro, gyro_sample_us)) {
             continue;   // go around again
         }
 
@@ -275,6 +284,14 @@ void Copter::rate_controller_thread()
         }
         motors_output(main_loop_count == 0);
 
+#if HAL_LOGGING_ENABLED
+        // time from the backend reading the sample to the outputs being pushed
+        const uint32_t latency_us = AP_HAL::micros() - gyro_sample_us;
+        latency_sum_us += latency_us;
+        latency_max_us = MAX(latency_us, latency_max_us);
+        latency_count++;
+#endif
+
         // process filter updates
         if (run_decimated_callback(rates.filter_rate, filter_loop_count)) {
             filter_loop_count = 0;
@@ -287,9 +304,14 @@ void Copter::rate_controller_thread()
 
 #if HAL_LOGGING_ENABLED
         if (now_ms - last_rtdt_log_ms >= 100) {    // 10 Hz
-            Log_Write_Rate_Thread_Dt(dt, sensor_dt, max_dt, min_dt);
+            Log_Write_Rate_Thread_Dt(dt, sensor_dt, max_dt, min_dt,
+                                     latency_count > 0 ? latency_sum_us * 1.0e-6 / latency_count : 0,
+                                     latency_max_us * 1.0e-6);
             max_dt = sensor_dt;
             min_dt = sensor_dt;
+            latency_sum_us = 0;
+            latency_max_us = 0;
+            latency_count = 0;
             last_rtdt_log_ms = now_ms;
         }
 #endif
@@ -25,6 +25,7 @@
 #include <GCS_MAVLink/GCS_Dummy.h>
 #include <AP_Filesystem/AP_Filesystem.h>
 #include <AP_Filesystem/posix_compat.h>
+#include <AP_Common/ExpandingString.h>
 #include <AP_AdvancedFailsafe/AP_AdvancedFailsafe.h>
 
 #if CONFIG_HAL_BOARD == HAL_BOARD_LINUX
@@ -126,11 +127,15 @@ void Replay::usage(void)
     ::printf("\t--force-ekf2 force enable EKF2\n");
     ::printf("\t--force-ekf3 force enable EKF3\n");
     ::printf("\t--progress  show a progress bar during replay\n");
+#if EK3_FEATURE_STEP_TIMING
+    ::printf("\t--benchmark FILENAME  write EKF3 step timing as JSON to FILENAME\n");
+#endif
 }
 
 enum param_key : uint8_t {
     FORCE_EKF2 = 1,
     FORCE_EKF3,
+    BENCHMARK,
 };
 
 void Replay::_parse_command_line(uint8_t argc, char * const argv[])
@@ -143,6 +148,9 @@ void Replay::_parse_command_line(uint8_t argc, char * const argv[])
         {"force-ekf2",      false,  0, param_key::FORCE_EKF2},
         {"force-ekf3",      false,  0, param_key::FORCE_EKF3},
         {"progress",        false,  0, 'P'},
+#if EK3_FEATURE_STEP_TIMING
+        {"benchmark",       true,   0, param_key::BENCHMARK},
+#endif
         {"help",            false,  0, 'h'},
         {0, false, 0, 0}
     };
@@ -182,6 +190,12 @@ void Replay::_parse_command_line(uint8_t argc, char * const argv[])
             show_progress = true;
             break;
 
+#if EK3_FEATURE_STEP_TIMING
+        case param_key::BENCHMARK:
+            benchmark_filename = gopt.optarg;
+            break;
+#endif
+
         case 'h':
         default:
             usage();
@@ -292,11 +306,20 @@ void Replay::setup()
     if (replay_force_ekf2) {
         write_EKF_formats();
     }
+
+#if EK3_FEATURE_STEP_TIMING
+    benchmark_start_ns = EK3_StepTiming::now_ns();
+#endif
 }
 
 void Replay::loop()
 {
     if (!reader.update()) {
+#if EK3_FEATURE_STEP_TIMING
+        if (benchmark_filename != nullptr) {
+            write_benchmark();
+        }
+#endif
 #if CONFIG_HAL_BOARD == HAL_BOARD_LINUX
     // If we don't tear down the threads then they continue to access
     // global state during object destruction.
@@ -335,6 +358,66 @@ void Replay::loop()
     }
 }
 
+#if EK3_FEATURE_STEP_TIMING
+/*
+  write the time spent in each EKF3 step over the whole log as JSON,
+  for tracking EKF performance over a corpus of logs with
+  benchmark_replay.py
+ */
+void Replay::write_benchmark(void)
+{
+    const double wall_time_s = (EK3_StepTiming::now_ns() - benchmark_start_ns) * 1.0e-9;
+
+    ExpandingString str;
+    // the log name is escaped as a JSON string
+    str.printf("{\n  \"log\": \"");
+    for (const char *c = filename; *c; c++) {
+        if (*c == '"' || *c == '\\') {
+            str.printf("\\%c", *c);
+        } else if ((uint8_t)*c < 0x20) {
+            str.printf("\\u%04x", unsigned((uint8_t)*c));
+        } else {
+            str.append(c, 1);
+        }
+    }
+    str.printf("\",\n  \"wall_time_s\": %.6f,\n  \"ekf3\": [", wall_time_s);
+
+    const auto &ekf3 = _vehicle.ekf3;
+    for (uint8_t i=0; i<ekf3.activeCores(); i++) {
+        const EK3_StepTiming *timing = ekf3.getStepTiming(i);
+        if (timing == nullptr) {
+            continue;
+        }
+        const uint64_t imu_samples = timing->step[uint8_t(EK3_TimedStep::UpdateFilter)].calls;
+        str.printf("%s\n    {\n      \"core\": %u,\n      \"imu_samples\": %llu,\n      \"steps\": {",
+                   i==0?"":",", unsigned(i), (unsigned long long)imu_samples);
+        for (uint8_t s=0; s<uint8_t(EK3_TimedStep::COUNT); s++) {
+            const auto &st = timing->step[s];
+            const double total_us = st.total_ns * 1.0e-3;
+            str.printf("%s\n        \"%s\": { \"calls\": %llu, \"total_us\": %.3f, \"max_us\": %.3f, \"us_per_call\": %.4f, \"us_per_imu_sample\": %.4f }",
+                       s==0?"":",",
+                       EK3_StepTiming::name(EK3_TimedStep(s)),
+                       (unsigned long long)st.calls,
+                       total_us,
+                       st.max_ns * 1.0e-3,
+                       st.calls > 0 ? total_us / st.calls : 0,
+                       imu_samples > 0 ? total_us / imu_samples : 0);
+        }
+        str.printf("\n      }\n    }");
+    }
+    str.printf("\n  ]\n}\n");
+
+    auto &fs = AP::FS();
+    const int fd = fs.open(benchmark_filename, O_WRONLY|O_CREAT|O_TRUNC, true);
+    if (fd == -1 || str.has_failed_allocation() ||
+        fs.write(fd, str.get_string(), str.get_length()) != int32_t(str.get_length())) {
+        ::printf("Failed to write benchmark file: %s\n", benchmark_filename);
+        exit(1);
+    }
+    fs.close(fd);
+}
+#endif  // EK3_FEATURE_STEP_TIMING
+
 /*
   setup user -p parameters
  */
@@ -103,6 +103,12 @@ private:
     bool show_progress = false;  // Flag to determine if progress bar should be shown
     uint32_t last_progress_update = 0; // Last time progress was displayed
 
+#if EK3_FEATURE_STEP_TIMING
+    const char *benchmark_filename = nullptr;  // file to write EKF3 step timing to
+    uint64_t benchmark_start_ns = 0;
+    void write_benchmark(void);
+#endif
+
     void _parse_command_line(uint8_t argc, char * const argv[]);
 
     void set_user_parameters(void);
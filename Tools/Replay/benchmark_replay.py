@@ -0,0 +1,109 @@
+#!/usr/bin/env python3
+
+'''
+run Replay over a corpus of logs and report the time spent in each
+EKF3 step, per call and per IMU sample, as JSON
+
+example:
+  ./waf configure --board sitl && ./waf replay
+  Tools/Replay/benchmark_replay.py --output ekf3-bench.json logs/*.BIN
+
+AP_FLAKE8_CLEAN
+'''
+
+import argparse
+import glob
+import json
+import os
+import subprocess
+import sys
+import tempfile
+
+
+def find_logs(paths):
+    '''expand directories into the logs they contain'''
+    logs = []
+    for path in paths:
+        if os.path.isdir(path):
+            found = []
+            for ext in ('bin', 'BIN'):
+                found.extend(glob.glob(os.path.join(path, '**', '*.' + ext), recursive=True))
+            logs.extend(sorted(found))
+        else:
+            logs.append(path)
+    return logs
+
+
+def run_replay(replay, logfile, params, keep_output):
+    '''run Replay over one log, returning its benchmark results'''
+    with tempfile.TemporaryDirectory() as tmpdir:
+        bench_file = os.path.join(tmpdir, 'benchmark.json')
+        cmd = [os.path.abspath(replay), '--benchmark', bench_file]
+        for p in params:
+            cmd.extend(['--param', p])
+        cmd.append(os.path.abspath(logfile))
+        # Replay writes its output log into the current directory
+        cwd = os.getcwd() if keep_output else tmpdir
+        subprocess.check_call(cmd, cwd=cwd, stdout=subprocess.DEVNULL)
+        with open(bench_file) as f:
+            return json.load(f)
+
+
+def summarise(results):
+    '''combine results from all logs into totals per step for each core'''
+    cores = {}
+    for result in results:
+        for core in result['ekf3']:
+            total = cores.setdefault(core['core'], {'imu_samples': 0, 'steps': {}})
+            total['imu_samples'] += core['imu_samples']
+            for name, step in core['steps'].items():
+                s = total['steps'].setdefault(name, {'calls': 0, 'total_us': 0.0, 'max_us': 0.0})
+                s['calls'] += step['calls']
+                s['total_us'] += step['total_us']
+                s['max_us'] = max(s['max_us'], step['max_us'])
+    for total in cores.values():
+        for s in total['steps'].values():
+            s['us_per_call'] = s['total_us'] / s['calls'] if s['calls'] else 0
+            s['us_per_imu_sample'] = s['total_us'] / total['imu_samples'] if total['imu_samples'] else 0
+    return [dict(core=c, **cores[c]) for c in sorted(cores.keys())]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--replay', default='build/sitl/tool/Replay', help='path to the Replay binary')
+    parser.add_argument('--param', action='append', default=[], help='NAME=VALUE parameter passed to Replay')
+    parser.add_argument('--output', default=None, help='file to write JSON results to, default stdout')
+    parser.add_argument('--keep-output', action='store_true', help='keep the logs written by Replay')
+    parser.add_argument('logs', nargs='+', help='logs, or directories of logs, to replay')
+    args = parser.parse_args()
+
+    logs = find_logs(args.logs)
+    if len(logs) == 0:
+        print("No logs found", file=sys.stderr)
+        sys.exit(1)
+
+    results = []
+    for logfile in logs:
+        print("Replaying %s" % logfile, file=sys.stderr)
+        results.append(run_replay(args.replay, logfile, args.param, args.keep_output))
+
+    report = {
+        'replay': args.replay,
+        'params': args.param,
+        'logs': results,
+        'total': {
+            'wall_time_s': sum([r['wall_time_s'] for r in results]),
+            'ekf3': summarise(results),
+        },
+    }
+
+    if args.output is None:
+        json.dump(report, sys.stdout, indent=2)
+        print()
+    else:
+        with open(args.output, 'w') as f:
+            json.dump(report, f, indent=2)
+
+
+if __name__ == '__main__':
+    main()
@@ -48,6 +48,8 @@ class Board:
     def configure(self, cfg):
         cfg.env.TOOLCHAIN = cfg.options.toolchain or self.toolchain
         cfg.env.ROMFS_FILES = []
+        if cfg.options.romfs_block_size:
+            cfg.env.ROMFS_BLOCK_SIZE = cfg.options.romfs_block_size
         if hasattr(self,'configure_toolchain'):
             self.configure_toolchain(cfg)
         else:
@@ -608,7 +610,8 @@ class Board:
         '''embed some files using AP_ROMFS'''
         import embed
         header = ctx.bldnode.make_node('ap_romfs_embedded.h').abspath()
-        if not embed.create_embedded_h(header, ctx.env.ROMFS_FILES, ctx.env.ROMFS_UNCOMPRESSED):
+        block_size = int(ctx.env.ROMFS_BLOCK_SIZE or 0)
+        if not embed.create_embedded_h(header, ctx.env.ROMFS_FILES, ctx.env.ROMFS_UNCOMPRESSED, block_size):
             ctx.fatal("Failed to created ap_romfs_embedded.h")
 
         ctx.env.CXXFLAGS += ['-DHAL_HAVE_AP_ROMFS_EMBEDDED_H']
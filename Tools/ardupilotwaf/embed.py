@@ -14,8 +14,17 @@ import os, sys, zlib
 def write_encode(out, s):
     out.write(s.encode())
 
-def embed_file(out, f, idx, embedded_name, uncompressed):
-    '''embed one file'''
+def compress_raw(contents):
+    '''compress to a raw deflate stream (max level, max window size, max mem usage)'''
+    z = zlib.compressobj(level=9, method=zlib.DEFLATED, wbits=-15, memLevel=9)
+    b = z.compress(contents)
+    b += z.flush()
+    return b
+
+def embed_file(out, f, idx, embedded_name, uncompressed, block_size=0):
+    '''embed one file. With a block_size the file is compressed in
+    independent blocks of that many bytes plus an index of block
+    offsets, so any block can be decompressed on its own'''
     try:
         contents = open(f,'rb').read()
     except Exception:
@@ -38,11 +47,20 @@ def embed_file(out, f, idx, embedded_name, uncompressed):
         # the contents to avoid storing the wrong length
         null_terminate = 0 not in contents
         b = contents
+    elif len(contents) == 0:
+        # an empty file has no blocks, so is embedded without an index
+        block_size = 0
+        b = compress_raw(contents)
+        null_terminate = False
+    elif block_size > 0:
+        b = bytes()
+        offsets = [0]
+        for ofs in range(0, len(contents), block_size):
+            b += compress_raw(contents[ofs:ofs+block_size])
+            offsets.append(len(b))
+        null_terminate = False
     else:
-        # compress it (max level, max window size, raw stream, max mem usage)
-        z = zlib.compressobj(level=9, method=zlib.DEFLATED, wbits=-15, memLevel=9)
-        b = z.compress(contents)
-        b += z.flush()
+        b = compress_raw(contents)
         # decompressed data will be null terminated at runtime, nothing to do here
         null_terminate = False
 
@@ -52,7 +70,11 @@ def embed_file(out, f, idx, embedded_name, uncompressed):
     if null_terminate:
         write_encode(out, ",0")
     write_encode(out, '};\n\n');
-    return crc, len(contents)
+    if block_size > 0 and not uncompressed:
+        write_encode(out, '__EXTFLASHFUNC__ static const uint32_t ap_romfs_%u_blocks[] = {' % idx)
+        write_encode(out, ",".join(str(o) for o in offsets))
+        write_encode(out, '};\n\n');
+    return crc, len(contents), block_size
 
 def crc32(bytes, crc=0):
     '''crc32 equivalent to crc32_small() from AP_Math/crc.cpp'''
@@ -64,9 +86,12 @@ def crc32(bytes, crc=0):
             crc ^= (0xEDB88320 & mask)
     return crc
 
-def create_embedded_h(filename, files, uncompressed=False):
+def create_embedded_h(filename, files, uncompressed=False, block_size=0):
     '''create a ap_romfs_embedded.h file'''
 
+    if uncompressed:
+        block_size = 0
+
     done = set()
 
     out = open(filename, "wb")
@@ -76,6 +101,7 @@ def create_embedded_h(filename, files, uncompressed=False):
     files = sorted(list(set(files)))
     crc = {}
     decompressed_size = {}
+    file_block_size = {}
     for i in range(len(files)):
         (name, filename) = files[i]
         if name in done:
@@ -83,7 +109,7 @@ def create_embedded_h(filename, files, uncompressed=False):
             sys.exit(1)
         done.add(name)
         try:
-            crc[filename], decompressed_size[filename] = embed_file(out, filename, i, name, uncompressed)
+            crc[filename], decompressed_size[filename], file_block_size[filename] = embed_file(out, filename, i, name, uncompressed, block_size)
         except Exception as e:
             print(e)
             return False
@@ -94,11 +120,17 @@ def create_embedded_h(filename, files, uncompressed=False):
         (name, filename) = files[i]
         if uncompressed:
             ustr = ' (uncompressed)'
+        elif file_block_size[filename] > 0:
+            ustr = ' (%u byte blocks)' % block_size
         else:
             ustr = ''
         print("Embedding file %s:%s%s" % (name, filename, ustr))
-        write_encode(out, '{ "%s", sizeof(ap_romfs_%u), %d, 0x%08x, ap_romfs_%u },\n' % (
-            name, i, decompressed_size[filename], crc[filename], i))
+        if file_block_size[filename] > 0:
+            write_encode(out, '{ "%s", sizeof(ap_romfs_%u), %d, 0x%08x, ap_romfs_%u, %u, ap_romfs_%u_blocks },\n' % (
+                name, i, decompressed_size[filename], crc[filename], i, block_size, i))
+        else:
+            write_encode(out, '{ "%s", sizeof(ap_romfs_%u), %d, 0x%08x, ap_romfs_%u },\n' % (
+                name, i, decompressed_size[filename], crc[filename], i))
     write_encode(out, '};\n')
     out.close()
     return True
@@ -106,7 +138,11 @@ def create_embedded_h(filename, files, uncompressed=False):
 if __name__ == '__main__':
     import sys
     flist = []
+    block_size = 0
     for i in range(1, len(sys.argv)):
         f = sys.argv[i]
+        if f.startswith("--block-size="):
+            block_size = int(f[13:])
+            continue
         flist.append((f, f))
-    create_embedded_h("/tmp/ap_romfs_embedded.h", flist)
+    create_embedded_h("/tmp/ap_romfs_embedded.h", flist, block_size=block_size)
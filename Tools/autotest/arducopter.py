@@ -5,6 +5,7 @@ AP_FLAKE8_CLEAN
 '''
 
 import copy
+import json
 import math
 import os
 import shutil
@@ -12,6 +13,7 @@ import tempfile
 import time
 import numpy
 import pathlib
+import re
 
 from pymavlink import quaternion
 from pymavlink import mavutil
@@ -6929,6 +6931,45 @@ class AutoTestCopter(vehicle_test_suite.TestSuite):
         self.context_pop()
         self.reboot_sitl()
 
+    def RateThreadLatency(self):
+        """Check gyro read to motor output latency of the fast rate thread."""
+        self.context_push()
+        self.set_parameters({
+            "FSTRATE_ENABLE": 1,
+            "LOG_BITMASK": 959,
+            "LOG_DISARMED": 0,
+        })
+        self.reboot_sitl()
+
+        self.takeoff(10, mode="ALT_HOLD")
+        self.hover_for_interval(10)
+        self.do_RTL()
+
+        dfreader = self.dfreader_for_current_onboard_log()
+        count = 0
+        lat_avg_sum = 0
+        lat_max = 0
+        while True:
+            m = dfreader.recv_match(type="RTDT")
+            if m is None:
+                break
+            if m.LatMax <= 0:
+                continue
+            count += 1
+            lat_avg_sum += m.LatAvg
+            lat_max = max(lat_max, m.LatMax)
+
+        if count == 0:
+            raise NotAchievedException("No RTDT latency samples")
+        lat_avg = lat_avg_sum / count
+        self.progress("Rate thread latency avg=%.1fus max=%.1fus" % (lat_avg*1.0e6, lat_max*1.0e6))
+        # a sample should always be consumed within one main loop period
+        if lat_avg > 0.0025:
+            raise NotAchievedException("Rate thread latency too high avg=%.1fus" % (lat_avg*1.0e6))
+
+        self.context_pop()
+        self.reboot_sitl()
+
     def hover_and_check_matched_frequency(self, dblevel=-15, minhz=200, maxhz=300, fftLength=32, peakhz=None):
         '''do a simple up-and-down test flight with current vehicle state.
         Check that the onboard filter comes up with the same peak-frequency that
@@ -10544,6 +10585,14 @@ class AutoTestCopter(vehicle_test_suite.TestSuite):
 
         return current_log_filepath
 
+    def test_replay_gps_lane_threads_bit(self):
+        # as for the GPS replay test, with EKF3 lanes updated on
+        # separate threads
+        self.set_parameters({
+            "EK3_OPTIONS": 4,
+        })
+        return self.test_replay_gps_bit()
+
     def test_replay_beacon_bit(self):
         self.set_parameters({
             "LOG_REPLAY": 1,
@@ -10772,6 +10821,117 @@ class AutoTestCopter(vehicle_test_suite.TestSuite):
         self.context_pop()
         self.reboot_sitl()
 
+    def GPSRTCMInjection(self):
+        '''measure GPS_RTCM_DATA injection throughput to two GPS'''
+        self.set_parameters({
+            "GPS2_TYPE": 1,
+            "SIM_GPS2_TYPE": 1,
+            "SIM_GPS2_ENABLE": 1,
+            "LOG_DISARMED": 1,
+        })
+        self.reboot_sitl()
+        self.wait_gps_fix_type_gte(3, message_type="GPS2_RAW", verbose=True)
+
+        # send 720 byte blocks as four fragments at about 10kB/s
+        block_len = 720
+        fragment_len = 180
+        interval = 0.072
+        duration = 10
+        blocks = 0
+        tstart = self.get_sim_time()
+        next_send = tstart
+        while True:
+            now = self.get_sim_time_cached()
+            if now - tstart > duration:
+                break
+            if now < next_send:
+                self.mav.recv_match(type='SYSTEM_TIME', blocking=True, timeout=1)
+                continue
+            next_send += interval
+            block = bytes([(blocks + i) & 0xFF for i in range(block_len)])
+            seq = blocks & 0x1F
+            for fragment in range(block_len // fragment_len):
+                flags = 1 | (fragment << 1) | (seq << 3)
+                data = block[fragment*fragment_len:(fragment+1)*fragment_len]
+                self.mav.mav.gps_rtcm_data_send(flags, len(data), data)
+            blocks += 1
+        self.delay_sim_time(3)
+
+        sent = blocks * block_len
+        self.progress("Sent %u bytes in %u blocks" % (sent, blocks))
+
+        dfreader = self.dfreader_for_current_onboard_log()
+        first = {}
+        last = {}
+        while True:
+            m = dfreader.recv_match(type='GINJ')
+            if m is None:
+                break
+            if m.I not in first:
+                first[m.I] = m
+            last[m.I] = m
+        for instance in 0, 1:
+            if instance not in last:
+                raise NotAchievedException("No GINJ for GPS %u" % instance)
+            m = last[instance]
+            dt = (m.TimeUS - first[instance].TimeUS) * 1.0e-6
+            rate = 0
+            if dt > 0:
+                rate = (m.Bytes - first[instance].Bytes) / dt
+            self.progress("GPS %u: %u bytes %u frames %.0f bytes/s drop=%u stall=%u" %
+                          (instance, m.Bytes, m.Frm, rate, m.Drop, m.Stall))
+            if m.Drop != 0:
+                raise NotAchievedException("GPS %u dropped %u frames" % (instance, m.Drop))
+            if m.Bytes != sent:
+                raise NotAchievedException("GPS %u got %u of %u bytes" % (instance, m.Bytes, sent))
+
+    def LogStartupTiming(self):
+        '''measure the time taken to write the startup messages of a log'''
+        self.set_parameters({
+            "LOG_DISARMED": 0,
+            "LOG_FILE_DSRMROT": 1,
+        })
+        self.reboot_sitl()
+        self.wait_ready_to_arm()
+
+        for i in range(3):
+            self.arm_vehicle()
+            self.delay_sim_time(10)
+            self.disarm_vehicle()
+
+            # times from the first message of the log to the first
+            # message logged at vehicle rate, and to the last of the
+            # startup parameters, mission, rally points and fence
+            startup_types = set(['PARM', 'CMD', 'RALY', 'FNCE'])
+            first_us = None
+            first_vehicle_us = None
+            last_startup_us = None
+            dfreader = self.dfreader_for_current_onboard_log()
+            while True:
+                m = dfreader.recv_match()
+                if m is None:
+                    break
+                t = getattr(m, "TimeUS", None)
+                if t is None:
+                    continue
+                if first_us is None:
+                    first_us = t
+                mtype = m.get_type()
+                if mtype in startup_types:
+                    last_startup_us = t
+                elif mtype in ('IMU', 'ATT') and first_vehicle_us is None:
+                    first_vehicle_us = t
+            if first_us is None or first_vehicle_us is None or last_startup_us is None:
+                raise NotAchievedException("No startup or vehicle messages in log")
+            vehicle_ms = (first_vehicle_us - first_us) * 0.001
+            startup_ms = (last_startup_us - first_us) * 0.001
+            self.progress("Log startup: first vehicle message %.1fms, startup complete %.1fms" %
+                          (vehicle_ms, startup_ms))
+            if vehicle_ms > 1000:
+                raise NotAchievedException("First vehicle message took %.1fms" % vehicle_ms)
+            if startup_ms > 5000:
+                raise NotAchievedException("Startup messages took %.1fms" % startup_ms)
+
     def GPSBlendingAffinity(self):
         '''test blending when affinity in use'''
         # configure:
@@ -10947,12 +11107,41 @@ class AutoTestCopter(vehicle_test_suite.TestSuite):
 
         bits = [
             ('GPS', self.test_replay_gps_bit),
+            ('GPSLaneThreads', self.test_replay_gps_lane_threads_bit),
             ('Beacon', self.test_replay_beacon_bit),
             ('OpticalFlow', self.test_replay_optical_flow_bit),
         ]
+        logs = {}
         for (name, func) in bits:
             self.start_subtest("%s" % name)
-            self.test_replay_bit(func)
+            logs[name] = self.test_replay_bit(func)
+
+        self.start_subtest("Benchmark")
+        self.test_replay_benchmark(logs['GPS'])
+
+    def test_replay_benchmark(self, log_filepath):
+        '''run Replay with --benchmark and check the EKF3 step timing it writes'''
+        benchmark_filepath = self.buildlogs_path("Replay-benchmark.json")
+        self.run_replay(log_filepath, extra_args=['--benchmark', benchmark_filepath])
+
+        with open(benchmark_filepath) as f:
+            benchmark = json.load(f)
+        self.progress("Replay benchmark: %s" % json.dumps(benchmark, indent=2))
+
+        if benchmark["wall_time_s"] <= 0:
+            raise NotAchievedException("Bad wall time %f" % benchmark["wall_time_s"])
+        if len(benchmark["ekf3"]) == 0:
+            raise NotAchievedException("No EKF3 cores in benchmark")
+        for core in benchmark["ekf3"]:
+            steps = core["steps"]
+            if core["imu_samples"] == 0:
+                raise NotAchievedException("No IMU samples for core %u" % core["core"])
+            if steps["UpdateFilter"]["calls"] != core["imu_samples"]:
+                raise NotAchievedException("UpdateFilter calls %u != IMU samples %u" %
+                                           (steps["UpdateFilter"]["calls"], core["imu_samples"]))
+            for name in "UpdateFilter", "CovariancePrediction", "FuseVelPosNED":
+                if steps[name]["calls"] == 0 or steps[name]["total_us"] <= 0:
+                    raise NotAchievedException("No time recorded for %s on core %u" % (name, core["core"]))
 
     def test_replay_bit(self, bit):
 
@@ -10977,6 +11166,8 @@ class AutoTestCopter(vehicle_test_suite.TestSuite):
         if not ok:
             raise NotAchievedException("check_replay (%s) failed" % current_log_filepath)
 
+        return current_log_filepath
+
     def DefaultIntervalsFromFiles(self):
         '''Test setting default mavlink message intervals from files'''
         ex = None
@@ -11521,6 +11712,38 @@ class AutoTestCopter(vehicle_test_suite.TestSuite):
         self.disarm_vehicle()
         self.context_pop()
 
+    def ADSBBenchmark(self):
+        '''ADSB and avoidance under load from several hundred aircraft'''
+        self.load_default_params_file("adsb-benchmark.parm")
+        self.set_parameter('SCHED_OPTIONS', 1)  # enable task statistics
+        self.reboot_sitl()
+
+        self.assert_receive_message('ADSB_VEHICLE', timeout=30)
+
+        # the first fetch starts statistics collection, the second
+        # covers a period with all of the aircraft being tracked
+        self.fetch_file_via_ftp("@SYS/tasks.txt")
+        self.delay_sim_time(30)
+        content = self.fetch_file_via_ftp("@SYS/tasks.txt")
+
+        tasks = {
+            "avoidance_adsb_update": "list maintenance and threat levels",
+            "update_receive": "ADSB_VEHICLE lookups",
+        }
+        for (task, desc) in tasks.items():
+            found = False
+            for line in content.split("\n"):
+                if task not in line:
+                    continue
+                match = re.search(r"MIN=\s*(\d+) MAX=\s*(\d+) AVG=\s*(\d+)", line)
+                if match is None:
+                    raise NotAchievedException("Unable to parse (%s)" % line)
+                self.progress("ADSB benchmark: %s (%s) MIN=%sus MAX=%sus AVG=%sus" %
+                              (task, desc, match.group(1), match.group(2), match.group(3)))
+                found = True
+            if not found:
+                raise NotAchievedException("No %s task in tasks.txt" % task)
+
     def PAUSE_CONTINUE(self):
         '''Test MAV_CMD_DO_PAUSE_CONTINUE in AUTO mode'''
         self.load_mission(filename="copter_mission.txt", strict=False)
@@ -14438,6 +14661,7 @@ RTL_ALT 111
             self.PositionWhenGPSIsZero,
             self.DynamicRpmNotches, # Do not add attempts to this - failure is sign of a bug
             self.DynamicRpmNotchesRateThread,
+            self.RateThreadLatency,
             self.PIDNotches,
             self.StaticNotches,
             self.LuaParamSet,
@@ -14457,6 +14681,7 @@ RTL_ALT 111
             self.GSF,
             self.GSF_reset,
             self.AP_Avoidance,
+            self.ADSBBenchmark,
             self.RTL_ALT_FINAL,
             self.SMART_RTL,
             self.SMART_RTL_EnterLeave,
@@ -14468,7 +14693,10 @@ RTL_ALT 111
             self.GPSWeightedBlending,
             self.GPSBlendingLog,
             self.GPSBlendingAffinity,
+            self.GPSRTCMInjection,
             self.DataFlash,
+            self.DataFlashDownload,
+            self.LogStartupTiming,
             Test(self.DataFlashErase, attempts=8),
             self.Callisto,
             self.PerfInfo,
@@ -7520,6 +7520,8 @@ class AutoTestPlane(vehicle_test_suite.TestSuite):
             self.ForcedDCM,
             self.DCMFallback,
             self.MAVFTP,
+            self.MAVFTPMultiSession,
+            self.MAVFTPParamDelta,
             self.AUTOTUNE,
             self.AutotuneFiltering,
             self.MegaSquirt,
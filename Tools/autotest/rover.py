@@ -10,6 +10,7 @@ import math
 import operator
 import os
 import pathlib
+import signal
 import sys
 import time
 
@@ -5234,6 +5235,32 @@ Brakes have negligible effect (with=%0.2fm without=%0.2fm delta=%0.2fm)
         self.context_pop()
         self.reboot_sitl()
 
+    def test_scripting_can_restart(self):
+        self.start_subtest("Scripting CAN buffers after restarts")
+
+        self.context_push()
+        self.context_collect('STATUSTEXT')
+        self.set_parameters({
+            "SCR_ENABLE": 1,
+            "CAN_P1_DRIVER": 1,
+            "CAN_D1_PROTOCOL": 10,  # scripting
+        })
+        self.install_test_script_context("can_restart.lua")
+        self.reboot_sitl()
+
+        # each run takes 4 of the 16 buffers, so these fail unless a
+        # restart frees them
+        self.wait_statustext("CAN buffers good", check_context=True)
+        for i in range(8):
+            self.context_clear_collection('STATUSTEXT')
+            self.scripting_restart()
+            self.wait_statustext("CAN buffers (good|failed)", regex=True, check_context=True)
+            if self.statustext_in_collections("CAN buffers failed"):
+                raise NotAchievedException("CAN buffers not freed on restart %u" % (i+1))
+
+        self.context_pop()
+        self.reboot_sitl()
+
     def Scripting(self):
         '''Scripting test'''
         self.test_scripting_set_home_to_vehicle_location()
@@ -5243,6 +5270,7 @@ Brakes have negligible effect (with=%0.2fm without=%0.2fm delta=%0.2fm)
         self.test_scripting_internal_test()
         self.test_scripting_auxfunc()
         self.test_scripting_serial_loopback()
+        self.test_scripting_can_restart()
 
     def test_mission_frame(self, frame, target_system=1, target_component=1):
         self.clear_mission(mavutil.mavlink.MAV_MISSION_TYPE_MISSION,
@@ -5917,6 +5945,41 @@ Brakes have negligible effect (with=%0.2fm without=%0.2fm delta=%0.2fm)
         # make sure we're back at our original value:
         self.assert_parameter_value("LOG_BITMASK", 1)
 
+    def JournalStorage(self):
+        '''Test journal storage (for parameters etc), including SIGKILL'''
+        self.set_parameter("LOG_BITMASK", 1)
+        self.reboot_sitl()
+
+        # a new journal is imported from the posix storage
+        if os.path.exists("eeprom.jnl"):
+            os.unlink("eeprom.jnl")
+        journal_commandline = [
+            "--set-storage-posix-enabled", "0",
+            "--set-storage-journal-enabled", "1",
+        ]
+        self.customise_SITL_commandline(journal_commandline)
+        self.assert_parameter_value("LOG_BITMASK", 1)
+        self.set_parameter("LOG_BITMASK", 2)
+        self.reboot_sitl()
+        self.assert_parameter_value("LOG_BITMASK", 2)
+
+        # killing the process, including part way through a burst of
+        # parameter saves, must never lose a parameter which has been
+        # saved or corrupt the storage
+        for value in range(3, 8):
+            self.set_parameter("LOG_BITMASK", value)
+            self.delay_sim_time(1)
+            for i in range(value):
+                self.send_set_parameter("SIM_WIND_SPD", i)
+            self.sitl.kill(signal.SIGKILL)
+            self.customise_SITL_commandline(journal_commandline)
+            self.assert_parameter_value("LOG_BITMASK", value)
+        self.set_parameter("SIM_WIND_SPD", 0)
+
+        self.customise_SITL_commandline([])
+        # make sure we're back at our original value:
+        self.assert_parameter_value("LOG_BITMASK", 1)
+
     def RangeFinder(self):
         '''Test RangeFinder'''
         # the following magic numbers correspond to the post locations in SITL
@@ -6961,6 +7024,7 @@ Brakes have negligible effect (with=%0.2fm without=%0.2fm delta=%0.2fm)
             self.WheelEncoders,
             self.DataFlashOverMAVLink,
             self.DataFlash,
+            self.DataFlashDownload,
             self.SkidSteer,
             self.PolyFence,
             self.SDPolyFence,
@@ -6983,6 +7047,7 @@ Brakes have negligible effect (with=%0.2fm without=%0.2fm delta=%0.2fm)
             self.EndMissionBehavior,
             self.FlashStorage,
             self.FRAMStorage,
+            self.JournalStorage,
             self.DepthFinder,
             self.ChangeModeByNumber,
             self.EStopAtBoot,
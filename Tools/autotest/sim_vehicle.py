@@ -800,6 +800,9 @@ def start_vehicle(binary, opts, stuff, spawns=None):
     elif opts.fram_storage:
         cmd.append("--set-storage-fram-enabled 1")
         cmd.append("--set-storage-posix-enabled 0")
+    elif opts.journal_storage:
+        cmd.append("--set-storage-journal-enabled 1")
+        cmd.append("--set-storage-posix-enabled 0")
     if opts.add_param_file:
         for file in opts.add_param_file:
             if not os.path.isfile(file):
@@ -1318,6 +1321,9 @@ group_sim.add_option("--flash-storage",
 group_sim.add_option("--fram-storage",
                      action='store_true',
                      help="use fram storage emulation")
+group_sim.add_option("--journal-storage",
+                     action='store_true',
+                     help="use journal file storage")
 group_sim.add_option("--enable-ekf2",
                      action='store_true',
                      help="disable EKF2 in build")
@@ -4958,7 +4958,15 @@ class TestSuite(ABC):
             "NET_P2_IP1": 255,
             "NET_P2_IP2": 255,
             "NET_P2_IP3": 255,
-            "NET_P3_TYPE": -1,
+            # UDP client combining messages into full sized packets
+            "NET_P3_TYPE": 1,
+            "NET_P3_PROTOCOL": 2,
+            "NET_P3_PORT": 16007,
+            "NET_P3_IP0": 127,
+            "NET_P3_IP1": 0,
+            "NET_P3_IP2": 0,
+            "NET_P3_IP3": 1,
+            "NET_P3_COALESCE": 5,
             "NET_P4_TYPE": -1,
             "LOG_DISARMED": 0,
             })
@@ -4967,7 +4975,8 @@ class TestSuite(ABC):
         self.set_parameter('SIM_SPEEDUP', 1)
 
         endpoints = [('UDPMulticast', 'mcast:16005') ,
-                     ('UDPBroadcast', ':16006')]
+                     ('UDPBroadcast', ':16006'),
+                     ('UDPCoalesced', ':16007')]
         for name, e in endpoints:
             self.progress("Downloading log with %s %s" % (name, e))
             filename = "MAVProxy-downloaded-net-log-%s.BIN" % name
@@ -10540,6 +10549,121 @@ Also, ignores heartbeats not from our target system'''
         if ex is not None:
             raise ex
 
+    def stream_log(self, log_id, size, resume_at=None, timeout=120):
+        '''download a log with a single request, resuming with a new
+        request from the first missing byte if packets are lost.  If
+        resume_at is given then once that many bytes are received the
+        transfer is restarted from the middle of the log while it is
+        still running.  Returns the data and the bytes/second achieved'''
+        data = bytearray(size)
+        received = 0
+        expected_ofs = 0
+        resumed = resume_at is None
+        tstart = time.time()
+        last_request = 0
+        self.drain_mav()
+        while received < size:
+            now = time.time()
+            if now - tstart > timeout:
+                raise NotAchievedException("Did not download log in good time (%u/%u)" % (received, size))
+            if now - last_request > 2:
+                # initial request, or the transfer has stalled
+                self.mav.mav.log_request_data_send(
+                    self.sysid_thismav(),
+                    1, # target component
+                    log_id,
+                    expected_ofs,
+                    0xFFFFFFFF
+                )
+                last_request = now
+            m = self.mav.recv_match(type='LOG_DATA', blocking=True, timeout=0.1)
+            if m is None:
+                continue
+            if m.id != log_id:
+                raise NotAchievedException("Unexpected id %u" % m.id)
+            if m.ofs != expected_ofs:
+                if m.ofs > expected_ofs and now - last_request > 0.2:
+                    # lost packets; ask for the rest of the log from the gap
+                    self.mav.mav.log_request_data_send(
+                        self.sysid_thismav(),
+                        1, # target component
+                        log_id,
+                        expected_ofs,
+                        0xFFFFFFFF
+                    )
+                    last_request = now
+                continue
+            last_request = now
+            data[m.ofs:m.ofs+m.count] = bytearray(m.data[:m.count])
+            expected_ofs += m.count
+            received = max(received, expected_ofs)
+            if m.count < 90:
+                break
+            if not resumed and received >= resume_at:
+                resumed = True
+                expected_ofs = size // 2
+                self.progress("Resuming transfer at offset %u" % expected_ofs)
+                self.mav.mav.log_request_data_send(
+                    self.sysid_thismav(),
+                    1, # target component
+                    log_id,
+                    expected_ofs,
+                    0xFFFFFFFF
+                )
+        elapsed = max(time.time() - tstart, 0.001)
+        return (data[:received], received / elapsed)
+
+    def DataFlashDownload(self):
+        '''Test log download speed and resume with the DataFlash SITL backend'''
+        self.context_push()
+        self.set_parameters({
+            "LOG_BACKEND_TYPE": 4,
+            "LOG_FILE_DSRMROT": 1,
+        })
+        self.reboot_sitl()
+        self.mav.mav.log_erase_send(self.sysid_thismav(), 1)
+        self.wait_statustext("Chip erase complete", timeout=60)
+
+        # create a log of a few hundred kilobytes
+        self.set_parameter("LOG_DISARMED", 1)
+        self.delay_sim_time(30)
+        self.set_parameter("LOG_DISARMED", 0)
+        self.delay_sim_time(2)
+
+        logs = self.download_full_log_list(print_logs=False)
+        log_id = sorted(logs.keys())[-1]
+        size = logs[log_id].size
+        if size < 50000:
+            raise NotAchievedException("Log too small (%u bytes)" % size)
+        self.progress("Log %u size %u" % (log_id, size))
+
+        self.start_subtest("Streamed download")
+        (streamed, rate) = self.stream_log(log_id, size)
+        self.progress("Downloaded %u bytes at %.0f bytes/s" % (len(streamed), rate))
+        if len(streamed) != size:
+            raise NotAchievedException("Got %u bytes, want %u" % (len(streamed), size))
+
+        self.start_subtest("Download with a request per packet")
+        tstart = time.time()
+        polled = self.download_log(log_id)
+        self.progress("Downloaded %u bytes at %.0f bytes/s" %
+                      (len(polled), len(polled) / max(time.time() - tstart, 0.001)))
+        if len(polled) != size:
+            raise NotAchievedException("Got %u bytes, want %u" % (len(polled), size))
+        self.assert_bytes_equal(streamed, polled)
+
+        self.start_subtest("Resume from an offset during a download")
+        (resumed, rate) = self.stream_log(log_id, size, resume_at=size // 4)
+        self.progress("Downloaded %u bytes at %.0f bytes/s" % (len(resumed), rate))
+        if len(resumed) != size:
+            raise NotAchievedException("Got %u bytes, want %u" % (len(resumed), size))
+        # the quarter from resume_at up to the restart point may be missing
+        self.assert_bytes_equal(streamed[:size//4], resumed[:size//4])
+        self.assert_bytes_equal(streamed[size//2:], resumed[size//2:])
+
+        self.context_pop()
+        self.reboot_sitl()
+
     def validate_log_file(self, logname, header_errors=0):
         """Validate the contents of a log file"""
         # read the downloaded log - it must parse without error
@@ -14222,10 +14346,12 @@ switch value'''
         # heading seemingly indefinitely.
         self.reboot_sitl()
 
-    def run_replay(self, filepath):
+    def run_replay(self, filepath, extra_args=None):
         '''runs replay in filepath, returns filepath to Replay logfile'''
+        if extra_args is None:
+            extra_args = []
         util.run_cmd(
-            ['build/sitl/tool/Replay', filepath],
+            ['build/sitl/tool/Replay'] + extra_args + [filepath],
             directory=util.topdir(),
             checkfail=True,
             show=True,
@@ -14434,13 +14560,13 @@ switch value'''
         if abs(new_gpi_alt2 - m.alt) > 100:
             raise NotAchievedException("Failover not detected")
 
-    def fetch_file_via_ftp(self, path, timeout=20):
+    def fetch_file_via_ftp(self, path, timeout=20, binary=False):
         '''returns the content of the FTP'able file at path'''
         self.progress("Retrieving (%s) using MAVProxy" % path)
         mavproxy = self.start_mavproxy()
         mavproxy.expect("Saved .* parameters to")
         ex = None
-        tmpfile = tempfile.NamedTemporaryFile(mode='r', delete=False)
+        tmpfile = tempfile.NamedTemporaryFile(mode='rb' if binary else 'r', delete=False)
         try:
             mavproxy.send("module load ftp\n")
             mavproxy.expect(["Loaded module ftp", "module ftp already loaded"])
@@ -14499,6 +14625,158 @@ switch value'''
         if ex is not None:
             raise ex
 
+    def MAVFTPMultiSession(self):
+        '''concurrent MAVFTP burst downloads over a UDP network port'''
+        self.set_parameters({
+            "NET_ENABLE": 1,
+            "LOG_DISARMED": 1,
+            # UDP server
+            "NET_P1_TYPE": 2,
+            "NET_P1_PROTOCOL": 2,
+            "NET_P1_PORT": 16002,
+            "NET_P1_IP0": 0,
+            "NET_P1_IP1": 0,
+            "NET_P1_IP2": 0,
+            "NET_P1_IP3": 0,
+        })
+        self.reboot_sitl()
+
+        # a file with known content in the SITL directory
+        content = bytes([(i * 7 + (i >> 8)) % 256 for i in range(300000)])
+        filename = "mavftp-multi-session.bin"
+        self.write_content_to_filepath(content, filename)
+
+        sys.path.insert(1, os.path.join(self.rootdir(), 'Tools', 'scripts'))
+        import mavftp_bench
+
+        master = mavutil.mavlink_connection(
+            'udpout:127.0.0.1:16002',
+            robust_parsing=True,
+            source_system=123,
+        )
+        try:
+            master.mav.heartbeat_send(mavutil.mavlink.MAV_TYPE_GCS, mavutil.mavlink.MAV_AUTOPILOT_INVALID, 0, 0, 0)
+            master.wait_heartbeat()
+            bench = mavftp_bench.FTPBench(master, self.sysid_thismav(), 1)
+            downloads = bench.download([filename, filename, "@PARAM/param.pck"],
+                                       timeout=120,
+                                       progress=self.progress)
+        finally:
+            master.close()
+            os.unlink(filename)
+
+        for d in downloads:
+            if d.error is not None:
+                raise NotAchievedException("%s failed: %s" % (d.path, d.error))
+            if d.rate() <= 0:
+                raise NotAchievedException("No data for %s" % d.path)
+        for d in downloads[:2]:
+            self.progress(d.report())
+            if d.data() != content:
+                raise NotAchievedException("Content mismatch on session %u" % d.session)
+            # network ports are not paced, so each session should get
+            # well over one packet per millisecond
+            if d.rate() < 300000:
+                raise NotAchievedException("Session %u too slow: %.0f bytes/s" % (d.session, d.rate()))
+        # the header gives the number of parameters
+        (magic, num_params, total_params) = struct.unpack("<HHH", downloads[2].data()[0:6])
+        if magic != 0x671b or num_params < 100:
+            raise NotAchievedException("Bad param.pck header 0x%x %u" % (magic, num_params))
+
+    def unpack_param_pck(self, data):
+        '''unpack a param.pck or delta file, returning the header and
+        a dictionary of parameter values'''
+        (magic, num_params, total_params) = struct.unpack("<HHH", data[0:6])
+        header = {
+            "magic": magic,
+            "num_params": num_params,
+            "total_params": total_params,
+            "hash": None,
+        }
+        if magic in (0x671d, 0x671e):
+            header["hash"] = struct.unpack("<I", data[6:10])[0]
+            data = data[10:]
+        elif magic in (0x671b, 0x671c):
+            data = data[6:]
+        else:
+            raise NotAchievedException("Bad param.pck magic 0x%x" % magic)
+        data_types = {
+            1: (1, 'b'),
+            2: (2, 'h'),
+            3: (4, 'i'),
+            4: (4, 'f'),
+        }
+        params = {}
+        last_name = ""
+        while True:
+            # skip pad bytes
+            while len(data) > 0 and data[0] == 0:
+                data = data[1:]
+            if len(data) == 0:
+                break
+            (ptype, plen) = struct.unpack("<BB", data[0:2])
+            flags = (ptype >> 4) & 0x0F
+            ptype &= 0x0F
+            if ptype not in data_types:
+                raise NotAchievedException("Bad param.pck type 0x%x" % ptype)
+            (type_len, type_format) = data_types[ptype]
+            name_len = ((plen >> 4) & 0x0F) + 1
+            common_len = plen & 0x0F
+            name = last_name[0:common_len] + data[2:2+name_len].decode('utf-8')
+            (value,) = struct.unpack("<" + type_format, data[2+name_len:2+name_len+type_len])
+            if flags & 1:
+                # includes the default value
+                type_len *= 2
+            data = data[2+name_len+type_len:]
+            last_name = name
+            params[name] = value
+        if len(params) != num_params:
+            raise NotAchievedException("param.pck has %u params, header says %u" % (len(params), num_params))
+        return (header, params)
+
+    def MAVFTPParamDelta(self):
+        '''download parameter deltas from param.pck?delta=HASH'''
+        # these are saved by the vehicle itself while we run, so may
+        # appear in any delta
+        self_updated = set(["STAT_RUNTIME", "STAT_FLTTIME"])
+
+        def fetch_delta(hash):
+            path = "@PARAM/param.pck?delta=%x" % hash
+            return self.unpack_param_pck(self.fetch_file_via_ftp(path, binary=True))
+
+        # an unknown hash gives the full parameter set
+        (header, full) = fetch_delta(0)
+        if header["magic"] != 0x671d:
+            raise NotAchievedException("Bad delta magic 0x%x" % header["magic"])
+        if header["num_params"] != header["total_params"] or header["num_params"] < 100:
+            raise NotAchievedException("Delta from 0 not full: %u/%u" %
+                                       (header["num_params"], header["total_params"]))
+        for name in ["SYSID_THISMAV", "SERIAL0_BAUD"]:
+            if name not in full:
+                raise NotAchievedException("%s missing from full delta" % name)
+
+        # nothing has changed since that hash
+        (header2, delta) = fetch_delta(header["hash"])
+        extra = set(delta.keys()) - self_updated
+        if len(extra) != 0:
+            raise NotAchievedException("Unexpected params in unchanged delta: %s" % str(extra))
+
+        # change two parameters and only those come back
+        changes = {
+            "SERIAL1_BAUD": 19 if full["SERIAL1_BAUD"] != 19 else 38,
+            "SERIAL2_BAUD": 19 if full["SERIAL2_BAUD"] != 19 else 38,
+        }
+        self.set_parameters(changes)
+        (header3, delta) = fetch_delta(header2["hash"])
+        if header3["hash"] == header2["hash"]:
+            raise NotAchievedException("Hash did not change with the parameters")
+        if set(delta.keys()) - self_updated != set(changes.keys()):
+            raise NotAchievedException("Delta has %s, expected %s" %
+                                       (str(sorted(delta.keys())), str(sorted(changes.keys()))))
+        for (name, value) in changes.items():
+            if abs(delta[name] - value) > 0.001:
+                raise NotAchievedException("%s=%f in delta, expected %f" % (name, delta[name], value))
+
     def write_content_to_filepath(self, content, filepath):
         '''write biunary content to filepath'''
         with open(filepath, "wb") as f:
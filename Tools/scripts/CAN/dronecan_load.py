@@ -0,0 +1,139 @@
+#!/usr/bin/env python3
+
+# flake8: noqa
+
+'''
+generate a heavy DroneCAN load to test the receive path of a DroneCAN
+driver, simulating a bus with many ESCs, GNSS receivers and IMU/flow
+sensors. With SITL use the multicast CAN transport:
+
+  CAN_P1_DRIVER=1 CAN_D1_PROTOCOL=1 CAN_P1_DRIVER_TYPE=1 (Multicast)
+  dronecan_load.py mcast:0
+
+or attach to SocketCAN:
+
+  dronecan_load.py vcan0
+
+then check the CANP log messages (pool use, out of memory drops and
+frames handled per wakeup) and the CANS receive overflow counts
+'''
+
+import dronecan
+import time
+import math
+from dronecan import uavcan
+
+from argparse import ArgumentParser
+parser = ArgumentParser(description='DroneCAN load generator')
+parser.add_argument("port", default=None, type=str, help="serial port, SocketCAN interface or mcast:N")
+parser.add_argument("--bitrate", default=1000000, type=int, help="CAN bit rate")
+parser.add_argument("--node-id", default=100, type=int, help="first node ID to use")
+parser.add_argument("--num-esc", default=8, type=int, help="number of ESCs")
+parser.add_argument("--esc-rate", default=400, type=float, help="ESC status rate in Hz")
+parser.add_argument("--num-gnss", default=2, type=int, help="number of GNSS receivers")
+parser.add_argument("--gnss-rate", default=20, type=float, help="GNSS Fix2 rate in Hz")
+parser.add_argument("--num-imu", default=1, type=int, help="number of raw IMU nodes")
+parser.add_argument("--imu-rate", default=400, type=float, help="raw IMU rate in Hz")
+parser.add_argument("--flow-rate", default=0, type=float, help="optical flow rate in Hz, 0 to disable")
+parser.add_argument("--canfd", action='store_true', help="send with CAN FD")
+parser.add_argument("--duration", default=0, type=float, help="seconds to run for, 0 for ever")
+args = parser.parse_args()
+
+next_node_id = args.node_id
+counts = {}
+
+def new_node():
+    global next_node_id
+    node = dronecan.make_node(args.port, node_id=next_node_id, bitrate=args.bitrate)
+    node.health = uavcan.protocol.NodeStatus().HEALTH_OK
+    node.mode = uavcan.protocol.NodeStatus().MODE_OPERATIONAL
+    next_node_id += 1
+    return node
+
+def broadcast(node, msg, name):
+    try:
+        node.broadcast(msg, canfd=args.canfd)
+        counts[name] = counts.get(name, 0) + 1
+    except Exception as ex:
+        counts['errors'] = counts.get('errors', 0) + 1
+
+nodes = []
+
+# all ESCs are sent from one node, as for a 4in1 ESC
+if args.num_esc > 0:
+    esc_node = new_node()
+    nodes.append(esc_node)
+    def send_esc():
+        t = time.time()
+        for i in range(args.num_esc):
+            broadcast(esc_node, uavcan.equipment.esc.Status(
+                error_count=0,
+                voltage=16.0,
+                current=5.0 + i,
+                temperature=320.0,
+                rpm=int(8000 + 1000 * math.sin(t + i)),
+                power_rating_pct=50,
+                esc_index=i), 'esc')
+    esc_node.periodic(1.0 / args.esc_rate, send_esc)
+
+# Fix2 is a multi-frame transfer on classic CAN
+for i in range(args.num_gnss):
+    gnss_node = new_node()
+    nodes.append(gnss_node)
+    def send_gnss(node=gnss_node):
+        broadcast(node, uavcan.equipment.gnss.Fix2(
+            gnss_timestamp=uavcan.Timestamp(usec=int(time.time() * 1e6)),
+            gnss_time_standard=uavcan.equipment.gnss.Fix2().GNSS_TIME_STANDARD_UTC,
+            latitude_deg_1e8=int(-35.363261 * 1e8),
+            longitude_deg_1e8=int(149.165230 * 1e8),
+            height_ellipsoid_mm=584000,
+            height_msl_mm=584000,
+            ned_velocity=[0.1, 0.2, 0.0],
+            sats_used=20,
+            status=uavcan.equipment.gnss.Fix2().STATUS_3D_FIX,
+            mode=uavcan.equipment.gnss.Fix2().MODE_RTK,
+            sub_mode=uavcan.equipment.gnss.Fix2().SUB_MODE_RTK_FIXED,
+            covariance=[0.01] * 6,
+            pdop=1.0), 'fix2')
+    gnss_node.periodic(1.0 / args.gnss_rate, send_gnss)
+
+for i in range(args.num_imu):
+    imu_node = new_node()
+    nodes.append(imu_node)
+    def send_imu(node=imu_node):
+        broadcast(node, uavcan.equipment.ahrs.RawIMU(
+            timestamp=uavcan.Timestamp(usec=int(time.time() * 1e6)),
+            integration_interval=1.0 / args.imu_rate,
+            rate_gyro_latest=[0.01, 0.02, 0.03],
+            rate_gyro_integral=[0.0, 0.0, 0.0],
+            accelerometer_latest=[0.0, 0.0, -9.8],
+            accelerometer_integral=[0.0, 0.0, -9.8 / args.imu_rate]), 'imu')
+    imu_node.periodic(1.0 / args.imu_rate, send_imu)
+
+if args.flow_rate > 0:
+    flow_node = new_node()
+    nodes.append(flow_node)
+    def send_flow():
+        broadcast(flow_node, dronecan.com.hex.equipment.flow.Measurement(
+            integration_interval=1.0 / args.flow_rate,
+            rate_gyro_integral=[0.0, 0.0],
+            flow_integral=[0.01, 0.01],
+            quality=200), 'flow')
+    flow_node.periodic(1.0 / args.flow_rate, send_flow)
+
+print("Sending from %u nodes on %s" % (len(nodes), args.port))
+tstart = time.time()
+last_print = tstart
+last_counts = {}
+while args.duration <= 0 or time.time() - tstart < args.duration:
+    for node in nodes:
+        try:
+            node.spin(0.0005)
+        except Exception as ex:
+            print(ex)
+    now = time.time()
+    if now - last_print >= 1.0:
+        rates = ["%s=%.0f/s" % (k, (v - last_counts.get(k, 0)) / (now - last_print)) for k, v in sorted(counts.items())]
+        print(" ".join(rates))
+        last_counts = dict(counts)
+        last_print = now
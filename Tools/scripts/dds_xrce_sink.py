@@ -0,0 +1,180 @@
+#!/usr/bin/env python3
+
+'''
+minimal stand-in for the Micro XRCE-DDS agent, for throughput testing of
+the AP_DDS publishers over UDP without a ROS 2 installation
+
+It accepts the session, answers every create request with success,
+acknowledges the reliable stream and answers pings, then counts the
+WRITE_DATA samples per datawriter. Nothing is forwarded to DDS; use
+MicroXRCEAgent for that.
+
+  ./Tools/scripts/dds_xrce_sink.py --port 2019 --interval 5
+
+then run SITL with DDS_ENABLE=1. Per topic rates can be compared with
+the rates reported by the vehicle in @SYS/dds.txt
+
+AP_FLAKE8_CLEAN
+'''
+
+import argparse
+import socket
+import struct
+import time
+
+# submessage ids from the DDS-XRCE specification
+CREATE_CLIENT = 0
+CREATE = 1
+GET_INFO = 2
+DELETE = 3
+STATUS_AGENT = 4
+STATUS = 5
+INFO = 6
+WRITE_DATA = 7
+READ_DATA = 8
+ACKNACK = 10
+HEARTBEAT = 11
+FRAGMENT = 13
+
+FLAG_LITTLE_ENDIAN = 0x01
+SESSION_ID_WITHOUT_CLIENT_KEY = 0x80
+STREAM_NONE = 0x00
+OBJK_AGENT = 0x0D
+OBJK_DATAWRITER = 0x05
+
+XRCE_COOKIE = b'XRCE'
+XRCE_VERSION = b'\x01\x00'
+XRCE_VENDOR = b'\x01\x0f'
+
+
+def align(n, a):
+    return (n + a - 1) & ~(a - 1)
+
+
+class Sink(object):
+    def __init__(self, port):
+        self.sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+        self.sock.bind(('', port))
+        self.sock.settimeout(0.1)
+        # next expected sequence number per reliable input stream
+        self.reliable_expected = {}
+        self.writers = {}
+        self.packets = 0
+        self.bytes = 0
+
+    def header(self, session_id, key):
+        hdr = struct.pack('<BBH', session_id, STREAM_NONE, 0)
+        if session_id < SESSION_ID_WITHOUT_CLIENT_KEY:
+            hdr += key
+        return hdr
+
+    def submessage(self, msg, sub_id, payload):
+        '''append a submessage, aligned to 4 bytes from the message start'''
+        msg += b'\x00' * (align(len(msg), 4) - len(msg))
+        return msg + struct.pack('<BBH', sub_id, FLAG_LITTLE_ENDIAN, len(payload)) + payload
+
+    def agent_representation(self):
+        # cookie, version, vendor, no properties
+        return XRCE_COOKIE + XRCE_VERSION + XRCE_VENDOR + b'\x00'
+
+    def info_payload(self, request):
+        # BaseObjectReply, then ObjectInfo with an agent config and
+        # activity. Offsets are relative to an aligned payload start
+        p = request + b'\x00\x00'
+        p += b'\x01' + bytes([OBJK_AGENT]) + self.agent_representation()
+        p += b'\x01' + bytes([OBJK_AGENT])
+        p += b'\x00' * (align(len(p), 2) - len(p))
+        p += struct.pack('<h', 1)
+        p += b'\x00' * (align(len(p), 4) - len(p))
+        p += struct.pack('<I', 0)
+        return p
+
+    def acknack(self, stream_id):
+        first_unacked = self.reliable_expected.get(stream_id, 0)
+        return struct.pack('<HBBB', first_unacked, 0, 0, stream_id)
+
+    def handle(self, data, addr):
+        self.packets += 1
+        self.bytes += len(data)
+        if len(data) < 4:
+            return
+        (session_id, stream_id, seq) = struct.unpack('<BBH', data[:4])
+        ofs = 4
+        key = b''
+        if session_id < SESSION_ID_WITHOUT_CLIENT_KEY:
+            key = data[4:8]
+            ofs = 8
+
+        if stream_id >= 0x80:
+            # reliable stream, only in order messages are accepted by
+            # the client so it will resend anything missing
+            expected = self.reliable_expected.get(stream_id, 0)
+            if seq == expected:
+                self.reliable_expected[stream_id] = (seq + 1) & 0xFFFF
+
+        reply = self.header(session_id, key)
+        nreply = 0
+        while ofs + 4 <= len(data):
+            (sub_id, flags, length) = struct.unpack('<BBH', data[ofs:ofs+4])
+            payload = data[ofs+4:ofs+4+length]
+            ofs = align(ofs + 4 + length, 4)
+            if sub_id == CREATE_CLIENT:
+                reply = self.submessage(reply, STATUS_AGENT, b'\x00\x00' + self.agent_representation())
+                nreply += 1
+                self.reliable_expected = {}
+            elif sub_id in (CREATE, DELETE):
+                # echo the request id and object id with STATUS_OK
+                reply = self.submessage(reply, STATUS, payload[:4] + b'\x00\x00')
+                nreply += 1
+            elif sub_id == GET_INFO:
+                reply = self.submessage(reply, INFO, self.info_payload(payload[:4]))
+                nreply += 1
+            elif sub_id == HEARTBEAT:
+                reply = self.submessage(reply, ACKNACK, self.acknack(payload[4]))
+                nreply += 1
+            elif sub_id == WRITE_DATA:
+                (obj_id,) = struct.unpack('>H', payload[2:4])
+                if obj_id & 0x0F == OBJK_DATAWRITER:
+                    w = self.writers.setdefault(obj_id >> 4, [0, 0])
+                    w[0] += 1
+                    w[1] += length - 4
+
+        if stream_id >= 0x80:
+            reply = self.submessage(reply, ACKNACK, self.acknack(stream_id))
+            nreply += 1
+        if nreply > 0:
+            self.sock.sendto(reply, addr)
+
+    def report(self, dt):
+        print("%.1f packets/s %.0f bytes/s" % (self.packets / dt, self.bytes / dt))
+        for dw in sorted(self.writers.keys()):
+            (n, nbytes) = self.writers[dw]
+            print("  datawriter %3u: %7.1f samples/s %8.0f bytes/s" % (dw, n / dt, nbytes / dt))
+        self.writers = {}
+        self.packets = 0
+        self.bytes = 0
+
+    def run(self, interval):
+        last_report = time.time()
+        while True:
+            try:
+                (data, addr) = self.sock.recvfrom(65536)
+                self.handle(data, addr)
+            except socket.timeout:
+                pass
+            now = time.time()
+            if now - last_report >= interval:
+                self.report(now - last_report)
+                last_report = now
+
+
+def main():
+    parser = argparse.ArgumentParser(description='XRCE agent stand-in for DDS throughput tests')
+    parser.add_argument('--port', type=int, default=2019, help='UDP port to listen on')
+    parser.add_argument('--interval', type=float, default=5.0, help='report interval in seconds')
+    args = parser.parse_args()
+    Sink(args.port).run(args.interval)
+
+
+if __name__ == '__main__':
+    main()
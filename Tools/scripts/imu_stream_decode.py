@@ -0,0 +1,91 @@
+#!/usr/bin/env python3
+
+'''
+decode a raw IMU stream capture (IMUSTRMnnn.BIN) written when INS_RSTR_MASK is set
+
+see libraries/AP_InertialSensor/AP_InertialSensor_RawStream.h for the file format
+
+AP_FLAKE8_CLEAN
+'''
+
+import argparse
+import struct
+import sys
+
+MAGIC = 0x53524d49
+HEADER_FMT = "<IHHQ"
+RECORD_FMT = "<IBBHfff"
+
+TYPE_ACCEL = 0
+TYPE_GYRO = 1
+TYPE_DROPPED = 2
+
+
+def decode(filename, csv_out, instance_filter=None):
+    '''decode a capture, writing CSV lines and returning per-sensor sample counts'''
+    counts = {}
+    dropped = 0
+    with open(filename, 'rb') as f:
+        hdr = f.read(struct.calcsize(HEADER_FMT))
+        if len(hdr) != struct.calcsize(HEADER_FMT):
+            raise ValueError("short file")
+        (magic, version, record_size, start_us) = struct.unpack(HEADER_FMT, hdr)
+        if magic != MAGIC:
+            raise ValueError("bad magic 0x%08x" % magic)
+        if version != 1 or record_size != struct.calcsize(RECORD_FMT):
+            raise ValueError("unsupported version %u record_size %u" % (version, record_size))
+
+        if csv_out is not None:
+            csv_out.write("time_us,instance,type,x,y,z\n")
+
+        # timestamps in the file are 32 bit, unwrap them to 64 bit
+        last_us = start_us
+        while True:
+            rec = f.read(record_size)
+            if len(rec) < record_size:
+                break
+            (time_us, instance, rtype, _, x, y, z) = struct.unpack(RECORD_FMT, rec)
+            t = (last_us & ~0xFFFFFFFF) | time_us
+            if t + 0x80000000 < last_us:
+                t += 0x100000000
+            last_us = t
+            if rtype == TYPE_DROPPED:
+                dropped += int(x)
+                continue
+            if instance_filter is not None and instance != instance_filter:
+                continue
+            key = (instance, rtype)
+            counts[key] = counts.get(key, [0, t, t])
+            counts[key][0] += 1
+            counts[key][2] = t
+            if csv_out is not None:
+                csv_out.write("%u,%u,%s,%f,%f,%f\n" % (t, instance, "ACC" if rtype == TYPE_ACCEL else "GYR", x, y, z))
+    return counts, dropped
+
+
+def main():
+    parser = argparse.ArgumentParser(description='decode a raw IMU stream capture from ArduPilot')
+    parser.add_argument('--csv', default=None, help='write samples to this CSV file')
+    parser.add_argument('--instance', type=int, default=None, help='only decode this IMU instance')
+    parser.add_argument('file', help='capture file')
+    args = parser.parse_args()
+
+    csv_out = open(args.csv, 'w') if args.csv is not None else None
+    try:
+        counts, dropped = decode(args.file, csv_out, args.instance)
+    except ValueError as e:
+        print("%s: %s" % (args.file, e))
+        sys.exit(1)
+    finally:
+        if csv_out is not None:
+            csv_out.close()
+
+    for (instance, rtype) in sorted(counts.keys()):
+        (n, t0, t1) = counts[(instance, rtype)]
+        rate = (n - 1) * 1.0e6 / (t1 - t0) if t1 > t0 else 0
+        print("IMU%u %s: %u samples %.1fHz" % (instance, "ACC" if rtype == TYPE_ACCEL else "GYR", n, rate))
+    print("dropped: %u" % dropped)
+
+
+if __name__ == '__main__':
+    main()
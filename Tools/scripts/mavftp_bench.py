@@ -0,0 +1,242 @@
+#!/usr/bin/env python3
+
+'''
+download files from an autopilot with MAVFTP burst reads, using one
+session per file with all the sessions running at once, and report
+the throughput of each session. For example, with SITL and a UDP
+server on NET_P1:
+
+  mavftp_bench.py --master udpout:127.0.0.1:16002 @PARAM/param.pck logs/00000001.BIN
+
+the same file may be given more than once to get concurrent downloads
+of it
+'''
+
+import struct
+import sys
+import time
+
+from pymavlink import mavutil
+
+# opcodes
+OP_TerminateSession = 1
+OP_ResetSessions = 2
+OP_OpenFileRO = 4
+OP_ReadFile = 5
+OP_BurstReadFile = 15
+OP_Ack = 128
+OP_Nack = 129
+
+# errors
+ERR_EndOfFile = 6
+
+HDR_LEN = 12
+MAX_DATA = 239
+
+
+class Download(object):
+    '''state of one file download'''
+    def __init__(self, client, session, path, read_size):
+        self.client = client
+        self.session = session
+        self.path = path
+        self.read_size = read_size
+        self.seq = 0
+        self.size = None
+        self.blocks = {}
+        self.eof_offset = None
+        self.state = 'open'
+        self.last_op = None
+        self.last_send = 0
+        self.start_time = None
+        self.end_time = None
+        self.bytes_received = 0
+        self.duplicates = 0
+        self.gap_reads = 0
+        self.bursts = 0
+        self.error = None
+
+    def send(self, opcode, size=0, offset=0, data=b''):
+        self.seq = (self.seq + 1) % 65536
+        self.last_op = (opcode, size, offset, data)
+        self.last_send = time.time()
+        self.client.send(self.seq, self.session, opcode, size, offset, data)
+
+    def resend(self):
+        '''resend the last request after a timeout, with the same seq'''
+        (opcode, size, offset, data) = self.last_op
+        self.last_send = time.time()
+        self.client.send(self.seq, self.session, opcode, size, offset, data)
+
+    def start(self):
+        name = self.path.encode('utf-8')
+        self.send(OP_OpenFileRO, len(name), 0, name)
+
+    def received_length(self):
+        '''length of data received without gaps from the start'''
+        ofs = 0
+        while ofs in self.blocks:
+            ofs += len(self.blocks[ofs])
+        return ofs
+
+    def next_gap(self):
+        '''offset of the first missing block before the highest block'''
+        if len(self.blocks) == 0:
+            return None
+        end = max(self.blocks.keys())
+        ofs = 0
+        while ofs < end:
+            if ofs not in self.blocks:
+                return ofs
+            ofs += len(self.blocks[ofs])
+        return None
+
+    def continue_read(self):
+        '''fill in gaps, then carry on bursting from the end'''
+        gap = self.next_gap()
+        if gap is not None:
+            self.gap_reads += 1
+            self.send(OP_ReadFile, self.read_size, gap)
+            return
+        end = self.received_length()
+        if self.eof_offset is not None and end >= self.eof_offset:
+            self.finish()
+            return
+        self.bursts += 1
+        self.send(OP_BurstReadFile, self.read_size, end)
+
+    def finish(self, error=None):
+        self.error = error
+        self.end_time = time.time()
+        self.state = 'terminate'
+        self.send(OP_TerminateSession)
+
+    def handle(self, seq, opcode, size, req_opcode, burst_complete, offset, data):
+        if self.state == 'done':
+            return
+        if req_opcode == OP_TerminateSession:
+            self.state = 'done'
+            return
+        if req_opcode == OP_OpenFileRO:
+            if self.state != 'open':
+                return
+            if opcode == OP_Nack:
+                self.error = 'open failed %s' % list(data[:size])
+                self.state = 'done'
+                return
+            self.size, = struct.unpack("<I", data[0:4])
+            self.state = 'read'
+            self.start_time = time.time()
+            self.bursts += 1
+            self.send(OP_BurstReadFile, self.read_size, 0)
+            return
+        if self.state != 'read':
+            return
+        if opcode == OP_Nack:
+            if size > 0 and data[0] == ERR_EndOfFile:
+                if self.eof_offset is None or offset < self.eof_offset:
+                    self.eof_offset = offset
+                self.continue_read()
+            else:
+                self.finish('read failed %s' % list(data[:size]))
+            return
+        if offset in self.blocks:
+            self.duplicates += 1
+        else:
+            self.blocks[offset] = data[:size]
+            self.bytes_received += size
+            if size < self.read_size:
+                self.eof_offset = offset + size
+        if req_opcode == OP_ReadFile or burst_complete:
+            self.continue_read()
+
+    def data(self):
+        return b''.join([self.blocks[k] for k in sorted(self.blocks.keys())])
+
+    def rate(self):
+        if self.start_time is None or self.end_time is None:
+            return 0
+        return self.bytes_received / max(self.end_time - self.start_time, 0.001)
+
+    def report(self):
+        status = self.error if self.error is not None else 'OK'
+        return ("session %u %s: %u bytes in %.2fs %.1f kB/s bursts=%u gap_reads=%u duplicates=%u %s" %
+                (self.session, self.path, self.bytes_received,
+                 (self.end_time or time.time()) - (self.start_time or time.time()),
+                 self.rate() / 1024.0, self.bursts, self.gap_reads, self.duplicates, status))
+
+
+class FTPBench(object):
+    '''concurrent MAVFTP downloads over one connection'''
+    def __init__(self, master, target_system=1, target_component=1):
+        self.master = master
+        self.target_system = target_system
+        self.target_component = target_component
+
+    def send(self, seq, session, opcode, size, offset, data):
+        payload = struct.pack("<HBBBBBBI", seq, session, opcode, size, 0, 0, 0, offset)
+        payload += data + bytes(MAX_DATA - len(data))
+        self.master.mav.file_transfer_protocol_send(0, self.target_system, self.target_component, payload)
+
+    def download(self, paths, read_size=MAX_DATA, timeout=120, first_session=1, progress=print):
+        '''download files at once, returning a list of Download objects'''
+        downloads = []
+        for i in range(len(paths)):
+            downloads.append(Download(self, (first_session + i) % 256, paths[i], read_size))
+        for d in downloads:
+            d.start()
+        tstart = time.time()
+        while time.time() - tstart < timeout:
+            if all([d.state == 'done' for d in downloads]):
+                break
+            m = self.master.recv_match(type='FILE_TRANSFER_PROTOCOL', blocking=True, timeout=0.1)
+            now = time.time()
+            if m is not None:
+                payload = bytes(m.payload)
+                (seq, session, opcode, size, req_opcode, burst_complete, pad, offset) = struct.unpack(
+                    "<HBBBBBBI", payload[:HDR_LEN])
+                for d in downloads:
+                    if d.session == session:
+                        d.handle(seq, opcode, size, req_opcode, burst_complete, offset, payload[HDR_LEN:])
+            for d in downloads:
+                if d.state != 'done' and now - d.last_send > 1.0:
+                    # lost request or reply
+                    if d.state == 'read':
+                        d.continue_read()
+                    else:
+                        d.resend()
+        for d in downloads:
+            if d.state != 'done':
+                d.error = 'timed out'
+                if d.end_time is None:
+                    d.end_time = time.time()
+            progress(d.report())
+        return downloads
+
+
+if __name__ == '__main__':
+    from argparse import ArgumentParser
+    parser = ArgumentParser(description=__doc__)
+    parser.add_argument("--master", default="udpout:127.0.0.1:16002", help="MAVLink connection")
+    parser.add_argument("--read-size", type=int, default=MAX_DATA, help="bytes read per packet")
+    parser.add_argument("--timeout", type=float, default=120, help="timeout in seconds")
+    parser.add_argument("--out", default=None, help="directory to save downloaded files in")
+    parser.add_argument("path", nargs='+', help="files to download")
+    args = parser.parse_args()
+
+    master = mavutil.mavlink_connection(args.master, source_system=250)
+    master.mav.heartbeat_send(mavutil.mavlink.MAV_TYPE_GCS, mavutil.mavlink.MAV_AUTOPILOT_INVALID, 0, 0, 0)
+    master.wait_heartbeat()
+    bench = FTPBench(master, master.target_system, master.target_component)
+    tstart = time.time()
+    downloads = bench.download(args.path, read_size=args.read_size, timeout=args.timeout)
+    elapsed = time.time() - tstart
+    total = sum([d.bytes_received for d in downloads])
+    print("total %u bytes in %.2fs %.1f kB/s" % (total, elapsed, total / max(elapsed, 0.001) / 1024.0))
+    if args.out is not None:
+        import os
+        for d in downloads:
+            fname = os.path.join(args.out, "%u-%s" % (d.session, os.path.basename(d.path)))
+            open(fname, 'wb').write(d.data())
+    if any([d.error is not None for d in downloads]):
+        sys.exit(1)
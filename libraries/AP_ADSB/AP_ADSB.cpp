@@ -77,7 +77,7 @@ const AP_Param::GroupInfo AP_ADSB::var_info[] = {
     // @Param: LIST_MAX
     // @DisplayName: ADSB vehicle list size
     // @Description: ADSB list size of nearest vehicles. Longer lists take longer to refresh with lower SRx_ADSB values.
-    // @Range: 1 100
+    // @Range: 1 500
     // @User: Advanced
     // @RebootRequired: True
     AP_GROUPINFO("LIST_MAX",   2, AP_ADSB, in_state.list_size_param, ADSB_VEHICLE_LIST_SIZE_DEFAULT),
@@ -206,6 +206,11 @@ void AP_ADSB::init(void)
 
         in_state.vehicle_list = NEW_NOTHROW adsb_vehicle_t[in_state.list_size_param];
 
+        if (in_state.vehicle_list != nullptr && !in_state.icao_index.init(in_state.list_size_param)) {
+            delete[] in_state.vehicle_list;
+            in_state.vehicle_list = nullptr;
+        }
+
         if (in_state.vehicle_list == nullptr) {
             // dynamic RAM allocation of in_state.vehicle_list[] failed
             _init_failed = true; // this keeps us from constantly trying to init forever in main update
@@ -492,8 +497,10 @@ void AP_ADSB::delete_vehicle(const uint16_t index)
         in_state.furthest_vehicle_distance = 0;
         in_state.furthest_vehicle_index = 0;
     }
+    in_state.icao_index.remove(in_state.vehicle_list[index].info.ICAO_address);
     if (index != (in_state.vehicle_count-1)) {
         in_state.vehicle_list[index] = in_state.vehicle_list[in_state.vehicle_count-1];
+        in_state.icao_index.set(in_state.vehicle_list[index].info.ICAO_address, index);
     }
     // TODO: is memset needed? When we decrement the index we essentially forget about it
     memset(&in_state.vehicle_list[in_state.vehicle_count-1], 0, sizeof(adsb_vehicle_t));
@@ -507,13 +514,7 @@ void AP_ADSB::delete_vehicle(const uint16_t index)
  */
 bool AP_ADSB::find_index(const adsb_vehicle_t &vehicle, uint16_t *index) const
 {
-    for (uint16_t i = 0; i < in_state.vehicle_count; i++) {
-        if (in_state.vehicle_list[i].info.ICAO_address == vehicle.info.ICAO_address) {
-            *index = i;
-            return true;
-        }
-    }
-    return false;
+    return in_state.icao_index.find(vehicle.info.ICAO_address, *index);
 }
 
 /*
@@ -610,7 +611,13 @@ void AP_ADSB::set_vehicle(const uint16_t index, const adsb_vehicle_t &vehicle)
         // out of range
         return;
     }
+    if (index < in_state.vehicle_count &&
+        in_state.vehicle_list[index].info.ICAO_address != vehicle.info.ICAO_address) {
+        // replacing a different vehicle
+        in_state.icao_index.remove(in_state.vehicle_list[index].info.ICAO_address);
+    }
     in_state.vehicle_list[index] = vehicle;
+    in_state.icao_index.set(vehicle.info.ICAO_address, index);
 
 #if HAL_LOGGING_ENABLED
     write_log(vehicle);
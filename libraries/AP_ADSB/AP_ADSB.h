@@ -29,6 +29,7 @@
 #include <AP_Common/Location.h>
 #include <GCS_MAVLink/GCS_MAVLink.h>
 #include <AP_GPS/AP_GPS_FixType.h>
+#include "AP_ADSB_ICAO_Index.h"
 
 #define ADSB_MAX_INSTANCES             1   // Maximum number of ADSB sensor instances available on this platform
 
@@ -269,6 +270,8 @@ private:
         uint16_t    list_size_allocated;
         adsb_vehicle_t *vehicle_list;
         uint16_t    vehicle_count;
+        // ICAO address to vehicle_list index
+        AP_ADSB_ICAO_Index icao_index;
         AP_Int32    list_radius;
         AP_Int16    list_altitude;
 
@@ -0,0 +1,128 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "AP_ADSB_ICAO_Index.h"
+
+#if HAL_ADSB_ENABLED
+
+#include <string.h>
+
+AP_ADSB_ICAO_Index::~AP_ADSB_ICAO_Index()
+{
+    delete[] _slots;
+}
+
+bool AP_ADSB_ICAO_Index::init(uint16_t max_entries)
+{
+    // at least twice as many slots as entries, and a power of two
+    uint8_t bits = 1;
+    while ((1UL << bits) < 2UL * max_entries && bits < 16) {
+        bits++;
+    }
+    delete[] _slots;
+    _slots = NEW_NOTHROW Slot[1UL << bits];
+    if (_slots == nullptr) {
+        _max_entries = 0;
+        return false;
+    }
+    _bits = bits;
+    _mask = (1UL << bits) - 1;
+    _max_entries = max_entries;
+    clear();
+    return true;
+}
+
+void AP_ADSB_ICAO_Index::clear()
+{
+    if (_slots != nullptr) {
+        memset(_slots, 0, sizeof(Slot) * (_mask + 1UL));
+    }
+    _count = 0;
+}
+
+bool AP_ADSB_ICAO_Index::find(uint32_t icao, uint16_t &index) const
+{
+    if (_slots == nullptr) {
+        return false;
+    }
+    for (uint16_t i = hash(icao); _slots[i].index_plus_one != 0; i = (i + 1) & _mask) {
+        if (_slots[i].icao == icao) {
+            index = _slots[i].index_plus_one - 1;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool AP_ADSB_ICAO_Index::set(uint32_t icao, uint16_t index)
+{
+    if (_slots == nullptr) {
+        return false;
+    }
+    uint16_t i = hash(icao);
+    for (; _slots[i].index_plus_one != 0; i = (i + 1) & _mask) {
+        if (_slots[i].icao == icao) {
+            _slots[i].index_plus_one = index + 1;
+            return true;
+        }
+    }
+    if (_count >= _max_entries) {
+        return false;
+    }
+    _slots[i].icao = icao;
+    _slots[i].index_plus_one = index + 1;
+    _count++;
+    return true;
+}
+
+bool AP_ADSB_ICAO_Index::remove(uint32_t icao)
+{
+    if (_slots == nullptr) {
+        return false;
+    }
+    uint16_t i = hash(icao);
+    while (true) {
+        if (_slots[i].index_plus_one == 0) {
+            return false;
+        }
+        if (_slots[i].icao == icao) {
+            break;
+        }
+        i = (i + 1) & _mask;
+    }
+
+    // backward shift: move later entries of the probe run into the
+    // hole if their home slot is not between the hole and themselves
+    uint16_t hole = i;
+    uint16_t j = i;
+    while (true) {
+        j = (j + 1) & _mask;
+        if (_slots[j].index_plus_one == 0) {
+            break;
+        }
+        const uint16_t home = hash(_slots[j].icao);
+        const uint16_t dist_home = (j - home) & _mask;
+        const uint16_t dist_hole = (j - hole) & _mask;
+        if (dist_home >= dist_hole) {
+            _slots[hole] = _slots[j];
+            hole = j;
+        }
+    }
+    _slots[hole].index_plus_one = 0;
+    _count--;
+    return true;
+}
+
+#endif  // HAL_ADSB_ENABLED
@@ -0,0 +1,73 @@
+#pragma once
+
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/*
+  hash index from ICAO address to position in the ADSB vehicle list
+
+  Open addressing with linear probing. The table is sized to at least
+  twice the number of vehicles so probe sequences stay short, and
+  removal uses backward shift so no tombstones are needed
+ */
+
+#include "AP_ADSB_config.h"
+
+#if HAL_ADSB_ENABLED
+
+#include <AP_Common/AP_Common.h>
+
+class AP_ADSB_ICAO_Index {
+public:
+    AP_ADSB_ICAO_Index() {}
+    ~AP_ADSB_ICAO_Index();
+
+    CLASS_NO_COPY(AP_ADSB_ICAO_Index);
+
+    // allocate a table for up to max_entries addresses
+    bool init(uint16_t max_entries);
+
+    // find the list index of an address
+    bool find(uint32_t icao, uint16_t &index) const;
+
+    // add an address or change the list index of an existing one
+    bool set(uint32_t icao, uint16_t index);
+
+    // remove an address, returns false if it was not present
+    bool remove(uint32_t icao);
+
+    void clear();
+
+    uint16_t count() const { return _count; }
+
+private:
+    struct Slot {
+        uint32_t icao;
+        // list index plus one, zero for an empty slot
+        uint16_t index_plus_one;
+    };
+
+    uint16_t hash(uint32_t icao) const {
+        // multiplicative hash, ICAO addresses are 24 bits
+        return (uint16_t)((icao * 2654435761U) >> (32 - _bits)) & _mask;
+    }
+
+    Slot *_slots = nullptr;
+    uint16_t _mask = 0;
+    uint8_t _bits = 1;
+    uint16_t _count = 0;
+    uint16_t _max_entries = 0;
+};
+
+#endif  // HAL_ADSB_ENABLED
@@ -0,0 +1,93 @@
+#include <AP_gtest.h>
+
+#include <AP_ADSB/AP_ADSB_ICAO_Index.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+TEST(ADSBICAOIndex, SetFindRemove)
+{
+    AP_ADSB_ICAO_Index index;
+    ASSERT_TRUE(index.init(25));
+
+    uint16_t i;
+    EXPECT_FALSE(index.find(0xABCDEF, i));
+    EXPECT_TRUE(index.set(0xABCDEF, 3));
+    EXPECT_TRUE(index.find(0xABCDEF, i));
+    EXPECT_EQ(i, 3);
+
+    // updating an existing address does not add an entry
+    EXPECT_TRUE(index.set(0xABCDEF, 7));
+    EXPECT_EQ(index.count(), 1);
+    EXPECT_TRUE(index.find(0xABCDEF, i));
+    EXPECT_EQ(i, 7);
+
+    EXPECT_TRUE(index.remove(0xABCDEF));
+    EXPECT_FALSE(index.remove(0xABCDEF));
+    EXPECT_FALSE(index.find(0xABCDEF, i));
+    EXPECT_EQ(index.count(), 0);
+}
+
+TEST(ADSBICAOIndex, Full)
+{
+    AP_ADSB_ICAO_Index index;
+    ASSERT_TRUE(index.init(10));
+    for (uint16_t n = 0; n < 10; n++) {
+        EXPECT_TRUE(index.set(1000 + n, n));
+    }
+    EXPECT_FALSE(index.set(2000, 0));
+    // existing addresses can still be moved when full
+    EXPECT_TRUE(index.set(1000, 9));
+    EXPECT_EQ(index.count(), 10);
+}
+
+/*
+  mirror the way AP_ADSB uses the index, with removal by swapping the
+  last list entry into the hole, and check every lookup against a
+  linear search of the list
+ */
+TEST(ADSBICAOIndex, ListChurn)
+{
+    const uint16_t list_size = 300;
+    AP_ADSB_ICAO_Index index;
+    ASSERT_TRUE(index.init(list_size));
+
+    uint32_t list[list_size];
+    uint16_t count = 0;
+    uint32_t seed = 1;
+
+    for (uint32_t step = 0; step < 20000; step++) {
+        seed = seed * 1103515245U + 12345U;
+        // a small address space so there are plenty of repeats and
+        // hash collisions
+        const uint32_t icao = (seed >> 8) % 2000;
+        uint16_t found;
+        const bool in_index = index.find(icao, found);
+        int32_t linear = -1;
+        for (uint16_t n = 0; n < count; n++) {
+            if (list[n] == icao) {
+                linear = n;
+                break;
+            }
+        }
+        ASSERT_EQ(in_index, linear >= 0);
+        if (in_index) {
+            ASSERT_EQ(found, linear);
+            if ((seed & 3) == 0) {
+                // delete, moving the last entry down
+                ASSERT_TRUE(index.remove(icao));
+                count--;
+                if (found != count) {
+                    list[found] = list[count];
+                    ASSERT_TRUE(index.set(list[found], found));
+                }
+            }
+        } else if (count < list_size) {
+            list[count] = icao;
+            ASSERT_TRUE(index.set(icao, count));
+            count++;
+        }
+        ASSERT_EQ(index.count(), count);
+    }
+}
+
+AP_GTEST_MAIN()
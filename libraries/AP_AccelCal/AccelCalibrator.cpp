@@ -345,24 +345,32 @@ void AccelCalibrator::run_fit(uint8_t max_iterations, float& fitness)
 
             calc_jacob(sample, fit_param.s, jacob);
 
+            const float residual = calc_residual(sample, fit_param.s);
             for(uint8_t i = 0; i < get_num_params(); i++) {
                 // compute JTJ
                 for(uint8_t j = 0; j < get_num_params(); j++) {
                     JTJ[i*get_num_params()+j] += jacob[i] * jacob[j];
                 }
                 // compute JTFI
-                JTFI[i] += jacob[i] * calc_residual(sample, fit_param.s);
+                JTFI[i] += jacob[i] * residual;
             }
         }
 
-        if (!mat_inverse(JTJ, JTJ, get_num_params())) {
+        // solve JTJ * step = JTFI with the fixed size kernel for the
+        // fit type rather than inverting JTJ
+        float step[ACCEL_CAL_MAX_NUM_PARAMS];
+        bool solved;
+        if (get_num_params() == 9) {
+            solved = mat_ldlt_solve<float,9>(JTJ, &JTFI[0], step);
+        } else {
+            solved = mat_ldlt_solve<float,6>(JTJ, &JTFI[0], step);
+        }
+        if (!solved) {
             return;
         }
 
         for(uint8_t row=0; row < get_num_params(); row++) {
-            for(uint8_t col=0; col < get_num_params(); col++) {
-                fit_param.a[row] -= JTFI[col] * JTJ[row*get_num_params()+col];
-            }
+            fit_param.a[row] -= step[row];
         }
 
         fitness = calc_mean_squared_residuals(fit_param.s);
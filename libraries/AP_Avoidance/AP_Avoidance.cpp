@@ -148,6 +148,11 @@ void AP_Avoidance::init(void)
     if (_obstacles == nullptr) {
         _obstacles = NEW_NOTHROW AP_Avoidance::Obstacle[_obstacles_max];
 
+        if (_obstacles != nullptr && !alloc_batch(_obstacles_max)) {
+            delete [] _obstacles;
+            _obstacles = nullptr;
+        }
+
         if (_obstacles == nullptr) {
             // dynamic RAM allocation of _obstacles[] failed, disable gracefully
             DEV_PRINTF("Unable to initialize Avoidance obstacle list\n");
@@ -172,6 +177,7 @@ void AP_Avoidance::deinit(void)
     if (_obstacles != nullptr) {
         delete [] _obstacles;
         _obstacles = nullptr;
+        free_batch();
         _obstacles_allocated = 0;
         handle_recovery(RecoveryAction::RTL);
     }
@@ -334,57 +340,169 @@ float closest_approach_z(const Location &my_loc,
     return ret*0.01f;
 }
 
-void AP_Avoidance::update_threat_level(const Location &my_loc,
-                                       const Vector3f &my_vel,
-                                       AP_Avoidance::Obstacle &obstacle)
+/*
+  allocate the structure of arrays used by update_threat_levels()
+ */
+bool AP_Avoidance::alloc_batch(uint8_t count)
 {
+    float *buf = NEW_NOTHROW float[THREAT_BATCH_FLOATS * count];
+    uint32_t *age_ms = NEW_NOTHROW uint32_t[count];
+    if (buf == nullptr || age_ms == nullptr) {
+        delete [] buf;
+        delete [] age_ms;
+        return false;
+    }
+    _batch.pos_n = &buf[0];
+    _batch.pos_e = &buf[count];
+    _batch.alt_cm = &buf[2*count];
+    _batch.vel_n = &buf[3*count];
+    _batch.vel_e = &buf[4*count];
+    _batch.vel_d = &buf[5*count];
+    _batch.age_ms = age_ms;
+    return true;
+}
 
-    Location &obstacle_loc = obstacle._location;
-    Vector3f &obstacle_vel = obstacle._velocity;
+void AP_Avoidance::free_batch()
+{
+    // pos_n is the start of the float allocation
+    delete [] _batch.pos_n;
+    delete [] _batch.age_ms;
+    _batch = {};
+}
 
-    obstacle.threat_level = MAV_COLLISION_THREAT_LEVEL_NONE;
+/*
+  fill the batch with each obstacle relative to us. This is the only
+  place Location maths is done per obstacle
+ */
+void AP_Avoidance::gather_batch(const Location &my_loc, const Vector3f &my_vel)
+{
+    const uint32_t now_ms = AP_HAL::millis();
+    for (uint8_t i=0; i<_obstacle_count; i++) {
+        const AP_Avoidance::Obstacle &obstacle = _obstacles[i];
+        const Vector2f pos_ne = obstacle._location.get_distance_NE(my_loc);
+        _batch.pos_n[i] = pos_ne.x;
+        _batch.pos_e[i] = pos_ne.y;
+        _batch.alt_cm[i] = obstacle._location.alt - my_loc.alt;
+        _batch.vel_n[i] = obstacle._velocity.x - my_vel.x;
+        _batch.vel_e[i] = obstacle._velocity.y - my_vel.y;
+        _batch.vel_d[i] = obstacle._velocity.z - my_vel.z;
+        _batch.age_ms[i] = now_ms - obstacle.timestamp_ms;
+    }
+}
 
-    const uint32_t obstacle_age = AP_HAL::millis() - obstacle.timestamp_ms;
-    float closest_xy = closest_approach_xy(my_loc, my_vel, obstacle_loc, obstacle_vel, _fail_time_horizon + obstacle_age/1000);
-    if (closest_xy < _fail_distance_xy) {
-        obstacle.threat_level = MAV_COLLISION_THREAT_LEVEL_HIGH;
-    } else {
-        closest_xy = closest_approach_xy(my_loc, my_vel, obstacle_loc, obstacle_vel, _warn_time_horizon + obstacle_age/1000);
-        if (closest_xy < _warn_distance_xy) {
-            obstacle.threat_level = MAV_COLLISION_THREAT_LEVEL_LOW;
+// distance from p to the segment from the origin to w, as
+// Vector2f::closest_distance_between_radial_and_point()
+static inline float closest_distance_radial(const float w_x, const float w_y, const float p_x, const float p_y)
+{
+    float c_x = w_x;
+    float c_y = w_y;
+    const float l2 = sq(w_x, w_y);
+    if (l2 >= FLT_EPSILON) {
+        const float t = (p_x * w_x + p_y * w_y) / l2;
+        if (t <= 0) {
+            c_x = 0;
+            c_y = 0;
+        } else if (t < 1) {
+            c_x = w_x * t;
+            c_y = w_y * t;
         }
     }
+    return norm(c_x - p_x, c_y - p_y);
+}
+
+// as closest_approach_z(), with the altitude difference in cm
+static inline float closest_distance_z(const float alt_cm, const float vel_d, const uint8_t time_horizon)
+{
+    float ret;
+    if (alt_cm >= 0 && vel_d >= 0) {
+        ret = alt_cm;
+    } else if (alt_cm <= 0 && vel_d <= 0) {
+        ret = fabsf(alt_cm);
+    } else {
+        ret = fabsf(alt_cm - vel_d * time_horizon);
+    }
+    return ret * 0.01f;
+}
+
+/*
+  calculate closest approach and threat level of every obstacle from
+  the gathered batch. Threat levels match closest_approach_xy() and
+  closest_approach_z() for each obstacle. Obstacles are rejected early
+  from the fail horizon evaluation if they cannot come within the fail
+  distance inside the fail horizon (their distance less the relative
+  travel is already too large), or if they stay outside the warn
+  altitude band, which means they can't be a threat whatever their
+  horizontal approach. Closest approach for those obstacles is
+  reported over the warn horizon
+ */
+void AP_Avoidance::update_threat_levels()
+{
+    const float fail_distance_xy = _fail_distance_xy;
+    const float warn_distance_xy = _warn_distance_xy;
+    const float fail_distance_z = _fail_distance_z;
+    const float warn_distance_z = _warn_distance_z;
 
-    // check for vertical separation; our threat level is the minimum
-    // of vertical and horizontal threat levels
-    float closest_z = closest_approach_z(my_loc, my_vel, obstacle_loc, obstacle_vel, _warn_time_horizon + obstacle_age/1000);
-    if (obstacle.threat_level != MAV_COLLISION_THREAT_LEVEL_NONE) {
-        if (closest_z > _warn_distance_z) {
-            obstacle.threat_level = MAV_COLLISION_THREAT_LEVEL_NONE;
+    for (uint8_t i=0; i<_obstacle_count; i++) {
+        AP_Avoidance::Obstacle &obstacle = _obstacles[i];
+        const float pos_n = _batch.pos_n[i];
+        const float pos_e = _batch.pos_e[i];
+        const float vel_n = _batch.vel_n[i];
+        const float vel_e = _batch.vel_e[i];
+        const uint32_t age_ms = _batch.age_ms[i];
+        const uint8_t fail_horizon = _fail_time_horizon + age_ms/1000;
+        const uint8_t warn_horizon = _warn_time_horizon + age_ms/1000;
+
+        const float distance = norm(pos_n, pos_e);
+        const float rel_speed = norm(vel_n, vel_e);
+
+        // check for vertical separation first; our threat level is the
+        // minimum of vertical and horizontal threat levels
+        const float alt_cm = _batch.alt_cm[i];
+        const float vel_d = _batch.vel_d[i];
+        float closest_z = closest_distance_z(alt_cm, vel_d, warn_horizon);
+        const bool in_alt_band = closest_z <= warn_distance_z;
+
+        MAV_COLLISION_THREAT_LEVEL threat_level = MAV_COLLISION_THREAT_LEVEL_NONE;
+        float closest_xy = 0;
+        bool fail_xy = false;
+        if (in_alt_band && distance - rel_speed * fail_horizon < fail_distance_xy) {
+            closest_xy = closest_distance_radial(vel_n * fail_horizon, vel_e * fail_horizon, pos_n, pos_e);
+            fail_xy = closest_xy < fail_distance_xy;
+        }
+        if (fail_xy) {
+            threat_level = MAV_COLLISION_THREAT_LEVEL_HIGH;
         } else {
-            closest_z = closest_approach_z(my_loc, my_vel, obstacle_loc, obstacle_vel, _fail_time_horizon + obstacle_age/1000);
-            if (closest_z > _fail_distance_z) {
-                obstacle.threat_level = MAV_COLLISION_THREAT_LEVEL_LOW;
+            closest_xy = closest_distance_radial(vel_n * warn_horizon, vel_e * warn_horizon, pos_n, pos_e);
+            if (closest_xy < warn_distance_xy) {
+                threat_level = MAV_COLLISION_THREAT_LEVEL_LOW;
             }
         }
-    }
 
-    // If we haven't heard from a vehicle then assume it is no threat
-    if (obstacle_age > MAX_OBSTACLE_AGE_MS) {
-        obstacle.threat_level = MAV_COLLISION_THREAT_LEVEL_NONE;
-    }
+        if (threat_level != MAV_COLLISION_THREAT_LEVEL_NONE) {
+            if (!in_alt_band) {
+                threat_level = MAV_COLLISION_THREAT_LEVEL_NONE;
+            } else {
+                closest_z = closest_distance_z(alt_cm, vel_d, fail_horizon);
+                if (closest_z > fail_distance_z) {
+                    threat_level = MAV_COLLISION_THREAT_LEVEL_LOW;
+                }
+            }
+        }
 
-    // could optimise this to not calculate a lot of this if threat
-    // level is none - but only *once the GCS has been informed*!
-    obstacle.closest_approach_xy = closest_xy;
-    obstacle.closest_approach_z = closest_z;
-    float current_distance = my_loc.get_distance(obstacle_loc);
-    obstacle.distance_to_closest_approach = current_distance - closest_xy;
-    Vector2f net_velocity_ne = Vector2f(my_vel[0] - obstacle_vel[0], my_vel[1] - obstacle_vel[1]);
-    obstacle.time_to_closest_approach = 0.0f;
-    if (!is_zero(obstacle.distance_to_closest_approach) &&
-        ! is_zero(net_velocity_ne.length())) {
-        obstacle.time_to_closest_approach = obstacle.distance_to_closest_approach / net_velocity_ne.length();
+        // If we haven't heard from a vehicle then assume it is no threat
+        if (age_ms > MAX_OBSTACLE_AGE_MS) {
+            threat_level = MAV_COLLISION_THREAT_LEVEL_NONE;
+        }
+
+        obstacle.threat_level = threat_level;
+        obstacle.closest_approach_xy = closest_xy;
+        obstacle.closest_approach_z = closest_z;
+        obstacle.distance_to_closest_approach = distance - closest_xy;
+        obstacle.time_to_closest_approach = 0.0f;
+        if (!is_zero(obstacle.distance_to_closest_approach) &&
+            !is_zero(rel_speed)) {
+            obstacle.time_to_closest_approach = obstacle.distance_to_closest_approach / rel_speed;
+        }
     }
 }
 
@@ -477,15 +595,16 @@ void AP_Avoidance::check_for_threats()
 
     // we always check all obstacles to see if they are threats since it
     // is most likely our own position and/or velocity have changed
+    gather_batch(my_loc, my_vel);
+    update_threat_levels();
+
     // determine the current most-serious-threat
     _current_most_serious_threat = -1;
     for (uint8_t i=0; i<_obstacle_count; i++) {
 
         AP_Avoidance::Obstacle &obstacle = _obstacles[i];
-        const uint32_t obstacle_age = AP_HAL::millis() - obstacle.timestamp_ms;
+        const uint32_t obstacle_age = _batch.age_ms[i];
         debug("i=%d src_id=%d timestamp=%u age=%d", i, obstacle.src_id, obstacle.timestamp_ms, obstacle_age);
-
-        update_threat_level(my_loc, my_vel, obstacle);
         debug("   threat-level=%d", obstacle.threat_level);
 
         // ignore any really old data:
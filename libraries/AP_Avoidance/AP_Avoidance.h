@@ -173,9 +173,24 @@ private:
     uint32_t src_id_for_adsb_vehicle(const AP_ADSB::adsb_vehicle_t &vehicle) const;
 
     void check_for_threats();
-    void update_threat_level(const Location &my_loc,
-                             const Vector3f &my_vel,
-                             AP_Avoidance::Obstacle &obstacle);
+
+    // obstacle state relative to us, gathered once per update in
+    // structure of arrays form so the closest approach maths for all
+    // obstacles runs as one loop over contiguous arrays
+    struct ThreatBatch {
+        float *pos_n;       // our position relative to the obstacle, metres
+        float *pos_e;
+        float *alt_cm;      // obstacle altitude above ours, cm
+        float *vel_n;       // obstacle velocity relative to ours, m/s NED
+        float *vel_e;
+        float *vel_d;
+        uint32_t *age_ms;
+    } _batch;
+    static constexpr uint8_t THREAT_BATCH_FLOATS = 6;
+    bool alloc_batch(uint8_t count);
+    void free_batch();
+    void gather_batch(const Location &my_loc, const Vector3f &my_vel);
+    void update_threat_levels();
 
     // calls into the AP_ADSB library to retrieve vehicle data
     void get_adsb_samples();
@@ -0,0 +1,172 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/*
+  table of CAN frame ID/mask filters for the consumers of frames on a
+  bus, so each received frame is only passed to the consumers which
+  want it. The same table gives the hardware acceptance filters for
+  the bus.
+
+  A frame matches a filter if (frame.id & mask) == (id & mask), with
+  the id including the AP_HAL::CANFrame flags, so masking FlagEFF
+  selects 11 or 29 bit frames. A consumer with no filters takes all
+  frames.
+
+  Filters may be added while match() is called from another thread.
+  An entry is written before num_filters is increased with release
+  ordering to publish it
+ */
+#pragma once
+
+#include <AP_HAL/AP_HAL.h>
+#include <atomic>
+
+template <uint8_t MAX_FILTERS>
+class CANDispatchTable {
+public:
+    static const uint8_t max_consumers = 16;
+    typedef uint16_t ConsumerMask;
+
+    // add a consumer, which takes all frames until it has a filter
+    bool add_consumer(uint8_t consumer) {
+        if (consumer >= max_consumers) {
+            return false;
+        }
+        registered |= ConsumerMask(1U << consumer);
+        accept_all.fetch_or(ConsumerMask(1U << consumer), std::memory_order_release);
+        return true;
+    }
+
+    // add a filter for a consumer, returning false if the table is full
+    bool add_filter(uint8_t consumer, uint32_t id, uint32_t mask) {
+        if (consumer >= max_consumers || (registered & (1U << consumer)) == 0) {
+            return false;
+        }
+        id &= mask;
+        const ConsumerMask bit = 1U << consumer;
+        const uint8_t n = num_filters.load(std::memory_order_relaxed);
+        // consumers with the same filter share an entry
+        for (uint8_t i=0; i<n; i++) {
+            if (filters[i].id == id && filters[i].mask == mask) {
+                filters[i].consumers.fetch_or(bit, std::memory_order_release);
+                accept_all.fetch_and(ConsumerMask(~bit), std::memory_order_release);
+                return true;
+            }
+        }
+        if (n >= MAX_FILTERS) {
+            return false;
+        }
+        filters[n].id = id;
+        filters[n].mask = mask;
+        filters[n].consumers.store(bit, std::memory_order_relaxed);
+        num_filters.store(n+1, std::memory_order_release);
+        accept_all.fetch_and(ConsumerMask(~bit), std::memory_order_release);
+        return true;
+    }
+
+    /*
+      remove all consumers and filters. match() may still be running
+      on another thread with the old entries, so the caller must not
+      free anything a consumer uses until that call has returned
+     */
+    void clear(void) {
+        num_filters.store(0, std::memory_order_release);
+        accept_all.store(0, std::memory_order_release);
+        for (auto &f : filters) {
+            f.consumers.store(0, std::memory_order_relaxed);
+        }
+        registered = 0;
+    }
+
+    // return the consumers a frame should be passed to
+    ConsumerMask match(uint32_t frame_id) const {
+        ConsumerMask ret = accept_all.load(std::memory_order_acquire);
+        const uint8_t n = num_filters.load(std::memory_order_acquire);
+        for (uint8_t i=0; i<n; i++) {
+            const Filter &f = filters[i];
+            const ConsumerMask consumers = f.consumers.load(std::memory_order_acquire);
+            if ((ret & consumers) != consumers &&
+                (frame_id & f.mask) == f.id) {
+                ret |= consumers;
+            }
+        }
+        return ret;
+    }
+
+    // true if any consumer has a filter
+    bool filtered(void) const {
+        return num_filters.load(std::memory_order_acquire) != 0 &&
+            accept_all.load(std::memory_order_acquire) == 0;
+    }
+
+    /*
+      fill in hardware acceptance filters equivalent to the table.
+      Returns false if some consumer takes all frames, or if there are
+      more filters than max_configs, in which case the hardware should
+      accept everything
+     */
+    bool get_hw_filters(AP_HAL::CANIface::CanFilterConfig *configs, uint16_t max_configs, uint16_t &num_configs) const {
+        if (!filtered()) {
+            return false;
+        }
+        // bits of a 29 bit ID which are always zero in an 11 bit ID
+        const uint32_t ext_only = AP_HAL::CANFrame::MaskExtID & ~AP_HAL::CANFrame::MaskStdID;
+        const uint8_t n = num_filters.load(std::memory_order_acquire);
+        uint16_t count = 0;
+        for (uint8_t i=0; i<n; i++) {
+            const Filter &f = filters[i];
+            if ((f.mask & AP_HAL::CANFrame::FlagEFF) != 0) {
+                if (count >= max_configs) {
+                    return false;
+                }
+                configs[count].id = f.id;
+                configs[count].mask = f.mask;
+                count++;
+                continue;
+            }
+            /*
+              a mask without FlagEFF matches both 11 and 29 bit
+              frames. Hardware filters select one or the other, so it
+              needs one of each
+             */
+            if (count >= max_configs) {
+                return false;
+            }
+            configs[count].id = f.id | AP_HAL::CANFrame::FlagEFF;
+            configs[count].mask = f.mask | AP_HAL::CANFrame::FlagEFF;
+            count++;
+            if ((f.id & ext_only) == 0) {
+                // 11 bit frames can match
+                if (count >= max_configs) {
+                    return false;
+                }
+                configs[count].id = f.id;
+                configs[count].mask = (f.mask & ~ext_only) | AP_HAL::CANFrame::FlagEFF;
+                count++;
+            }
+        }
+        num_configs = count;
+        return true;
+    }
+
+private:
+    struct Filter {
+        uint32_t id;
+        uint32_t mask;
+        std::atomic<ConsumerMask> consumers;
+    } filters[MAX_FILTERS];
+    std::atomic<uint8_t> num_filters{0};
+    std::atomic<ConsumerMask> accept_all{0};
+    ConsumerMask registered{0};
+};
@@ -22,6 +22,7 @@
 #include <AP_Scheduler/AP_Scheduler.h>
 #include "AP_CANSensor.h"
 #include <AP_BoardConfig/AP_BoardConfig.h>
+#include <AP_Logger/AP_Logger.h>
 
 extern const AP_HAL::HAL& hal;
 
@@ -34,7 +35,14 @@ extern const AP_HAL::HAL& hal;
 CANSensor::CANSensor(const char *driver_name, uint16_t stack_size) :
     _driver_name(driver_name),
     _stack_size(stack_size)
-{}
+{
+    // with no filters all frames are passed to handle_frame()
+    _rx_filters.add_consumer(0);
+}
+
+#ifndef CANSENSOR_AUX_RX_QUEUE_LEN
+#define CANSENSOR_AUX_RX_QUEUE_LEN 32
+#endif
 
 
 void CANSensor::register_driver(AP_CAN::Protocol dtype)
@@ -44,6 +52,15 @@ void CANSensor::register_driver(AP_CAN::Protocol dtype)
         if (AP::can().register_11bit_driver(dtype, this, _driver_index)) {
             is_aux_11bit_driver = true;
             _can_driver = AP::can().get_driver(_driver_index);
+            // frames are queued by the main driver and handled on our
+            // own thread. Without a queue or thread they are handled
+            // directly on the main driver's thread
+            _aux_rx_queue = NEW_NOTHROW ObjectBuffer<AP_HAL::CANFrame>(CANSENSOR_AUX_RX_QUEUE_LEN);
+            if (_aux_rx_queue != nullptr &&
+                !hal.scheduler->thread_create(FUNCTOR_BIND_MEMBER(&CANSensor::loop, void), _driver_name, _stack_size, AP_HAL::Scheduler::PRIORITY_CAN, 0)) {
+                delete _aux_rx_queue;
+                _aux_rx_queue = nullptr;
+            }
             _initialized = true;
         } else {
             debug_can(AP_CANManager::LOG_ERROR, "Failed to register CANSensor %s", _driver_name);
@@ -157,6 +174,104 @@ bool CANSensor::write_frame(AP_HAL::CANFrame &out_frame, const uint32_t timeout_
     return (_can_iface->send(out_frame, deadline, AP_HAL::CANIface::AbortOnError) == 1);
 }
 
+// add a filter for the frames passed to handle_frame()
+bool CANSensor::add_rx_filter(uint32_t id, uint32_t mask)
+{
+    if (!_rx_filters.add_filter(0, id, mask)) {
+        debug_can(AP_CANManager::LOG_ERROR, "too many filters");
+        return false;
+    }
+    hw_filters_changed();
+    return true;
+}
+
+// called on the main driver's thread
+void CANSensor::receive_frame(const AP_HAL::CANFrame &frame)
+{
+    if (_aux_rx_queue == nullptr) {
+        AP_HAL::CANFrame copy = frame;
+        dispatch_frame(copy);
+        return;
+    }
+    _rx_stats.received++;
+    if (_rx_filters.match(frame.id) == 0) {
+        // don't wake our thread for frames we will discard
+        _rx_stats.filtered++;
+        return;
+    }
+    if (!_aux_rx_queue->push(frame)) {
+        _rx_stats.dropped++;
+        return;
+    }
+    sem_handle.signal();
+}
+
+void CANSensor::dispatch_frame(AP_HAL::CANFrame &frame)
+{
+    _rx_stats.received++;
+    if (_rx_filters.match(frame.id) == 0) {
+        _rx_stats.filtered++;
+        return;
+    }
+    handle_frame(frame);
+}
+
+void CANSensor::update_hw_filters(void)
+{
+    _hw_filters_pending = false;
+    if (is_aux_11bit_driver || _can_iface == nullptr ||
+        _can_iface->get_operating_mode() != AP_HAL::CANIface::FilteredMode) {
+        // filters on the interface of a main driver are its own
+        // business, and only FilteredMode interfaces support filters
+        return;
+    }
+    const uint16_t max_configs = MIN(_can_iface->getNumFilters(), 16U);
+    AP_HAL::CANIface::CanFilterConfig configs[16];
+    uint16_t num_configs = 0;
+    if (!get_hw_filters(configs, max_configs, num_configs)) {
+        // accept all frames
+        num_configs = 1;
+        configs[0].id = 0;
+        configs[0].mask = 0;
+    }
+    // configureFilters() returns false if the backend didn't program
+    // the filters, as on flight controllers
+    _hw_filters_active = _can_iface->configureFilters(configs, num_configs) && configs[0].mask != 0;
+}
+
+#if HAL_LOGGING_ENABLED
+void CANSensor::log_rx_stats(void)
+{
+    const uint32_t now_ms = AP_HAL::millis();
+    if (now_ms - _last_log_ms < 1000) {
+        return;
+    }
+    _last_log_ms = now_ms;
+
+// @LoggerMessage: CANR
+// @Description: CAN sensor driver receive statistics
+// @Field: TimeUS: Time since system startup
+// @Field: Drv: driver index
+// @Field: Name: driver name
+// @Field: Rx: frames received
+// @Field: Flt: frames discarded by the driver receive filters
+// @Field: Drop: frames dropped as a receive queue was full
+// @Field: HW: 1 if hardware acceptance filters are in use
+    AP::logger().WriteStreaming("CANR",
+                                "TimeUS,Drv,Name,Rx,Flt,Drop,HW",
+                                "s#-----",
+                                "F------",
+                                "QBNIIIB",
+                                AP_HAL::micros64(),
+                                _driver_index,
+                                _driver_name,
+                                _rx_stats.received,
+                                _rx_stats.filtered,
+                                _rx_stats.dropped,
+                                uint8_t(_hw_filters_active));
+}
+#endif
+
 void CANSensor::loop()
 {
     while (!hal.scheduler->is_system_initialized()) {
@@ -171,6 +286,24 @@ void CANSensor::loop()
 #endif
 
     while (true) {
+#if HAL_LOGGING_ENABLED
+        log_rx_stats();
+#endif
+
+        if (_aux_rx_queue != nullptr) {
+            // handle frames queued by the main driver
+            AP_HAL::CANFrame frame;
+            while (_aux_rx_queue->pop(frame)) {
+                handle_frame(frame);
+            }
+            sem_handle.wait(LOOP_INTERVAL_US);
+            continue;
+        }
+
+        if (_hw_filters_pending) {
+            update_hw_filters();
+        }
+
         uint64_t deadline_us = AP_HAL::micros64() + LOOP_INTERVAL_US;
 
         // wait to receive frame
@@ -185,7 +318,7 @@ void CANSensor::loop()
             int16_t res = _can_iface->receive(frame, time, flags);
 
             if (res == 1) {
-                handle_frame(frame);
+                dispatch_frame(frame);
             }
         }
     }
@@ -20,6 +20,8 @@
 
 #include "AP_CAN.h"
 #include "AP_CANDriver.h"
+#include "AP_CANDispatch.h"
+#include <AP_HAL/utility/RingBuffer.h>
 #ifndef HAL_BUILD_AP_PERIPH
 #include "AP_CANManager.h"
 #endif
@@ -45,6 +47,11 @@ public:
     // handler for outgoing frames
     bool write_frame(AP_HAL::CANFrame &out_frame, const uint32_t timeout_us);
 
+    // frame from the driver we are an auxiliary 11 bit driver of. It
+    // is queued for our own thread so the driver is not held up by
+    // our handle_frame()
+    void receive_frame(const AP_HAL::CANFrame &frame);
+
 #ifdef HAL_BUILD_AP_PERIPH
     static void set_periph(const uint8_t i, const AP_CAN::Protocol protocol, AP_HAL::CANIface* iface) {
         if (i < ARRAY_SIZE(_periph)) {
@@ -68,9 +75,49 @@ public:
 protected:
     void register_driver(AP_CAN::Protocol dtype);
 
+    // only pass frames to handle_frame() which match one of the
+    // filters. The filters are also used as hardware acceptance
+    // filters when the interface is in FilteredMode
+    bool add_rx_filter(uint32_t id, uint32_t mask);
+
+    // hardware filters for the interface, returning false to accept all frames
+    virtual bool get_hw_filters(AP_HAL::CANIface::CanFilterConfig *configs, uint16_t max_configs, uint16_t &num_configs) const {
+        return _rx_filters.get_hw_filters(configs, max_configs, num_configs);
+    }
+
+    // re-program hardware filters from get_hw_filters() on the next loop
+    void hw_filters_changed(void) { _hw_filters_pending = true; }
+
+    // count a frame a consumer had no room for
+    void count_rx_drop(void) { _rx_stats.dropped++; }
+
 private:
     void loop();
 
+    // pass a received frame to handle_frame() if it matches our filters
+    void dispatch_frame(AP_HAL::CANFrame &frame);
+
+    // program hardware acceptance filters, if supported
+    void update_hw_filters(void);
+
+#if HAL_LOGGING_ENABLED
+    void log_rx_stats(void);
+    uint32_t _last_log_ms;
+#endif
+
+    CANDispatchTable<4> _rx_filters;
+    bool _hw_filters_pending;
+    bool _hw_filters_active;
+
+    // frames from the main driver when we are an auxiliary driver
+    ObjectBuffer<AP_HAL::CANFrame> *_aux_rx_queue;
+
+    struct {
+        uint32_t received;
+        uint32_t filtered;
+        uint32_t dropped;
+    } _rx_stats;
+
     const char *const _driver_name;
     const uint16_t _stack_size;
     bool _initialized;
@@ -0,0 +1,132 @@
+#include <AP_gtest.h>
+
+#include <AP_CANManager/AP_CANDispatch.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+static const uint32_t EFF = AP_HAL::CANFrame::FlagEFF;
+
+TEST(CANDispatchTable, AcceptAll)
+{
+    CANDispatchTable<4> table;
+    EXPECT_EQ(table.match(0x123), 0U);
+    EXPECT_TRUE(table.add_consumer(0));
+    EXPECT_EQ(table.match(0x123), 1U);
+    EXPECT_EQ(table.match(EFF | 0x1234567), 1U);
+    EXPECT_FALSE(table.filtered());
+
+    // no hardware filters while a consumer takes everything
+    AP_HAL::CANIface::CanFilterConfig configs[4];
+    uint16_t n;
+    EXPECT_FALSE(table.get_hw_filters(configs, ARRAY_SIZE(configs), n));
+
+    // filters for unknown consumers are refused
+    EXPECT_FALSE(table.add_filter(1, 0x100, 0x700));
+    EXPECT_FALSE(table.add_consumer(CANDispatchTable<4>::max_consumers));
+}
+
+TEST(CANDispatchTable, Match)
+{
+    CANDispatchTable<4> table;
+    ASSERT_TRUE(table.add_consumer(0));
+    ASSERT_TRUE(table.add_consumer(3));
+
+    // 11 bit frames 0x100 to 0x1FF for consumer 0
+    ASSERT_TRUE(table.add_filter(0, 0x100, EFF | 0x700));
+    EXPECT_EQ(table.match(0x123), (1U<<0) | (1U<<3));
+    ASSERT_TRUE(table.add_filter(3, EFF | 0x00000500, EFF | 0x0000FF00));
+
+    EXPECT_EQ(table.match(0x123), 1U<<0);
+    EXPECT_EQ(table.match(0x223), 0U);
+    // an extended frame with the same low bits doesn't match the 11 bit filter
+    EXPECT_EQ(table.match(EFF | 0x123), 0U);
+    EXPECT_EQ(table.match(EFF | 0x12345678), 0U);
+    EXPECT_EQ(table.match(EFF | 0x12340512), 1U<<3);
+
+    // the same filter for two consumers shares an entry
+    ASSERT_TRUE(table.add_filter(3, 0x1FF, EFF | 0x700));
+    EXPECT_EQ(table.match(0x150), (1U<<0) | (1U<<3));
+
+    ASSERT_TRUE(table.add_filter(0, 0x7FF, EFF | 0x7FF));
+    ASSERT_TRUE(table.add_filter(0, 0x7FE, EFF | 0x7FF));
+    EXPECT_FALSE(table.add_filter(0, 0x7FD, EFF | 0x7FF));
+    EXPECT_EQ(table.match(0x7FE), 1U<<0);
+}
+
+TEST(CANDispatchTable, HardwareFilters)
+{
+    CANDispatchTable<4> table;
+    ASSERT_TRUE(table.add_consumer(0));
+    ASSERT_TRUE(table.add_consumer(1));
+    ASSERT_TRUE(table.add_filter(0, EFF | 0x1234, EFF | 0xFFFF));
+    ASSERT_TRUE(table.add_filter(1, 0x10, EFF | 0x7F0));
+    EXPECT_TRUE(table.filtered());
+
+    AP_HAL::CANIface::CanFilterConfig configs[2];
+    uint16_t n = 0;
+    ASSERT_TRUE(table.get_hw_filters(configs, ARRAY_SIZE(configs), n));
+    EXPECT_EQ(n, 2U);
+    EXPECT_EQ(configs[0].id, EFF | 0x1234);
+    EXPECT_EQ(configs[1].mask, EFF | 0x7F0);
+
+    // too many filters for the hardware
+    ASSERT_TRUE(table.add_filter(1, 0x20, EFF | 0x7F0));
+    EXPECT_FALSE(table.get_hw_filters(configs, ARRAY_SIZE(configs), n));
+}
+
+TEST(CANDispatchTable, HardwareFiltersBothFormats)
+{
+    CANDispatchTable<4> table;
+    ASSERT_TRUE(table.add_consumer(0));
+    // without FlagEFF in the mask both 11 and 29 bit frames match
+    ASSERT_TRUE(table.add_filter(0, 0x123, 0x7FF));
+    EXPECT_EQ(table.match(0x123), 1U);
+    EXPECT_EQ(table.match(EFF | 0x1000123), 1U);
+
+    AP_HAL::CANIface::CanFilterConfig configs[4];
+    uint16_t n = 0;
+    ASSERT_TRUE(table.get_hw_filters(configs, ARRAY_SIZE(configs), n));
+    ASSERT_EQ(n, 2U);
+    EXPECT_EQ(configs[0].id, EFF | 0x123);
+    EXPECT_EQ(configs[0].mask, EFF | 0x7FF);
+    EXPECT_EQ(configs[1].id, 0x123U);
+    EXPECT_EQ(configs[1].mask, EFF | 0x7FF);
+
+    // an ID only a 29 bit frame can have needs no 11 bit filter
+    ASSERT_TRUE(table.add_filter(0, 0x12345, 0xFFFFF));
+    ASSERT_TRUE(table.get_hw_filters(configs, ARRAY_SIZE(configs), n));
+    ASSERT_EQ(n, 3U);
+    EXPECT_EQ(configs[2].id, EFF | 0x12345);
+    EXPECT_EQ(configs[2].mask, EFF | 0xFFFFF);
+
+    // both formats count against the hardware filters
+    EXPECT_FALSE(table.get_hw_filters(configs, 2, n));
+}
+
+TEST(CANDispatchTable, Clear)
+{
+    // consumers are re-added after a clear, as when scripting
+    // restarts, without using up the table
+    CANDispatchTable<4> table;
+    for (uint8_t i=0; i<3*CANDispatchTable<4>::max_consumers; i++) {
+        table.clear();
+        EXPECT_EQ(table.match(0x123), 0U);
+        EXPECT_FALSE(table.filtered());
+        // refused for consumers removed by the clear
+        EXPECT_FALSE(table.add_filter(0, 0x100, EFF | 0x700));
+
+        ASSERT_TRUE(table.add_consumer(0));
+        ASSERT_TRUE(table.add_consumer(1));
+        ASSERT_TRUE(table.add_filter(0, 0x100 + i, EFF | 0x7FF));
+        ASSERT_TRUE(table.add_filter(0, 0x200 + i, EFF | 0x7FF));
+        ASSERT_TRUE(table.add_filter(1, 0x300 + i, EFF | 0x7FF));
+        ASSERT_TRUE(table.add_filter(1, 0x400 + i, EFF | 0x7FF));
+        EXPECT_EQ(table.match(0x100 + i), 1U<<0);
+        EXPECT_EQ(table.match(0x400 + i), 1U<<1);
+        // filters from before the clear are gone
+        EXPECT_EQ(table.match(0x100 + i - 1), 0U);
+        EXPECT_TRUE(table.filtered());
+    }
+}
+
+AP_GTEST_MAIN()
@@ -644,7 +644,6 @@ void CompassCalibrator::run_sphere_fit()
     fit1_params = fit2_params = _params;
 
     float JTJ[COMPASS_CAL_NUM_SPHERE_PARAMS*COMPASS_CAL_NUM_SPHERE_PARAMS] = { };
-    float JTJ2[COMPASS_CAL_NUM_SPHERE_PARAMS*COMPASS_CAL_NUM_SPHERE_PARAMS] = { };
     float JTFI[COMPASS_CAL_NUM_SPHERE_PARAMS] = { };
 
     // Gauss Newton Part common for all kind of extensions including LM
@@ -655,38 +654,41 @@ void CompassCalibrator::run_sphere_fit()
 
         calc_sphere_jacob(sample, fit1_params, sphere_jacob);
 
+        // compute JTJ
+        mat_sym_rank1_update<float,COMPASS_CAL_NUM_SPHERE_PARAMS>(JTJ, sphere_jacob, 1.0f);
+
+        // compute JTFI
+        const float residual = calc_residual(sample, fit1_params);
         for (uint8_t i = 0;i < COMPASS_CAL_NUM_SPHERE_PARAMS; i++) {
-            // compute JTJ
-            for (uint8_t j = 0; j < COMPASS_CAL_NUM_SPHERE_PARAMS; j++) {
-                JTJ[i*COMPASS_CAL_NUM_SPHERE_PARAMS+j] += sphere_jacob[i] * sphere_jacob[j];
-                JTJ2[i*COMPASS_CAL_NUM_SPHERE_PARAMS+j] += sphere_jacob[i] * sphere_jacob[j];   //a backup JTJ for LM
-            }
-            // compute JTFI
-            JTFI[i] += sphere_jacob[i] * calc_residual(sample, fit1_params);
+            JTFI[i] += sphere_jacob[i] * residual;
         }
     }
 
     //------------------------Levenberg-Marquardt-part-starts-here---------------------------------//
     // refer: http://en.wikipedia.org/wiki/Levenberg%E2%80%93Marquardt_algorithm#Choice_of_damping_parameter
+    float JTJ2[COMPASS_CAL_NUM_SPHERE_PARAMS*COMPASS_CAL_NUM_SPHERE_PARAMS];    //a backup JTJ for LM
+    memcpy(JTJ2, JTJ, sizeof(JTJ2));
     for (uint8_t i = 0; i < COMPASS_CAL_NUM_SPHERE_PARAMS; i++) {
         JTJ[i*COMPASS_CAL_NUM_SPHERE_PARAMS+i] += _sphere_lambda;
         JTJ2[i*COMPASS_CAL_NUM_SPHERE_PARAMS+i] += _sphere_lambda/lma_damping;
     }
 
-    if (!mat_inverse(JTJ, JTJ, 4)) {
+    // JTJ is positive definite with the damping added, so solve for
+    // the steps rather than inverting it
+    float step1[COMPASS_CAL_NUM_SPHERE_PARAMS];
+    float step2[COMPASS_CAL_NUM_SPHERE_PARAMS];
+    if (!mat_ldlt_solve<float,COMPASS_CAL_NUM_SPHERE_PARAMS>(JTJ, JTFI, step1)) {
         return;
     }
 
-    if (!mat_inverse(JTJ2, JTJ2, 4)) {
+    if (!mat_ldlt_solve<float,COMPASS_CAL_NUM_SPHERE_PARAMS>(JTJ2, JTFI, step2)) {
         return;
     }
 
     // extract radius, offset, diagonals and offdiagonal parameters
     for (uint8_t row=0; row < COMPASS_CAL_NUM_SPHERE_PARAMS; row++) {
-        for (uint8_t col=0; col < COMPASS_CAL_NUM_SPHERE_PARAMS; col++) {
-            fit1_params.get_sphere_params()[row] -= JTFI[col] * JTJ[row*COMPASS_CAL_NUM_SPHERE_PARAMS+col];
-            fit2_params.get_sphere_params()[row] -= JTFI[col] * JTJ2[row*COMPASS_CAL_NUM_SPHERE_PARAMS+col];
-        }
+        fit1_params.get_sphere_params()[row] -= step1[row];
+        fit2_params.get_sphere_params()[row] -= step2[row];
     }
 
     // calculate fitness of two possible sets of parameters
@@ -760,7 +762,6 @@ void CompassCalibrator::run_ellipsoid_fit()
     fit1_params = fit2_params = _params;
 
     float JTJ[COMPASS_CAL_NUM_ELLIPSOID_PARAMS*COMPASS_CAL_NUM_ELLIPSOID_PARAMS] = { };
-    float JTJ2[COMPASS_CAL_NUM_ELLIPSOID_PARAMS*COMPASS_CAL_NUM_ELLIPSOID_PARAMS] = { };
     float JTFI[COMPASS_CAL_NUM_ELLIPSOID_PARAMS] = { };
 
     // Gauss Newton Part common for all kind of extensions including LM
@@ -771,38 +772,41 @@ void CompassCalibrator::run_ellipsoid_fit()
 
         calc_ellipsoid_jacob(sample, fit1_params, ellipsoid_jacob);
 
+        // compute JTJ
+        mat_sym_rank1_update<float,COMPASS_CAL_NUM_ELLIPSOID_PARAMS>(JTJ, ellipsoid_jacob, 1.0f);
+
+        // compute JTFI
+        const float residual = calc_residual(sample, fit1_params);
         for (uint8_t i = 0;i < COMPASS_CAL_NUM_ELLIPSOID_PARAMS; i++) {
-            // compute JTJ
-            for (uint8_t j = 0; j < COMPASS_CAL_NUM_ELLIPSOID_PARAMS; j++) {
-                JTJ [i*COMPASS_CAL_NUM_ELLIPSOID_PARAMS+j] += ellipsoid_jacob[i] * ellipsoid_jacob[j];
-                JTJ2[i*COMPASS_CAL_NUM_ELLIPSOID_PARAMS+j] += ellipsoid_jacob[i] * ellipsoid_jacob[j];
-            }
-            // compute JTFI
-            JTFI[i] += ellipsoid_jacob[i] * calc_residual(sample, fit1_params);
+            JTFI[i] += ellipsoid_jacob[i] * residual;
         }
     }
 
     //------------------------Levenberg-Marquardt-part-starts-here---------------------------------//
     //refer: http://en.wikipedia.org/wiki/Levenberg%E2%80%93Marquardt_algorithm#Choice_of_damping_parameter
+    float JTJ2[COMPASS_CAL_NUM_ELLIPSOID_PARAMS*COMPASS_CAL_NUM_ELLIPSOID_PARAMS];    //a backup JTJ for LM
+    memcpy(JTJ2, JTJ, sizeof(JTJ2));
     for (uint8_t i = 0; i < COMPASS_CAL_NUM_ELLIPSOID_PARAMS; i++) {
         JTJ[i*COMPASS_CAL_NUM_ELLIPSOID_PARAMS+i] += _ellipsoid_lambda;
         JTJ2[i*COMPASS_CAL_NUM_ELLIPSOID_PARAMS+i] += _ellipsoid_lambda/lma_damping;
     }
 
-    if (!mat_inverse(JTJ, JTJ, 9)) {
+    // JTJ is positive definite with the damping added, so solve for
+    // the steps rather than inverting it
+    float step1[COMPASS_CAL_NUM_ELLIPSOID_PARAMS];
+    float step2[COMPASS_CAL_NUM_ELLIPSOID_PARAMS];
+    if (!mat_ldlt_solve<float,COMPASS_CAL_NUM_ELLIPSOID_PARAMS>(JTJ, JTFI, step1)) {
         return;
     }
 
-    if (!mat_inverse(JTJ2, JTJ2, 9)) {
+    if (!mat_ldlt_solve<float,COMPASS_CAL_NUM_ELLIPSOID_PARAMS>(JTJ2, JTFI, step2)) {
         return;
     }
 
     // extract radius, offset, diagonals and offdiagonal parameters
     for (uint8_t row=0; row < COMPASS_CAL_NUM_ELLIPSOID_PARAMS; row++) {
-        for (uint8_t col=0; col < COMPASS_CAL_NUM_ELLIPSOID_PARAMS; col++) {
-            fit1_params.get_ellipsoid_params()[row] -= JTFI[col] * JTJ[row*COMPASS_CAL_NUM_ELLIPSOID_PARAMS+col];
-            fit2_params.get_ellipsoid_params()[row] -= JTFI[col] * JTJ2[row*COMPASS_CAL_NUM_ELLIPSOID_PARAMS+col];
-        }
+        fit1_params.get_ellipsoid_params()[row] -= step1[row];
+        fit2_params.get_ellipsoid_params()[row] -= step2[row];
     }
 
     // calculate fitness of two possible sets of parameters
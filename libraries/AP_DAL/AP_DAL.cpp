@@ -4,6 +4,7 @@
 #include <AP_Logger/AP_Logger.h>
 #include <AP_AHRS/AP_AHRS.h>
 #include <AP_Vehicle/AP_Vehicle.h>
+#include <AP_Scheduler/AP_Scheduler.h>
 #include <AP_OpticalFlow/AP_OpticalFlow.h>
 #include <AP_WheelEncoder/AP_WheelEncoder.h>
 #include <AP_Vehicle/AP_Vehicle_Type.h>
@@ -340,6 +341,17 @@ bool AP_DAL::ekf_low_time_remaining(EKFType etype, uint8_t core)
     return (_RFRF.core_slow & mask) != 0;
 }
 
+/*
+  report time saved on the main loop by running EKF lanes on other
+  threads. This is only for performance monitoring and is not replayed
+*/
+void AP_DAL::ekf_parallel_time_saved(uint32_t time_us)
+{
+#if !APM_BUILD_TYPE(APM_BUILD_AP_DAL_Standalone) && !APM_BUILD_TYPE(APM_BUILD_Replay) && AP_SCHEDULER_ENABLED
+    AP::scheduler().perf_info.add_parallel_time_saved(time_us);
+#endif
+}
+
 // log optical flow data
 void AP_DAL::writeOptFlowMeas(const uint8_t rawFlowQuality, const Vector2f &rawFlowRates, const Vector2f &rawGyroRates, const uint32_t msecFlowMeas, const Vector3f &posOffset, float heightOverride)
 {
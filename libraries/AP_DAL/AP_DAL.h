@@ -106,6 +106,9 @@ public:
 
     // check if we are low on CPU for this core
     bool ekf_low_time_remaining(EKFType etype, uint8_t core);
+
+    // report main loop time saved by running EKF lanes on other threads
+    void ekf_parallel_time_saved(uint32_t time_us);
     
     // returns armed state for the current frame
     bool get_armed() const { return _RFRN.armed; }
@@ -50,45 +50,14 @@
 
 #define STRCPY(D,S) strncpy(D, S, ARRAY_SIZE(D))
 
+// default rate in Hz for a topic published every delay_ms, at least 1Hz
+#define AP_DDS_RATE_HZ(delay_ms) ((delay_ms) < 1000 ? 1000 / (delay_ms) : 1)
+
 // Enable DDS at runtime by default
 static constexpr uint8_t ENABLED_BY_DEFAULT = 1;
-#if AP_DDS_TIME_PUB_ENABLED
-static constexpr uint16_t DELAY_TIME_TOPIC_MS = AP_DDS_DELAY_TIME_TOPIC_MS;
-#endif // AP_DDS_TIME_PUB_ENABLED
-#if AP_DDS_BATTERY_STATE_PUB_ENABLED
-static constexpr uint16_t DELAY_BATTERY_STATE_TOPIC_MS = AP_DDS_DELAY_BATTERY_STATE_TOPIC_MS;
-#endif // AP_DDS_BATTERY_STATE_PUB_ENABLED
-#if AP_DDS_IMU_PUB_ENABLED
-static constexpr uint16_t DELAY_IMU_TOPIC_MS = AP_DDS_DELAY_IMU_TOPIC_MS;
-#endif // AP_DDS_IMU_PUB_ENABLED
-#if AP_DDS_LOCAL_POSE_PUB_ENABLED
-static constexpr uint16_t DELAY_LOCAL_POSE_TOPIC_MS = AP_DDS_DELAY_LOCAL_POSE_TOPIC_MS;
-#endif // AP_DDS_LOCAL_POSE_PUB_ENABLED
-#if AP_DDS_LOCAL_VEL_PUB_ENABLED
-static constexpr uint16_t DELAY_LOCAL_VELOCITY_TOPIC_MS = AP_DDS_DELAY_LOCAL_VELOCITY_TOPIC_MS;
-#endif // AP_DDS_LOCAL_VEL_PUB_ENABLED
-#if AP_DDS_AIRSPEED_PUB_ENABLED
-static constexpr uint16_t DELAY_AIRSPEED_TOPIC_MS = AP_DDS_DELAY_AIRSPEED_TOPIC_MS;
-#endif // AP_DDS_AIRSPEED_PUB_ENABLED
-#if AP_DDS_RC_PUB_ENABLED
-static constexpr uint16_t DELAY_RC_TOPIC_MS = AP_DDS_DELAY_RC_TOPIC_MS;
-#endif // AP_DDS_RC_PUB_ENABLED
-#if AP_DDS_GEOPOSE_PUB_ENABLED
-static constexpr uint16_t DELAY_GEO_POSE_TOPIC_MS = AP_DDS_DELAY_GEO_POSE_TOPIC_MS;
-#endif // AP_DDS_GEOPOSE_PUB_ENABLED
-#if AP_DDS_GOAL_PUB_ENABLED
-static constexpr uint16_t DELAY_GOAL_TOPIC_MS = AP_DDS_DELAY_GOAL_TOPIC_MS ;
-#endif // AP_DDS_GOAL_PUB_ENABLED
-#if AP_DDS_CLOCK_PUB_ENABLED
-static constexpr uint16_t DELAY_CLOCK_TOPIC_MS =AP_DDS_DELAY_CLOCK_TOPIC_MS;
-#endif // AP_DDS_CLOCK_PUB_ENABLED
-#if AP_DDS_GPS_GLOBAL_ORIGIN_PUB_ENABLED
-static constexpr uint16_t DELAY_GPS_GLOBAL_ORIGIN_TOPIC_MS = AP_DDS_DELAY_GPS_GLOBAL_ORIGIN_TOPIC_MS;
-#endif // AP_DDS_GPS_GLOBAL_ORIGIN_PUB_ENABLED
 static constexpr uint16_t DELAY_PING_MS = 500;
-#if AP_DDS_STATUS_PUB_ENABLED
-static constexpr uint16_t DELAY_STATUS_TOPIC_MS = AP_DDS_DELAY_STATUS_TOPIC_MS;
-#endif // AP_DDS_STATUS_PUB_ENABLED
+
+AP_DDS_Client *AP_DDS_Client::_singleton;
 
 // Define the subscriber data members, which are static class scope.
 // If these are created on the stack in the subscriber,
@@ -169,6 +138,143 @@ const AP_Param::GroupInfo AP_DDS_Client::var_info[] {
     // @User: Standard
     AP_GROUPINFO("_MAX_RETRY", 6, AP_DDS_Client, ping_max_retry, 10),
 
+#if AP_DDS_TIME_PUB_ENABLED
+    // @Param: _RATE_TIME
+    // @DisplayName: DDS Time rate
+    // @Description: Rate at which the Time topic is published. Set to 0 to disable the topic.
+    // @Units: Hz
+    // @Range: 0 1000
+    // @User: Advanced
+    AP_GROUPINFO("_RATE_TIME", 7, AP_DDS_Client, pub_rate_hz[uint8_t(PubTopic::TIME)], AP_DDS_RATE_HZ(AP_DDS_DELAY_TIME_TOPIC_MS)),
+#endif // AP_DDS_TIME_PUB_ENABLED
+
+#if AP_DDS_NAVSATFIX_PUB_ENABLED
+    // @Param: _RATE_NAVSAT
+    // @DisplayName: DDS NavSatFix rate
+    // @Description: Rate at which the NavSatFix topic is published. Set to 0 to disable the topic. Fixes are only sent when new data is available, this sets how often each GPS is checked. The default checks on every update of the DDS client.
+    // @Units: Hz
+    // @Range: 0 1000
+    // @User: Advanced
+    AP_GROUPINFO("_RATE_NAVSAT", 8, AP_DDS_Client, pub_rate_hz[uint8_t(PubTopic::NAV_SAT_FIX)], 1000),
+#endif // AP_DDS_NAVSATFIX_PUB_ENABLED
+
+#if AP_DDS_BATTERY_STATE_PUB_ENABLED
+    // @Param: _RATE_BATT
+    // @DisplayName: DDS BatteryState rate
+    // @Description: Rate at which the BatteryState topic is published. Set to 0 to disable the topic.
+    // @Units: Hz
+    // @Range: 0 1000
+    // @User: Advanced
+    AP_GROUPINFO("_RATE_BATT", 9, AP_DDS_Client, pub_rate_hz[uint8_t(PubTopic::BATTERY_STATE)], AP_DDS_RATE_HZ(AP_DDS_DELAY_BATTERY_STATE_TOPIC_MS)),
+#endif // AP_DDS_BATTERY_STATE_PUB_ENABLED
+
+#if AP_DDS_IMU_PUB_ENABLED
+    // @Param: _RATE_IMU
+    // @DisplayName: DDS Imu rate
+    // @Description: Rate at which the Imu topic is published. Set to 0 to disable the topic.
+    // @Units: Hz
+    // @Range: 0 1000
+    // @User: Advanced
+    AP_GROUPINFO("_RATE_IMU", 10, AP_DDS_Client, pub_rate_hz[uint8_t(PubTopic::IMU)], AP_DDS_RATE_HZ(AP_DDS_DELAY_IMU_TOPIC_MS)),
+#endif // AP_DDS_IMU_PUB_ENABLED
+
+#if AP_DDS_LOCAL_POSE_PUB_ENABLED
+    // @Param: _RATE_POSE
+    // @DisplayName: DDS local PoseStamped rate
+    // @Description: Rate at which the local PoseStamped topic is published. Set to 0 to disable the topic.
+    // @Units: Hz
+    // @Range: 0 1000
+    // @User: Advanced
+    AP_GROUPINFO("_RATE_POSE", 11, AP_DDS_Client, pub_rate_hz[uint8_t(PubTopic::LOCAL_POSE)], AP_DDS_RATE_HZ(AP_DDS_DELAY_LOCAL_POSE_TOPIC_MS)),
+#endif // AP_DDS_LOCAL_POSE_PUB_ENABLED
+
+#if AP_DDS_LOCAL_VEL_PUB_ENABLED
+    // @Param: _RATE_TWIST
+    // @DisplayName: DDS local TwistStamped rate
+    // @Description: Rate at which the local TwistStamped topic is published. Set to 0 to disable the topic.
+    // @Units: Hz
+    // @Range: 0 1000
+    // @User: Advanced
+    AP_GROUPINFO("_RATE_TWIST", 12, AP_DDS_Client, pub_rate_hz[uint8_t(PubTopic::LOCAL_VELOCITY)], AP_DDS_RATE_HZ(AP_DDS_DELAY_LOCAL_VELOCITY_TOPIC_MS)),
+#endif // AP_DDS_LOCAL_VEL_PUB_ENABLED
+
+#if AP_DDS_AIRSPEED_PUB_ENABLED
+    // @Param: _RATE_ASPD
+    // @DisplayName: DDS Airspeed rate
+    // @Description: Rate at which the Airspeed topic is published. Set to 0 to disable the topic. Messages are only sent when the data is available or has changed, this sets how often it is checked.
+    // @Units: Hz
+    // @Range: 0 1000
+    // @User: Advanced
+    AP_GROUPINFO("_RATE_ASPD", 13, AP_DDS_Client, pub_rate_hz[uint8_t(PubTopic::AIRSPEED)], AP_DDS_RATE_HZ(AP_DDS_DELAY_AIRSPEED_TOPIC_MS)),
+#endif // AP_DDS_AIRSPEED_PUB_ENABLED
+
+#if AP_DDS_RC_PUB_ENABLED
+    // @Param: _RATE_RC
+    // @DisplayName: DDS Rc rate
+    // @Description: Rate at which the Rc topic is published. Set to 0 to disable the topic. Messages are only sent when the data is available or has changed, this sets how often it is checked.
+    // @Units: Hz
+    // @Range: 0 1000
+    // @User: Advanced
+    AP_GROUPINFO("_RATE_RC", 14, AP_DDS_Client, pub_rate_hz[uint8_t(PubTopic::RC)], AP_DDS_RATE_HZ(AP_DDS_DELAY_RC_TOPIC_MS)),
+#endif // AP_DDS_RC_PUB_ENABLED
+
+#if AP_DDS_GEOPOSE_PUB_ENABLED
+    // @Param: _RATE_GEOPOSE
+    // @DisplayName: DDS GeoPoseStamped rate
+    // @Description: Rate at which the GeoPoseStamped topic is published. Set to 0 to disable the topic.
+    // @Units: Hz
+    // @Range: 0 1000
+    // @User: Advanced
+    AP_GROUPINFO("_RATE_GEOPOSE", 15, AP_DDS_Client, pub_rate_hz[uint8_t(PubTopic::GEOPOSE)], AP_DDS_RATE_HZ(AP_DDS_DELAY_GEO_POSE_TOPIC_MS)),
+#endif // AP_DDS_GEOPOSE_PUB_ENABLED
+
+#if AP_DDS_CLOCK_PUB_ENABLED
+    // @Param: _RATE_CLOCK
+    // @DisplayName: DDS Clock rate
+    // @Description: Rate at which the Clock topic is published. Set to 0 to disable the topic.
+    // @Units: Hz
+    // @Range: 0 1000
+    // @User: Advanced
+    AP_GROUPINFO("_RATE_CLOCK", 16, AP_DDS_Client, pub_rate_hz[uint8_t(PubTopic::CLOCK)], AP_DDS_RATE_HZ(AP_DDS_DELAY_CLOCK_TOPIC_MS)),
+#endif // AP_DDS_CLOCK_PUB_ENABLED
+
+#if AP_DDS_GPS_GLOBAL_ORIGIN_PUB_ENABLED
+    // @Param: _RATE_ORIGIN
+    // @DisplayName: DDS GPS global origin rate
+    // @Description: Rate at which the GPS global origin topic is published. Set to 0 to disable the topic.
+    // @Units: Hz
+    // @Range: 0 1000
+    // @User: Advanced
+    AP_GROUPINFO("_RATE_ORIGIN", 17, AP_DDS_Client, pub_rate_hz[uint8_t(PubTopic::GPS_GLOBAL_ORIGIN)], AP_DDS_RATE_HZ(AP_DDS_DELAY_GPS_GLOBAL_ORIGIN_TOPIC_MS)),
+#endif // AP_DDS_GPS_GLOBAL_ORIGIN_PUB_ENABLED
+
+#if AP_DDS_GOAL_PUB_ENABLED
+    // @Param: _RATE_GOAL
+    // @DisplayName: DDS goal rate
+    // @Description: Rate at which the goal topic is published. Set to 0 to disable the topic. Messages are only sent when the data is available or has changed, this sets how often it is checked.
+    // @Units: Hz
+    // @Range: 0 1000
+    // @User: Advanced
+    AP_GROUPINFO("_RATE_GOAL", 18, AP_DDS_Client, pub_rate_hz[uint8_t(PubTopic::GOAL)], AP_DDS_RATE_HZ(AP_DDS_DELAY_GOAL_TOPIC_MS)),
+#endif // AP_DDS_GOAL_PUB_ENABLED
+
+#if AP_DDS_STATUS_PUB_ENABLED
+    // @Param: _RATE_STATUS
+    // @DisplayName: DDS Status rate
+    // @Description: Rate at which the Status topic is published. Set to 0 to disable the topic. Messages are only sent when the data is available or has changed, this sets how often it is checked.
+    // @Units: Hz
+    // @Range: 0 1000
+    // @User: Advanced
+    AP_GROUPINFO("_RATE_STATUS", 19, AP_DDS_Client, pub_rate_hz[uint8_t(PubTopic::STATUS)], AP_DDS_RATE_HZ(AP_DDS_DELAY_STATUS_TOPIC_MS)),
+#endif // AP_DDS_STATUS_PUB_ENABLED
+
+    // @Param: _PUB_BE
+    // @DisplayName: DDS best effort topics
+    // @Description: Topics to send on the XRCE best effort stream. Samples on the best effort stream are batched into MTU sized packets and are not resent if lost, reducing latency and agent round trips for high rate topics. Other topics use the reliable stream.
+    // @Bitmask: 0:Time,1:NavSatFix,2:BatteryState,3:Imu,4:LocalPose,5:LocalTwist,6:Airspeed,7:Rc,8:GeoPose,9:Clock,10:GPSGlobalOrigin,11:Goal,12:Status
+    // @User: Advanced
+    AP_GROUPINFO("_PUB_BE", 20, AP_DDS_Client, pub_best_effort, 0),
+
     AP_GROUPEND
 };
 
@@ -770,6 +876,8 @@ bool AP_DDS_Client::start(void)
         return true;
     }
 
+    _singleton = this;
+
     if (!hal.scheduler->thread_create(FUNCTOR_BIND_MEMBER(&AP_DDS_Client::main_loop, void),
                                       "DDS",
                                       8192, AP_HAL::Scheduler::PRIORITY_IO, 1)) {
@@ -1249,7 +1357,13 @@ void AP_DDS_Client::main_loop(void)
             GCS_SEND_TEXT(MAV_SEVERITY_ERROR, "%s Creation Requests failed", msg_prefix);
             return;
         }
-        connected = true;
+        {
+            WITH_SEMAPHORE(csem);
+            memset(pub_state, 0, sizeof(pub_state));
+            pub_window_start_ms = AP_HAL::millis();
+            flushes = 0;
+            connected = true;
+        }
         GCS_SEND_TEXT(MAV_SEVERITY_INFO, "%s Initialization passed", msg_prefix);
 
 #if AP_DDS_STATIC_TF_PUB_ENABLED
@@ -1343,13 +1457,15 @@ bool AP_DDS_Client::init_session()
     // setup reliable stream buffers
     input_reliable_stream = NEW_NOTHROW uint8_t[DDS_BUFFER_SIZE];
     output_reliable_stream = NEW_NOTHROW uint8_t[DDS_BUFFER_SIZE];
-    if (input_reliable_stream == nullptr || output_reliable_stream == nullptr) {
+    output_best_effort_stream = NEW_NOTHROW uint8_t[DDS_MTU];
+    if (input_reliable_stream == nullptr || output_reliable_stream == nullptr || output_best_effort_stream == nullptr) {
         GCS_SEND_TEXT(MAV_SEVERITY_ERROR, "%s Allocation failed", msg_prefix);
         return false;
     }
 
     reliable_in = uxr_create_input_reliable_stream(&session, input_reliable_stream, DDS_BUFFER_SIZE, DDS_STREAM_HISTORY);
     reliable_out = uxr_create_output_reliable_stream(&session, output_reliable_stream, DDS_BUFFER_SIZE, DDS_STREAM_HISTORY);
+    best_effort_out = uxr_create_output_best_effort_stream(&session, output_best_effort_stream, DDS_MTU);
 
     GCS_SEND_TEXT(MAV_SEVERITY_INFO, "%s Init complete", msg_prefix);
 
@@ -1499,7 +1615,9 @@ void AP_DDS_Client::write_time_topic()
     if (connected) {
         ucdrBuffer ub {};
         const uint32_t topic_size = builtin_interfaces_msg_Time_size_of_topic(&time_topic, 0);
-        uxr_prepare_output_stream(&session, reliable_out, topics[to_underlying(TopicIndex::TIME_PUB)].dw_id, &ub, topic_size);
+        if (!prepare_output_stream(to_underlying(TopicIndex::TIME_PUB), ub, topic_size)) {
+            return;
+        }
         const bool success = builtin_interfaces_msg_Time_serialize_topic(&ub, &time_topic);
         if (!success) {
             // TODO sometimes serialization fails on bootup. Determine why.
@@ -1515,7 +1633,9 @@ void AP_DDS_Client::write_nav_sat_fix_topic()
     if (connected) {
         ucdrBuffer ub {};
         const uint32_t topic_size = sensor_msgs_msg_NavSatFix_size_of_topic(&nav_sat_fix_topic, 0);
-        uxr_prepare_output_stream(&session, reliable_out, topics[to_underlying(TopicIndex::NAV_SAT_FIX_PUB)].dw_id, &ub, topic_size);
+        if (!prepare_output_stream(to_underlying(TopicIndex::NAV_SAT_FIX_PUB), ub, topic_size)) {
+            return;
+        }
         const bool success = sensor_msgs_msg_NavSatFix_serialize_topic(&ub, &nav_sat_fix_topic);
         if (!success) {
             // TODO sometimes serialization fails on bootup. Determine why.
@@ -1532,7 +1652,9 @@ void AP_DDS_Client::write_static_transforms()
     if (connected) {
         ucdrBuffer ub {};
         const uint32_t topic_size = tf2_msgs_msg_TFMessage_size_of_topic(&tx_static_transforms_topic, 0);
-        uxr_prepare_output_stream(&session, reliable_out, topics[to_underlying(TopicIndex::STATIC_TRANSFORMS_PUB)].dw_id, &ub, topic_size);
+        if (!prepare_output_stream(to_underlying(TopicIndex::STATIC_TRANSFORMS_PUB), ub, topic_size)) {
+            return;
+        }
         const bool success = tf2_msgs_msg_TFMessage_serialize_topic(&ub, &tx_static_transforms_topic);
         if (!success) {
             // TODO sometimes serialization fails on bootup. Determine why.
@@ -1549,7 +1671,9 @@ void AP_DDS_Client::write_battery_state_topic()
     if (connected) {
         ucdrBuffer ub {};
         const uint32_t topic_size = sensor_msgs_msg_BatteryState_size_of_topic(&battery_state_topic, 0);
-        uxr_prepare_output_stream(&session, reliable_out, topics[to_underlying(TopicIndex::BATTERY_STATE_PUB)].dw_id, &ub, topic_size);
+        if (!prepare_output_stream(to_underlying(TopicIndex::BATTERY_STATE_PUB), ub, topic_size)) {
+            return;
+        }
         const bool success = sensor_msgs_msg_BatteryState_serialize_topic(&ub, &battery_state_topic);
         if (!success) {
             // TODO sometimes serialization fails on bootup. Determine why.
@@ -1566,7 +1690,9 @@ void AP_DDS_Client::write_local_pose_topic()
     if (connected) {
         ucdrBuffer ub {};
         const uint32_t topic_size = geometry_msgs_msg_PoseStamped_size_of_topic(&local_pose_topic, 0);
-        uxr_prepare_output_stream(&session, reliable_out, topics[to_underlying(TopicIndex::LOCAL_POSE_PUB)].dw_id, &ub, topic_size);
+        if (!prepare_output_stream(to_underlying(TopicIndex::LOCAL_POSE_PUB), ub, topic_size)) {
+            return;
+        }
         const bool success = geometry_msgs_msg_PoseStamped_serialize_topic(&ub, &local_pose_topic);
         if (!success) {
             // TODO sometimes serialization fails on bootup. Determine why.
@@ -1583,7 +1709,9 @@ void AP_DDS_Client::write_tx_local_velocity_topic()
     if (connected) {
         ucdrBuffer ub {};
         const uint32_t topic_size = geometry_msgs_msg_TwistStamped_size_of_topic(&tx_local_velocity_topic, 0);
-        uxr_prepare_output_stream(&session, reliable_out, topics[to_underlying(TopicIndex::LOCAL_VELOCITY_PUB)].dw_id, &ub, topic_size);
+        if (!prepare_output_stream(to_underlying(TopicIndex::LOCAL_VELOCITY_PUB), ub, topic_size)) {
+            return;
+        }
         const bool success = geometry_msgs_msg_TwistStamped_serialize_topic(&ub, &tx_local_velocity_topic);
         if (!success) {
             // TODO sometimes serialization fails on bootup. Determine why.
@@ -1599,7 +1727,9 @@ void AP_DDS_Client::write_tx_local_airspeed_topic()
     if (connected) {
         ucdrBuffer ub {};
         const uint32_t topic_size = ardupilot_msgs_msg_Airspeed_size_of_topic(&tx_local_airspeed_topic, 0);
-        uxr_prepare_output_stream(&session, reliable_out, topics[to_underlying(TopicIndex::LOCAL_AIRSPEED_PUB)].dw_id, &ub, topic_size);
+        if (!prepare_output_stream(to_underlying(TopicIndex::LOCAL_AIRSPEED_PUB), ub, topic_size)) {
+            return;
+        }
         const bool success = ardupilot_msgs_msg_Airspeed_serialize_topic(&ub, &tx_local_airspeed_topic);
         if (!success) {
             // TODO sometimes serialization fails on bootup. Determine why.
@@ -1615,7 +1745,9 @@ void AP_DDS_Client::write_tx_local_rc_topic()
     if (connected) {
         ucdrBuffer ub {};
         const uint32_t topic_size = ardupilot_msgs_msg_Rc_size_of_topic(&tx_local_rc_topic, 0);
-        uxr_prepare_output_stream(&session, reliable_out, topics[to_underlying(TopicIndex::LOCAL_RC_PUB)].dw_id, &ub, topic_size);
+        if (!prepare_output_stream(to_underlying(TopicIndex::LOCAL_RC_PUB), ub, topic_size)) {
+            return;
+        }
         const bool success = ardupilot_msgs_msg_Rc_serialize_topic(&ub, &tx_local_rc_topic);
         if (!success) {
             // TODO sometimes serialization fails on bootup. Determine why.
@@ -1631,7 +1763,9 @@ void AP_DDS_Client::write_imu_topic()
     if (connected) {
         ucdrBuffer ub {};
         const uint32_t topic_size = sensor_msgs_msg_Imu_size_of_topic(&imu_topic, 0);
-        uxr_prepare_output_stream(&session, reliable_out, topics[to_underlying(TopicIndex::IMU_PUB)].dw_id, &ub, topic_size);
+        if (!prepare_output_stream(to_underlying(TopicIndex::IMU_PUB), ub, topic_size)) {
+            return;
+        }
         const bool success = sensor_msgs_msg_Imu_serialize_topic(&ub, &imu_topic);
         if (!success) {
             // TODO sometimes serialization fails on bootup. Determine why.
@@ -1648,7 +1782,9 @@ void AP_DDS_Client::write_geo_pose_topic()
     if (connected) {
         ucdrBuffer ub {};
         const uint32_t topic_size = geographic_msgs_msg_GeoPoseStamped_size_of_topic(&geo_pose_topic, 0);
-        uxr_prepare_output_stream(&session, reliable_out, topics[to_underlying(TopicIndex::GEOPOSE_PUB)].dw_id, &ub, topic_size);
+        if (!prepare_output_stream(to_underlying(TopicIndex::GEOPOSE_PUB), ub, topic_size)) {
+            return;
+        }
         const bool success = geographic_msgs_msg_GeoPoseStamped_serialize_topic(&ub, &geo_pose_topic);
         if (!success) {
             // TODO sometimes serialization fails on bootup. Determine why.
@@ -1665,7 +1801,9 @@ void AP_DDS_Client::write_clock_topic()
     if (connected) {
         ucdrBuffer ub {};
         const uint32_t topic_size = rosgraph_msgs_msg_Clock_size_of_topic(&clock_topic, 0);
-        uxr_prepare_output_stream(&session, reliable_out, topics[to_underlying(TopicIndex::CLOCK_PUB)].dw_id, &ub, topic_size);
+        if (!prepare_output_stream(to_underlying(TopicIndex::CLOCK_PUB), ub, topic_size)) {
+            return;
+        }
         const bool success = rosgraph_msgs_msg_Clock_serialize_topic(&ub, &clock_topic);
         if (!success) {
             // TODO sometimes serialization fails on bootup. Determine why.
@@ -1682,7 +1820,9 @@ void AP_DDS_Client::write_gps_global_origin_topic()
     if (connected) {
         ucdrBuffer ub {};
         const uint32_t topic_size = geographic_msgs_msg_GeoPointStamped_size_of_topic(&gps_global_origin_topic, 0);
-        uxr_prepare_output_stream(&session, reliable_out, topics[to_underlying(TopicIndex::GPS_GLOBAL_ORIGIN_PUB)].dw_id, &ub, topic_size);
+        if (!prepare_output_stream(to_underlying(TopicIndex::GPS_GLOBAL_ORIGIN_PUB), ub, topic_size)) {
+            return;
+        }
         const bool success = geographic_msgs_msg_GeoPointStamped_serialize_topic(&ub, &gps_global_origin_topic);
         if (!success) {
             // AP_HAL::panic("FATAL: DDS_Client failed to serialize");
@@ -1698,7 +1838,9 @@ void AP_DDS_Client::write_goal_topic()
     if (connected) {
         ucdrBuffer ub {};
         const uint32_t topic_size = geographic_msgs_msg_GeoPointStamped_size_of_topic(&goal_topic, 0);
-        uxr_prepare_output_stream(&session, reliable_out, topics[to_underlying(TopicIndex::GOAL_PUB)].dw_id, &ub, topic_size);
+        if (!prepare_output_stream(to_underlying(TopicIndex::GOAL_PUB), ub, topic_size)) {
+            return;
+        }
         const bool success = geographic_msgs_msg_GeoPointStamped_serialize_topic(&ub, &goal_topic);
         if (!success) {
             // AP_HAL::panic("FATAL: DDS_Client failed to serialize");
@@ -1714,7 +1856,9 @@ void AP_DDS_Client::write_status_topic()
     if (connected) {
         ucdrBuffer ub {};
         const uint32_t topic_size = ardupilot_msgs_msg_Status_size_of_topic(&status_topic, 0);
-        uxr_prepare_output_stream(&session, reliable_out, topics[to_underlying(TopicIndex::STATUS_PUB)].dw_id, &ub, topic_size);
+        if (!prepare_output_stream(to_underlying(TopicIndex::STATUS_PUB), ub, topic_size)) {
+            return;
+        }
         const bool success = ardupilot_msgs_msg_Status_serialize_topic(&ub, &status_topic);
         if (!success) {
             // TODO sometimes serialization fails on bootup. Determine why.
@@ -1724,114 +1868,116 @@ void AP_DDS_Client::write_status_topic()
 }
 #endif // AP_DDS_STATUS_PUB_ENABLED
 
+/*
+  prepare the output stream for one sample. Samples from publishers
+  in the best effort mask go to the best effort stream, which is sent
+  when full rather than per sample
+ */
+bool AP_DDS_Client::prepare_output_stream(uint8_t topic_index, ucdrBuffer &ub, uint32_t topic_size)
+{
+    const uxrObjectId dw_id = topics[topic_index].dw_id;
+    const bool best_effort = pub_current != nullptr &&
+        (uint32_t(pub_best_effort.get()) & (1U << (pub_current - pub_state))) != 0;
+    const uxrStreamId stream_id = best_effort ? best_effort_out : reliable_out;
+
+    bool ok = uxr_prepare_output_stream(&session, stream_id, dw_id, &ub, topic_size) != UXR_INVALID_REQUEST_ID;
+    if (!ok && best_effort) {
+        // send the samples already batched and try again
+        uxr_flash_output_streams(&session);
+        flushes++;
+        ok = uxr_prepare_output_stream(&session, stream_id, dw_id, &ub, topic_size) != UXR_INVALID_REQUEST_ID;
+    }
+
+    if (pub_current != nullptr) {
+        if (ok) {
+            pub_current->count++;
+            pub_current->window_samples++;
+            pub_current->bytes += topic_size;
+        } else {
+            pub_current->dropped++;
+        }
+    }
+    return ok;
+}
+
 void AP_DDS_Client::update()
 {
     WITH_SEMAPHORE(csem);
-    const auto cur_time_ms = AP_HAL::millis64();
+    const uint64_t now_us = AP_HAL::micros64();
 
-#if AP_DDS_TIME_PUB_ENABLED
-    if (cur_time_ms - last_time_time_ms > DELAY_TIME_TOPIC_MS) {
-        update_topic(time_topic);
-        last_time_time_ms = cur_time_ms;
-        write_time_topic();
-    }
-#endif // AP_DDS_TIME_PUB_ENABLED
-#if AP_DDS_NAVSATFIX_PUB_ENABLED
-    for (uint8_t gps_instance = 0; gps_instance < GPS_MAX_INSTANCES; gps_instance++) {
-        if (update_topic(nav_sat_fix_topic, gps_instance)) {
-            write_nav_sat_fix_topic();
-        }
-    }
-#endif // AP_DDS_NAVSATFIX_PUB_ENABLED
-#if AP_DDS_BATTERY_STATE_PUB_ENABLED
-    if (cur_time_ms - last_battery_state_time_ms > DELAY_BATTERY_STATE_TOPIC_MS) {
-        for (uint8_t battery_instance = 0; battery_instance < AP_BATT_MONITOR_MAX_INSTANCES; battery_instance++) {
-            update_topic(battery_state_topic, battery_instance);
-            if (battery_state_topic.present) {
-                write_battery_state_topic();
-            }
-        }
-        last_battery_state_time_ms = cur_time_ms;
-    }
-#endif // AP_DDS_BATTERY_STATE_PUB_ENABLED
-#if AP_DDS_LOCAL_POSE_PUB_ENABLED
-    if (cur_time_ms - last_local_pose_time_ms > DELAY_LOCAL_POSE_TOPIC_MS) {
-        update_topic(local_pose_topic);
-        last_local_pose_time_ms = cur_time_ms;
-        write_local_pose_topic();
-    }
-#endif // AP_DDS_LOCAL_POSE_PUB_ENABLED
-#if AP_DDS_LOCAL_VEL_PUB_ENABLED
-    if (cur_time_ms - last_local_velocity_time_ms > DELAY_LOCAL_VELOCITY_TOPIC_MS) {
-        update_topic(tx_local_velocity_topic);
-        last_local_velocity_time_ms = cur_time_ms;
-        write_tx_local_velocity_topic();
-    }
-#endif // AP_DDS_LOCAL_VEL_PUB_ENABLED
-#if AP_DDS_AIRSPEED_PUB_ENABLED
-    if (cur_time_ms - last_airspeed_time_ms > DELAY_AIRSPEED_TOPIC_MS) {
-        last_airspeed_time_ms = cur_time_ms;
-        if (update_topic(tx_local_airspeed_topic)) {
-            write_tx_local_airspeed_topic();
+    for (const auto &pub : topics) {
+        if (pub.publish == nullptr) {
+            continue;
         }
-    }
-#endif // AP_DDS_AIRSPEED_PUB_ENABLED
-#if AP_DDS_RC_PUB_ENABLED
-    if (cur_time_ms - last_rc_time_ms > DELAY_RC_TOPIC_MS) {
-        last_rc_time_ms = cur_time_ms;
-        if (update_topic(tx_local_rc_topic)) {
-            write_tx_local_rc_topic();
+        const uint8_t idx = uint8_t(pub.pub_topic);
+        const int16_t rate_hz = pub_rate_hz[idx].get();
+        PubState &state = pub_state[idx];
+        if (rate_hz <= 0 || now_us < state.next_us) {
+            continue;
         }
-    }
-#endif // AP_DDS_RC_PUB_ENABLED
-#if AP_DDS_IMU_PUB_ENABLED
-    if (cur_time_ms - last_imu_time_ms > DELAY_IMU_TOPIC_MS) {
-        update_topic(imu_topic);
-        last_imu_time_ms = cur_time_ms;
-        write_imu_topic();
-    }
-#endif // AP_DDS_IMU_PUB_ENABLED
-#if AP_DDS_GEOPOSE_PUB_ENABLED
-    if (cur_time_ms - last_geo_pose_time_ms > DELAY_GEO_POSE_TOPIC_MS) {
-        update_topic(geo_pose_topic);
-        last_geo_pose_time_ms = cur_time_ms;
-        write_geo_pose_topic();
-    }
-#endif // AP_DDS_GEOPOSE_PUB_ENABLED
-#if AP_DDS_CLOCK_PUB_ENABLED
-    if (cur_time_ms - last_clock_time_ms > DELAY_CLOCK_TOPIC_MS) {
-        update_topic(clock_topic);
-        last_clock_time_ms = cur_time_ms;
-        write_clock_topic();
-    }
-#endif // AP_DDS_CLOCK_PUB_ENABLED
-#if AP_DDS_GPS_GLOBAL_ORIGIN_PUB_ENABLED
-    if (cur_time_ms - last_gps_global_origin_time_ms > DELAY_GPS_GLOBAL_ORIGIN_TOPIC_MS) {
-        update_topic(gps_global_origin_topic);
-        last_gps_global_origin_time_ms = cur_time_ms;
-        write_gps_global_origin_topic();
-    }
-#endif // AP_DDS_GPS_GLOBAL_ORIGIN_PUB_ENABLED
-#if AP_DDS_GOAL_PUB_ENABLED
-    if (cur_time_ms - last_goal_time_ms > DELAY_GOAL_TOPIC_MS) {
-        if (update_topic_goal(goal_topic)) {
-            write_goal_topic();
+        const uint32_t period_us = 1000000UL / MIN(rate_hz, 1000);
+        state.next_us += period_us;
+        if (state.next_us <= now_us) {
+            // late, or first run. Don't try to catch up
+            state.next_us = now_us + period_us;
         }
-        last_goal_time_ms = cur_time_ms;
-    }
-#endif // AP_DDS_GOAL_PUB_ENABLED
-#if AP_DDS_STATUS_PUB_ENABLED
-    if (cur_time_ms - last_status_check_time_ms > DELAY_STATUS_TOPIC_MS) {
-        if (update_topic(status_topic)) {
-            write_status_topic();
+
+        pub_current = &state;
+        const uint32_t start_us = AP_HAL::micros();
+        pub.publish(*this);
+        const uint32_t dt_us = AP_HAL::micros() - start_us;
+        pub_current = nullptr;
+
+        state.window_calls++;
+        state.window_time_us += dt_us;
+        state.window_time_max_us = MAX(state.window_time_max_us, dt_us);
+    }
+
+    // roll the statistics window once a second
+    const uint32_t now_ms = AP_HAL::millis();
+    const uint32_t window_ms = now_ms - pub_window_start_ms;
+    if (window_ms >= 1000) {
+        for (auto &state : pub_state) {
+            state.rate_hz = state.window_samples * 1000.0f / window_ms;
+            state.time_avg_us = state.window_calls > 0 ? MIN(state.window_time_us / state.window_calls, UINT16_MAX) : 0;
+            state.time_max_us = MIN(state.window_time_max_us, UINT16_MAX);
+            state.window_calls = 0;
+            state.window_samples = 0;
+            state.window_time_us = 0;
+            state.window_time_max_us = 0;
         }
-        last_status_check_time_ms = cur_time_ms;
+        pub_window_start_ms = now_ms;
     }
-#endif // AP_DDS_STATUS_PUB_ENABLED
 
     status_ok = uxr_run_session_time(&session, 1);
 }
 
+/*
+  report publisher statistics for @SYS/dds.txt
+ */
+void AP_DDS_Client::pub_info(ExpandingString &str)
+{
+    WITH_SEMAPHORE(csem);
+    str.printf("DDS %s flushes=%u\n", connected ? "connected" : "disconnected", unsigned(flushes));
+    for (const auto &pub : topics) {
+        if (pub.publish == nullptr) {
+            continue;
+        }
+        const uint8_t idx = uint8_t(pub.pub_topic);
+        const PubState &state = pub_state[idx];
+        str.printf("%-20s %s set=%3dHz rate=%6.1fHz avg=%4uus max=%5uus n=%u drop=%u bytes=%u\n",
+                   pub.topic_name,
+                   (uint32_t(pub_best_effort.get()) & (1U << idx)) ? "BE" : "RE",
+                   int(pub_rate_hz[idx].get()),
+                   double(state.rate_hz),
+                   unsigned(state.time_avg_us),
+                   unsigned(state.time_max_us),
+                   unsigned(state.count),
+                   unsigned(state.dropped),
+                   unsigned(state.bytes));
+    }
+}
+
 #if CONFIG_HAL_BOARD == HAL_BOARD_CHIBIOS
 extern "C" {
     int clock_gettime(clockid_t clockid, struct timespec *ts);
@@ -69,6 +69,7 @@
 #include "fcntl.h"
 
 #include <AP_Param/AP_Param.h>
+#include <AP_Common/ExpandingString.h>
 
 #define DDS_MTU             512
 #define DDS_STREAM_HISTORY  8
@@ -95,15 +96,72 @@ private:
     // input and output stream
     uint8_t *input_reliable_stream;
     uint8_t *output_reliable_stream;
+    uint8_t *output_best_effort_stream;
     uxrStreamId reliable_in;
     uxrStreamId reliable_out;
+    uxrStreamId best_effort_out;
+
+    /*
+      scheduled publishers. The values index the DDS_RATE_* parameters
+      and the bits of DDS_PUB_BE so must not change
+     */
+    enum class PubTopic : uint8_t {
+        TIME = 0,
+        NAV_SAT_FIX = 1,
+        BATTERY_STATE = 2,
+        IMU = 3,
+        LOCAL_POSE = 4,
+        LOCAL_VELOCITY = 5,
+        AIRSPEED = 6,
+        RC = 7,
+        GEOPOSE = 8,
+        CLOCK = 9,
+        GPS_GLOBAL_ORIGIN = 10,
+        GOAL = 11,
+        STATUS = 12,
+        COUNT
+    };
+    static constexpr uint8_t NUM_PUB_TOPICS = uint8_t(PubTopic::COUNT);
+
+    // per topic publish rate in Hz, 0 to disable
+    AP_Int16 pub_rate_hz[NUM_PUB_TOPICS];
+    // topics written to the best effort output stream
+    AP_Int32 pub_best_effort;
+
+    //! @brief Per topic schedule and statistics
+    struct PubState {
+        uint64_t next_us;
+        // totals since connection
+        uint32_t count;
+        uint32_t dropped;
+        uint32_t bytes;
+        // accumulators for the current reporting window
+        uint32_t window_calls;
+        uint32_t window_samples;
+        uint32_t window_time_us;
+        uint32_t window_time_max_us;
+        // results from the last completed window
+        float rate_hz;
+        uint16_t time_avg_us;
+        uint16_t time_max_us;
+    } pub_state[NUM_PUB_TOPICS];
+    uint32_t pub_window_start_ms;
+    // number of times the best effort stream filled and was sent early
+    uint32_t flushes;
+    // state of the publisher being run, nullptr outside of the schedule
+    PubState *pub_current;
+
+    //! @brief Prepare the output stream for a sample on a topic, picking
+    //         the stream configured for the publisher being run. If the
+    //         best effort stream is full it is flushed so samples
+    //         are batched up to the MTU before going on the wire
+    //! @return True if ub is ready for serialisation
+    bool prepare_output_stream(uint8_t topic_index, ucdrBuffer &ub, uint32_t topic_size) WARN_IF_UNUSED;
 
     // Outgoing Sensor and AHRS data
 
 #if AP_DDS_TIME_PUB_ENABLED
     builtin_interfaces_msg_Time time_topic;
-    // The last ms timestamp AP_DDS wrote a Time message
-    uint64_t last_time_time_ms;
     //! @brief Serialize the current time state and publish to the IO stream(s)
     void write_time_topic();
     static void update_topic(builtin_interfaces_msg_Time& msg);
@@ -111,8 +169,6 @@ private:
 
 #if AP_DDS_GPS_GLOBAL_ORIGIN_PUB_ENABLED
     geographic_msgs_msg_GeoPointStamped gps_global_origin_topic;
-    // The last ms timestamp AP_DDS wrote a gps global origin message
-    uint64_t last_gps_global_origin_time_ms;
     //! @brief Serialize the current gps global origin and publish to the IO stream(s)
     void write_gps_global_origin_topic();
     static void update_topic(geographic_msgs_msg_GeoPointStamped& msg);
@@ -120,8 +176,6 @@ private:
 
 #if AP_DDS_GOAL_PUB_ENABLED
     geographic_msgs_msg_GeoPointStamped goal_topic;
-    // The last ms timestamp AP_DDS wrote a goal message
-    uint64_t last_goal_time_ms;
     //! @brief Serialize the current goal and publish to the IO stream(s)
     void write_goal_topic();
     bool update_topic_goal(geographic_msgs_msg_GeoPointStamped& msg);
@@ -130,8 +184,6 @@ private:
 
 #if AP_DDS_GEOPOSE_PUB_ENABLED
     geographic_msgs_msg_GeoPoseStamped geo_pose_topic;
-    // The last ms timestamp AP_DDS wrote a GeoPose message
-    uint64_t last_geo_pose_time_ms;
     //! @brief Serialize the current geo_pose and publish to the IO stream(s)
     void write_geo_pose_topic();
     static void update_topic(geographic_msgs_msg_GeoPoseStamped& msg);
@@ -139,8 +191,6 @@ private:
 
 #if AP_DDS_LOCAL_POSE_PUB_ENABLED
     geometry_msgs_msg_PoseStamped local_pose_topic;
-    // The last ms timestamp AP_DDS wrote a Local Pose message
-    uint64_t last_local_pose_time_ms;
     //! @brief Serialize the current local_pose and publish to the IO stream(s)
     void write_local_pose_topic();
     static void update_topic(geometry_msgs_msg_PoseStamped& msg);
@@ -148,8 +198,6 @@ private:
 
 #if AP_DDS_LOCAL_VEL_PUB_ENABLED
     geometry_msgs_msg_TwistStamped tx_local_velocity_topic;
-    // The last ms timestamp AP_DDS wrote a Local Velocity message
-    uint64_t last_local_velocity_time_ms;
     //! @brief Serialize the current local velocity and publish to the IO stream(s)
     void write_tx_local_velocity_topic();
     static void update_topic(geometry_msgs_msg_TwistStamped& msg);
@@ -157,8 +205,6 @@ private:
 
 #if AP_DDS_AIRSPEED_PUB_ENABLED
     ardupilot_msgs_msg_Airspeed tx_local_airspeed_topic;
-    // The last ms timestamp AP_DDS wrote a airspeed message
-    uint64_t last_airspeed_time_ms;
     //! @brief Serialize the current local airspeed and publish to the IO stream(s)
     void write_tx_local_airspeed_topic();
     static bool update_topic(ardupilot_msgs_msg_Airspeed& msg);
@@ -166,8 +212,6 @@ private:
 
 #if AP_DDS_RC_PUB_ENABLED
     ardupilot_msgs_msg_Rc tx_local_rc_topic;
-    // The last ms timestamp AP_DDS wrote a rc message
-    uint64_t last_rc_time_ms;
     //! @brief Serialize the current local rc and publish to the IO stream(s)
     void write_tx_local_rc_topic();
     static bool update_topic(ardupilot_msgs_msg_Rc& msg);
@@ -175,8 +219,6 @@ private:
 
 #if AP_DDS_BATTERY_STATE_PUB_ENABLED
     sensor_msgs_msg_BatteryState battery_state_topic;
-    // The last ms timestamp AP_DDS wrote a BatteryState message
-    uint64_t last_battery_state_time_ms;
     //! @brief Serialize the current nav_sat_fix state and publish it to the IO stream(s)
     void write_battery_state_topic();
     static void update_topic(sensor_msgs_msg_BatteryState& msg, const uint8_t instance);
@@ -193,8 +235,6 @@ private:
 
 #if AP_DDS_IMU_PUB_ENABLED
     sensor_msgs_msg_Imu imu_topic;
-    // The last ms timestamp AP_DDS wrote an IMU message
-    uint64_t last_imu_time_ms;
     static void update_topic(sensor_msgs_msg_Imu& msg);
     //! @brief Serialize the current IMU data and publish to the IO stream(s)
     void write_imu_topic();
@@ -202,8 +242,6 @@ private:
 
 #if AP_DDS_CLOCK_PUB_ENABLED
     rosgraph_msgs_msg_Clock clock_topic;
-    // The last ms timestamp AP_DDS wrote a Clock message
-    uint64_t last_clock_time_ms;
     //! @brief Serialize the current clock and publish to the IO stream(s)
     void write_clock_topic();
     static void update_topic(rosgraph_msgs_msg_Clock& msg);
@@ -212,8 +250,6 @@ private:
 #if AP_DDS_STATUS_PUB_ENABLED
     ardupilot_msgs_msg_Status status_topic;
     bool update_topic(ardupilot_msgs_msg_Status& msg);
-    // The last ms timestamp AP_DDS wrote/checked a status message
-    uint64_t last_status_check_time_ms;
     // last status values;
     ardupilot_msgs_msg_Status last_status_msg_;
     //! @brief Serialize the current status and publish to the IO stream(s)
@@ -331,6 +367,11 @@ public:
     //! @brief Update the internally stored DDS messages with latest data
     void update();
 
+    //! @brief Report per topic publish rate and timing for @SYS/dds.txt
+    void pub_info(ExpandingString &str);
+
+    static AP_DDS_Client *get_singleton() { return _singleton; }
+
     //! @brief GCS message prefix
     static constexpr const char* msg_prefix = "DDS:";
 
@@ -363,6 +404,11 @@ public:
         const char* topic_name;
         const char* type_name;
         const uxrQoS_t qos;
+        // schedule entry for published topics, COUNT if not scheduled
+        const PubTopic pub_topic;
+        // refresh the message(s) for the topic and write any that
+        // have changed to the output stream
+        void (*const publish)(AP_DDS_Client &dds);
     };
     static const struct Topic_table topics[];
 
@@ -402,6 +448,9 @@ public:
         const uxrQoS_t qos;
     };
     static const struct Service_table services[];
+
+private:
+    static AP_DDS_Client *_singleton;
 };
 
 #endif // AP_DDS_ENABLED
@@ -95,6 +95,11 @@ constexpr struct AP_DDS_Client::Topic_table AP_DDS_Client::topics[] = {
             .history = UXR_HISTORY_KEEP_LAST,
             .depth = 20,
         },
+        .pub_topic = PubTopic::TIME,
+        .publish = [](AP_DDS_Client &dds) {
+            dds.update_topic(dds.time_topic);
+            dds.write_time_topic();
+        },
     },
 #endif // AP_DDS_TIME_PUB_ENABLED
 #if AP_DDS_NAVSATFIX_PUB_ENABLED
@@ -113,6 +118,14 @@ constexpr struct AP_DDS_Client::Topic_table AP_DDS_Client::topics[] = {
             .history = UXR_HISTORY_KEEP_LAST,
             .depth = 5,
         },
+        .pub_topic = PubTopic::NAV_SAT_FIX,
+        .publish = [](AP_DDS_Client &dds) {
+            for (uint8_t gps_instance = 0; gps_instance < GPS_MAX_INSTANCES; gps_instance++) {
+                if (dds.update_topic(dds.nav_sat_fix_topic, gps_instance)) {
+                    dds.write_nav_sat_fix_topic();
+                }
+            }
+        },
     },
 #endif // AP_DDS_NAVSATFIX_PUB_ENABLED
 #if AP_DDS_STATIC_TF_PUB_ENABLED
@@ -131,6 +144,8 @@ constexpr struct AP_DDS_Client::Topic_table AP_DDS_Client::topics[] = {
             .history = UXR_HISTORY_KEEP_LAST,
             .depth = 1,
         },
+        .pub_topic = PubTopic::COUNT,
+        .publish = nullptr,
     },
 #endif // AP_DDS_STATIC_TF_PUB_ENABLED
 #if AP_DDS_BATTERY_STATE_PUB_ENABLED
@@ -149,6 +164,15 @@ constexpr struct AP_DDS_Client::Topic_table AP_DDS_Client::topics[] = {
             .history = UXR_HISTORY_KEEP_LAST,
             .depth = 5,
         },
+        .pub_topic = PubTopic::BATTERY_STATE,
+        .publish = [](AP_DDS_Client &dds) {
+            for (uint8_t battery_instance = 0; battery_instance < AP_BATT_MONITOR_MAX_INSTANCES; battery_instance++) {
+                dds.update_topic(dds.battery_state_topic, battery_instance);
+                if (dds.battery_state_topic.present) {
+                    dds.write_battery_state_topic();
+                }
+            }
+        },
     },
 #endif // AP_DDS_BATTERY_STATE_PUB_ENABLED
 #if AP_DDS_IMU_PUB_ENABLED
@@ -167,6 +191,11 @@ constexpr struct AP_DDS_Client::Topic_table AP_DDS_Client::topics[] = {
             .history = UXR_HISTORY_KEEP_LAST,
             .depth = 5,
         },
+        .pub_topic = PubTopic::IMU,
+        .publish = [](AP_DDS_Client &dds) {
+            dds.update_topic(dds.imu_topic);
+            dds.write_imu_topic();
+        },
     },
 #endif //AP_DDS_IMU_PUB_ENABLED
 #if AP_DDS_LOCAL_POSE_PUB_ENABLED
@@ -185,6 +214,11 @@ constexpr struct AP_DDS_Client::Topic_table AP_DDS_Client::topics[] = {
             .history = UXR_HISTORY_KEEP_LAST,
             .depth = 5,
         },
+        .pub_topic = PubTopic::LOCAL_POSE,
+        .publish = [](AP_DDS_Client &dds) {
+            dds.update_topic(dds.local_pose_topic);
+            dds.write_local_pose_topic();
+        },
     },
 #endif // AP_DDS_LOCAL_POSE_PUB_ENABLED
 #if AP_DDS_LOCAL_VEL_PUB_ENABLED
@@ -203,6 +237,11 @@ constexpr struct AP_DDS_Client::Topic_table AP_DDS_Client::topics[] = {
             .history = UXR_HISTORY_KEEP_LAST,
             .depth = 5,
         },
+        .pub_topic = PubTopic::LOCAL_VELOCITY,
+        .publish = [](AP_DDS_Client &dds) {
+            dds.update_topic(dds.tx_local_velocity_topic);
+            dds.write_tx_local_velocity_topic();
+        },
     },
 #endif // AP_DDS_LOCAL_VEL_PUB_ENABLED
 #if AP_DDS_AIRSPEED_PUB_ENABLED
@@ -221,6 +260,12 @@ constexpr struct AP_DDS_Client::Topic_table AP_DDS_Client::topics[] = {
             .history = UXR_HISTORY_KEEP_LAST,
             .depth = 5,
         },
+        .pub_topic = PubTopic::AIRSPEED,
+        .publish = [](AP_DDS_Client &dds) {
+            if (dds.update_topic(dds.tx_local_airspeed_topic)) {
+                dds.write_tx_local_airspeed_topic();
+            }
+        },
     },
 #endif // AP_DDS_AIRSPEED_PUB_ENABLED
 #if AP_DDS_RC_PUB_ENABLED
@@ -239,6 +284,12 @@ constexpr struct AP_DDS_Client::Topic_table AP_DDS_Client::topics[] = {
             .history = UXR_HISTORY_KEEP_LAST,
             .depth = 1,
         },
+        .pub_topic = PubTopic::RC,
+        .publish = [](AP_DDS_Client &dds) {
+            if (dds.update_topic(dds.tx_local_rc_topic)) {
+                dds.write_tx_local_rc_topic();
+            }
+        },
     },
 #endif // AP_DDS_RC_PUB_ENABLED
 #if AP_DDS_GEOPOSE_PUB_ENABLED
@@ -257,6 +308,11 @@ constexpr struct AP_DDS_Client::Topic_table AP_DDS_Client::topics[] = {
             .history = UXR_HISTORY_KEEP_LAST,
             .depth = 5,
         },
+        .pub_topic = PubTopic::GEOPOSE,
+        .publish = [](AP_DDS_Client &dds) {
+            dds.update_topic(dds.geo_pose_topic);
+            dds.write_geo_pose_topic();
+        },
     },
 #endif // AP_DDS_GEOPOSE_PUB_ENABLED
 #if AP_DDS_GOAL_PUB_ENABLED
@@ -275,6 +331,12 @@ constexpr struct AP_DDS_Client::Topic_table AP_DDS_Client::topics[] = {
             .history = UXR_HISTORY_KEEP_LAST,
             .depth = 1,
         },
+        .pub_topic = PubTopic::GOAL,
+        .publish = [](AP_DDS_Client &dds) {
+            if (dds.update_topic_goal(dds.goal_topic)) {
+                dds.write_goal_topic();
+            }
+        },
     },
 #endif // AP_DDS_GOAL_PUB_ENABLED
 #if AP_DDS_CLOCK_PUB_ENABLED
@@ -293,6 +355,11 @@ constexpr struct AP_DDS_Client::Topic_table AP_DDS_Client::topics[] = {
             .history = UXR_HISTORY_KEEP_LAST,
             .depth = 20,
         },
+        .pub_topic = PubTopic::CLOCK,
+        .publish = [](AP_DDS_Client &dds) {
+            dds.update_topic(dds.clock_topic);
+            dds.write_clock_topic();
+        },
     },
 #endif // AP_DDS_CLOCK_PUB_ENABLED
 #if AP_DDS_GPS_GLOBAL_ORIGIN_PUB_ENABLED
@@ -311,6 +378,11 @@ constexpr struct AP_DDS_Client::Topic_table AP_DDS_Client::topics[] = {
             .history = UXR_HISTORY_KEEP_LAST,
             .depth = 5,
         },
+        .pub_topic = PubTopic::GPS_GLOBAL_ORIGIN,
+        .publish = [](AP_DDS_Client &dds) {
+            dds.update_topic(dds.gps_global_origin_topic);
+            dds.write_gps_global_origin_topic();
+        },
     },
 #endif // AP_DDS_GPS_GLOBAL_ORIGIN_PUB_ENABLED
 #if AP_DDS_STATUS_PUB_ENABLED
@@ -329,6 +401,12 @@ constexpr struct AP_DDS_Client::Topic_table AP_DDS_Client::topics[] = {
             .history = UXR_HISTORY_KEEP_LAST,
             .depth = 1,
         },
+        .pub_topic = PubTopic::STATUS,
+        .publish = [](AP_DDS_Client &dds) {
+            if (dds.update_topic(dds.status_topic)) {
+                dds.write_status_topic();
+            }
+        },
     },
 #endif // AP_DDS_STATUS_PUB_ENABLED
 #if AP_DDS_JOY_SUB_ENABLED
@@ -347,6 +425,8 @@ constexpr struct AP_DDS_Client::Topic_table AP_DDS_Client::topics[] = {
             .history = UXR_HISTORY_KEEP_LAST,
             .depth = 5,
         },
+        .pub_topic = PubTopic::COUNT,
+        .publish = nullptr,
     },
 #endif // AP_DDS_JOY_SUB_ENABLED
 #if AP_DDS_DYNAMIC_TF_SUB_ENABLED
@@ -365,6 +445,8 @@ constexpr struct AP_DDS_Client::Topic_table AP_DDS_Client::topics[] = {
             .history = UXR_HISTORY_KEEP_LAST,
             .depth = 5,
         },
+        .pub_topic = PubTopic::COUNT,
+        .publish = nullptr,
     },
 #endif // AP_DDS_DYNAMIC_TF_SUB_ENABLED
 #if AP_DDS_VEL_CTRL_ENABLED
@@ -383,6 +465,8 @@ constexpr struct AP_DDS_Client::Topic_table AP_DDS_Client::topics[] = {
             .history = UXR_HISTORY_KEEP_LAST,
             .depth = 5,
         },
+        .pub_topic = PubTopic::COUNT,
+        .publish = nullptr,
     },
 #endif // AP_DDS_VEL_CTRL_ENABLED
 #if AP_DDS_GLOBAL_POS_CTRL_ENABLED
@@ -401,6 +485,8 @@ constexpr struct AP_DDS_Client::Topic_table AP_DDS_Client::topics[] = {
             .history = UXR_HISTORY_KEEP_LAST,
             .depth = 5,
         },
+        .pub_topic = PubTopic::COUNT,
+        .publish = nullptr,
     },
 #endif // AP_DDS_GLOBAL_POS_CTRL_ENABLED
 };
@@ -30,9 +30,26 @@
 #include <AP_Math/AP_Math.h>
 
 /*
-  calculate magnetic field intensity and orientation
+  load the values along the south and north edges of a cell
+ */
+template <typename T>
+void AP_Declination::get_edges(const T table[LAT_TABLE_SIZE][LON_TABLE_SIZE], float scale, uint32_t lat_index, uint32_t lon_index, Cell::Edges &edges)
+{
+    const float data_sw = table[lat_index][lon_index] * scale;
+    const float data_se = table[lat_index][lon_index + 1] * scale;
+    const float data_ne = table[lat_index + 1][lon_index + 1] * scale;
+    const float data_nw = table[lat_index + 1][lon_index] * scale;
+
+    edges.south = data_sw;
+    edges.south_delta = data_se - data_sw;
+    edges.north = data_nw;
+    edges.north_delta = data_ne - data_nw;
+}
+
+/*
+  find the cell of the tables containing a location
 */
-bool AP_Declination::get_mag_field_ef(float latitude_deg, float longitude_deg, float &intensity_gauss, float &declination_deg, float &inclination_deg)
+void AP_Declination::get_cell(float latitude_deg, float longitude_deg, Cell &cell)
 {
     bool valid_input_data = true;
 
@@ -70,49 +87,52 @@ bool AP_Declination::get_mag_field_ef(float latitude_deg, float longitude_deg, f
     uint32_t min_lat_index = constrain_int32(static_cast<uint32_t>((-(SAMPLING_MIN_LAT) + min_lat)  / SAMPLING_RES), 0, LAT_TABLE_SIZE - 2);
     uint32_t min_lon_index = constrain_int32(static_cast<uint32_t>((-(SAMPLING_MIN_LON) + min_lon) / SAMPLING_RES), 0, LON_TABLE_SIZE -2);
 
-    /* calculate intensity */
-
-    float data_sw = intensity_table[min_lat_index][min_lon_index];
-    float data_se = intensity_table[min_lat_index][min_lon_index + 1];
-    float data_ne = intensity_table[min_lat_index + 1][min_lon_index + 1];
-    float data_nw = intensity_table[min_lat_index + 1][min_lon_index];
-
-    /* perform bilinear interpolation on the four grid corners */
-
-    float data_min = ((longitude_deg - min_lon) / SAMPLING_RES) * (data_se - data_sw) + data_sw;
-    float data_max = ((longitude_deg - min_lon) / SAMPLING_RES) * (data_ne - data_nw) + data_nw;
-
-    intensity_gauss = ((latitude_deg - min_lat) / SAMPLING_RES) * (data_max - data_min) + data_min;
-
-    /* calculate declination */
-
-    data_sw = declination_table[min_lat_index][min_lon_index];
-    data_se = declination_table[min_lat_index][min_lon_index + 1];
-    data_ne = declination_table[min_lat_index + 1][min_lon_index + 1];
-    data_nw = declination_table[min_lat_index + 1][min_lon_index];
-
-    /* perform bilinear interpolation on the four grid corners */
-
-    data_min = ((longitude_deg - min_lon) / SAMPLING_RES) * (data_se - data_sw) + data_sw;
-    data_max = ((longitude_deg - min_lon) / SAMPLING_RES) * (data_ne - data_nw) + data_nw;
-
-    declination_deg = ((latitude_deg - min_lat) / SAMPLING_RES) * (data_max - data_min) + data_min;
+    cell.min_lat = min_lat;
+    cell.min_lon = min_lon;
+    cell.valid_input_data = valid_input_data;
+
+#if AP_DECLINATION_COMPRESSED_TABLE_ENABLED
+    get_edges(intensity_table, intensity_scale, min_lat_index, min_lon_index, cell.intensity);
+    get_edges(declination_table, declination_scale, min_lat_index, min_lon_index, cell.declination);
+    get_edges(inclination_table, inclination_scale, min_lat_index, min_lon_index, cell.inclination);
+#else
+    get_edges(intensity_table, 1.0f, min_lat_index, min_lon_index, cell.intensity);
+    get_edges(declination_table, 1.0f, min_lat_index, min_lon_index, cell.declination);
+    get_edges(inclination_table, 1.0f, min_lat_index, min_lon_index, cell.inclination);
+#endif
+}
 
-    /* calculate inclination */
+/*
+  perform bilinear interpolation within a cell
+*/
+bool AP_Declination::interpolate(const Cell &cell, float latitude_deg, float longitude_deg, float &intensity_gauss, float &declination_deg, float &inclination_deg)
+{
+    const float lon_ratio = (longitude_deg - cell.min_lon) / SAMPLING_RES;
+    const float lat_ratio = (latitude_deg - cell.min_lat) / SAMPLING_RES;
 
-    data_sw = inclination_table[min_lat_index][min_lon_index];
-    data_se = inclination_table[min_lat_index][min_lon_index + 1];
-    data_ne = inclination_table[min_lat_index + 1][min_lon_index + 1];
-    data_nw = inclination_table[min_lat_index + 1][min_lon_index];
+    float data_min = lon_ratio * cell.intensity.south_delta + cell.intensity.south;
+    float data_max = lon_ratio * cell.intensity.north_delta + cell.intensity.north;
+    intensity_gauss = lat_ratio * (data_max - data_min) + data_min;
 
-    /* perform bilinear interpolation on the four grid corners */
+    data_min = lon_ratio * cell.declination.south_delta + cell.declination.south;
+    data_max = lon_ratio * cell.declination.north_delta + cell.declination.north;
+    declination_deg = lat_ratio * (data_max - data_min) + data_min;
 
-    data_min = ((longitude_deg - min_lon) / SAMPLING_RES) * (data_se - data_sw) + data_sw;
-    data_max = ((longitude_deg - min_lon) / SAMPLING_RES) * (data_ne - data_nw) + data_nw;
+    data_min = lon_ratio * cell.inclination.south_delta + cell.inclination.south;
+    data_max = lon_ratio * cell.inclination.north_delta + cell.inclination.north;
+    inclination_deg = lat_ratio * (data_max - data_min) + data_min;
 
-    inclination_deg = ((latitude_deg - min_lat) / SAMPLING_RES) * (data_max - data_min) + data_min;
+    return cell.valid_input_data;
+}
 
-    return valid_input_data;
+/*
+  calculate magnetic field intensity and orientation
+*/
+bool AP_Declination::get_mag_field_ef(float latitude_deg, float longitude_deg, float &intensity_gauss, float &declination_deg, float &inclination_deg)
+{
+    Cell cell;
+    get_cell(latitude_deg, longitude_deg, cell);
+    return interpolate(cell, latitude_deg, longitude_deg, intensity_gauss, declination_deg, inclination_deg);
 }
 
 
@@ -129,13 +149,10 @@ float AP_Declination::get_declination(float latitude_deg, float longitude_deg)
 }
 
 /*
-  get earth field as a Vector3f in Gauss given a Location
+  convert field intensity and orientation to a vector in Gauss
 */
-Vector3f AP_Declination::get_earth_field_ga(const Location &loc)
+Vector3f AP_Declination::field_vector(float intensity_gauss, float declination_deg, float inclination_deg)
 {
-    float declination_deg=0, inclination_deg=0, intensity_gauss=0;
-    get_mag_field_ef(loc.lat*1.0e-7f, loc.lng*1.0e-7f, intensity_gauss, declination_deg, inclination_deg);
-
     // create earth field
     Vector3f mag_ef = Vector3f(intensity_gauss, 0.0, 0.0);
     Matrix3f R;
@@ -144,3 +161,67 @@ Vector3f AP_Declination::get_earth_field_ga(const Location &loc)
     mag_ef = R * mag_ef;
     return mag_ef;
 }
+
+/*
+  get earth field as a Vector3f in Gauss given a Location
+*/
+Vector3f AP_Declination::get_earth_field_ga(const Location &loc)
+{
+    float declination_deg=0, inclination_deg=0, intensity_gauss=0;
+    get_mag_field_ef(loc.lat*1.0e-7f, loc.lng*1.0e-7f, intensity_gauss, declination_deg, inclination_deg);
+    return field_vector(intensity_gauss, declination_deg, inclination_deg);
+}
+
+/*
+  calculate magnetic field intensity and orientation, reusing the
+  cell of the last call if the location is still within it
+*/
+bool AP_Declination::LocalField::get_mag_field_ef(float latitude_deg, float longitude_deg, float &intensity_gauss, float &declination_deg, float &inclination_deg)
+{
+    // the cell is found in the same way as get_cell(), so results are identical
+    const int32_t lat_index = static_cast<int32_t>(floorf(latitude_deg / SAMPLING_RES));
+    const int32_t lon_index = static_cast<int32_t>(floorf(longitude_deg / SAMPLING_RES));
+
+    if (!cell_valid ||
+        lat_index != lat_cell ||
+        lon_index != lon_cell ||
+        latitude_deg <= SAMPLING_MIN_LAT ||
+        latitude_deg >= SAMPLING_MAX_LAT ||
+        longitude_deg <= SAMPLING_MIN_LON ||
+        longitude_deg >= SAMPLING_MAX_LON) {
+        get_cell(latitude_deg, longitude_deg, cell);
+        lat_cell = lat_index;
+        lon_cell = lon_index;
+        // cells on the edge of the tables are not reused
+        cell_valid = cell.valid_input_data;
+    }
+
+    return interpolate(cell, latitude_deg, longitude_deg, intensity_gauss, declination_deg, inclination_deg);
+}
+
+/*
+  get declination in degrees for a given latitude_deg and longitude_deg
+*/
+float AP_Declination::LocalField::get_declination(float latitude_deg, float longitude_deg)
+{
+    float declination_deg=0, inclination_deg=0, intensity_gauss=0;
+    get_mag_field_ef(latitude_deg, longitude_deg, intensity_gauss, declination_deg, inclination_deg);
+    return declination_deg;
+}
+
+/*
+  get earth field as a Vector3f in Gauss given a Location
+*/
+Vector3f AP_Declination::LocalField::get_earth_field_ga(const Location &loc)
+{
+    if (field_valid && loc.lat == field_lat && loc.lng == field_lng) {
+        return field_ga;
+    }
+    float declination_deg=0, inclination_deg=0, intensity_gauss=0;
+    get_mag_field_ef(loc.lat*1.0e-7f, loc.lng*1.0e-7f, intensity_gauss, declination_deg, inclination_deg);
+    field_ga = field_vector(intensity_gauss, declination_deg, inclination_deg);
+    field_lat = loc.lat;
+    field_lng = loc.lng;
+    field_valid = true;
+    return field_ga;
+}
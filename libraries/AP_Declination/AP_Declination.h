@@ -1,5 +1,7 @@
 #pragma once
 
+#include "AP_Declination_config.h"
+
 #include <AP_Common/Location.h>
 
 /*
@@ -27,7 +29,53 @@ public:
       get declination in degrees for a given latitude_deg and longitude_deg
      */
     static float get_declination(float latitude_deg, float longitude_deg);
-    
+
+private:
+    /*
+      a cell of the tables, holding the values at the south west and
+      north west corners and the change from west to east along the
+      south and north edges for bilinear interpolation
+     */
+    struct Cell {
+        float min_lat;
+        float min_lon;
+        struct Edges {
+            float south;
+            float south_delta;
+            float north;
+            float north_delta;
+        } intensity, declination, inclination;
+        bool valid_input_data;
+    };
+
+public:
+    /*
+      field model for the area around the vehicle, for callers which
+      look up the field repeatedly. It keeps the interpolation cell of
+      the last lookup and only reads the tables again when the
+      location moves into another cell. Results are identical to the
+      static functions. Each caller should have its own LocalField, as
+      it is not thread safe
+     */
+    class LocalField {
+    public:
+        bool get_mag_field_ef(float latitude_deg, float longitude_deg, float &intensity_gauss, float &declination_deg, float &inclination_deg);
+        Vector3f get_earth_field_ga(const Location &loc);
+        float get_declination(float latitude_deg, float longitude_deg);
+
+    private:
+        bool cell_valid = false;
+        int32_t lat_cell;
+        int32_t lon_cell;
+        Cell cell;
+
+        // last result of get_earth_field_ga()
+        bool field_valid = false;
+        int32_t field_lat;
+        int32_t field_lng;
+        Vector3f field_ga;
+    };
+
 private:
     static const float SAMPLING_RES;
     static const float SAMPLING_MIN_LAT;
@@ -38,7 +86,31 @@ private:
     static const uint32_t LAT_TABLE_SIZE = 19;
     static const uint32_t LON_TABLE_SIZE = 37;
 
+#if AP_DECLINATION_COMPRESSED_TABLE_ENABLED
+    // table values are multiplied by the scale to give the field
+    static const float declination_scale;
+    static const float inclination_scale;
+    static const float intensity_scale;
+
+    static const int16_t declination_table[LAT_TABLE_SIZE][LON_TABLE_SIZE];
+    static const int16_t inclination_table[LAT_TABLE_SIZE][LON_TABLE_SIZE];
+    static const int16_t intensity_table[LAT_TABLE_SIZE][LON_TABLE_SIZE];
+#else
     static const float declination_table[LAT_TABLE_SIZE][LON_TABLE_SIZE];
     static const float inclination_table[LAT_TABLE_SIZE][LON_TABLE_SIZE];
     static const float intensity_table[LAT_TABLE_SIZE][LON_TABLE_SIZE];
+#endif
+
+    // load the edges of a cell from a table
+    template <typename T>
+    static void get_edges(const T table[LAT_TABLE_SIZE][LON_TABLE_SIZE], float scale, uint32_t lat_index, uint32_t lon_index, Cell::Edges &edges);
+
+    // find the cell containing a location
+    static void get_cell(float latitude_deg, float longitude_deg, Cell &cell);
+
+    // interpolate the field within a cell
+    static bool interpolate(const Cell &cell, float latitude_deg, float longitude_deg, float &intensity_gauss, float &declination_deg, float &inclination_deg);
+
+    // convert field intensity and orientation to a vector
+    static Vector3f field_vector(float intensity_gauss, float declination_deg, float inclination_deg);
 };
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <AP_HAL/AP_HAL_Boards.h>
+
+/*
+  store the field tables as scaled 16 bit integers, halving the flash
+  used by the tables. The resolution is better than 0.01 degrees and
+  0.03 milligauss
+ */
+#ifndef AP_DECLINATION_COMPRESSED_TABLE_ENABLED
+#define AP_DECLINATION_COMPRESSED_TABLE_ENABLED HAL_PROGRAM_SIZE_LIMIT_KB <= 1024
+#endif
@@ -0,0 +1,102 @@
+#include <AP_gbenchmark.h>
+
+#include <AP_Declination/AP_Declination.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+/*
+  a vehicle flying slowly north east, as seen by the EKF and compass
+  code looking up the field repeatedly
+ */
+static float lat = -35.363261;
+static float lon = 149.165230;
+
+static void move(void)
+{
+    lat += 1.0e-6;
+    lon += 1.0e-6;
+}
+
+static void BM_GetMagFieldEf(benchmark::State &state)
+{
+    float intensity, declination, inclination;
+    while (state.KeepRunning()) {
+        move();
+        AP_Declination::get_mag_field_ef(lat, lon, intensity, declination, inclination);
+        gbenchmark_escape(&intensity);
+        gbenchmark_escape(&declination);
+        gbenchmark_escape(&inclination);
+    }
+}
+
+BENCHMARK(BM_GetMagFieldEf);
+
+static void BM_LocalFieldGetMagFieldEf(benchmark::State &state)
+{
+    AP_Declination::LocalField local;
+    float intensity, declination, inclination;
+    while (state.KeepRunning()) {
+        move();
+        local.get_mag_field_ef(lat, lon, intensity, declination, inclination);
+        gbenchmark_escape(&intensity);
+        gbenchmark_escape(&declination);
+        gbenchmark_escape(&inclination);
+    }
+}
+
+BENCHMARK(BM_LocalFieldGetMagFieldEf);
+
+// a new cell on every lookup, the worst case for the local field
+static void BM_LocalFieldNewCell(benchmark::State &state)
+{
+    AP_Declination::LocalField local;
+    float intensity, declination, inclination;
+    float lat2 = lat;
+    while (state.KeepRunning()) {
+        lat2 = lat2 > 0 ? lat2 - 50 : lat2 + 50;
+        local.get_mag_field_ef(lat2, lon, intensity, declination, inclination);
+        gbenchmark_escape(&intensity);
+    }
+}
+
+BENCHMARK(BM_LocalFieldNewCell);
+
+static void BM_GetEarthFieldGa(benchmark::State &state)
+{
+    Location loc(lat*1.0e7, lon*1.0e7, 0, Location::AltFrame::ABSOLUTE);
+    while (state.KeepRunning()) {
+        loc.lat++;
+        Vector3f field = AP_Declination::get_earth_field_ga(loc);
+        gbenchmark_escape(&field);
+    }
+}
+
+BENCHMARK(BM_GetEarthFieldGa);
+
+static void BM_LocalFieldGetEarthFieldGa(benchmark::State &state)
+{
+    AP_Declination::LocalField local;
+    Location loc(lat*1.0e7, lon*1.0e7, 0, Location::AltFrame::ABSOLUTE);
+    while (state.KeepRunning()) {
+        loc.lat++;
+        Vector3f field = local.get_earth_field_ga(loc);
+        gbenchmark_escape(&field);
+    }
+}
+
+BENCHMARK(BM_LocalFieldGetEarthFieldGa);
+
+// the same location looked up by several callers
+static void BM_LocalFieldGetEarthFieldGaSameLocation(benchmark::State &state)
+{
+    AP_Declination::LocalField local;
+    const Location loc(lat*1.0e7, lon*1.0e7, 0, Location::AltFrame::ABSOLUTE);
+    while (state.KeepRunning()) {
+        Vector3f field = local.get_earth_field_ga(loc);
+        gbenchmark_escape(&field);
+    }
+}
+
+BENCHMARK(BM_LocalFieldGetEarthFieldGaSameLocation);
+
+BENCHMARK_MAIN();
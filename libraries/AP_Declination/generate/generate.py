@@ -40,6 +40,31 @@ def write_table(f,name, table):
         f.write("\n")
     f.write("};\n\n")
 
+def compressed_scale(table):
+    '''scale to fit a table in 16 bit integers'''
+    return float(np.float32(np.abs(table).max() / 32767.0))
+
+def write_compressed_table(f, name, table):
+    '''write one table as scaled 16 bit integers'''
+    scale = compressed_scale(table)
+    f.write("__EXTFLASHFUNC__ const int16_t AP_Declination::%s[%u][%u] = {\n" %
+                (name, NUM_LAT, NUM_LON))
+    for i in range(NUM_LAT):
+        f.write("    {")
+        for j in range(NUM_LON):
+            f.write("%d" % int(round(table[i][j] / scale)))
+            if j != NUM_LON-1:
+                f.write(",")
+        f.write("}")
+        if i != NUM_LAT-1:
+            f.write(",")
+        f.write("\n")
+    f.write("};\n\n")
+
+def write_scale(f, name, table):
+    '''write the scale of a compressed table'''
+    f.write("const float AP_Declination::%s = %.9gf;\n" % (name, compressed_scale(table)))
+
 date = datetime.datetime.now()
 
 SAMPLING_RES = args.sampling_res
@@ -179,9 +204,19 @@ const float AP_Declination::SAMPLING_MAX_LON = %u;
            SAMPLING_MAX_LON))
 
 
+    f.write("#if AP_DECLINATION_COMPRESSED_TABLE_ENABLED\n\n")
+    write_scale(f, 'declination_scale', declination_table)
+    write_scale(f, 'inclination_scale', inclination_table)
+    write_scale(f, 'intensity_scale', intensity_table)
+    f.write("\n")
+    write_compressed_table(f, 'declination_table', declination_table)
+    write_compressed_table(f, 'inclination_table', inclination_table)
+    write_compressed_table(f, 'intensity_table', intensity_table)
+    f.write("#else\n\n")
     write_table(f,'declination_table', declination_table)
     write_table(f,'inclination_table', inclination_table)
     write_table(f,'intensity_table', intensity_table)
+    f.write("#endif // AP_DECLINATION_COMPRESSED_TABLE_ENABLED\n")
 
 if args.check_error:
     print("Checking for maximum error")
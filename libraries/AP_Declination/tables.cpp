@@ -9,6 +9,80 @@ const float AP_Declination::SAMPLING_MAX_LAT = 90;
 const float AP_Declination::SAMPLING_MIN_LON = -180;
 const float AP_Declination::SAMPLING_MAX_LON = 180;
 
+#if AP_DECLINATION_COMPRESSED_TABLE_ENABLED
+
+const float AP_Declination::declination_scale = 0.00548721198f;
+const float AP_Declination::inclination_scale = 0.00269760005f;
+const float AP_Declination::intensity_scale = 2.04232911e-05f;
+
+__EXTFLASHFUNC__ const int16_t AP_Declination::declination_table[19][37] = {
+    {27124,25301,23479,21657,19834,18012,16189,14367,12544,10722,8900,7077,5255,3432,1610,-212,-2035,-3857,-5680,-7502,-9325,-11147,-12969,-14792,-16614,-18437,-20259,-22082,-23904,-25726,-27549,-29371,-31194,32591,30769,28946,27124},
+    {23526,21303,19279,17428,15716,14110,12583,11111,9677,8269,6881,5505,4139,2776,1409,29,-1373,-2807,-4280,-5797,-7358,-8963,-10610,-12301,-14039,-15833,-17698,-19653,-21724,-23938,-26315,-28859,-31544,31306,28572,25957,23526},
+    {15639,14185,13012,12007,11095,10220,9336,8406,7413,6352,5239,4102,2969,1866,795,-264,-1350,-2504,-3756,-5112,-6553,-8047,-9559,-11066,-12554,-14031,-15521,-17071,-18767,-20769,-23411,-27402,31993,25150,20462,17583,15639},
+    {8789,8532,8245,7966,7704,7436,7108,6651,6007,5151,4108,2950,1782,709,-212,-1003,-1766,-2624,-3670,-4919,-6312,-7746,-9128,-10389,-11496,-12430,-13177,-13695,-13876,-13407,-11202,-3583,5175,8016,8811,8936,8789},
+    {5728,5760,5701,5611,5537,5498,5463,5332,4971,4276,3219,1890,490,-741,-1643,-2223,-2639,-3107,-3828,-4890,-6194,-7531,-8721,-9655,-10272,-10519,-10319,-9531,-7953,-5482,-2445,429,2627,4107,5020,5518,5728},
+    {4133,4230,4238,4191,4125,4087,4095,4088,3905,3341,2272,768,-866,-2243,-3140,-3598,-3786,-3858,-4036,-4628,-5652,-6778,-7702,-8265,-8375,-7977,-7048,-5599,-3805,-2035,-519,761,1851,2747,3432,3888,4133},
+    {3111,3206,3240,3225,3162,3077,3018,2986,2849,2345,1264,-320,-2002,-3317,-4085,-4425,-4497,-4284,-3828,-3594,-3987,-4777,-5510,-5877,-5740,-5116,-4115,-2857,-1592,-616,80,711,1365,1991,2525,2904,3111},
+    {2437,2492,2513,2513,2468,2367,2258,2180,2022,1504,403,-1157,-2702,-3807,-4355,-4457,-4241,-3671,-2773,-1936,-1658,-2039,-2718,-3205,-3235,-2853,-2194,-1346,-533,-28,238,555,1014,1513,1962,2281,2437},
+    {2025,2026,2007,2004,1976,1881,1769,1676,1475,901,-206,-1650,-2976,-3835,-4110,-3863,-3261,-2450,-1564,-774,-297,-340,-829,-1353,-1576,-1481,-1153,-636,-118,131,179,348,732,1187,1605,1903,2025},
+    {1801,1771,1715,1710,1701,1622,1515,1400,1125,475,-609,-1891,-2987,-3595,-3590,-3063,-2262,-1443,-757,-201,223,333,43,-390,-661,-719,-610,-339,-41,49,-16,80,435,893,1335,1668,1801},
+    {1663,1673,1630,1648,1676,1621,1497,1302,905,157,-907,-2031,-2890,-3241,-3021,-2385,-1582,-837,-292,100,436,590,422,85,-167,-279,-296,-216,-114,-158,-304,-274,40,509,1014,1443,1663},
+    {1469,1628,1694,1789,1878,1859,1696,1373,804,-82,-1168,-2160,-2780,-2894,-2545,-1913,-1179,-502,-16,304,570,723,631,375,161,38,-53,-125,-215,-415,-662,-721,-478,-16,550,1096,1469},
+    {1150,1534,1810,2044,2212,2229,2030,1579,820,-246,-1407,-2317,-2749,-2689,-2270,-1658,-976,-334,151,468,704,856,839,685,524,390,227,5,-297,-693,-1077,-1238,-1070,-630,-29,609,1150},
+    {777,1385,1902,2315,2581,2630,2403,1842,894,-380,-1668,-2568,-2903,-2749,-2281,-1657,-976,-324,209,591,870,1075,1179,1172,1085,920,636,208,-357,-995,-1537,-1786,-1664,-1234,-610,93,777},
+    {469,1243,1954,2543,2934,3048,2806,2122,939,-614,-2094,-3047,-3355,-3155,-2643,-1968,-1230,-504,142,674,1108,1472,1764,1945,1963,1759,1290,550,-382,-1326,-2035,-2336,-2211,-1753,-1089,-324,469},
+    {262,1144,1983,2712,3244,3467,3239,2392,827,-1192,-2965,-3983,-4249,-3983,-3392,-2618,-1757,-875,-24,762,1477,2122,2680,3094,3268,3078,2411,1241,-245,-1636,-2554,-2881,-2708,-2187,-1457,-620,262},
+    {24,994,1923,2749,3381,3677,3404,2224,-66,-2823,-4822,-5685,-5710,-5224,-4435,-3469,-2403,-1287,-161,947,2014,3017,3919,4659,5134,5178,4547,2995,663,-1580,-2950,-3406,-3223,-2651,-1855,-942,24},
+    {-756,205,1086,1794,2177,1970,734,-1889,-5094,-7253,-8049,-7942,-7313,-6377,-5254,-4014,-2699,-1339,44,1431,2805,4148,5435,6632,7683,8491,8864,8401,6328,2212,-1638,-3399,-3732,-3353,-2624,-1724,-756},
+    {-30945,-29122,-27300,-25477,-23655,-21832,-20010,-18188,-16365,-14543,-12720,-10898,-9076,-7253,-5431,-3608,-1786,37,1859,3681,5504,7326,9149,10971,12793,14616,16438,18261,20083,21906,23728,25550,27373,29195,31018,-32767,-30945}
+};
+
+__EXTFLASHFUNC__ const int16_t AP_Declination::inclination_table[19][37] = {
+    {-26698,-26698,-26698,-26698,-26698,-26698,-26698,-26698,-26698,-26698,-26698,-26698,-26698,-26698,-26698,-26698,-26698,-26698,-26698,-26698,-26698,-26698,-26698,-26698,-26698,-26698,-26698,-26698,-26698,-26698,-26698,-26698,-26698,-26698,-26698,-26698,-26698},
+    {-29001,-28717,-28376,-27993,-27582,-27154,-26722,-26297,-25891,-25517,-25183,-24896,-24660,-24476,-24341,-24253,-24212,-24219,-24278,-24394,-24572,-24816,-25124,-25492,-25913,-26373,-26860,-27354,-27838,-28289,-28686,-29004,-29225,-29333,-29326,-29210,-29001},
+    {-29953,-29277,-28599,-27910,-27203,-26471,-25718,-24962,-24236,-23582,-23044,-22651,-22410,-22296,-22266,-22274,-22291,-22313,-22364,-22484,-22713,-23085,-23611,-24282,-25076,-25963,-26913,-27897,-28886,-29847,-30736,-31468,-31864,-31744,-31252,-30621,-29953},
+    {-28713,-27964,-27245,-26534,-25799,-25006,-24127,-23165,-22174,-21261,-20560,-20189,-20184,-20476,-20909,-21312,-21571,-21658,-21628,-21593,-21691,-22029,-22651,-23528,-24594,-25777,-27019,-28282,-29531,-30724,-31782,-32395,-32014,-31197,-30335,-29503,-28713},
+    {-26535,-25807,-25102,-24416,-23730,-23000,-22159,-21157,-20027,-18918,-18092,-17830,-18262,-19248,-20450,-21529,-22280,-22618,-22556,-22234,-21930,-21940,-22412,-23302,-24457,-25714,-26957,-28100,-29047,-29679,-29908,-29752,-29318,-28718,-28023,-27283,-26535},
+    {-23872,-23132,-22394,-21658,-20938,-20225,-19461,-18550,-17434,-16238,-15344,-15259,-16232,-17986,-19958,-21725,-23114,-24028,-24320,-23957,-23223,-22645,-22633,-23237,-24225,-25297,-26239,-26921,-27253,-27257,-27069,-26781,-26400,-25908,-25304,-24608,-23872},
+    {-20399,-19599,-18791,-17959,-17125,-16329,-15571,-14732,-13641,-12356,-11409,-11591,-13228,-15788,-18456,-20779,-22697,-24188,-25030,-24997,-24194,-23115,-22412,-22424,-22972,-23655,-24192,-24431,-24294,-23914,-23548,-23270,-22962,-22527,-21931,-21196,-20399},
+    {-15658,-14725,-13829,-12918,-11973,-11064,-10242,-9360,-8164,-6722,-5770,-6336,-8720,-12154,-15611,-18503,-20737,-22369,-23302,-23371,-22589,-21283,-20099,-19582,-19687,-20029,-20322,-20362,-19999,-19417,-19009,-18830,-18613,-18183,-17510,-16626,-15658},
+    {-9385,-8253,-7282,-6353,-5371,-4413,-3546,-2571,-1243,232,1000,75,-2779,-6855,-11048,-14456,-16763,-18094,-18642,-18491,-17608,-16155,-14755,-14018,-13932,-14134,-14380,-14426,-14029,-13402,-13082,-13105,-13018,-12569,-11756,-10630,-9385},
+    {-1936,-623,364,1218,2125,3015,3832,4790,6035,7238,7655,6580,3807,-254,-4595,-8087,-10216,-11116,-11210,-10819,-9869,-8347,-6858,-6067,-5941,-6107,-6371,-6511,-6236,-5743,-5640,-5950,-6075,-5684,-4790,-3453,-1936},
+    {5433,6763,7687,8410,9171,9948,10686,11516,12474,13248,13314,12259,9943,6608,3021,131,-1565,-2098,-1884,-1361,-483,878,2228,2953,3083,2971,2762,2583,2668,2879,2712,2141,1738,1883,2615,3894,5433},
+    {11492,12616,13429,14061,14724,15450,16179,16915,17613,18032,17844,16852,15068,12732,10344,8443,7334,7073,7400,7930,8633,9623,10608,11158,11277,11232,11136,11025,10995,10949,10577,9869,9237,9035,9383,10278,11492},
+    {16065,16851,17530,18136,18791,19532,20299,21020,21593,21826,21514,20617,19284,17769,16362,15289,14686,14602,14913,15373,15899,16531,17141,17512,17635,17660,17668,17656,17609,17426,16945,16192,15441,14972,14929,15338,16065},
+    {19685,20152,20695,21300,21990,22757,23542,24258,24785,24953,24632,23867,22866,21859,21014,20418,20113,20110,20348,20695,21068,21456,21819,22091,22264,22394,22507,22578,22542,22301,21778,21032,20257,19656,19353,19381,19685},
+    {22948,23202,23625,24192,24875,25628,26382,27053,27524,27650,27355,26723,25948,25214,24630,24238,24044,24037,24175,24393,24637,24885,25136,25390,25648,25909,26144,26292,26270,26003,25479,24786,24068,23463,23059,22890,22948},
+    {26161,26311,26623,27082,27656,28297,28943,29508,29881,29940,29656,29130,28517,27942,27474,27143,26952,26887,26923,27029,27178,27363,27588,27866,28202,28572,28919,29150,29163,28909,28433,27841,27249,26744,26381,26184,26161},
+    {29220,29309,29510,29810,30191,30623,31064,31444,31662,31620,31335,30914,30455,30024,29655,29368,29169,29054,29016,29047,29139,29292,29509,29794,30145,30541,30935,31238,31339,31184,30837,30412,29997,29646,29391,29247,29220},
+    {31852,31879,31959,32085,32246,32424,32587,32680,32642,32480,32246,31986,31728,31488,31276,31102,30970,30883,30843,30850,30906,31010,31162,31359,31597,31868,32158,32443,32674,32767,32678,32488,32282,32102,31965,31880,31852},
+    {32701,32701,32701,32701,32701,32701,32701,32701,32701,32701,32701,32701,32701,32701,32701,32701,32701,32701,32701,32701,32701,32701,32701,32701,32701,32701,32701,32701,32701,32701,32701,32701,32701,32701,32701,32701,32701}
+};
+
+__EXTFLASHFUNC__ const int16_t AP_Declination::intensity_table[19][37] = {
+    {26689,26689,26689,26689,26689,26689,26689,26689,26689,26689,26689,26689,26689,26689,26689,26689,26689,26689,26689,26689,26689,26689,26689,26689,26689,26689,26689,26689,26689,26689,26689,26689,26689,26689,26689,26689,26689},
+    {29653,29341,28954,28503,27999,27454,26877,26283,25685,25100,24541,24025,23565,23175,22865,22645,22526,22516,22623,22849,23195,23655,24217,24863,25567,26302,27036,27739,28381,28939,29391,29728,29942,30035,30012,29881,29653},
+    {30844,30192,29458,28650,27773,26828,25824,24774,23707,22657,21667,20772,19997,19352,18843,18470,18245,18190,18334,18710,19339,20223,21344,22656,24100,25602,27087,28477,29701,30703,31443,31908,32105,32060,31810,31392,30844},
+    {30288,29356,28375,27351,26270,25109,23847,22485,21059,19647,18342,17227,16346,15685,15200,14842,14599,14505,14634,15075,15902,17139,18748,20644,22712,24832,26890,28769,30362,31583,32384,32766,32767,32451,31889,31148,30288},
+    {28611,27485,26352,25222,24077,22873,21549,20067,18459,16835,15357,14183,13396,12952,12714,12540,12369,12239,12267,12622,13474,14902,16852,19165,21645,24116,26440,28494,30158,31344,32020,32215,31999,31457,30664,29692,28611},
+    {26402,25191,23990,22815,21666,20510,19272,17882,16337,14737,13277,12190,11617,11495,11593,11695,11712,11655,11600,11744,12386,13739,15788,18308,20983,23544,25830,27735,29164,30078,30512,30524,30174,29531,28648,27580,26402},
+    {23887,22709,21538,20387,19276,18206,17136,15998,14738,13390,12133,11242,10895,11020,11359,11710,12025,12269,12377,12431,12760,13738,15518,17918,20530,22960,25003,26554,27536,28014,28151,28025,27628,26977,26102,25044,23887},
+    {21157,20119,19093,18088,17127,16234,15409,14604,13731,12763,11832,11177,10977,11194,11639,12176,12790,13415,13855,14028,14148,14622,15801,17692,19905,21989,23686,24840,25350,25376,25231,25008,24605,23985,23170,22198,21157},
+    {18552,17766,17010,16291,15630,15044,14540,14092,13616,13053,12452,11966,11748,11872,12298,12925,13676,14453,15067,15376,15446,15582,16191,17426,19020,20590,21878,22681,22856,22593,22261,21951,21520,20918,20187,19374,18552},
+    {16703,16252,15839,15480,15209,15018,14890,14799,14679,14440,14053,13590,13199,13050,13261,13770,14418,15076,15637,16000,16152,16264,16640,17412,18434,19477,20355,20874,20903,20571,20141,19688,19138,18496,17837,17226,16703},
+    {16069,15921,15825,15807,15922,16148,16420,16678,16842,16793,16459,15901,15282,14819,14694,14906,15309,15786,16270,16680,16990,17297,17737,18320,18985,19663,20249,20594,20602,20298,19763,19061,18265,17480,16811,16339,16069},
+    {16638,16648,16778,17044,17490,18086,18724,19292,19674,19729,19374,18683,17873,17191,16816,16762,16944,17302,17776,18255,18698,19176,19719,20268,20803,21349,21850,22178,22229,21937,21260,20268,19157,18130,17328,16832,16638},
+    {18232,18258,18521,19006,19702,20543,21409,22168,22686,22813,22457,21699,20784,19981,19459,19234,19262,19517,19945,20430,20908,21419,21986,22570,23164,23782,24366,24791,24920,24631,23855,22678,21344,20104,19129,18503,18232},
+    {20685,20670,20979,21575,22388,23307,24205,24968,25480,25610,25280,24554,23644,22793,22163,21796,21676,21783,22074,22462,22887,23363,23927,24592,25343,26133,26863,27394,27586,27319,26554,25392,24056,22786,21753,21043,20685},
+    {23659,23613,23874,24404,25122,25908,26644,27235,27595,27644,27339,26722,25928,25130,24460,23985,23720,23661,23781,24034,24382,24829,25409,26142,27001,27900,28709,29285,29505,29294,28657,27699,26596,25532,24644,24008,23659},
+    {26406,26342,26475,26779,27200,27663,28087,28404,28560,28515,28253,27799,27217,26596,26018,25546,25219,25053,25049,25196,25480,25902,26469,27178,27987,28813,29542,30060,30282,30174,29765,29139,28415,27708,27108,26665,26406},
+    {28045,27953,27943,28001,28107,28231,28339,28402,28395,28299,28110,27835,27499,27133,26774,26460,26222,26083,26060,26158,26378,26717,27163,27693,28269,28835,29329,29693,29887,29900,29749,29478,29140,28791,28475,28221,28045},
+    {28350,28266,28195,28136,28086,28038,27988,27928,27855,27766,27659,27538,27408,27278,27158,27059,26992,26966,26989,27064,27190,27362,27573,27810,28056,28294,28505,28674,28792,28853,28861,28822,28750,28655,28550,28446,28350},
+    {27826,27826,27826,27826,27826,27826,27826,27826,27826,27826,27826,27826,27826,27826,27826,27826,27826,27826,27826,27826,27826,27826,27826,27826,27826,27826,27826,27826,27826,27826,27826,27826,27826,27826,27826,27826,27826}
+};
+
+#else
+
 __EXTFLASHFUNC__ const float AP_Declination::declination_table[LAT_TABLE_SIZE][LON_TABLE_SIZE] = {
     {148.83402f,138.83401f,128.83401f,118.83402f,108.83402f,98.83402f,88.83402f,78.83402f,68.83402f,58.83402f,48.83402f,38.83402f,28.83402f,18.83402f,8.83402f,-1.16598f,-11.16598f,-21.16598f,-31.16598f,-41.16598f,-51.16598f,-61.16598f,-71.16598f,-81.16598f,-91.16598f,-101.16598f,-111.16598f,-121.16598f,-131.16598f,-141.16598f,-151.16598f,-161.16598f,-171.16598f,178.83402f,168.83402f,158.83402f,148.83402f},
     {129.09306f,116.89412f,105.78898f,95.63017f,86.23504f,77.42476f,69.04348f,60.96591f,53.09841f,45.37592f,37.75568f,30.20867f,22.70998f,15.23027f,7.73037f,0.16098f,-7.53238f,-15.40109f,-23.48496f,-31.80703f,-40.37375f,-49.18062f,-58.22152f,-67.49946f,-77.03640f,-86.88079f,-97.11212f,-107.84156f,-119.20626f,-131.35191f,-144.39481f,-158.35719f,-173.08769f,171.78274f,156.78187f,142.43310f,129.09306f},
@@ -75,3 +149,4 @@ __EXTFLASHFUNC__ const float AP_Declination::intensity_table[LAT_TABLE_SIZE][LON
     {0.56830f,0.56830f,0.56830f,0.56830f,0.56830f,0.56830f,0.56830f,0.56830f,0.56830f,0.56830f,0.56830f,0.56830f,0.56830f,0.56830f,0.56830f,0.56830f,0.56830f,0.56830f,0.56830f,0.56830f,0.56830f,0.56830f,0.56830f,0.56830f,0.56830f,0.56830f,0.56830f,0.56830f,0.56830f,0.56830f,0.56830f,0.56830f,0.56830f,0.56830f,0.56830f,0.56830f,0.56830f}
 };
 
+#endif // AP_DECLINATION_COMPRESSED_TABLE_ENABLED
@@ -0,0 +1,101 @@
+#include <AP_gtest.h>
+
+#include <AP_Math/AP_Math.h>
+#include <AP_Declination/AP_Declination.h>
+
+/*
+  check that the compressed 16 bit tables give the same field as the
+  float tables. The library is built with the float tables, and a
+  second copy of the tables is built here in compressed form
+ */
+#if AP_DECLINATION_COMPRESSED_TABLE_ENABLED
+#error "this test expects the library to be built with the float tables"
+#endif
+
+namespace compressed {
+
+// the members tables.cpp defines for the compressed tables
+struct Tables {
+    static const float SAMPLING_RES;
+    static const float SAMPLING_MIN_LAT;
+    static const float SAMPLING_MAX_LAT;
+    static const float SAMPLING_MIN_LON;
+    static const float SAMPLING_MAX_LON;
+
+    static const uint32_t LAT_TABLE_SIZE = 19;
+    static const uint32_t LON_TABLE_SIZE = 37;
+
+    static const float declination_scale;
+    static const float inclination_scale;
+    static const float intensity_scale;
+
+    static const int16_t declination_table[LAT_TABLE_SIZE][LON_TABLE_SIZE];
+    static const int16_t inclination_table[LAT_TABLE_SIZE][LON_TABLE_SIZE];
+    static const int16_t intensity_table[LAT_TABLE_SIZE][LON_TABLE_SIZE];
+};
+
+#undef AP_DECLINATION_COMPRESSED_TABLE_ENABLED
+#define AP_DECLINATION_COMPRESSED_TABLE_ENABLED 1
+#define AP_Declination Tables
+#include "../tables.cpp"
+#undef AP_Declination
+
+/*
+  bilinear interpolation of a compressed table, in the same way as
+  AP_Declination::get_mag_field_ef() for locations inside the tables
+ */
+static float lookup(const int16_t table[Tables::LAT_TABLE_SIZE][Tables::LON_TABLE_SIZE], float scale, float latitude_deg, float longitude_deg)
+{
+    const float res = Tables::SAMPLING_RES;
+    const uint32_t lat_index = uint32_t((latitude_deg - Tables::SAMPLING_MIN_LAT) / res);
+    const uint32_t lon_index = uint32_t((longitude_deg - Tables::SAMPLING_MIN_LON) / res);
+    const float lat_ratio = (latitude_deg - (Tables::SAMPLING_MIN_LAT + lat_index * res)) / res;
+    const float lon_ratio = (longitude_deg - (Tables::SAMPLING_MIN_LON + lon_index * res)) / res;
+
+    const float sw = table[lat_index][lon_index] * scale;
+    const float se = table[lat_index][lon_index+1] * scale;
+    const float nw = table[lat_index+1][lon_index] * scale;
+    const float ne = table[lat_index+1][lon_index+1] * scale;
+
+    const float south = sw + lon_ratio * (se - sw);
+    const float north = nw + lon_ratio * (ne - nw);
+    return south + lat_ratio * (north - south);
+}
+
+}  // namespace compressed
+
+using compressed::Tables;
+
+TEST(AP_Declination, CompressedTables)
+{
+    /*
+      each table entry is rounded to the nearest multiple of the
+      scale, so both the table nodes and the interpolated values
+      between them are within half a scale step of the float tables
+     */
+    float max_declination_err = 0;
+    float max_inclination_err = 0;
+    float max_intensity_err = 0;
+
+    for (float lat = -89.75f; lat < 90; lat += 0.5f) {
+        for (float lon = -179.75f; lon < 180; lon += 0.5f) {
+            float intensity, declination, inclination;
+            EXPECT_TRUE(AP_Declination::get_mag_field_ef(lat, lon, intensity, declination, inclination));
+
+            max_declination_err = MAX(max_declination_err, fabsf(declination - compressed::lookup(Tables::declination_table, Tables::declination_scale, lat, lon)));
+            max_inclination_err = MAX(max_inclination_err, fabsf(inclination - compressed::lookup(Tables::inclination_table, Tables::inclination_scale, lat, lon)));
+            max_intensity_err = MAX(max_intensity_err, fabsf(intensity - compressed::lookup(Tables::intensity_table, Tables::intensity_scale, lat, lon)));
+        }
+    }
+
+    EXPECT_LE(max_declination_err, Tables::declination_scale);
+    EXPECT_LE(max_inclination_err, Tables::inclination_scale);
+    EXPECT_LE(max_intensity_err, Tables::intensity_scale);
+
+    // the resolution given in AP_Declination_config.h
+    EXPECT_LT(max_declination_err, 0.01f);
+    EXPECT_LT(max_inclination_err, 0.01f);
+    EXPECT_LT(max_intensity_err, 0.00003f);
+}
+
+AP_GTEST_MAIN()
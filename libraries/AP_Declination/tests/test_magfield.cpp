@@ -123,6 +123,58 @@ TEST(MagField, test_field_error)
     }
 }
 
+/*
+  check a LocalField gives the same results as the static functions
+  over the whole globe, including the edges of the tables
+ */
+static void check_local_field(AP_Declination::LocalField &local, float lat, float lon)
+{
+    float intensity1, declination1, inclination1;
+    float intensity2, declination2, inclination2;
+    const bool ret1 = AP_Declination::get_mag_field_ef(lat, lon, intensity1, declination1, inclination1);
+    const bool ret2 = local.get_mag_field_ef(lat, lon, intensity2, declination2, inclination2);
+    EXPECT_EQ(ret1, ret2);
+    EXPECT_EQ(intensity1, intensity2);
+    EXPECT_EQ(declination1, declination2);
+    EXPECT_EQ(inclination1, inclination2);
+}
+
+TEST(MagField, local_field_scan)
+{
+    AP_Declination::LocalField local;
+    for (float lat = -90; lat <= 90; lat += 0.37) {
+        for (float lon = -180; lon <= 180; lon += 0.53) {
+            check_local_field(local, lat, lon);
+        }
+        check_local_field(local, lat, 180);
+    }
+    for (float lon = -180; lon <= 180; lon += 0.53) {
+        check_local_field(local, 90, lon);
+    }
+}
+
+TEST(MagField, local_field_random)
+{
+    AP_Declination::LocalField local;
+    uint32_t state = 1;
+    for (uint32_t i=0; i<100000; i++) {
+        state = state * 1664525U + 1013904223U;
+        // mostly small moves with occasional jumps across the globe
+        static float lat, lon;
+        if ((state >> 28) == 0) {
+            lat = int32_t(state % 180000) * 0.001 - 90;
+            lon = int32_t((state >> 8) % 360000) * 0.001 - 180;
+        } else {
+            lat = constrain_float(lat + int32_t(state % 2001 - 1000) * 0.0001, -90, 90);
+            lon = constrain_float(lon + int32_t((state >> 12) % 2001 - 1000) * 0.0001, -180, 180);
+        }
+        check_local_field(local, lat, lon);
+
+        const Location loc(lat*1.0e7, lon*1.0e7, 0, Location::AltFrame::ABSOLUTE);
+        EXPECT_EQ(AP_Declination::get_earth_field_ga(loc), local.get_earth_field_ga(loc));
+        EXPECT_EQ(AP_Declination::get_declination(lat, lon), local.get_declination(lat, lon));
+    }
+}
 
 AP_GTEST_MAIN()
 int hal = 0;
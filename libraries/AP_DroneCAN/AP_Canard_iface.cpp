@@ -103,11 +103,7 @@ bool CanardInterface::broadcast(const Canard::Transfer &bcast_transfer) {
         test_iface_sem.give();
     }
 #endif
-    if (ret <= 0) {
-        protocol_stats.tx_errors++;
-    } else {
-        protocol_stats.tx_frames += ret;
-    }
+    update_tx_protocol_stats(ret);
     return ret > 0;
 }
 
@@ -135,11 +131,7 @@ bool CanardInterface::request(uint8_t destination_node_id, const Canard::Transfe
     };
     // do canard request
     int16_t ret = canardRequestOrRespondObj(&canard, destination_node_id, &tx_transfer);
-    if (ret <= 0) {
-        protocol_stats.tx_errors++;
-    } else {
-        protocol_stats.tx_frames += ret;
-    }
+    update_tx_protocol_stats(ret);
     return ret > 0;
 }
 
@@ -167,11 +159,7 @@ bool CanardInterface::respond(uint8_t destination_node_id, const Canard::Transfe
     };
     // do canard respond
     int16_t ret = canardRequestOrRespondObj(&canard, destination_node_id, &tx_transfer);
-    if (ret <= 0) {
-        protocol_stats.tx_errors++;
-    } else {
-        protocol_stats.tx_frames += ret;
-    }
+    update_tx_protocol_stats(ret);
     return ret > 0;
 }
 
@@ -326,67 +314,132 @@ void CanardInterface::update_rx_protocol_stats(int16_t res)
     }
 }
 
-void CanardInterface::processRx() {
-    AP_HAL::CANFrame rxmsg;
-    for (uint8_t i=0; i<num_ifaces; i++) {
-        while(true) {
-            if (ifaces[i] == NULL) {
-                break;
-            }
-            bool read_select = true;
-            bool write_select = false;
-            ifaces[i]->select(read_select, write_select, nullptr, 0);
-            if (!read_select) { // No data pending
-                break;
-            }
-            CanardCANFrame rx_frame {};
+void CanardInterface::update_tx_protocol_stats(int16_t res)
+{
+    if (res > 0) {
+        protocol_stats.tx_frames += res;
+        return;
+    }
+    protocol_stats.tx_errors++;
+    if (res == -CANARD_ERROR_OUT_OF_MEMORY) {
+        tx_error_oom++;
+    }
+}
 
-            //palToggleLine(HAL_GPIO_PIN_LED);
-            uint64_t timestamp;
-            AP_HAL::CANIface::CanIOFlags flags;
-            if (ifaces[i]->receive(rxmsg, timestamp, flags) <= 0) {
-                break;
-            }
+/*
+  read up to max frames from an interface into rx_batch starting at
+  ofs, returning the number read. 11 bit frames are passed straight
+  to the auxillary driver
+ */
+uint8_t CanardInterface::read_rx_frames(uint8_t iface_index, uint8_t ofs, uint8_t max)
+{
+    AP_HAL::CANIface *iface = ifaces[iface_index];
+    if (iface == nullptr) {
+        return 0;
+    }
+    uint8_t n = 0;
+    while (n < max) {
+        bool read_select = true;
+        bool write_select = false;
+        iface->select(read_select, write_select, nullptr, 0);
+        if (!read_select) { // No data pending
+            break;
+        }
 
-            if (!rxmsg.isExtended()) {
-                // 11 bit frame, see if we have a handler
-                if (aux_11bit_driver != nullptr) {
-                    aux_11bit_driver->handle_frame(rxmsg);
-                }
-                continue;
+        AP_HAL::CANFrame rxmsg;
+        uint64_t timestamp;
+        AP_HAL::CANIface::CanIOFlags flags;
+        if (iface->receive(rxmsg, timestamp, flags) <= 0) {
+            break;
+        }
+
+        if (!rxmsg.isExtended()) {
+            // 11 bit frame, see if we have a handler
+            if (aux_11bit_driver != nullptr) {
+                aux_11bit_driver->receive_frame(rxmsg);
             }
+            continue;
+        }
 
-            rx_frame.data_len = AP_HAL::CANFrame::dlcToDataLength(rxmsg.dlc);
-            memcpy(rx_frame.data, rxmsg.data, rx_frame.data_len);
+        auto &entry = rx_batch[ofs + n];
+        CanardCANFrame &rx_frame = entry.frame;
+        rx_frame.data_len = AP_HAL::CANFrame::dlcToDataLength(rxmsg.dlc);
+        memcpy(rx_frame.data, rxmsg.data, rx_frame.data_len);
 #if HAL_CANFD_SUPPORTED
-            rx_frame.canfd = rxmsg.canfd;
+        rx_frame.canfd = rxmsg.canfd;
 #endif
-            rx_frame.id = rxmsg.id;
+        rx_frame.id = rxmsg.id;
 #if CANARD_MULTI_IFACE
-            rx_frame.iface_id = i;
+        rx_frame.iface_id = iface_index;
 #endif
-            {
-                WITH_SEMAPHORE(_sem_rx);
-
-                const int16_t res = canardHandleRxFrame(&canard, &rx_frame, timestamp);
-                if (res == -CANARD_ERROR_RX_MISSED_START) {
-                    // this might remaining frames from a message that we don't accept, so check
-                    uint64_t dummy_signature;
-                    if (shouldAcceptTransfer(&canard,
-                                        &dummy_signature,
-                                        extractDataType(rx_frame.id),
-                                        extractTransferType(rx_frame.id),
-                                        1)) { // doesn't matter what we pass here
-                        update_rx_protocol_stats(res);
-                    } else {
-                        protocol_stats.rx_ignored_not_wanted++;
-                    }
-                } else {
-                    update_rx_protocol_stats(res);
-                }
+        entry.timestamp_us = timestamp;
+        n++;
+    }
+    return n;
+}
+
+// pass a frame to libcanard, must be called with _sem_rx held
+void CanardInterface::handle_rx_frame(const CanardCANFrame &rx_frame, uint64_t timestamp_us)
+{
+    const int16_t res = canardHandleRxFrame(&canard, &rx_frame, timestamp_us);
+    if (res == -CANARD_ERROR_RX_MISSED_START) {
+        // this might remaining frames from a message that we don't accept, so check
+        uint64_t dummy_signature;
+        if (shouldAcceptTransfer(&canard,
+                            &dummy_signature,
+                            extractDataType(rx_frame.id),
+                            extractTransferType(rx_frame.id),
+                            1)) { // doesn't matter what we pass here
+            update_rx_protocol_stats(res);
+        } else {
+            protocol_stats.rx_ignored_not_wanted++;
+        }
+    } else {
+        update_rx_protocol_stats(res);
+    }
+}
+
+/*
+  handle all pending received frames. Frames are read from the
+  interfaces into a batch which is then handled with the rx semaphore
+  taken once, rather than once per frame. A full batch means there may
+  be more frames waiting, so we go around again
+ */
+void CanardInterface::processRx() {
+    uint16_t total = 0;
+    while (true) {
+        uint8_t n = 0;
+        for (uint8_t i=0; i<num_ifaces && n < ARRAY_SIZE(rx_batch); i++) {
+            n += read_rx_frames(i, n, ARRAY_SIZE(rx_batch) - n);
+        }
+        if (n == 0) {
+            break;
+        }
+        {
+            WITH_SEMAPHORE(_sem_rx);
+            for (uint8_t i=0; i<n; i++) {
+                handle_rx_frame(rx_batch[i].frame, rx_batch[i].timestamp_us);
             }
         }
+        total += n;
+        if (n < ARRAY_SIZE(rx_batch)) {
+            break;
+        }
+    }
+    rx_wakeup_max = MAX(rx_wakeup_max, total);
+}
+
+void CanardInterface::get_pool_stats(PoolStats &stats)
+{
+    {
+        WITH_SEMAPHORE(_sem_rx);
+        stats.pool = canardGetPoolAllocatorStatistics(&canard);
     }
+    stats.rx_error_oom = protocol_stats.rx_error_oom;
+    stats.tx_error_oom = tx_error_oom;
+    stats.rx_frames = protocol_stats.rx_frames;
+    stats.rx_wakeup_max = rx_wakeup_max;
+    rx_wakeup_max = 0;
 }
 
 void CanardInterface::process(uint32_t duration_ms) {
@@ -7,6 +7,12 @@
 class AP_DroneCAN;
 class CANSensor;
 
+// number of received frames read from the interfaces before they are
+// handled together with the rx semaphore held
+#ifndef DRONECAN_RX_BATCH_SIZE
+#define DRONECAN_RX_BATCH_SIZE 16
+#endif
+
 class CanardInterface : public Canard::Interface {
     friend class AP_DroneCAN;
 public:
@@ -62,6 +68,20 @@ public:
 #endif
 
     void update_rx_protocol_stats(int16_t res);
+    void update_tx_protocol_stats(int16_t res);
+
+    // memory pool and receive batching statistics
+    struct PoolStats {
+        CanardPoolAllocatorStatistics pool;
+        uint32_t rx_error_oom;      // frames dropped with the pool exhausted
+        uint32_t tx_error_oom;      // transfers dropped with the pool exhausted
+        uint32_t rx_frames;
+        uint16_t rx_wakeup_max;     // most frames handled in one processRx()
+    };
+
+    // get pool statistics. The receive wakeup maximum is reset so
+    // each call gives the maximum since the last call
+    void get_pool_stats(PoolStats &stats);
 
     uint8_t get_node_id() const override { return canard.node_id; }
 
@@ -69,6 +89,12 @@ public:
     HAL_Semaphore &get_sem_rx(void) { return _sem_rx; }
 
 private:
+    // read up to max frames from an interface into rx_batch
+    uint8_t read_rx_frames(uint8_t iface_index, uint8_t ofs, uint8_t max);
+
+    // pass one received frame to libcanard
+    void handle_rx_frame(const CanardCANFrame &rx_frame, uint64_t timestamp_us);
+
     CanardInstance canard;
     AP_HAL::CANIface* ifaces[HAL_NUM_CAN_IFACES];
 #if AP_TEST_DRONECAN_DRIVERS
@@ -82,6 +108,13 @@ private:
     HAL_Semaphore _sem_rx;
     CanardTxTransfer tx_transfer;
     dronecan_protocol_Stats protocol_stats;
+    uint32_t tx_error_oom;
+    uint16_t rx_wakeup_max;
+
+    struct RxBatchEntry {
+        CanardCANFrame frame;
+        uint64_t timestamp_us;
+    } rx_batch[DRONECAN_RX_BATCH_SIZE];
 
     // auxillary 11 bit CANSensor
     CANSensor *aux_11bit_driver;
@@ -1945,6 +1945,42 @@ void AP_DroneCAN::logging(void)
         return;
     }
     last_log_ms = now_ms;
+
+    CanardInterface::PoolStats pool_stats;
+    canard_iface.get_pool_stats(pool_stats);
+    const uint32_t oom_count = pool_stats.rx_error_oom + pool_stats.tx_error_oom;
+    if (oom_count != 0 && !_pool_exhausted_warned) {
+        _pool_exhausted_warned = true;
+        GCS_SEND_TEXT(MAV_SEVERITY_WARNING, "DroneCAN%u: memory pool exhausted, raise CAN_D%u_UC_POOL",
+                      unsigned(_driver_index+1), unsigned(_driver_index+1));
+    }
+
+// @LoggerMessage: CANP
+// @Description: DroneCAN memory pool and receive statistics
+// @Field: TimeUS: Time since system startup
+// @Field: I: driver index
+// @Field: Cap: pool capacity in blocks
+// @Field: Use: pool blocks in use
+// @Field: Peak: most pool blocks ever in use
+// @Field: ROom: received frames dropped as the pool was exhausted
+// @Field: TOom: transfers not sent as the pool was exhausted
+// @Field: RF: received frames handled
+// @Field: RMax: most received frames handled in one wakeup since the last message
+    AP::logger().WriteStreaming("CANP",
+                                "TimeUS,I,Cap,Use,Peak,ROom,TOom,RF,RMax",
+                                "s#-------",
+                                "F--------",
+                                "QBHHHIIIH",
+                                AP_HAL::micros64(),
+                                _driver_index,
+                                pool_stats.pool.capacity_blocks,
+                                pool_stats.pool.current_usage_blocks,
+                                pool_stats.pool.peak_usage_blocks,
+                                pool_stats.rx_error_oom,
+                                pool_stats.tx_error_oom,
+                                pool_stats.rx_frames,
+                                pool_stats.rx_wakeup_max);
+
     if (HAL_NUM_CAN_IFACES <= _driver_index) {
         // no interface?
         return;
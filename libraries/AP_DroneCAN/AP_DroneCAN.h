@@ -271,6 +271,9 @@ private:
     // last log time
     uint32_t last_log_ms;
 
+    // true once the user has been told the memory pool ran out
+    bool _pool_exhausted_warned;
+
 #if AP_DRONECAN_SEND_GPS
     // send GNSS Fix and yaw, same thing AP_GPS_DroneCAN would receive
     void gnss_send_fix();
@@ -68,6 +68,12 @@ int AP_Filesystem_Param::open(const char *fname, int flags, bool allow_absolute_
     r.read_size = 0;
     r.file_size = 0;
     r.writebuf = nullptr;
+#if AP_FILESYSTEM_PARAM_SNAPSHOT_ENABLED
+    r.delta = false;
+    r.delta_hash = 0;
+    r.snapshot_tried = false;
+    r.use_snapshot = false;
+#endif
     if (!read_only) {
         // setup for upload
         r.writebuf = NEW_NOTHROW ExpandingString();
@@ -115,9 +121,25 @@ int AP_Filesystem_Param::open(const char *fname, int flags, bool allow_absolute_
             c = strchr(c, '&');
             continue;
         }
+#endif
+#if AP_FILESYSTEM_PARAM_SNAPSHOT_ENABLED
+        if (strncmp(c, "delta=", 6) == 0) {
+            r.delta_hash = strtoul(c+6, nullptr, 16);
+            r.delta = true;
+            c += 6;
+            c = strchr(c, '&');
+            continue;
+        }
 #endif
     }
 
+#if AP_FILESYSTEM_PARAM_SNAPSHOT_ENABLED
+    if (r.delta && (!read_only || r.start != 0 || r.count != 0)) {
+        // a delta is always of the whole parameter set
+        goto failed;
+    }
+#endif
+
     return idx;
 
 failed:
@@ -140,6 +162,9 @@ int AP_Filesystem_Param::close(int fd)
         ret = -1;
     }
     r.open = false;
+#if AP_FILESYSTEM_PARAM_SNAPSHOT_ENABLED
+    snapshot_detach(r);
+#endif
     delete [] r.cursors;
     r.cursors = nullptr;
     delete r.writebuf;
@@ -166,43 +191,30 @@ int AP_Filesystem_Param::close(int fd)
     Any leading zero bytes after the header should be discarded as pad
     bytes. Pad bytes are used to ensure that a parameter data[] field
     does not cross a read packet boundary
+
+  delta format, from param.pck?delta=HASH with HASH in hex:
+    file header:
+      uint16_t magic = 0x671d or 0x671e for included default values
+      uint16_t num_params    // parameters in this file
+      uint16_t total_params  // parameters on the vehicle
+      uint32_t hash          // hash of the current parameter values
+
+    followed by parameters packed as above. If HASH is the hash from
+    a recent delta download then only the parameters which have
+    changed since that download are included, otherwise all
+    parameters are included, so a GCS can start with delta=0. A GCS
+    should fetch the full list if total_params doesn't match its
+    own count
  */
 
 /*
-  pack a single parameter. The buffer must be at least of size max_pack_len
+  encode a single parameter at file offset ofs. The buffer must be at
+  least of size max_pack_len
  */
-uint8_t AP_Filesystem_Param::pack_param(const struct rfile &r, struct cursor &c, uint8_t *buf)
+uint8_t AP_Filesystem_Param::encode_param(const AP_Param *ap, enum ap_var_type ptype, float default_val, bool with_defaults,
+                                          const char *name, const char *last_name, uint32_t ofs, uint16_t read_size, uint8_t *buf) const
 {
-    char name[AP_MAX_NAME_SIZE+1];
-    name[AP_MAX_NAME_SIZE] = 0;
-    enum ap_var_type ptype;
-    AP_Param *ap;
-    float default_val;
-
-    if (c.token_ofs == 0) {
-        c.idx = 0;
-        ap = AP_Param::first(&c.token, &ptype, &default_val);
-        uint16_t idx = 0;
-        while (idx < r.start && ap) {
-            ap = AP_Param::next_scalar(&c.token, &ptype, &default_val);
-            idx++;
-        }
-    } else {
-        c.idx++;
-        ap = AP_Param::next_scalar(&c.token, &ptype, &default_val);
-    }
-    if (ap == nullptr || (r.count && c.idx >= r.count)) {
-        if (r.count == 0 && c.idx != AP_Param::count_parameters()) {
-            // the parameter count is incorrect, invalidate so a
-            // repeated param download avoids an error
-            AP_Param::invalidate_count();
-        }
-        return 0;
-    }
-    ap->copy_name_token(c.token, name, AP_MAX_NAME_SIZE, true);
-
     uint8_t common_len = 0;
-    const char *last_name = c.last_name;
     const char *pname = name;
     while (*pname == *last_name && *pname) {
         common_len++;
@@ -216,7 +228,7 @@ uint8_t AP_Filesystem_Param::pack_param(const struct rfile &r, struct cursor &c,
         pname--;
     }
 #if AP_PARAM_DEFAULTS_ENABLED
-    const bool add_default = r.with_defaults && !is_equal(ap->cast_to_float(ptype), default_val);
+    const bool add_default = with_defaults && !is_equal(ap->cast_to_float(ptype), default_val);
 #else
     const bool add_default = false;
 #endif
@@ -230,8 +242,7 @@ uint8_t AP_Filesystem_Param::pack_param(const struct rfile &r, struct cursor &c,
       won't get a corrupt value for a parameter
      */
     if (type_len > 1) {
-        const uint32_t ofs = c.token_ofs + sizeof(struct header) + packed_len;
-        const uint32_t ofs_mod = ofs % r.read_size;
+        const uint32_t ofs_mod = (ofs + packed_len) % read_size;
         if (ofs_mod > 0 && ofs_mod < type_len) {
             const uint8_t pad = type_len - ofs_mod;
             memset(buf, 0, pad);
@@ -275,6 +286,45 @@ uint8_t AP_Filesystem_Param::pack_param(const struct rfile &r, struct cursor &c,
     }
 #endif
 
+    return packed_len;
+}
+
+/*
+  pack a single parameter. The buffer must be at least of size max_pack_len
+ */
+uint8_t AP_Filesystem_Param::pack_param(const struct rfile &r, struct cursor &c, uint8_t *buf)
+{
+    char name[AP_MAX_NAME_SIZE+1];
+    name[AP_MAX_NAME_SIZE] = 0;
+    enum ap_var_type ptype;
+    AP_Param *ap;
+    float default_val;
+
+    if (c.token_ofs == 0) {
+        c.idx = 0;
+        ap = AP_Param::first(&c.token, &ptype, &default_val);
+        uint16_t idx = 0;
+        while (idx < r.start && ap) {
+            ap = AP_Param::next_scalar(&c.token, &ptype, &default_val);
+            idx++;
+        }
+    } else {
+        c.idx++;
+        ap = AP_Param::next_scalar(&c.token, &ptype, &default_val);
+    }
+    if (ap == nullptr || (r.count && c.idx >= r.count)) {
+        if (r.count == 0 && c.idx != AP_Param::count_parameters()) {
+            // the parameter count is incorrect, invalidate so a
+            // repeated param download avoids an error
+            AP_Param::invalidate_count();
+        }
+        return 0;
+    }
+    ap->copy_name_token(c.token, name, AP_MAX_NAME_SIZE, true);
+
+    const uint8_t packed_len = encode_param(ap, ptype, default_val, r.with_defaults, name, c.last_name,
+                                            c.token_ofs + sizeof(struct header), r.read_size, buf);
+
     strcpy(c.last_name, name);
 
     return packed_len;
@@ -348,6 +398,24 @@ int32_t AP_Filesystem_Param::read(int fd, void *buf, uint32_t count)
         return -1;
     }
 
+#if AP_FILESYSTEM_PARAM_SNAPSHOT_ENABLED
+    if (!r.snapshot_tried && r.read_size != 0 && r.start == 0 && r.count == 0) {
+        bool busy = false;
+        r.use_snapshot = snapshot_attach(r, busy);
+        // a delta can try again once the snapshot is free
+        r.snapshot_tried = !(busy && r.delta);
+    }
+    if (r.use_snapshot) {
+        return snapshot_read(r, buf, count);
+    }
+    if (r.delta) {
+        // deltas are only available from a snapshot, which is either
+        // being read with other options or couldn't be allocated
+        errno = r.snapshot_tried ? ENOMEM : EAGAIN;
+        return -1;
+    }
+#endif
+
     if (r.file_size != 0) {
         // ensure we don't try to read past EOF
         if (r.file_ofs > r.file_size) {
@@ -450,6 +518,242 @@ int32_t AP_Filesystem_Param::read(int fd, void *buf, uint32_t count)
     return total + header_total;
 }
 
+#if AP_FILESYSTEM_PARAM_SNAPSHOT_ENABLED
+/*
+  attach a file to the snapshot, regenerating it if it is out of date
+  and not in use by another file. Returns false if the file should use
+  the cursors instead, with busy set if that is because another file
+  is reading the snapshot
+ */
+bool AP_Filesystem_Param::snapshot_attach(struct rfile &r, bool &busy)
+{
+    WITH_SEMAPHORE(snapshot_sem);
+
+    const bool valid = snapshot.buf != nullptr &&
+        snapshot.change_marker == AP_Param::get_change_marker();
+    if (valid &&
+        snapshot.read_size == r.read_size &&
+        snapshot.with_defaults == r.with_defaults &&
+        snapshot.delta == r.delta &&
+        (!r.delta || snapshot.delta_hash == r.delta_hash)) {
+        snapshot.refs++;
+        return true;
+    }
+    if (snapshot.refs > 0) {
+        // another file is reading a snapshot with different options
+        busy = true;
+        return false;
+    }
+    delete snapshot.buf;
+    snapshot.buf = nullptr;
+    if (!snapshot_build(r)) {
+        delete snapshot.buf;
+        snapshot.buf = nullptr;
+        return false;
+    }
+    snapshot.read_size = r.read_size;
+    snapshot.with_defaults = r.with_defaults;
+    snapshot.delta = r.delta;
+    snapshot.delta_hash = r.delta_hash;
+    snapshot.refs = 1;
+    return true;
+}
+
+/*
+  detach a file from the snapshot, freeing it if no other file is
+  reading it
+ */
+void AP_Filesystem_Param::snapshot_detach(struct rfile &r)
+{
+    if (!r.use_snapshot) {
+        return;
+    }
+    r.use_snapshot = false;
+    WITH_SEMAPHORE(snapshot_sem);
+    if (--snapshot.refs == 0) {
+        delete snapshot.buf;
+        snapshot.buf = nullptr;
+    }
+}
+
+/*
+  generate the whole packed file for the options of a file in one pass
+ */
+bool AP_Filesystem_Param::snapshot_build(const struct rfile &r)
+{
+    snapshot.buf = NEW_NOTHROW ExpandingString();
+    if (snapshot.buf == nullptr) {
+        return false;
+    }
+    // values may change while we pack them, so take the marker first
+    snapshot.change_marker = AP_Param::get_change_marker();
+    const uint16_t total_params = AP_Param::count_parameters();
+
+    uint32_t hash = 0;
+    int32_t since_gen = -1;
+    if (r.delta && tracker_update(total_params, hash)) {
+        since_gen = tracker_find(r.delta_hash);
+    }
+
+    const uint8_t header_len = r.delta ? sizeof(struct delta_header) : sizeof(struct header);
+    if (!snapshot.buf->append(nullptr, header_len)) {
+        return false;
+    }
+
+    char last_name[AP_MAX_NAME_SIZE+1] {};
+    char name[AP_MAX_NAME_SIZE+1];
+    name[AP_MAX_NAME_SIZE] = 0;
+    AP_Param::ParamToken token;
+    enum ap_var_type ptype;
+    float default_val;
+    uint16_t idx = 0;
+    uint16_t num_params = 0;
+
+    for (AP_Param *ap = AP_Param::first(&token, &ptype, &default_val);
+         ap != nullptr;
+         ap = AP_Param::next_scalar(&token, &ptype, &default_val), idx++) {
+        if (since_gen >= 0 && idx < tracker.count && tracker.changed_gen[idx] <= since_gen) {
+            // unchanged since the GCS hash
+            continue;
+        }
+        ap->copy_name_token(token, name, AP_MAX_NAME_SIZE, true);
+        uint8_t pbuf[max_pack_len];
+        const uint8_t len = encode_param(ap, ptype, default_val, r.with_defaults, name, last_name,
+                                         snapshot.buf->get_length(), r.read_size, pbuf);
+        if (!snapshot.buf->append((const char *)pbuf, len)) {
+            return false;
+        }
+        strcpy(last_name, name);
+        num_params++;
+    }
+    if (idx != total_params) {
+        // the parameter count is incorrect, invalidate so a repeated
+        // param download avoids an error
+        AP_Param::invalidate_count();
+    }
+
+    uint8_t *b = (uint8_t *)snapshot.buf->get_writeable_string();
+    if (r.delta) {
+        struct delta_header hdr;
+        if (r.with_defaults) {
+            hdr.magic = pmagic_delta_with_default;
+        }
+        hdr.num_params = num_params;
+        hdr.total_params = idx;
+        hdr.hash = hash;
+        memcpy(b, &hdr, sizeof(hdr));
+    } else {
+        struct header hdr;
+        if (r.with_defaults) {
+            hdr.magic = pmagic_with_default;
+        }
+        hdr.num_params = num_params;
+        hdr.total_params = total_params;
+        memcpy(b, &hdr, sizeof(hdr));
+    }
+    return true;
+}
+
+/*
+  read from the snapshot, which is a copy at any offset
+ */
+int32_t AP_Filesystem_Param::snapshot_read(struct rfile &r, void *buf, uint32_t count)
+{
+    const uint32_t length = snapshot.buf->get_length();
+    if (r.file_ofs >= length) {
+        return 0;
+    }
+    count = MIN(count, length - r.file_ofs);
+    memcpy(buf, snapshot.buf->get_string() + r.file_ofs, count);
+    r.file_ofs += count;
+    return count;
+}
+
+/*
+  update the per-parameter hashes, marking the parameters whose value
+  has changed with a new generation. hash is set to a hash of all of
+  the parameters, which is remembered with the generation
+ */
+bool AP_Filesystem_Param::tracker_update(uint16_t total_params, uint32_t &hash)
+{
+    bool changed = false;
+    if (tracker.count != total_params || tracker.generation == UINT8_MAX) {
+        // the parameter tree has changed, start again
+        delete [] tracker.item_hash;
+        delete [] tracker.changed_gen;
+        memset(&tracker, 0, sizeof(tracker));
+        if (total_params > delta_max_params) {
+            return false;
+        }
+        tracker.item_hash = NEW_NOTHROW uint32_t[total_params];
+        tracker.changed_gen = NEW_NOTHROW uint8_t[total_params];
+        if (tracker.item_hash == nullptr || tracker.changed_gen == nullptr) {
+            delete [] tracker.item_hash;
+            delete [] tracker.changed_gen;
+            memset(&tracker, 0, sizeof(tracker));
+            return false;
+        }
+        tracker.count = total_params;
+        changed = true;
+    }
+    const uint8_t gen = tracker.generation + 1;
+
+    char name[AP_MAX_NAME_SIZE+1];
+    name[AP_MAX_NAME_SIZE] = 0;
+    AP_Param::ParamToken token;
+    enum ap_var_type ptype;
+    uint16_t idx = 0;
+    hash = 0;
+
+    for (AP_Param *ap = AP_Param::first(&token, &ptype);
+         ap != nullptr && idx < tracker.count;
+         ap = AP_Param::next_scalar(&token, &ptype), idx++) {
+        ap->copy_name_token(token, name, AP_MAX_NAME_SIZE, true);
+        const uint8_t type = ptype;
+        uint32_t h = crc_crc32(0, (const uint8_t *)name, strlen(name));
+        h = crc_crc32(h, &type, 1);
+        h = crc_crc32(h, (const uint8_t *)ap, AP_Param::type_size(ptype));
+        if (changed || h != tracker.item_hash[idx]) {
+            tracker.item_hash[idx] = h;
+            tracker.changed_gen[idx] = gen;
+            changed = true;
+        }
+        hash = crc_crc32(hash, (const uint8_t *)&h, sizeof(h));
+    }
+    if (changed) {
+        tracker.generation = gen;
+    }
+
+    // remember this hash, replacing an older entry for the same values
+    uint8_t i;
+    for (i=0; i<delta_history_len; i++) {
+        if (tracker.history[i].generation != 0 && tracker.history[i].hash == hash) {
+            break;
+        }
+    }
+    if (i == delta_history_len) {
+        i = tracker.history_next;
+        tracker.history_next = (tracker.history_next + 1) % delta_history_len;
+    }
+    tracker.history[i].hash = hash;
+    tracker.history[i].generation = tracker.generation;
+    return true;
+}
+
+/*
+  find the generation for a hash from a previous delta download, or -1
+ */
+int32_t AP_Filesystem_Param::tracker_find(uint32_t hash) const
+{
+    for (uint8_t i=0; i<delta_history_len; i++) {
+        if (tracker.history[i].generation != 0 && tracker.history[i].hash == hash) {
+            return tracker.history[i].generation;
+        }
+    }
+    return -1;
+}
+#endif  // AP_FILESYSTEM_PARAM_SNAPSHOT_ENABLED
+
 int32_t AP_Filesystem_Param::lseek(int fd, int32_t offset, int seek_from)
 {
     if (fd < 0 || fd >= max_open_file || !file[fd].open) {
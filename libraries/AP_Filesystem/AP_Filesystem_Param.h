@@ -57,6 +57,27 @@ private:
         uint16_t total_params; // for upload this is total file length
     };
 
+#if AP_FILESYSTEM_PARAM_SNAPSHOT_ENABLED
+    // magic for param.pck?delta=HASH downloads
+    static constexpr uint16_t pmagic_delta = 0x671d;
+    static constexpr uint16_t pmagic_delta_with_default = 0x671e;
+
+    // header at front of a delta file
+    struct PACKED delta_header {
+        uint16_t magic = pmagic_delta;
+        uint16_t num_params;
+        uint16_t total_params;
+        uint32_t hash;
+    };
+
+    // number of delta hashes remembered
+    static constexpr uint8_t delta_history_len = 8;
+
+    // vehicles with more parameters than this always get full deltas,
+    // bounding the memory kept between delta downloads
+    static constexpr uint16_t delta_max_params = 2000;
+#endif
+
     struct cursor {
         AP_Param::ParamToken token;
         uint32_t token_ofs;
@@ -76,10 +97,61 @@ private:
         uint32_t file_size;
         struct cursor *cursors;
         ExpandingString *writebuf; // for upload
+#if AP_FILESYSTEM_PARAM_SNAPSHOT_ENABLED
+        bool delta;
+        bool snapshot_tried;
+        bool use_snapshot;
+        uint32_t delta_hash;
+#endif
     } file[max_open_file];
 
+#if AP_FILESYSTEM_PARAM_SNAPSHOT_ENABLED
+    /*
+      the whole packed file for one set of options, generated in a
+      single pass on the first read and shared by all open files
+      which use the same options. Freed when the last of them closes
+     */
+    struct {
+        ExpandingString *buf;
+        uint32_t change_marker;
+        uint32_t delta_hash;
+        uint16_t read_size;
+        bool with_defaults;
+        bool delta;
+        uint8_t refs;
+    } snapshot;
+    HAL_Semaphore snapshot_sem;
+
+    /*
+      hash of each parameter and the generation in which it last
+      changed, used to find the parameters changed since the hash
+      given in a delta download. Only allocated once a delta has been
+      requested, and kept between downloads
+     */
+    struct {
+        uint32_t *item_hash;
+        uint8_t *changed_gen;
+        uint16_t count;
+        uint8_t generation;
+        struct {
+            uint32_t hash;
+            uint8_t generation;
+        } history[delta_history_len];
+        uint8_t history_next;
+    } tracker;
+
+    bool snapshot_attach(struct rfile &r, bool &busy);
+    void snapshot_detach(struct rfile &r);
+    bool snapshot_build(const struct rfile &r);
+    int32_t snapshot_read(struct rfile &r, void *buf, uint32_t count);
+    bool tracker_update(uint16_t total_params, uint32_t &hash);
+    int32_t tracker_find(uint32_t hash) const;
+#endif
+
     bool token_seek(const struct rfile &r, const uint32_t data_ofs, struct cursor &c);
     uint8_t pack_param(const struct rfile &r, struct cursor &c, uint8_t *buf);
+    uint8_t encode_param(const AP_Param *ap, enum ap_var_type ptype, float default_val, bool with_defaults,
+                         const char *name, const char *last_name, uint32_t ofs, uint16_t read_size, uint8_t *buf) const;
     bool check_file_name(const char *fname);
 
     // finish uploading parameters
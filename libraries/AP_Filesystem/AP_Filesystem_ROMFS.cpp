@@ -36,7 +36,7 @@ int AP_Filesystem_ROMFS::open(const char *fname, int flags, bool allow_absolute_
     WITH_SEMAPHORE(record_sem); // search for free file record
     uint8_t idx;
     for (idx=0; idx<max_open_file; idx++) {
-        if (file[idx].data == nullptr) {
+        if (!file_in_use(idx)) {
             break;
         }
     }
@@ -44,23 +44,49 @@ int AP_Filesystem_ROMFS::open(const char *fname, int flags, bool allow_absolute_
         errno = ENFILE;
         return -1;
     }
-    file[idx].data = AP_ROMFS::find_decompress(fname, file[idx].size);
-    if (file[idx].data == nullptr) {
-        errno = ENOENT;
-        return -1;
+    // files embedded in blocks are decompressed as they are read
+    file[idx].blocks = AP_ROMFS::find_block_file(fname);
+    if (file[idx].blocks != nullptr) {
+        file[idx].size = file[idx].blocks->decompressed_size;
+        file[idx].crc = 0;
+        file[idx].crc_ofs = 0;
+    } else {
+        file[idx].data = AP_ROMFS::find_decompress(fname, file[idx].size);
+        if (file[idx].data == nullptr) {
+            errno = ENOENT;
+            return -1;
+        }
     }
     file[idx].ofs = 0;
     return idx;
 }
 
+bool AP_Filesystem_ROMFS::file_in_use(int fd) const
+{
+    return fd >= 0 && fd < max_open_file &&
+        (file[fd].data != nullptr || file[fd].blocks != nullptr);
+}
+
 int AP_Filesystem_ROMFS::close(int fd)
 {
-    if (fd < 0 || fd >= max_open_file || file[fd].data == nullptr) {
+    if (!file_in_use(fd)) {
         errno = EBADF;
         return -1;
     }
 
     WITH_SEMAPHORE(record_sem); // release file record
+    if (file[fd].blocks != nullptr) {
+        file[fd].blocks = nullptr;
+        // free the cache once no blocked files are open
+        bool blocks_open = false;
+        for (uint8_t i=0; i<max_open_file; i++) {
+            blocks_open |= file[i].blocks != nullptr;
+        }
+        if (!blocks_open) {
+            free_block_cache();
+        }
+        return 0;
+    }
     AP_ROMFS::free(file[fd].data);
     file[fd].data = nullptr;
     return 0;
@@ -68,7 +94,7 @@ int AP_Filesystem_ROMFS::close(int fd)
 
 int32_t AP_Filesystem_ROMFS::read(int fd, void *buf, uint32_t count)
 {
-    if (fd < 0 || fd >= max_open_file || file[fd].data == nullptr) {
+    if (!file_in_use(fd)) {
         errno = EBADF;
         return -1;
     }
@@ -76,11 +102,106 @@ int32_t AP_Filesystem_ROMFS::read(int fd, void *buf, uint32_t count)
     if (count == 0) {
         return 0;
     }
+    if (file[fd].blocks != nullptr) {
+        const int32_t ret = read_blocks(file[fd], (uint8_t *)buf, count);
+        if (ret > 0) {
+            file[fd].ofs += ret;
+        }
+        return ret;
+    }
     memcpy(buf, &file[fd].data[file[fd].ofs], count);
     file[fd].ofs += count;
     return count;
 }
 
+/*
+  return a decompressed block, from the cache if possible, otherwise
+  by decompressing into the least recently used cache entry. Must be
+  called with block_sem held
+ */
+const AP_Filesystem_ROMFS::cached_block *AP_Filesystem_ROMFS::get_block(const AP_ROMFS::embedded_file *f, uint32_t block)
+{
+    cached_block *lru = &block_cache[0];
+    for (auto &cb : block_cache) {
+        if (cb.f == f && cb.block == block) {
+            cb.last_use = ++block_use_counter;
+            return &cb;
+        }
+        if (cb.last_use < lru->last_use) {
+            lru = &cb;
+        }
+    }
+
+    if (lru->data == nullptr || lru->capacity < f->block_size) {
+        free(lru->data);
+        lru->data = (uint8_t *)malloc(f->block_size);
+        lru->capacity = lru->data != nullptr ? f->block_size : 0;
+    }
+    lru->f = nullptr;
+    lru->last_use = 0;
+    if (lru->data == nullptr) {
+        return nullptr;
+    }
+    const int32_t length = AP_ROMFS::decompress_block(f, block, lru->data);
+    if (length < 0) {
+        return nullptr;
+    }
+    lru->f = f;
+    lru->block = block;
+    lru->length = length;
+    lru->last_use = ++block_use_counter;
+    return lru;
+}
+
+/*
+  read from the current offset of a blocked file, decompressing only
+  the blocks covering the range. Fails with EIO if the read completes
+  a file read in order whose contents don't match the stored CRC
+ */
+int32_t AP_Filesystem_ROMFS::read_blocks(rfile &r, uint8_t *buf, uint32_t count)
+{
+    WITH_SEMAPHORE(block_sem);
+    const uint32_t block_size = r.blocks->block_size;
+    uint32_t done = 0;
+    while (done < count) {
+        const uint32_t ofs = r.ofs + done;
+        const uint32_t block_ofs = ofs % block_size;
+        const cached_block *cb = get_block(r.blocks, ofs / block_size);
+        if (cb == nullptr || block_ofs >= cb->length) {
+            break;
+        }
+        const uint32_t n = MIN(cb->length - block_ofs, count - done);
+        memcpy(&buf[done], &cb->data[block_ofs], n);
+        done += n;
+        // check the CRC of the whole file once it has all been read
+        // in order. Blocks are not checked individually
+        if (ofs <= r.crc_ofs && r.crc_ofs < ofs + n) {
+            const uint32_t skip = r.crc_ofs - ofs;
+            r.crc = crc32_small(r.crc, &cb->data[block_ofs+skip], n - skip);
+            r.crc_ofs += n - skip;
+            if (r.crc_ofs == r.size && r.crc != r.blocks->crc) {
+                errno = EIO;
+                return -1;
+            }
+        }
+    }
+    if (done == 0) {
+        errno = EIO;
+        return -1;
+    }
+    return done;
+}
+
+void AP_Filesystem_ROMFS::free_block_cache()
+{
+    WITH_SEMAPHORE(block_sem);
+    for (auto &cb : block_cache) {
+        free(cb.data);
+        cb = {};
+    }
+    block_use_counter = 0;
+}
+
 int32_t AP_Filesystem_ROMFS::write(int fd, const void *buf, uint32_t count)
 {
     errno = EROFS;
@@ -94,7 +215,7 @@ int AP_Filesystem_ROMFS::fsync(int fd)
 
 int32_t AP_Filesystem_ROMFS::lseek(int fd, int32_t offset, int seek_from)
 {
-    if (fd < 0 || fd >= max_open_file || file[fd].data == nullptr) {
+    if (!file_in_use(fd)) {
         errno = EBADF;
         return -1;
     }
@@ -20,6 +20,7 @@
 #if AP_FILESYSTEM_ROMFS_ENABLED
 
 #include <AP_HAL/Semaphores.h>
+#include <AP_ROMFS/AP_ROMFS.h>
 
 #include "AP_Filesystem_backend.h"
 
@@ -65,11 +66,40 @@ private:
     static constexpr uint8_t max_open_file = 4;
     static constexpr uint8_t max_open_dir = 4;
     struct rfile {
+        // fully decompressed contents, or a file embedded in blocks
+        // which is read through the block cache
         const uint8_t *data;
+        const AP_ROMFS::embedded_file *blocks;
         uint32_t size;
         uint32_t ofs;
+        // CRC of a blocked file up to crc_ofs, checked against the
+        // stored CRC when the end of the file is reached
+        uint32_t crc;
+        uint32_t crc_ofs;
     } file[max_open_file];
 
+    bool file_in_use(int fd) const;
+
+    /*
+      cache of decompressed blocks shared by all open files. Buffers
+      are allocated on first use and freed when the last blocked file
+      is closed
+     */
+    HAL_Semaphore block_sem;
+    struct cached_block {
+        const AP_ROMFS::embedded_file *f;
+        uint32_t block;
+        uint32_t length;
+        uint32_t capacity;
+        uint32_t last_use;
+        uint8_t *data;
+    } block_cache[AP_FILESYSTEM_ROMFS_BLOCK_CACHE_SIZE];
+    uint32_t block_use_counter;
+
+    const cached_block *get_block(const AP_ROMFS::embedded_file *f, uint32_t block);
+    int32_t read_blocks(rfile &r, uint8_t *buf, uint32_t count);
+    void free_block_cache();
+
     // allow up to 4 directory opens
     struct rdir {
         char *path;
@@ -26,6 +26,10 @@
 #include <AP_CANManager/AP_CANManager.h>
 #include <AP_Scheduler/AP_Scheduler.h>
 #include <AP_Common/ExpandingString.h>
+#include <AP_DDS/AP_DDS_config.h>
+#if AP_DDS_ENABLED
+#include <AP_DDS/AP_DDS_Client.h>
+#endif
 
 extern const AP_HAL::HAL& hal;
 
@@ -40,6 +44,9 @@ static const SysFileList sysfs_file_list[] = {
     {"memory.txt"},
     {"uarts.txt"},
     {"timers.txt"},
+#if AP_DDS_ENABLED
+    {"dds.txt"},
+#endif
 #if HAL_MAX_CAN_PROTOCOL_DRIVERS
     {"can_log.txt"},
 #endif
@@ -120,6 +127,14 @@ int AP_Filesystem_Sys::open(const char *fname, int flags, bool allow_absolute_pa
     if (strcmp(fname, "timers.txt") == 0) {
         hal.util->timer_info(*r.str);
     }
+#if AP_DDS_ENABLED
+    if (strcmp(fname, "dds.txt") == 0) {
+        AP_DDS_Client *dds = AP_DDS_Client::get_singleton();
+        if (dds != nullptr) {
+            dds->pub_info(*r.str);
+        }
+    }
+#endif
 #if HAL_CANMANAGER_ENABLED
     if (strcmp(fname, "can_log.txt") == 0) {
         AP::can().log_retrieve(*r.str);
@@ -28,6 +28,12 @@
 #define AP_FILESYSTEM_PARAM_ENABLED 1
 #endif
 
+// cache the packed parameter file on the first read so that reads at
+// any offset are a copy, and allow param.pck?delta=HASH downloads
+#ifndef AP_FILESYSTEM_PARAM_SNAPSHOT_ENABLED
+#define AP_FILESYSTEM_PARAM_SNAPSHOT_ENABLED (AP_FILESYSTEM_PARAM_ENABLED && HAL_MEM_CLASS >= HAL_MEM_CLASS_500)
+#endif
+
 #ifndef AP_FILESYSTEM_POSIX_ENABLED
 #define AP_FILESYSTEM_POSIX_ENABLED (CONFIG_HAL_BOARD == HAL_BOARD_SITL || CONFIG_HAL_BOARD == HAL_BOARD_LINUX || CONFIG_HAL_BOARD == HAL_BOARD_QURT)
 #endif
@@ -36,6 +42,12 @@
 #define AP_FILESYSTEM_ROMFS_ENABLED defined(HAL_HAVE_AP_ROMFS_EMBEDDED_H)
 #endif
 
+#ifndef AP_FILESYSTEM_ROMFS_BLOCK_CACHE_SIZE
+// number of decompressed blocks kept for reads of ROMFS files which
+// are embedded in blocks
+#define AP_FILESYSTEM_ROMFS_BLOCK_CACHE_SIZE 2
+#endif
+
 #ifndef AP_FILESYSTEM_SYS_ENABLED
 #define AP_FILESYSTEM_SYS_ENABLED 1
 #endif
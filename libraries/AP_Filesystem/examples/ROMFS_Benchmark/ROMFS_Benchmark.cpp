@@ -0,0 +1,115 @@
+/*
+  ROMFS open and read latency benchmark
+
+  For every file in @ROMFS this times opening the file and reading
+  its first bytes, then reading the whole file sequentially. Build
+  once normally and once with --romfs-block-size to compare whole
+  file decompression on open against block decompression:
+
+    ./waf configure --board sitl --romfs-block-size 4096
+    ./waf --target examples/ROMFS_Benchmark
+    ./build/sitl/examples/ROMFS_Benchmark
+ */
+
+#include <AP_HAL/AP_HAL.h>
+#include <AP_Filesystem/AP_Filesystem.h>
+#include <AP_Math/AP_Math.h>
+#include <stdio.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+void setup();
+void loop();
+
+static constexpr uint8_t repeats = 20;
+static constexpr uint16_t first_read_len = 128;
+
+struct Totals {
+    uint32_t files;
+    uint64_t bytes;
+    uint64_t first_read_us;
+    uint64_t full_read_us;
+} totals;
+
+static uint8_t buf[1024];
+
+// open a file and read up to len bytes, returning the time taken
+static uint32_t time_read(const char *path, uint32_t len, uint32_t &nread)
+{
+    const uint64_t start_us = AP_HAL::micros64();
+    const int fd = AP::FS().open(path, O_RDONLY);
+    if (fd == -1) {
+        return 0;
+    }
+    nread = 0;
+    while (nread < len) {
+        const int32_t n = AP::FS().read(fd, buf, MIN(sizeof(buf), len - nread));
+        if (n <= 0) {
+            break;
+        }
+        nread += n;
+    }
+    AP::FS().close(fd);
+    return AP_HAL::micros64() - start_us;
+}
+
+static void benchmark_file(const char *path)
+{
+    uint32_t first_us = 0;
+    uint32_t full_us = 0;
+    uint32_t size = 0;
+    uint32_t n;
+    for (uint8_t i=0; i<repeats; i++) {
+        first_us += time_read(path, first_read_len, n);
+        full_us += time_read(path, UINT32_MAX, size);
+    }
+    first_us /= repeats;
+    full_us /= repeats;
+    hal.console->printf("%-40s %8u bytes  first %6u us  full %7u us\n",
+                        path, unsigned(size), unsigned(first_us), unsigned(full_us));
+    totals.files++;
+    totals.bytes += size;
+    totals.first_read_us += first_us;
+    totals.full_read_us += full_us;
+}
+
+static void benchmark_dir(const char *dirname)
+{
+    auto *d = AP::FS().opendir(dirname);
+    if (d == nullptr) {
+        return;
+    }
+    struct dirent *de;
+    while ((de = AP::FS().readdir(d)) != nullptr) {
+        char path[128];
+        snprintf(path, sizeof(path), "%s/%s", dirname, de->d_name);
+        if (de->d_type == DT_DIR) {
+            benchmark_dir(path);
+        } else {
+            benchmark_file(path);
+        }
+    }
+    AP::FS().closedir(d);
+}
+
+void setup()
+{
+    hal.console->printf("ROMFS benchmark, %u repeats per file\n", unsigned(repeats));
+    benchmark_dir("@ROMFS");
+    if (totals.files == 0) {
+        hal.console->printf("No ROMFS files\n");
+        return;
+    }
+    hal.console->printf("%u files, %u bytes: mean first read %u us, mean full read %u us\n",
+                        unsigned(totals.files),
+                        unsigned(totals.bytes),
+                        unsigned(totals.first_read_us / totals.files),
+                        unsigned(totals.full_read_us / totals.files));
+}
+
+void loop()
+{
+    hal.scheduler->delay(1000);
+}
+
+AP_HAL_MAIN();
@@ -95,9 +95,26 @@ bool AP_FlashStorage::init(void)
         first_sector = 0;
     }
 
+    /*
+      if a compaction finished before the full sector was erased then
+      the sector in use holds all of storage, and the full sector
+      doesn't need to be read or written out again
+     */
+    bool full_sector_compacted = false;
+    if (states[first_sector] == SECTOR_STATE_FULL &&
+        states[first_sector^1] == SECTOR_STATE_IN_USE) {
+        if (!load_sector(first_sector^1, false)) {
+            return erase_all();
+        }
+        full_sector_compacted = summary_found;
+    }
+
     // load data from any current sectors
     for (uint8_t i=0; i<2; i++) {
         uint8_t sector = (first_sector + i) & 1;
+        if (full_sector_compacted && sector == first_sector) {
+            continue;
+        }
         if (states[sector] == SECTOR_STATE_IN_USE ||
             states[sector] == SECTOR_STATE_FULL) {
             if (!load_sector(sector)) {
@@ -109,9 +126,10 @@ bool AP_FlashStorage::init(void)
     // clear any write error
     write_error = false;
     reserved_space = 0;
+    compact_state = CompactState::IDLE;
     
     // if the first sector is full then write out all data so we can erase it
-    if (states[first_sector] == SECTOR_STATE_FULL) {
+    if (states[first_sector] == SECTOR_STATE_FULL && !full_sector_compacted) {
         current_sector = first_sector ^ 1;
         if (!write_all()) {
             return erase_all();
@@ -160,11 +178,19 @@ bool AP_FlashStorage::protected_switch_full_sector(void)
 {
     // clear any write error
     write_error = false;
-    reserved_space = 0;
-    
-    if (!write_all()) {
-        return false;
+
+    // finish any compaction in one go, so the current sector holds
+    // all of storage, using the space reserved for it
+    if (compact_state != CompactState::COPYING) {
+        compact_offset = compact_state == CompactState::ERASE_PENDING ? storage_size : 0;
+    }
+    while (compact_offset < storage_size) {
+        if (!compact_chunk()) {
+            return false;
+        }
     }
+    compact_state = CompactState::IDLE;
+    reserved_space = 0;
 
     if (!erase_sector(current_sector ^ 1, true)) {
         return false;
@@ -261,8 +287,9 @@ bool AP_FlashStorage::write(uint16_t offset, uint16_t length)
 /*
   load all data from a flash sector into mem_buffer
  */
-bool AP_FlashStorage::load_sector(uint8_t sector)
+bool AP_FlashStorage::load_sector(uint8_t sector, bool load_data)
 {
+    summary_found = false;
     uint32_t ofs = sizeof(sector_header);
     while (ofs < flash_sector_size - sizeof(struct block_header)) {
         struct block_header header;
@@ -288,6 +315,15 @@ bool AP_FlashStorage::load_sector(uint8_t sector)
               sector
              */
             uint16_t block_nbytes = (header.num_blocks_minus_one+1)*block_size;
+            if (block_nbytes == block_size && header.block_num == 0) {
+                summary_data summary;
+                if (!flash_read(sector, ofs+sizeof(header), (uint8_t *)&summary, sizeof(summary))) {
+                    return false;
+                }
+                if (summary.magic == summary_magic && summary.storage_size == storage_size) {
+                    summary_found = true;
+                }
+            }
             ofs += block_nbytes + sizeof(header);
             break;
         }
@@ -299,7 +335,8 @@ bool AP_FlashStorage::load_sector(uint8_t sector)
                 // the data is invalid (out of range)
                 return false;
             }
-            if (!flash_read(sector, ofs+sizeof(header), &mem_buffer[block_ofs], block_nbytes)) {
+            if (load_data &&
+                !flash_read(sector, ofs+sizeof(header), &mem_buffer[block_ofs], block_nbytes)) {
                 return false;
             }
             //debug("read at %u for %u\n", block_ofs, block_nbytes);
@@ -344,6 +381,7 @@ bool AP_FlashStorage::erase_sector(uint8_t sector, bool mark_available)
 bool AP_FlashStorage::erase_all(void)
 {
     write_error = false;
+    compact_state = CompactState::IDLE;
 
     current_sector = 0;
     write_offset = sizeof(struct sector_header);
@@ -440,12 +478,115 @@ bool AP_FlashStorage::switch_sectors(void)
         
     // we need to reserve some space in next sector to ensure we can successfully do a
     // full write out on init()
-    reserved_space = reserve_size;
+    reserved_space = reserve_from(0);
     
     write_offset = sizeof(header);
+
+    // start copying storage into the new sector so the old one can
+    // be erased
+    compact_state = CompactState::COPYING;
+    compact_offset = 0;
     return true;    
 }
 
+/*
+  copy the next chunk of storage which isn't all zero into the current
+  sector. As each chunk is written the space reserved for the rest of
+  the copy is reduced
+ */
+bool AP_FlashStorage::compact_chunk(void)
+{
+    // local variable needed to overcome problem with MIN() macro and -O0
+    const uint8_t max_write_local = max_write;
+    while (compact_offset < storage_size) {
+        const uint16_t ofs = compact_offset;
+        const uint8_t n = MIN(max_write_local, storage_size-ofs);
+        if (all_zero(ofs, n)) {
+            compact_offset += n;
+            continue;
+        }
+        reserved_space = reserve_from(ofs + n);
+        if (!write(ofs, n)) {
+            reserved_space = reserve_from(ofs);
+            return false;
+        }
+        compact_offset += n;
+        break;
+    }
+    return true;
+}
+
+/*
+  write a marker showing that the current sector holds all of
+  storage. It uses the same header as a block so the sector can still
+  be read by load_sector() in older firmware
+ */
+bool AP_FlashStorage::write_summary(void)
+{
+    struct PACKED {
+        struct block_header header;
+        uint8_t data[block_size];
+    } blk;
+
+    if (flash_sector_size - write_offset < sizeof(blk)) {
+        return false;
+    }
+
+    blk.header.state = BLOCK_STATE_WRITING;
+    blk.header.block_num = 0;
+    blk.header.num_blocks_minus_one = 0;
+    memset(blk.data, 0xff, sizeof(blk.data));
+    const summary_data summary { summary_magic, storage_size };
+    memcpy(blk.data, &summary, sizeof(summary));
+
+    if (!flash_write(current_sector, write_offset, (uint8_t*)&blk, sizeof(blk))) {
+        return false;
+    }
+    write_offset += sizeof(blk);
+    return true;
+}
+
+/*
+  do one step of compaction. Each step writes at most one chunk of
+  storage or erases one sector
+ */
+void AP_FlashStorage::compact_step(void)
+{
+    if (write_error) {
+        return;
+    }
+    switch (compact_state) {
+    case CompactState::IDLE:
+        break;
+
+    case CompactState::COPYING:
+        if (compact_offset < storage_size) {
+            // a failed write is retried on the next step
+            if (!compact_chunk()) {
+                debug("compaction write failed at %u\n", compact_offset);
+            }
+            break;
+        }
+        // without the marker init() does a full write out if it
+        // finds the old sector not yet erased, which is still correct
+        if (!write_summary()) {
+            debug("no space for summary\n");
+        }
+        // keep some space reserved, as a non-zero reserved_space
+        // stops switch_sectors() using the unerased sector
+        reserved_space = reserve_from(storage_size);
+        compact_state = CompactState::ERASE_PENDING;
+        break;
+
+    case CompactState::ERASE_PENDING:
+        if (flash_erase_ok() && erase_sector(current_sector ^ 1, true)) {
+            reserved_space = 0;
+            compact_state = CompactState::IDLE;
+        }
+        break;
+    }
+}
+
 /*
   re-initialise, using current mem_buffer
  */
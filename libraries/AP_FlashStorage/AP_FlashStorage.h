@@ -34,6 +34,12 @@
     128k flash sectors with 16k storage size.
 
   - assumes two flash sectors are available
+
+  - after switching sectors the contents of storage are copied into
+    the new sector a chunk at a time by compact_step(), followed by a
+    summary marker. The old sector can then be erased without a long
+    blocking write, and init() skips reading it if the erase didn't
+    happen before a reboot
  */
 #pragma once
 
@@ -130,6 +136,17 @@ public:
     // write some data to storage from mem_buffer
     bool write(uint16_t offset, uint16_t length) WARN_IF_UNUSED;
 
+    // do one bounded step of any compaction of the old sector. This
+    // should be called regularly from the storage thread when there
+    // is nothing else to write. The old sector is erased only when
+    // flash_erase_ok() allows
+    void compact_step(void);
+
+    // true if a compaction is copying data or waiting to erase
+    bool compaction_pending(void) const {
+        return compact_state != CompactState::IDLE;
+    }
+
     // fixed storage size
     static const uint16_t storage_size = HAL_STORAGE_SIZE;
     
@@ -214,11 +231,46 @@ private:
         uint16_t num_blocks_minus_one:3;
     };
 
-    // amount of space needed to write full storage
-    static const uint32_t reserve_size = (storage_size / max_write) * (sizeof(block_header) + max_write) + max_write;
-        
-    // load data from a sector
-    bool load_sector(uint8_t sector) WARN_IF_UNUSED;
+    // amount of space needed to write storage from ofs onwards. Each
+    // chunk written reduces this by exactly one chunk, including a
+    // partial chunk at the end, and it never reaches zero
+    static constexpr uint32_t reserve_from(uint16_t ofs) {
+        return ((storage_size - ofs + (max_write - 1)) / max_write) * (sizeof(block_header) + max_write) + max_write;
+    }
+
+    /*
+      data of the marker written when a compaction completes. It is
+      written as a one block long block_header in the WRITING state
+      with a block_num of zero, so older firmware skips it as an
+      interrupted write
+     */
+    struct PACKED summary_data {
+        uint32_t magic;
+        uint16_t storage_size;
+    };
+    static_assert(sizeof(summary_data) <= block_size, "summary must fit in a block");
+    static const uint32_t summary_magic = 0x53464331;
+
+    enum class CompactState : uint8_t {
+        IDLE,
+        COPYING,        // copying storage into the current sector
+        ERASE_PENDING,  // copy done, waiting to erase the old sector
+    };
+    CompactState compact_state = CompactState::IDLE;
+    uint16_t compact_offset;
+
+    // set by load_sector() if the sector has a summary marker
+    bool summary_found;
+
+    // copy the next non-zero chunk of storage into the current sector
+    bool compact_chunk(void) WARN_IF_UNUSED;
+
+    // write the summary marker at write_offset
+    bool write_summary(void) WARN_IF_UNUSED;
+
+    // load data from a sector. With load_data false only the block
+    // headers are read, to check the sector and find a summary marker
+    bool load_sector(uint8_t sector, bool load_data=true) WARN_IF_UNUSED;
 
     // erase a sector and write header
     bool erase_sector(uint8_t sector, bool mark_available) WARN_IF_UNUSED;
@@ -0,0 +1,239 @@
+/*
+  AP_FlashStorage init time and compaction stall benchmark
+
+  Storage is kept in a simulated flash which follows the bit clearing
+  rules of real flash and counts the bytes read and written. Random
+  changes are written out a line at a time as the HAL storage drivers
+  do, with erase only allowed for one change in every 1000 to simulate
+  being armed most of the time. This is run without compaction, and
+  with compact_step() called when there are no dirty lines.
+
+  For each number of changes it shows the time and flash bytes read
+  and written by init() after a reboot, the largest number of flash
+  bytes written by a single write() or compact_step() call, which is
+  the length of the longest storage stall, and the number of line
+  writes which failed as both sectors were full. The contents after
+  each init() are checked.
+ */
+
+#include <AP_HAL/AP_HAL.h>
+#include <AP_Math/AP_Math.h>
+#include <AP_FlashStorage/AP_FlashStorage.h>
+#include <AP_Common/Bitmask.h>
+#include <stdio.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+void setup();
+void loop();
+
+#ifndef HAL_FLASH_SECTOR_SIZE
+#define HAL_FLASH_SECTOR_SIZE (128*1024)
+#endif
+
+static const uint32_t flash_sector_size = (HAL_FLASH_SECTOR_SIZE);
+static const uint8_t line_size = 8;
+
+class FlashSim {
+public:
+    FlashSim();
+    ~FlashSim();
+
+    bool flash_write(uint8_t sector, uint32_t offset, const uint8_t *data, uint16_t length);
+    bool flash_read(uint8_t sector, uint32_t offset, uint8_t *data, uint16_t length);
+    bool flash_erase(uint8_t sector);
+    bool flash_erase_ok(void) { return erase_ok; }
+
+    bool erase_ok = true;
+    uint32_t bytes_read = 0;
+    uint32_t bytes_written = 0;
+    uint32_t erases = 0;
+
+private:
+    uint8_t *flash[2];
+};
+
+FlashSim::FlashSim()
+{
+    for (uint8_t i=0; i<2; i++) {
+        flash[i] = (uint8_t *)malloc(flash_sector_size);
+        memset(flash[i], 0xFF, flash_sector_size);
+    }
+}
+
+FlashSim::~FlashSim()
+{
+    free(flash[0]);
+    free(flash[1]);
+}
+
+bool FlashSim::flash_write(uint8_t sector, uint32_t offset, const uint8_t *data, uint16_t length)
+{
+    if (sector > 1 || offset + length > flash_sector_size) {
+        AP_HAL::panic("FATAL: write to sector %u at offset %u length %u",
+                      unsigned(sector), unsigned(offset), unsigned(length));
+    }
+    uint8_t *b = &flash[sector][offset];
+    for (uint16_t i=0; i<length; i++) {
+        if (data[i] & ~b[i]) {
+            AP_HAL::panic("FATAL: setting bits at %u:%u", unsigned(sector), unsigned(offset+i));
+        }
+        b[i] &= data[i];
+    }
+    bytes_written += length;
+    return true;
+}
+
+bool FlashSim::flash_read(uint8_t sector, uint32_t offset, uint8_t *data, uint16_t length)
+{
+    if (sector > 1 || offset + length > flash_sector_size) {
+        AP_HAL::panic("FATAL: read from sector %u at offset %u length %u",
+                      unsigned(sector), unsigned(offset), unsigned(length));
+    }
+    memcpy(data, &flash[sector][offset], length);
+    bytes_read += length;
+    return true;
+}
+
+bool FlashSim::flash_erase(uint8_t sector)
+{
+    memset(flash[sector], 0xFF, flash_sector_size);
+    erases++;
+    return true;
+}
+
+struct Result {
+    uint32_t init_us;
+    uint32_t init_bytes_read;
+    uint32_t init_bytes_written;
+    uint32_t max_stall_bytes;
+    uint32_t failed_writes;
+    uint32_t erases;
+};
+
+static uint8_t mem_buffer[AP_FlashStorage::storage_size];
+static uint8_t mem_mirror[AP_FlashStorage::storage_size];
+static Bitmask<AP_FlashStorage::storage_size / line_size> dirty;
+
+static AP_FlashStorage *new_storage(FlashSim &sim)
+{
+    return NEW_NOTHROW AP_FlashStorage(mem_buffer,
+                                       flash_sector_size,
+                                       FUNCTOR_BIND(&sim, &FlashSim::flash_write, bool, uint8_t, uint32_t, const uint8_t *, uint16_t),
+                                       FUNCTOR_BIND(&sim, &FlashSim::flash_read, bool, uint8_t, uint32_t, uint8_t *, uint16_t),
+                                       FUNCTOR_BIND(&sim, &FlashSim::flash_erase, bool, uint8_t),
+                                       FUNCTOR_BIND(&sim, &FlashSim::flash_erase_ok, bool));
+}
+
+/*
+  one storage thread tick as in the HAL drivers: write the first dirty
+  line, or do a compaction step if there are none. A line which fails
+  to write stays dirty
+ */
+static void storage_tick(AP_FlashStorage &storage, FlashSim &sim, bool compact, Result &res)
+{
+    const uint32_t written = sim.bytes_written;
+    const int16_t line = dirty.first_set();
+    if (line >= 0) {
+        if (storage.write(line * line_size, line_size)) {
+            dirty.clear(line);
+        } else {
+            res.failed_writes++;
+        }
+    } else if (compact) {
+        storage.compact_step();
+    }
+    res.max_stall_bytes = MAX(res.max_stall_bytes, sim.bytes_written - written);
+}
+
+static void run(uint32_t num_writes, bool compact, Result &res)
+{
+    FlashSim sim;
+    AP_FlashStorage *storage = new_storage(sim);
+    if (storage == nullptr || !storage->init()) {
+        AP_HAL::panic("FATAL: first init failed");
+    }
+    memset(mem_mirror, 0, sizeof(mem_mirror));
+    dirty.clearall();
+
+    // seed the random generator so both modes see the same writes
+    uint32_t seed = 0x12345678;
+    for (uint32_t i=0; i<num_writes; i++) {
+        // mostly parameter sized writes, some mission sized ones
+        seed = seed * 1103515245U + 12345U;
+        const uint16_t len = (seed >> 28) == 0 ? 64 : 8;
+        // stay clear of a partial block at the end of storage
+        const uint16_t line = ((seed >> 8) % ((sizeof(mem_buffer) - 64) / line_size)) & ~((len / line_size) - 1);
+        const uint16_t ofs = line * line_size;
+        for (uint16_t j=0; j<len; j++) {
+            mem_buffer[ofs+j] = mem_mirror[ofs+j] = uint8_t(seed + j);
+        }
+        for (uint16_t j=0; j<len/line_size; j++) {
+            dirty.set(line + j);
+        }
+
+        sim.erase_ok = (i % 1000 == 0);
+        for (uint8_t t=0; t<4; t++) {
+            storage_tick(*storage, sim, compact, res);
+        }
+    }
+
+    // disarm and flush everything before rebooting
+    sim.erase_ok = true;
+    for (uint32_t t=0; !dirty.empty(); t++) {
+        if (t > dirty.size()) {
+            AP_HAL::panic("FATAL: unable to flush after %u writes", unsigned(num_writes));
+        }
+        storage_tick(*storage, sim, compact, res);
+    }
+    res.erases = sim.erases;
+    delete storage;
+
+    // reboot
+    memset(mem_buffer, 0, sizeof(mem_buffer));
+    storage = new_storage(sim);
+    sim.bytes_read = 0;
+    sim.bytes_written = 0;
+    const uint32_t start_us = AP_HAL::micros();
+    if (storage == nullptr || !storage->init()) {
+        AP_HAL::panic("FATAL: init failed");
+    }
+    res.init_us = AP_HAL::micros() - start_us;
+    res.init_bytes_read = sim.bytes_read;
+    res.init_bytes_written = sim.bytes_written;
+    delete storage;
+
+    if (memcmp(mem_buffer, mem_mirror, sizeof(mem_buffer)) != 0) {
+        AP_HAL::panic("FATAL: data mismatch after %u writes", unsigned(num_writes));
+    }
+}
+
+void setup()
+{
+    hal.console->printf("AP_FlashStorage benchmark: storage %u bytes, sectors %u bytes\n",
+                        unsigned(AP_FlashStorage::storage_size), unsigned(flash_sector_size));
+    hal.console->printf("%8s %-11s %8s %10s %10s %10s %7s %6s\n",
+                        "writes", "mode", "init_us", "init_read", "init_write", "max_stall", "failed", "erases");
+    for (const uint32_t num_writes : { 1000U, 5000U, 20000U, 50000U, 200000U }) {
+        for (const bool compact : { false, true }) {
+            Result res {};
+            run(num_writes, compact, res);
+            hal.console->printf("%8u %-11s %8u %10u %10u %10u %7u %6u\n",
+                                unsigned(num_writes),
+                                compact ? "incremental" : "blocking",
+                                unsigned(res.init_us),
+                                unsigned(res.init_bytes_read),
+                                unsigned(res.init_bytes_written),
+                                unsigned(res.max_stall_bytes),
+                                unsigned(res.failed_writes),
+                                unsigned(res.erases));
+        }
+    }
+}
+
+void loop()
+{
+    hal.scheduler->delay(1000);
+}
+
+AP_HAL_MAIN();
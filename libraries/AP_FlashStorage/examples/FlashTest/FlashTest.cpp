@@ -5,6 +5,7 @@
 #include <AP_HAL/AP_HAL.h>
 #include <AP_Math/AP_Math.h>
 #include <AP_FlashStorage/AP_FlashStorage.h>
+#include <AP_Common/Bitmask.h>
 #include <stdio.h>
 #include <AP_HAL/utility/sparse-endian.h>
 
@@ -40,6 +41,11 @@ private:
     // write to storage and mem_mirror
     void write(uint16_t offset, const uint8_t *data, uint16_t length);
 
+    // lines which failed to write, retried as the HAL storage drivers do
+    static const uint8_t line_size = 8;
+    Bitmask<(AP_FlashStorage::storage_size+line_size-1)/line_size> dirty;
+    bool flush_line(void);
+
     bool erase_ok;
 };
 
@@ -124,7 +130,29 @@ void FlashTest::write(uint16_t offset, const uint8_t *data, uint16_t length)
         if (erase_ok) {
             printf("Failed to write at %u for %u\n", offset, length);
         }
+        for (uint16_t line=offset/line_size; line<(offset+length+line_size-1)/line_size; line++) {
+            dirty.set(line);
+        }
+    }
+}
+
+/*
+  retry the first line which failed to write, or do a compaction step
+  if there are none. Returns false if the line failed again
+ */
+bool FlashTest::flush_line(void)
+{
+    const int16_t line = dirty.first_set();
+    if (line < 0) {
+        storage.compact_step();
+        return true;
+    }
+    const uint16_t ofs = line * line_size;
+    if (!storage.write(ofs, MIN(uint16_t(line_size), uint16_t(sizeof(mem_buffer) - ofs)))) {
+        return false;
     }
+    dirty.clear(line);
+    return true;
 }
 
 /*
@@ -158,6 +186,7 @@ void FlashTest::loop(void)
 
         erase_ok = (i % 1000 == 0);
         write(ofs, data, length);
+        flush_line();
 
         if (erase_ok) {
             if (memcmp(mem_buffer, mem_mirror, sizeof(mem_buffer)) != 0) {
@@ -170,6 +199,11 @@ void FlashTest::loop(void)
     erase_ok = true;
     uint8_t b = 42;
     write(37, &b, 1);
+    while (!dirty.empty()) {
+        if (!flush_line()) {
+            AP_HAL::panic("FATAL: flush failed");
+        }
+    }
     
     if (memcmp(mem_buffer, mem_mirror, sizeof(mem_buffer)) != 0) {
         AP_HAL::panic("FATAL: data mis-match before re-init");
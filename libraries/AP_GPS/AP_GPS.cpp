@@ -42,6 +42,7 @@
 #include "AP_GPS_MSP.h"
 #include "AP_GPS_ExternalAHRS.h"
 #include "GPS_Backend.h"
+#include "RTCM_FramePool.h"
 #if AP_SIM_GPS_ENABLED
 #include "AP_GPS_SITL.h"
 #endif
@@ -1057,6 +1058,9 @@ void AP_GPS::update(void)
         update_instance(i);
     }
 
+    // pass on injected data the drivers didn't have space for
+    send_injected();
+
     // calculate number of instances
     for (uint8_t i=0; i<GPS_MAX_RECEIVERS; i++) {
         if (drivers[i] != nullptr) {
@@ -1325,6 +1329,7 @@ void AP_GPS::lock_port(uint8_t instance, bool lock)
 // Inject a packet of raw binary to a GPS
 void AP_GPS::inject_data(const uint8_t *data, uint16_t len)
 {
+    uint8_t instances = 0;
     //Support broadcasting to all GPSes.
     if (_inject_to == GPS_RTK_INJECT_TO_ALL) {
         for (uint8_t i=0; i<GPS_MAX_RECEIVERS; i++) {
@@ -1332,18 +1337,119 @@ void AP_GPS::inject_data(const uint8_t *data, uint16_t len)
                 // we don't externally inject to moving baseline rover
                 continue;
             }
-            inject_data(i, data, len);
+            if (drivers[i] != nullptr) {
+                instances |= 1U<<i;
+            }
         }
     } else {
-        inject_data(_inject_to, data, len);
+        const uint8_t instance = _inject_to;
+        if (instance < GPS_MAX_RECEIVERS && drivers[instance] != nullptr) {
+            instances = 1U<<instance;
+        }
     }
+    queue_inject(data, len, instances);
 }
 
 void AP_GPS::inject_data(uint8_t instance, const uint8_t *data, uint16_t len)
 {
     if (instance < GPS_MAX_RECEIVERS && drivers[instance] != nullptr) {
-        drivers[instance]->inject_data(data, len);
+        queue_inject(data, len, 1U<<instance);
+    }
+}
+
+/*
+  copy injected data into the pool once for all the instances it is
+  for, then pass it on to any which have space for it now
+ */
+void AP_GPS::queue_inject(const uint8_t *data, uint16_t len, uint8_t instances)
+{
+    if (instances == 0 || len == 0) {
+        return;
+    }
+
+    // injection may come from scripting as well as the main thread
+    WITH_SEMAPHORE(rsem);
+
+    if (rtcm_pool == nullptr) {
+        rtcm_pool = NEW_NOTHROW RTCM_FramePool();
+        if (rtcm_pool != nullptr && !rtcm_pool->init(AP_GPS_RTCM_POOL_SIZE)) {
+            delete rtcm_pool;
+            rtcm_pool = nullptr;
+        }
     }
+    if (rtcm_pool == nullptr || !rtcm_pool->push(data, len, instances)) {
+        // no pool, or the data is too large for it, inject directly
+        for (uint8_t i=0; i<GPS_MAX_RECEIVERS; i++) {
+            if ((instances & (1U<<i)) && drivers[i] != nullptr) {
+                drivers[i]->inject_data(data, len);
+            }
+        }
+        return;
+    }
+    send_injected();
+}
+
+/*
+  pass queued injected data to each driver in order until it has no
+  more space. Data left in the pool waits for the next update, and is
+  dropped if newer data needs its space
+ */
+void AP_GPS::send_injected(void)
+{
+    if (rtcm_pool == nullptr) {
+        return;
+    }
+    for (uint8_t i=0; i<GPS_MAX_RECEIVERS; i++) {
+        if (drivers[i] == nullptr) {
+            rtcm_pool->flush(i);
+            continue;
+        }
+        const uint8_t *data;
+        uint16_t len;
+        while (rtcm_pool->peek(i, data, len)) {
+            if (!drivers[i]->can_inject(len)) {
+                rtcm_pool->stalled(i);
+                break;
+            }
+            drivers[i]->inject_data(data, len);
+            rtcm_pool->take(i);
+        }
+    }
+
+#if HAL_LOGGING_ENABLED
+    const uint32_t now_ms = AP_HAL::millis();
+    if (now_ms - rtcm_pool_log_ms < 1000 || !should_log()) {
+        return;
+    }
+    rtcm_pool_log_ms = now_ms;
+    for (uint8_t i=0; i<GPS_MAX_RECEIVERS; i++) {
+        const auto &stats = rtcm_pool->get_stats(i);
+        if (stats.frames == 0 && stats.dropped == 0) {
+            continue;
+        }
+// @LoggerMessage: GINJ
+// @Description: GPS injected data statistics
+// @Field: TimeUS: Time since system startup
+// @Field: I: GPS instance number
+// @Field: Frm: frames passed to the GPS driver
+// @Field: Bytes: bytes passed to the GPS driver
+// @Field: Drop: frames dropped before the GPS driver had space for them
+// @Field: Stall: times the GPS driver had no space for the next frame
+// @Field: Pend: bytes waiting for the GPS driver
+        AP::logger().WriteStreaming("GINJ",
+                                    "TimeUS,I,Frm,Bytes,Drop,Stall,Pend",
+                                    "s#-b--b",
+                                    "F------",
+                                    "QBIIIII",
+                                    AP_HAL::micros64(),
+                                    i,
+                                    stats.frames,
+                                    stats.bytes,
+                                    stats.dropped,
+                                    stats.stalls,
+                                    rtcm_pool->pending(i));
+    }
+#endif
 }
 
 /*
@@ -47,6 +47,7 @@
 
 class AP_GPS_Backend;
 class RTCM3_Parser;
+class RTCM_FramePool;
 
 /// @class AP_GPS
 /// GPS driver main class
@@ -756,6 +757,22 @@ private:
     //Inject a packet of raw binary to a GPS
     void inject_data(uint8_t instance, const uint8_t *data, uint16_t len);
 
+    /*
+      injected data is copied once into a pool shared by all the GPS
+      instances it is for, and passed to each driver when it has space
+      for it. The pool is allocated on first use
+     */
+    RTCM_FramePool *rtcm_pool;
+#if HAL_LOGGING_ENABLED
+    uint32_t rtcm_pool_log_ms;
+#endif
+
+    // queue injected data for a bitmask of GPS instances
+    void queue_inject(const uint8_t *data, uint16_t len, uint8_t instances);
+
+    // pass queued injected data to the drivers with space for it
+    void send_injected(void);
+
 #if AP_GPS_BLENDED_ENABLED
     bool _output_is_blended; // true when a blended GPS solution being output
 #endif
@@ -810,6 +810,15 @@ void AP_GPS_DroneCAN::send_rtcm(void)
     }
 }
 
+/*
+  only take injected data when it fits in the RTCM stream buffer, so
+  a full buffer holds data back rather than splitting a frame
+ */
+bool AP_GPS_DroneCAN::can_inject(uint16_t len) const
+{
+    return _rtcm_stream.buf == nullptr || _rtcm_stream.buf->space() >= len;
+}
+
 /*
   handle RTCM data from MAVLink GPS_RTCM_DATA, forwarding it over MAVLink
  */
@@ -58,6 +58,7 @@ public:
 #endif
     static bool inter_instance_pre_arm_checks(char failure_msg[], uint16_t failure_msg_len);
     void inject_data(const uint8_t *data, uint16_t len) override;
+    bool can_inject(uint16_t len) const override;
 
     bool get_error_codes(uint32_t &error_codes) const override { error_codes = error_code; return seen_status; };
 
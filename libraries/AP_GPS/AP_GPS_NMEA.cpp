@@ -58,18 +58,21 @@ extern const AP_HAL::HAL& hal;
 
 bool AP_GPS_NMEA::read(void)
 {
-    int16_t numc;
     bool parsed = false;
 
     send_config();
 
-    numc = port->available();
-    while (numc--) {
-        char c = port->read();
-#if AP_GPS_DEBUG_LOGGING_ENABLED
-        log_data((const uint8_t *)&c, 1);
-#endif
-        if (_decode(c)) {
+    rx_begin();
+    while (true) {
+        // skip bytes between sentences
+        if (_sentence_done && !rx_skip_to('$', '#')) {
+            break;
+        }
+        uint8_t c;
+        if (!rx_byte(c)) {
+            break;
+        }
+        if (_decode(char(c))) {
             parsed = true;
         }
     }
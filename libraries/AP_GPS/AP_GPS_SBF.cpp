@@ -88,12 +88,21 @@ bool
 AP_GPS_SBF::read(void)
 {
     bool ret = false;
-    uint32_t available_bytes = port->available();
-    for (uint32_t i = 0; i < available_bytes; i++) {
-        uint8_t temp = port->read();
-#if AP_GPS_DEBUG_LOGGING_ENABLED
-        log_data(&temp, 1);
-#endif
+
+    // the command prompt between blocks is only needed while
+    // configuring, after that bytes between blocks can be skipped
+    const bool skip_to_preamble = config_step == Config_State::Complete ||
+                                  gps._auto_config == AP_GPS::GPS_AUTO_CONFIG_DISABLE;
+
+    rx_begin();
+    while (true) {
+        if (skip_to_preamble && sbf_msg.sbf_state == sbf_msg_parser_t::PREAMBLE1 && !rx_skip_to(SBF_PREAMBLE1)) {
+            break;
+        }
+        uint8_t temp;
+        if (!rx_byte(temp)) {
+            break;
+        }
         ret |= parse(temp);
     }
 
@@ -684,17 +684,26 @@ AP_GPS_UBLOX::read(void)
         }
     }
 
-    const uint16_t numc = MIN(port->available(), 8192U);
-    for (uint16_t i = 0; i < numc; i++) {        // Process bytes received
+#if GPS_MOVING_BASELINE
+    // RTCMv3 from a moving baseline base comes between UBX messages,
+    // so every byte needs to go to the RTCMv3 parser
+    const bool skip_to_preamble = (rtcm3_parser == nullptr);
+#else
+    const bool skip_to_preamble = true;
+#endif
+
+    rx_begin(8192);
+    while (true) {        // Process bytes received
+        // skip bytes between messages
+        if (_step == 0 && skip_to_preamble && !rx_skip_to(PREAMBLE1)) {
+            break;
+        }
 
         // read the next byte
         uint8_t data;
-        if (!port->read(data)) {
+        if (!rx_byte(data)) {
             break;
         }
-#if AP_GPS_DEBUG_LOGGING_ENABLED
-        log_data(&data, 1);
-#endif
 
 #if GPS_MOVING_BASELINE
         if (rtcm3_parser) {
@@ -703,7 +712,8 @@ AP_GPS_UBLOX::read(void)
                 // this point and reset u-blox parse state. We need to
                 // stop parsing to give the higher level driver a
                 // chance to send the RTCMv3 packet to another (rover)
-                // GPS
+                // GPS. Any bytes after the packet are kept for the
+                // next read()
                 _step = 0;
                 break;
             }
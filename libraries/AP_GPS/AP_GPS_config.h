@@ -121,3 +121,18 @@
 #ifndef AP_GPS_GPS2_RTK_SENDING_ENABLED
 #define AP_GPS_GPS2_RTK_SENDING_ENABLED HAL_GCS_ENABLED && AP_GPS_ENABLED && GPS_MAX_RECEIVERS > 1 && (AP_GPS_SBF_ENABLED || AP_GPS_ERB_ENABLED)
 #endif
+
+// size of the blocks read from the port by the serial GPS drivers
+#ifndef AP_GPS_RX_BLOCK_SIZE
+#define AP_GPS_RX_BLOCK_SIZE 128
+#endif
+
+// space for RTCM data waiting to be injected into the GPS receivers
+#ifndef AP_GPS_RTCM_POOL_SIZE
+#define AP_GPS_RTCM_POOL_SIZE 3072
+#endif
+
+// maximum number of frames of RTCM data waiting to be injected
+#ifndef AP_GPS_RTCM_POOL_MAX_FRAMES
+#define AP_GPS_RTCM_POOL_MAX_FRAMES 32
+#endif
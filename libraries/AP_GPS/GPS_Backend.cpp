@@ -130,6 +130,12 @@ AP_GPS_Backend::inject_data(const uint8_t *data, uint16_t len)
     }
 }
 
+bool AP_GPS_Backend::can_inject(uint16_t len) const
+{
+    // data for backends without a port is discarded
+    return port == nullptr || port->txspace() > len;
+}
+
 void AP_GPS_Backend::_detection_message(char *buffer, const uint8_t buflen) const
 {
     const uint8_t instance = state.instance;
@@ -223,12 +229,98 @@ void AP_GPS_Backend::send_mavlink_gps_rtk(mavlink_channel_t chan)
 void AP_GPS_Backend::set_uart_timestamp(uint16_t nbytes)
 {
     if (port) {
-        state.last_corrected_gps_time_us = port->receive_time_constraint_us(nbytes);
+        // bytes read from the port but not yet parsed arrived after this byte
+        state.last_corrected_gps_time_us = port->receive_time_constraint_us(nbytes + rx_unparsed());
         state.corrected_timestamp_updated = true;
     }
 }
 
 
+/*
+  start reading from the port. At most max_bytes more than are already
+  in the block are read in this call
+ */
+void AP_GPS_Backend::rx_begin(uint32_t max_bytes)
+{
+    rx.budget = MIN(port->available(), max_bytes);
+
+    const uint32_t now_ms = AP_HAL::millis();
+    const uint32_t dt_ms = now_ms - rx.last_rate_ms;
+    if (dt_ms < 1000) {
+        return;
+    }
+#if HAL_LOGGING_ENABLED
+    if (rx.last_rate_ms != 0 && should_log()) {
+// @LoggerMessage: GPSR
+// @Description: GPS receive statistics for serial GPS drivers
+// @Field: TimeUS: Time since system startup
+// @Field: I: GPS instance number
+// @Field: BPS: bytes read from the port per second
+// @Field: RPS: reads from the port per second
+        AP::logger().WriteStreaming("GPSR",
+                                    "TimeUS,I,BPS,RPS",
+                                    "s#B-",
+                                    "F---",
+                                    "QBIH",
+                                    AP_HAL::micros64(),
+                                    state.instance,
+                                    uint32_t(rx.bytes * 1000ULL / dt_ms),
+                                    uint16_t(rx.reads * 1000U / dt_ms));
+    }
+#endif
+    rx.bytes = 0;
+    rx.reads = 0;
+    rx.last_rate_ms = now_ms;
+}
+
+/*
+  read the next block of bytes from the port
+ */
+bool AP_GPS_Backend::rx_fill(void)
+{
+    if (rx.budget == 0) {
+        return false;
+    }
+    const ssize_t n = port->read(rx.buf, MIN(rx.budget, sizeof(rx.buf)));
+    if (n <= 0) {
+        rx.budget = 0;
+        return false;
+    }
+    rx.len = n;
+    rx.ofs = 0;
+    rx.budget -= n;
+    rx.bytes += n;
+    rx.reads++;
+#if AP_GPS_DEBUG_LOGGING_ENABLED
+    log_data(rx.buf, n);
+#endif
+    return true;
+}
+
+/*
+  skip bytes in the block up to the next sync byte
+ */
+bool AP_GPS_Backend::rx_skip_to(uint8_t sync1, uint8_t sync2)
+{
+    while (rx.ofs < rx.len || rx_fill()) {
+        const uint8_t *p = &rx.buf[rx.ofs];
+        const uint8_t *end = &rx.buf[rx.len];
+        const uint8_t *s = (const uint8_t *)memchr(p, sync1, end - p);
+        if (sync2 != sync1) {
+            const uint8_t *s2 = (const uint8_t *)memchr(p, sync2, (s != nullptr ? s : end) - p);
+            if (s2 != nullptr) {
+                s = s2;
+            }
+        }
+        if (s != nullptr) {
+            rx.ofs = s - rx.buf;
+            return true;
+        }
+        rx.ofs = rx.len;
+    }
+    return false;
+}
+
 void AP_GPS_Backend::check_new_itow(uint32_t itow, uint32_t msg_length)
 {
     if (itow != _last_itow_ms) {
@@ -252,7 +344,7 @@ void AP_GPS_Backend::check_new_itow(uint32_t itow, uint32_t msg_length)
             uart_us = _last_pps_time_us;
             _last_pps_time_us = 0;
         } else if (port) {
-            uart_us = port->receive_time_constraint_us(msg_length);
+            uart_us = port->receive_time_constraint_us(msg_length + rx_unparsed());
         } else {
             uart_us = AP_HAL::micros64();
         }
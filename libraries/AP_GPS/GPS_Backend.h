@@ -68,6 +68,9 @@ public:
 
     virtual void inject_data(const uint8_t *data, uint16_t len);
 
+    // return true if inject_data() can take len bytes now
+    virtual bool can_inject(uint16_t len) const;
+
 #if HAL_GCS_ENABLED
     //MAVLink methods
     virtual bool supports_mavlink_gps_rtk_message() const { return false; }
@@ -176,7 +179,47 @@ protected:
     // set alt in location, honouring GPS driver option for ellipsoid height
     void set_alt_amsl_cm(AP_GPS::GPS_State &_state, int32_t alt_amsl_cm);
 
+    /*
+      bytes are read from the port a block at a time, so serial
+      drivers don't call into the UART driver for every byte. A
+      driver calls rx_begin() at the start of read() then rx_byte()
+      for each byte. Bytes which are read from the port but not
+      parsed in one read() are kept for the next
+     */
+    void rx_begin(uint32_t max_bytes=UINT32_MAX);
+    bool rx_byte(uint8_t &b) {
+        if (rx.ofs >= rx.len && !rx_fill()) {
+            return false;
+        }
+        b = rx.buf[rx.ofs++];
+        return true;
+    }
+
+    // skip bytes up to the next one which could start a message, for
+    // a driver waiting for the start of a message. Returns false if
+    // there are no more bytes in the block
+    bool rx_skip_to(uint8_t sync1, uint8_t sync2);
+    bool rx_skip_to(uint8_t sync) { return rx_skip_to(sync, sync); }
+
+    // number of bytes read from the port which haven't been parsed
+    uint16_t rx_unparsed(void) const { return rx.len - rx.ofs; }
+
 private:
+    // read the next block from the port
+    bool rx_fill(void);
+
+    struct {
+        uint8_t buf[AP_GPS_RX_BLOCK_SIZE];
+        uint16_t len;
+        uint16_t ofs;
+        // bytes which may still be read from the port in this read()
+        uint32_t budget;
+        // bytes and port reads since the rate was last updated
+        uint32_t bytes;
+        uint16_t reads;
+        uint32_t last_rate_ms;
+    } rx;
+
     // itow from previous message
     uint64_t _pseudo_itow;
     int32_t _pseudo_itow_delta_ms;
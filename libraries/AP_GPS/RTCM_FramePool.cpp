@@ -0,0 +1,194 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/*
+  pool of RTCM frames waiting to be injected into GPS receivers
+ */
+#include "RTCM_FramePool.h"
+
+#if AP_GPS_ENABLED
+
+#include <AP_HAL/AP_HAL.h>
+#include <string.h>
+
+RTCM_FramePool::~RTCM_FramePool()
+{
+    delete[] buf;
+}
+
+bool RTCM_FramePool::init(uint16_t _size)
+{
+    if (buf != nullptr) {
+        return true;
+    }
+    buf = NEW_NOTHROW uint8_t[_size];
+    if (buf == nullptr) {
+        return false;
+    }
+    size = _size;
+    return true;
+}
+
+/*
+  find space for len bytes after the newest frame, wrapping to the
+  start of the buffer if there isn't room at the end
+ */
+bool RTCM_FramePool::alloc(uint16_t len, uint16_t &ofs) const
+{
+    if (count == 0) {
+        ofs = 0;
+        return len <= size;
+    }
+    const uint16_t oldest = frame(0).offset;
+    if (write_ofs > oldest) {
+        // in use space is oldest..write_ofs
+        if (size - write_ofs >= len) {
+            ofs = write_ofs;
+            return true;
+        }
+        if (oldest >= len) {
+            ofs = 0;
+            return true;
+        }
+        return false;
+    }
+    // in use space has wrapped, free space is write_ofs..oldest
+    if (oldest - write_ofs >= len) {
+        ofs = write_ofs;
+        return true;
+    }
+    return false;
+}
+
+void RTCM_FramePool::release(void)
+{
+    while (count > 0 && frame(0).refs == 0) {
+        head = (head + 1) % max_frames;
+        count--;
+    }
+}
+
+void RTCM_FramePool::drop_oldest(void)
+{
+    const uint8_t refs = frame(0).refs;
+    for (uint8_t i=0; i<max_consumers; i++) {
+        if (refs & (1U<<i)) {
+            stats[i].dropped++;
+        }
+    }
+    frame(0).refs = 0;
+    release();
+}
+
+bool RTCM_FramePool::push(const uint8_t *data, uint16_t len, uint8_t consumers)
+{
+    if (len == 0 || consumers == 0) {
+        return true;
+    }
+    if (buf == nullptr || len > size) {
+        return false;
+    }
+    uint16_t ofs;
+    while (count == max_frames || !alloc(len, ofs)) {
+        drop_oldest();
+    }
+    memcpy(&buf[ofs], data, len);
+    Frame &f = frame(count);
+    f.offset = ofs;
+    f.len = len;
+    f.refs = consumers;
+    count++;
+    write_ofs = ofs + len;
+    return true;
+}
+
+bool RTCM_FramePool::find(uint8_t consumer, uint8_t &n) const
+{
+    if (consumer >= max_consumers) {
+        return false;
+    }
+    const uint8_t mask = 1U<<consumer;
+    for (n=0; n<count; n++) {
+        if (frame(n).refs & mask) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool RTCM_FramePool::peek(uint8_t consumer, const uint8_t *&data, uint16_t &len) const
+{
+    uint8_t n;
+    if (!find(consumer, n)) {
+        return false;
+    }
+    const Frame &f = frame(n);
+    data = &buf[f.offset];
+    len = f.len;
+    return true;
+}
+
+void RTCM_FramePool::take(uint8_t consumer)
+{
+    uint8_t n;
+    if (!find(consumer, n)) {
+        return;
+    }
+    Frame &f = frame(n);
+    f.refs &= ~(1U<<consumer);
+    stats[consumer].frames++;
+    stats[consumer].bytes += f.len;
+    release();
+}
+
+void RTCM_FramePool::stalled(uint8_t consumer)
+{
+    if (consumer < max_consumers) {
+        stats[consumer].stalls++;
+    }
+}
+
+void RTCM_FramePool::flush(uint8_t consumer)
+{
+    if (consumer >= max_consumers) {
+        return;
+    }
+    const uint8_t mask = 1U<<consumer;
+    for (uint8_t n=0; n<count; n++) {
+        Frame &f = frame(n);
+        if (f.refs & mask) {
+            f.refs &= ~mask;
+            stats[consumer].dropped++;
+        }
+    }
+    release();
+}
+
+uint32_t RTCM_FramePool::pending(uint8_t consumer) const
+{
+    if (consumer >= max_consumers) {
+        return 0;
+    }
+    const uint8_t mask = 1U<<consumer;
+    uint32_t ret = 0;
+    for (uint8_t n=0; n<count; n++) {
+        const Frame &f = frame(n);
+        if (f.refs & mask) {
+            ret += f.len;
+        }
+    }
+    return ret;
+}
+
+#endif  // AP_GPS_ENABLED
@@ -0,0 +1,109 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/*
+  pool of RTCM frames waiting to be injected into GPS receivers.
+
+  Each frame is copied into the pool once, and holds a reference for
+  each consumer (a GPS instance) which has yet to take it. Consumers
+  take their frames in order at their own pace, and a frame's space
+  is released once all of its consumers have taken it.
+
+  Frames are stored contiguously in a ring, so space is released
+  oldest first. If there is no room for a new frame then the oldest
+  frame is dropped, counting a drop for each consumer which had not
+  taken it
+ */
+#pragma once
+
+#include "AP_GPS_config.h"
+#include <AP_Common/AP_Common.h>
+#include <stdint.h>
+
+class RTCM_FramePool {
+public:
+    RTCM_FramePool() {}
+    ~RTCM_FramePool();
+
+    CLASS_NO_COPY(RTCM_FramePool);
+
+    static const uint8_t max_consumers = 8;
+    static const uint8_t max_frames = AP_GPS_RTCM_POOL_MAX_FRAMES;
+
+    // allocate the space for frames, returning false on failure
+    bool init(uint16_t size);
+
+    // add a frame for a bitmask of consumers. Returns false if the
+    // frame can never fit in the pool
+    bool push(const uint8_t *data, uint16_t len, uint8_t consumers);
+
+    // get the next frame for a consumer, without taking it
+    bool peek(uint8_t consumer, const uint8_t *&data, uint16_t &len) const;
+
+    // take the frame returned by peek()
+    void take(uint8_t consumer);
+
+    // record that a consumer had no space for its next frame
+    void stalled(uint8_t consumer);
+
+    // drop all frames waiting for a consumer
+    void flush(uint8_t consumer);
+
+    // number of bytes waiting for a consumer
+    uint32_t pending(uint8_t consumer) const;
+
+    struct Stats {
+        uint32_t frames;    // frames taken
+        uint32_t bytes;     // bytes taken
+        uint32_t dropped;   // frames dropped before they were taken
+        uint32_t stalls;    // times the consumer had no space for a frame
+    };
+    const Stats &get_stats(uint8_t consumer) const {
+        return stats[consumer];
+    }
+
+private:
+    struct Frame {
+        uint16_t offset;
+        uint16_t len;
+        uint8_t refs;       // bitmask of consumers yet to take the frame
+    } frames[max_frames];
+    uint8_t head = 0;       // index of the oldest frame
+    uint8_t count = 0;
+    uint16_t write_ofs = 0; // end of the newest frame
+    uint16_t size = 0;
+    uint8_t *buf = nullptr;
+
+    Stats stats[max_consumers] {};
+
+    // n'th oldest frame
+    Frame &frame(uint8_t n) {
+        return frames[(head + n) % max_frames];
+    }
+    const Frame &frame(uint8_t n) const {
+        return frames[(head + n) % max_frames];
+    }
+
+    // index from the oldest frame of the next frame for a consumer
+    bool find(uint8_t consumer, uint8_t &n) const;
+
+    // find space for len bytes, without dropping frames
+    bool alloc(uint16_t len, uint16_t &ofs) const;
+
+    // release frames from the oldest which all consumers have taken
+    void release(void);
+
+    // drop the oldest frame
+    void drop_oldest(void);
+};
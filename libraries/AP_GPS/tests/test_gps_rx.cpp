@@ -0,0 +1,488 @@
+#include <AP_gtest.h>
+
+#include <AP_HAL/UARTDriver.h>
+#include <AP_GPS/AP_GPS.h>
+#include <AP_GPS/AP_GPS_NMEA.h>
+#include <AP_GPS/AP_GPS_SBF.h>
+#include <AP_GPS/AP_GPS_UBLOX.h>
+
+const AP_HAL::HAL &hal = AP_HAL::get_HAL();
+
+/*
+  UART which gives a capture to a GPS driver, making at most
+  chunk_size more bytes available for each read()
+ */
+class CaptureUart : public AP_HAL::UARTDriver {
+public:
+    void set_capture(const uint8_t *_data, uint32_t _len, uint32_t _chunk_size) {
+        data = _data;
+        len = _len;
+        chunk_size = _chunk_size;
+        arrived = 0;
+        consumed = 0;
+        reads = 0;
+    }
+
+    // make the next chunk of the capture available, returning false at the end
+    bool arrive(void) {
+        if (arrived >= len) {
+            return false;
+        }
+        arrived = MIN(arrived + chunk_size, len);
+        return true;
+    }
+
+    bool is_initialized() override { return true; }
+    bool tx_pending() override { return false; }
+    uint32_t txspace() override { return 1024; }
+
+    uint32_t reads;
+
+protected:
+    uint32_t _available() override { return arrived - consumed; }
+    void _begin(uint32_t baud, uint16_t rxSpace, uint16_t txSpace) override {}
+    void _end() override {}
+    void _flush() override {}
+    size_t _write(const uint8_t *buffer, size_t size) override { return size; }
+    ssize_t _read(uint8_t *buf, uint16_t count) override {
+        const uint32_t n = MIN(uint32_t(count), arrived - consumed);
+        memcpy(buf, &data[consumed], n);
+        consumed += n;
+        reads++;
+        return n;
+    }
+    bool _discard_input() override { return false; }
+
+private:
+    const uint8_t *data;
+    uint32_t len;
+    uint32_t chunk_size;
+    uint32_t arrived;
+    uint32_t consumed;
+};
+
+/*
+  NMEA capture, with noise between sentences, a sentence with a bad
+  checksum and a sentence we don't decode
+ */
+static const char nmea_capture[] =
+    "\r\n\x01\x02noise*12\r\n"
+    "$GPGGA,092750.000,5321.6802,N,00630.3372,W,1,8,1.03,61.7,M,55.2,M,,*76\r\n"
+    "$GPRMC,092750.000,A,5321.6802,N,00630.3372,W,0.02,31.66,280511,,,A*43\r\n"
+    "$GPGSV,3,1,11,10,63,137,17,07,61,098,15,05,59,290,20,08,54,157,30*70\r\n"
+    "\xb5\x62\x01\x07garbage$GP\r\n"
+    "$GPGGA,092751.000,5321.6803,N,00630.3374,W,1,8,1.03,61.8,M,55.2,M,,*7F\r\n"
+    "$GPRMC,092751.000,A,5321.6803,N,00630.3374,W,0.03,31.70,280511,,,A*44\r\n"
+    "$GPRMC,092751.000,A,5321.6803,N,00630.3374,W,0.03,31.70,280511,,,A*43\r\n";
+
+static CaptureUart uart;
+static AP_GPS gps;
+static AP_GPS::Params params;
+
+struct RxResult {
+    uint32_t parsed;
+    // RTCMv3 packets passed on by a moving baseline base
+    uint32_t rtcm;
+    AP_GPS::GPS_State state;
+};
+
+/*
+  run a driver over the capture given to the UART. After each read()
+  any RTCMv3 packet found is taken, as the frontend does, and the
+  driver is read again as a moving baseline base stops part way
+  through the bytes when it finds one
+ */
+static void run_driver(AP_GPS_Backend *driver, RxResult &result)
+{
+    while (uart.arrive()) {
+        bool found_rtcm;
+        do {
+            if (driver->read()) {
+                result.parsed++;
+            }
+            const uint8_t *bytes;
+            uint16_t len;
+            found_rtcm = driver->get_RTCMV3(bytes, len);
+            if (found_rtcm) {
+                result.rtcm++;
+                driver->clear_RTCMV3();
+            }
+        } while (found_rtcm);
+    }
+    // nothing left over
+    EXPECT_FALSE(driver->read());
+    EXPECT_EQ(uart.available(), 0U);
+    delete driver;
+}
+
+/*
+  check two runs over the same capture gave the same result. read()
+  returns true if it decoded any message, so the number of reads which
+  parsed depends on how the capture arrived and isn't compared
+ */
+static void expect_same_result(const RxResult &r, const RxResult &whole)
+{
+    EXPECT_EQ(r.rtcm, whole.rtcm);
+    EXPECT_EQ(r.state.status, whole.state.status);
+    EXPECT_EQ(r.state.location.lat, whole.state.location.lat);
+    EXPECT_EQ(r.state.location.lng, whole.state.location.lng);
+    EXPECT_EQ(r.state.location.alt, whole.state.location.alt);
+    EXPECT_EQ(r.state.ground_speed, whole.state.ground_speed);
+    EXPECT_EQ(r.state.ground_course, whole.state.ground_course);
+    EXPECT_EQ(r.state.time_week_ms, whole.state.time_week_ms);
+    EXPECT_EQ(r.state.num_sats, whole.state.num_sats);
+}
+
+// amounts arriving between each read(), splitting messages at many points
+static const uint32_t chunk_sizes[] { 1, 2, 3, 7, 13, 31, 64, 99, 100, 127, 128, 129, 300 };
+
+// feed the NMEA capture to a driver with the given amount arriving between each read()
+static RxResult feed_nmea(uint32_t chunk_size)
+{
+    RxResult result {};
+    params.type.set(AP_GPS::GPS_Type::GPS_TYPE_NMEA);
+    uart.set_capture((const uint8_t *)nmea_capture, sizeof(nmea_capture)-1, chunk_size);
+    // drivers expect to be zero initialised
+    run_driver(NEW_NOTHROW AP_GPS_NMEA(gps, params, result.state, &uart), result);
+    return result;
+}
+
+TEST(AP_GPS_RX, nmea_capture)
+{
+    const RxResult whole = feed_nmea(sizeof(nmea_capture));
+    EXPECT_EQ(whole.state.status, AP_GPS::GPS_OK_FIX_3D);
+    EXPECT_NEAR(whole.state.location.lat * 1.0e-7, 53.0 + 21.6803/60, 1.0e-6);
+    EXPECT_NEAR(whole.state.location.lng * 1.0e-7, -(6.0 + 30.3374/60), 1.0e-6);
+    EXPECT_EQ(whole.state.num_sats, 8);
+    EXPECT_GT(whole.parsed, 0U);
+    // whole capture is read a block at a time
+    EXPECT_LE(uart.reads, (sizeof(nmea_capture) + AP_GPS_RX_BLOCK_SIZE - 1) / AP_GPS_RX_BLOCK_SIZE);
+
+    // a byte at a time each fix is completed by its own read(), and
+    // the sentence with a bad checksum doesn't complete a third
+    EXPECT_EQ(feed_nmea(1).parsed, 2U);
+
+    // the same result however the capture arrives
+    for (uint32_t chunk_size : chunk_sizes) {
+        expect_same_result(feed_nmea(chunk_size), whole);
+    }
+}
+
+/*
+  a capture built from messages, stored in little endian order
+ */
+struct Capture {
+    uint8_t data[1024];
+    uint32_t len;
+
+    void add(const void *bytes, uint32_t n) {
+        memcpy(&data[len], bytes, n);
+        len += n;
+    }
+};
+
+template <typename T>
+static void put(uint8_t *buf, uint16_t ofs, T v)
+{
+    memcpy(&buf[ofs], &v, sizeof(v));
+}
+
+// add a UBX message, optionally with a corrupt checksum
+static void add_ubx(Capture &c, uint8_t msg_class, uint8_t msg_id, const uint8_t *payload, uint16_t len, bool corrupt=false)
+{
+    const uint8_t header[] { 0xB5, 0x62, msg_class, msg_id, uint8_t(len & 0xFF), uint8_t(len >> 8) };
+    uint8_t ck_a = 0, ck_b = 0;
+    for (uint8_t i=2; i<sizeof(header); i++) {
+        ck_b += (ck_a += header[i]);
+    }
+    for (uint16_t i=0; i<len; i++) {
+        ck_b += (ck_a += payload[i]);
+    }
+    const uint8_t ck[] { ck_a, uint8_t(ck_b + (corrupt ? 1 : 0)) };
+    c.add(header, sizeof(header));
+    c.add(payload, len);
+    c.add(ck, sizeof(ck));
+}
+
+// add a UBX NAV-PVT message with a 3D fix
+static void add_ubx_pvt(Capture &c, uint32_t itow, int32_t lat, int32_t lng, bool corrupt=false)
+{
+    uint8_t pvt[92] {};
+    put<uint32_t>(pvt, 0, itow);
+    pvt[20] = 3; // fix type
+    pvt[23] = 14; // satellites
+    put<int32_t>(pvt, 24, lng);
+    put<int32_t>(pvt, 28, lat);
+    put<int32_t>(pvt, 32, 102500); // height above ellipsoid, mm
+    put<int32_t>(pvt, 36, 58400); // height above MSL, mm
+    put<uint32_t>(pvt, 40, 800); // horizontal accuracy, mm
+    put<uint32_t>(pvt, 44, 1300); // vertical accuracy, mm
+    put<int32_t>(pvt, 48, 1200); // velocity N, mm/s
+    put<int32_t>(pvt, 52, -350); // velocity E, mm/s
+    put<int32_t>(pvt, 56, 20); // velocity D, mm/s
+    put<int32_t>(pvt, 60, 1250); // ground speed, mm/s
+    put<int32_t>(pvt, 64, 34370000); // heading of motion, 1e-5 deg
+    put<uint16_t>(pvt, 76, 110); // position DOP
+    add_ubx(c, 0x01, 0x07, pvt, sizeof(pvt), corrupt);
+}
+
+// add a RTCMv3 packet with the given message number
+static void add_rtcm3(Capture &c, uint16_t msg_num)
+{
+    uint8_t pkt[6+12] {};
+    const uint16_t len = sizeof(pkt) - 6;
+    pkt[0] = 0xD3;
+    pkt[1] = len >> 8;
+    pkt[2] = len & 0xFF;
+    pkt[3] = msg_num >> 4;
+    pkt[4] = (msg_num & 0xF) << 4;
+    for (uint8_t i=5; i<len+3; i++) {
+        pkt[i] = i * 11;
+    }
+    const uint32_t crc = crc_crc24(pkt, len+3);
+    pkt[len+3] = crc >> 16;
+    pkt[len+4] = crc >> 8;
+    pkt[len+5] = crc;
+    c.add(pkt, sizeof(pkt));
+}
+
+/*
+  UBX capture, with noise including false preambles, a message we
+  don't decode with a preamble in its payload and a NAV-PVT with a
+  bad checksum
+ */
+static Capture ubx_capture(void)
+{
+    Capture c {};
+    const uint8_t noise[] { 0x00, 0xB5, 0x00, 0x62, 0xB5, 0xB5, 0x13 };
+    c.add(noise, sizeof(noise));
+    add_ubx_pvt(c, 3000, -353632610, 1491652300);
+    const uint8_t unknown[] { 0xB5, 0x62, 0x01, 0x07, 0x10, 0x00, 0xB5 };
+    add_ubx(c, 0x0A, 0x7F, unknown, sizeof(unknown));
+    add_ubx_pvt(c, 3200, -353632000, 1491652000, true);
+    c.add(noise, sizeof(noise));
+    add_ubx_pvt(c, 3400, -353632710, 1491652450);
+    return c;
+}
+
+static RxResult feed_ubx(const Capture &capture, uint32_t chunk_size, AP_GPS::GPS_Role role)
+{
+    RxResult result {};
+    params.type.set(AP_GPS::GPS_Type::GPS_TYPE_UBLOX);
+    uart.set_capture(capture.data, capture.len, chunk_size);
+    run_driver(NEW_NOTHROW AP_GPS_UBLOX(gps, params, result.state, &uart, role), result);
+    return result;
+}
+
+TEST(AP_GPS_RX, ubx_capture)
+{
+    const Capture capture = ubx_capture();
+    const RxResult whole = feed_ubx(capture, capture.len, AP_GPS::GPS_ROLE_NORMAL);
+    EXPECT_GT(whole.parsed, 0U);
+    // a byte at a time each message is decoded by its own read(), so
+    // this counts the messages decoded
+    EXPECT_EQ(feed_ubx(capture, 1, AP_GPS::GPS_ROLE_NORMAL).parsed, 2U);
+    EXPECT_EQ(whole.rtcm, 0U);
+    EXPECT_EQ(whole.state.status, AP_GPS::GPS_OK_FIX_3D);
+    EXPECT_EQ(whole.state.location.lat, -353632710);
+    EXPECT_EQ(whole.state.location.lng, 1491652450);
+    EXPECT_EQ(whole.state.time_week_ms, 3400U);
+    EXPECT_EQ(whole.state.num_sats, 14);
+    EXPECT_FLOAT_EQ(whole.state.ground_speed, 1.25);
+
+    for (uint32_t chunk_size : chunk_sizes) {
+        expect_same_result(feed_ubx(capture, chunk_size, AP_GPS::GPS_ROLE_NORMAL), whole);
+    }
+}
+
+#if GPS_MOVING_BASELINE
+/*
+  a moving baseline base stops reading when it finds a RTCMv3 packet
+  so it can be passed on to the rover. The bytes after it must be
+  kept for the next read()
+ */
+TEST(AP_GPS_RX, ubx_moving_baseline_leftover)
+{
+    Capture c {};
+    add_rtcm3(c, 4072);
+    add_ubx_pvt(c, 5000, -353632610, 1491652300);
+    ASSERT_LE(c.len, uint32_t(AP_GPS_RX_BLOCK_SIZE));
+
+    AP_GPS::GPS_State state {};
+    params.type.set(AP_GPS::GPS_Type::GPS_TYPE_UBLOX);
+    uart.set_capture(c.data, c.len, c.len);
+    AP_GPS_UBLOX *ubx = NEW_NOTHROW AP_GPS_UBLOX(gps, params, state, &uart, AP_GPS::GPS_ROLE_MB_BASE);
+    ASSERT_TRUE(uart.arrive());
+
+    // the whole capture is read in one block, stopping at the packet
+    EXPECT_FALSE(ubx->read());
+    EXPECT_EQ(uart.available(), 0U);
+    const uint8_t *bytes;
+    uint16_t len;
+    ASSERT_TRUE(ubx->get_RTCMV3(bytes, len));
+    EXPECT_EQ(len, 18U);
+    EXPECT_EQ(memcmp(bytes, c.data, len), 0);
+    ubx->clear_RTCMV3();
+    EXPECT_EQ(state.time_week_ms, 0U);
+
+    // with nothing more from the port the NAV-PVT is parsed from the
+    // bytes kept from the last read()
+    EXPECT_TRUE(ubx->read());
+    EXPECT_EQ(state.time_week_ms, 5000U);
+    EXPECT_EQ(state.location.lat, -353632610);
+    EXPECT_FALSE(ubx->get_RTCMV3(bytes, len));
+    delete ubx;
+}
+
+TEST(AP_GPS_RX, ubx_moving_baseline_capture)
+{
+    Capture c {};
+    add_rtcm3(c, 4072);
+    add_ubx_pvt(c, 5000, -353632610, 1491652300);
+    add_rtcm3(c, 1077);
+    add_rtcm3(c, 1087);
+    add_ubx_pvt(c, 5200, -353632710, 1491652450);
+
+    const RxResult whole = feed_ubx(c, c.len, AP_GPS::GPS_ROLE_MB_BASE);
+    EXPECT_EQ(whole.parsed, 2U);
+    EXPECT_EQ(whole.rtcm, 3U);
+    EXPECT_EQ(whole.state.time_week_ms, 5200U);
+
+    for (uint32_t chunk_size : chunk_sizes) {
+        expect_same_result(feed_ubx(c, chunk_size, AP_GPS::GPS_ROLE_MB_BASE), whole);
+    }
+}
+#endif // GPS_MOVING_BASELINE
+
+// add a SBF PVTGeodetic block, optionally with a corrupt CRC
+static void add_sbf_pvt(Capture &c, uint32_t tow, double lat_deg, double lng_deg, bool corrupt=false)
+{
+    // header, then the revision 2 block padded to a multiple of 4 bytes
+    uint8_t block[8+88] {};
+    uint8_t *body = &block[8];
+    put<uint32_t>(body, 0, tow);
+    put<uint16_t>(body, 4, 2100); // week
+    body[6] = 1; // standalone fix
+    put<double>(body, 8, lat_deg * DEG_TO_RAD_DOUBLE);
+    put<double>(body, 16, lng_deg * DEG_TO_RAD_DOUBLE);
+    put<double>(body, 24, 102.5); // height above ellipsoid
+    put<float>(body, 32, 44.1f); // undulation
+    put<float>(body, 36, 1.2f); // velocity N
+    put<float>(body, 40, -0.35f); // velocity E
+    put<float>(body, 44, -0.02f); // velocity U
+    body[66] = 17; // satellites
+    put<uint16_t>(body, 82, 160); // horizontal accuracy
+    put<uint16_t>(body, 84, 260); // vertical accuracy
+
+    const uint16_t block_id = 4007 | (2U << 13);
+    const uint16_t length = sizeof(block);
+    block[0] = '$';
+    block[1] = '@';
+    put<uint16_t>(block, 4, block_id);
+    put<uint16_t>(block, 6, length);
+    const uint16_t crc = crc16_ccitt(&block[4], length - 4, 0) + (corrupt ? 1 : 0);
+    put<uint16_t>(block, 2, crc);
+    c.add(block, sizeof(block));
+}
+
+/*
+  SBF capture, with noise, a block with a bad CRC and a block header
+  with a bad length
+ */
+static Capture sbf_capture(void)
+{
+    Capture c {};
+    const char noise[] = "\r\n$R? noise\r\n";
+    c.add(noise, sizeof(noise)-1);
+    add_sbf_pvt(c, 7000, -35.363261, 149.165230);
+    add_sbf_pvt(c, 7100, -35.363200, 149.165200, true);
+    const uint8_t bad_length[] { '$', '@', 0x12, 0x34, 0xA7, 0x4F, 0x0A, 0x00 };
+    c.add(bad_length, sizeof(bad_length));
+    add_sbf_pvt(c, 7200, -35.363271, 149.165245);
+    return c;
+}
+
+static RxResult feed_sbf(const Capture &capture, uint32_t chunk_size)
+{
+    RxResult result {};
+    params.type.set(AP_GPS::GPS_Type::GPS_TYPE_SBF);
+    uart.set_capture(capture.data, capture.len, chunk_size);
+    run_driver(NEW_NOTHROW AP_GPS_SBF(gps, params, result.state, &uart), result);
+    return result;
+}
+
+TEST(AP_GPS_RX, sbf_capture)
+{
+    const Capture capture = sbf_capture();
+    const RxResult whole = feed_sbf(capture, capture.len);
+    EXPECT_GT(whole.parsed, 0U);
+    // a byte at a time each block is decoded by its own read()
+    EXPECT_EQ(feed_sbf(capture, 1).parsed, 2U);
+    EXPECT_EQ(whole.state.status, AP_GPS::GPS_OK_FIX_3D);
+    EXPECT_NEAR(whole.state.location.lat * 1.0e-7, -35.363271, 1.0e-6);
+    EXPECT_NEAR(whole.state.location.lng * 1.0e-7, 149.165245, 1.0e-6);
+    EXPECT_EQ(whole.state.time_week_ms, 7200U);
+    EXPECT_EQ(whole.state.num_sats, 17);
+
+    for (uint32_t chunk_size : chunk_sizes) {
+        expect_same_result(feed_sbf(capture, chunk_size), whole);
+    }
+}
+
+/*
+  driver which counts the UBX preambles found by rx_skip_to()
+ */
+class SyncBackend : public AP_GPS_Backend {
+public:
+    using AP_GPS_Backend::AP_GPS_Backend;
+
+    bool read() override {
+        rx_begin();
+        while (rx_skip_to(0xB5, '$')) {
+            uint8_t b;
+            if (!rx_byte(b)) {
+                break;
+            }
+            if (b == 0xB5) {
+                ubx++;
+            } else {
+                nmea++;
+            }
+        }
+        return false;
+    }
+    const char *name() const override { return "Sync"; }
+
+    uint32_t ubx;
+    uint32_t nmea;
+};
+
+TEST(AP_GPS_RX, skip_to_sync)
+{
+    uint8_t capture[1000];
+    uint32_t ubx = 0, nmea = 0;
+    for (uint16_t i=0; i<sizeof(capture); i++) {
+        capture[i] = (i * 37 + (i >> 3)) & 0xFF;
+        if (capture[i] == 0xB5) {
+            ubx++;
+        } else if (capture[i] == '$') {
+            nmea++;
+        }
+    }
+    ASSERT_GT(ubx, 0U);
+    ASSERT_GT(nmea, 0U);
+
+    for (uint32_t chunk_size : { 1U, 5U, 128U, 1000U }) {
+        AP_GPS::GPS_State state {};
+        uart.set_capture(capture, sizeof(capture), chunk_size);
+        SyncBackend *backend = NEW_NOTHROW SyncBackend(gps, params, state, &uart);
+        while (uart.arrive()) {
+            backend->read();
+        }
+        EXPECT_EQ(backend->ubx, ubx);
+        EXPECT_EQ(backend->nmea, nmea);
+        delete backend;
+    }
+}
+
+AP_GTEST_MAIN()
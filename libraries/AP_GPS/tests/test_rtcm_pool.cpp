@@ -0,0 +1,164 @@
+#include <AP_gtest.h>
+
+#include <AP_GPS/RTCM_FramePool.h>
+#include <AP_Math/AP_Math.h>
+
+const AP_HAL::HAL &hal = AP_HAL::get_HAL();
+
+// fill a frame with a pattern from its sequence number
+static void fill_frame(uint8_t *data, uint16_t len, uint32_t seq)
+{
+    for (uint16_t i=0; i<len; i++) {
+        data[i] = uint8_t(seq * 7 + i);
+    }
+}
+
+static bool check_frame(const uint8_t *data, uint16_t len, uint32_t seq, uint16_t start=0)
+{
+    for (uint16_t i=start; i<len; i++) {
+        if (data[i] != uint8_t(seq * 7 + i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+TEST(RTCM_FramePool, SharedFrames)
+{
+    RTCM_FramePool *pool = NEW_NOTHROW RTCM_FramePool();
+    ASSERT_TRUE(pool->init(1024));
+
+    uint8_t data[100];
+    for (uint8_t seq=0; seq<5; seq++) {
+        fill_frame(data, sizeof(data), seq);
+        EXPECT_TRUE(pool->push(data, sizeof(data), 0x3));
+    }
+    EXPECT_EQ(pool->pending(0), 500U);
+    EXPECT_EQ(pool->pending(1), 500U);
+    EXPECT_EQ(pool->pending(2), 0U);
+
+    // consumer 0 takes everything, consumer 1 takes one frame
+    const uint8_t *frame;
+    uint16_t len;
+    for (uint8_t seq=0; seq<5; seq++) {
+        ASSERT_TRUE(pool->peek(0, frame, len));
+        EXPECT_EQ(len, sizeof(data));
+        EXPECT_TRUE(check_frame(frame, len, seq));
+        pool->take(0);
+    }
+    EXPECT_FALSE(pool->peek(0, frame, len));
+    ASSERT_TRUE(pool->peek(1, frame, len));
+    EXPECT_TRUE(check_frame(frame, len, 0));
+    pool->take(1);
+    EXPECT_EQ(pool->pending(1), 400U);
+
+    // frames are still there for the slower consumer
+    ASSERT_TRUE(pool->peek(1, frame, len));
+    EXPECT_TRUE(check_frame(frame, len, 1));
+
+    EXPECT_EQ(pool->get_stats(0).frames, 5U);
+    EXPECT_EQ(pool->get_stats(0).bytes, 500U);
+    EXPECT_EQ(pool->get_stats(1).frames, 1U);
+
+    // a frame larger than the pool is refused
+    uint8_t big[1025] {};
+    EXPECT_FALSE(pool->push(big, sizeof(big), 0x1));
+
+    delete pool;
+}
+
+TEST(RTCM_FramePool, DropOldest)
+{
+    RTCM_FramePool *pool = NEW_NOTHROW RTCM_FramePool();
+    ASSERT_TRUE(pool->init(1000));
+
+    // consumer 1 never takes, so frames are dropped to make space
+    uint8_t data[300];
+    const uint8_t *frame;
+    uint16_t len;
+    for (uint8_t seq=0; seq<10; seq++) {
+        fill_frame(data, sizeof(data), seq);
+        ASSERT_TRUE(pool->push(data, sizeof(data), 0x3));
+        ASSERT_TRUE(pool->peek(0, frame, len));
+        EXPECT_TRUE(check_frame(frame, len, seq));
+        pool->take(0);
+    }
+    EXPECT_EQ(pool->get_stats(0).dropped, 0U);
+    EXPECT_EQ(pool->get_stats(1).dropped, 7U);
+    EXPECT_EQ(pool->pending(1), 900U);
+
+    // the newest frames are kept
+    for (uint8_t seq=7; seq<10; seq++) {
+        ASSERT_TRUE(pool->peek(1, frame, len));
+        EXPECT_TRUE(check_frame(frame, len, seq));
+        pool->take(1);
+    }
+    EXPECT_FALSE(pool->peek(1, frame, len));
+
+    // flushing counts drops
+    ASSERT_TRUE(pool->push(data, sizeof(data), 0x2));
+    pool->flush(1);
+    EXPECT_EQ(pool->get_stats(1).dropped, 8U);
+    EXPECT_EQ(pool->pending(1), 0U);
+
+    delete pool;
+}
+
+/*
+  random frame sizes with consumers taking at random rates, checking
+  each consumer gets its frames in order with no corruption, and
+  every frame is either taken or counted as dropped
+ */
+TEST(RTCM_FramePool, RandomPace)
+{
+    RTCM_FramePool *pool = NEW_NOTHROW RTCM_FramePool();
+    ASSERT_TRUE(pool->init(3072));
+
+    const uint8_t num_consumers = 3;
+    uint32_t pushed[num_consumers] {};
+    uint32_t next_seq[num_consumers] {};
+    uint8_t data[720];
+    const uint8_t *frame;
+    uint16_t len;
+    uint32_t seed = 1;
+
+    for (uint32_t seq=0; seq<20000; seq++) {
+        seed = seed * 1103515245U + 12345U;
+        const uint16_t flen = 1 + (seed >> 8) % sizeof(data);
+        const uint8_t consumers = 1 + (seed >> 20) % 7;
+        fill_frame(data, flen, seq);
+        // store the sequence number in the first bytes
+        memcpy(data, &seq, sizeof(seq));
+        ASSERT_TRUE(pool->push(data, MAX(flen, sizeof(seq)), consumers));
+        for (uint8_t c=0; c<num_consumers; c++) {
+            if (consumers & (1U<<c)) {
+                pushed[c]++;
+            }
+            // consumer c takes up to c+1 frames per push
+            seed = seed * 1103515245U + 12345U;
+            uint8_t n = (seed >> 16) % (c+2);
+            while (n-- > 0 && pool->peek(c, frame, len)) {
+                uint32_t fseq;
+                memcpy(&fseq, frame, sizeof(fseq));
+                ASSERT_GE(fseq, next_seq[c]);
+                next_seq[c] = fseq + 1;
+                ASSERT_TRUE(check_frame(frame, len, fseq, sizeof(fseq)));
+                pool->take(c);
+            }
+        }
+    }
+    for (uint8_t c=0; c<num_consumers; c++) {
+        while (pool->peek(c, frame, len)) {
+            pool->take(c);
+        }
+        const auto &stats = pool->get_stats(c);
+        EXPECT_EQ(stats.frames + stats.dropped, pushed[c]);
+        EXPECT_GT(stats.frames, 0U);
+    }
+    // the slowest consumer must have dropped frames
+    EXPECT_GT(pool->get_stats(0).dropped, 0U);
+
+    delete pool;
+}
+
+AP_GTEST_MAIN()
@@ -191,6 +191,64 @@ bool AP_HAL::Device::read_registers(uint8_t first_reg, uint8_t *recv, uint32_t r
     return result;
 }
 
+/*
+  default batch implementation, one transfer() per transaction
+ */
+bool AP_HAL::Device::transfer_batch(const Transaction *transactions, uint8_t count)
+{
+    for (uint8_t i=0; i<count; i++) {
+        const Transaction &t = transactions[i];
+        if (!transfer(t.send, t.send_len, t.recv, t.recv_len)) {
+            return false;
+        }
+    }
+    return count > 0;
+}
+
+bool AP_HAL::Device::Batch::read_registers(uint8_t first_reg, uint8_t *recv, uint32_t recv_len)
+{
+    if (_count >= MAX_TRANSACTIONS) {
+        return false;
+    }
+    _regs[_count][0] = first_reg | _dev._read_flag;
+    _regs[_count][1] = first_reg;
+    _transactions[_count] = Transaction { _regs[_count], 1, recv, recv_len };
+    _count++;
+    return true;
+}
+
+bool AP_HAL::Device::Batch::write_register(uint8_t reg, uint8_t val)
+{
+    if (_count >= MAX_TRANSACTIONS) {
+        return false;
+    }
+    _regs[_count][0] = reg;
+    _regs[_count][1] = val;
+    _transactions[_count] = Transaction { _regs[_count], 2, nullptr, 0 };
+    _count++;
+    return true;
+}
+
+bool AP_HAL::Device::Batch::submit()
+{
+    const uint8_t n = _count;
+    _count = 0;
+    if (!_dev.transfer_batch(_transactions, n)) {
+        return false;
+    }
+    if (_dev._register_rw_callback) {
+        for (uint8_t i=0; i<n; i++) {
+            const Transaction &t = _transactions[i];
+            if (t.recv != nullptr) {
+                _dev._register_rw_callback(_regs[i][1], t.recv, t.recv_len, false);
+            } else {
+                _dev._register_rw_callback(_regs[i][0], &_regs[i][1], 1, true);
+            }
+        }
+    }
+    return true;
+}
+
 bool AP_HAL::Device::transfer_bank(uint8_t bank, const uint8_t *send, uint32_t send_len,
                         uint8_t *recv, uint32_t recv_len)
 {
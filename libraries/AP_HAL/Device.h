@@ -22,6 +22,8 @@
 #include "utility/functor.h"
 #include "AP_HAL_Boards.h"
 
+#include <AP_Common/AP_Common.h>
+
 #if CONFIG_HAL_BOARD != HAL_BOARD_QURT
 // we need utility for std::move, but not on QURT due to a include error in hexagon SDK
 #include <utility>
@@ -138,6 +140,70 @@ public:
         return transfer(send_recv, len, send_recv, len);
     }
 
+    /*
+     * One transaction in a batch passed to #transfer_batch(). Each
+     * transaction is equivalent to a call to #transfer() with the same
+     * arguments.
+     */
+    struct Transaction {
+        const uint8_t *send;
+        uint32_t send_len;
+        uint8_t *recv;
+        uint32_t recv_len;
+    };
+
+    /*
+     * Perform count independent transactions in order. Buses which can
+     * queue several messages in one operation (for example a single
+     * ioctl on Linux) override this to reduce the per-transaction
+     * overhead. On SPI the chip select is released between
+     * transactions. The default implementation calls #transfer() for
+     * each transaction.
+     *
+     * Return: true if all transactions succeeded, false on failure,
+     * in which case the contents of all receive buffers are undefined.
+     */
+    virtual bool transfer_batch(const Transaction *transactions, uint8_t count);
+
+    /*
+     * Helper to build a batch of register reads and writes for
+     * #transfer_batch(). The read flag and register read/write callback
+     * are handled as for #read_registers() and #write_register().
+     *
+     *     AP_HAL::Device::Batch batch(*dev);
+     *     batch.read_registers(REG_STATUS, &status, 1);
+     *     batch.read_registers(REG_DATA, data, sizeof(data));
+     *     if (!batch.submit()) { ... }
+     */
+    class Batch {
+    public:
+        static constexpr uint8_t MAX_TRANSACTIONS = 8;
+
+        Batch(Device &dev) : _dev(dev) {}
+
+        /* Do not allow copies */
+        CLASS_NO_COPY(Batch);
+
+        // queue a read of recv_len registers starting at first_reg
+        bool read_registers(uint8_t first_reg, uint8_t *recv, uint32_t recv_len);
+
+        // queue a write of a single register
+        bool write_register(uint8_t reg, uint8_t val);
+
+        // perform all queued transactions and empty the batch
+        bool submit();
+
+        uint8_t count() const { return _count; }
+
+    private:
+        Device &_dev;
+        Transaction _transactions[MAX_TRANSACTIONS];
+        // bytes sent for each transaction. For reads the second byte
+        // holds the register number without the read flag
+        uint8_t _regs[MAX_TRANSACTIONS][2];
+        uint8_t _count = 0;
+    };
+
     /*
      * Sets the required flags before transaction starts
      * this is to be used by Wide SPI communication interfaces like
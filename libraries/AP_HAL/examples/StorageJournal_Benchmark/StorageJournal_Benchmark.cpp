@@ -0,0 +1,159 @@
+/*
+  storage journal write amplification and mount time benchmark
+
+  Runs a parameter save workload (small writes scattered over the
+  storage) and a mission upload workload (sequential writes), feeding
+  changes to the journal in 8 byte lines as the SITL storage driver
+  does. For each it reports the bytes written to the journal, including
+  compaction, against the bytes changed and against rewriting the
+  dirty lines in place as the SITL (8 byte lines) and Linux (512 byte
+  lines) storage drivers do, then the time to mount the journal
+
+    ./waf configure --board sitl
+    ./waf --target examples/StorageJournal_Benchmark
+    ./build/sitl/examples/StorageJournal_Benchmark
+ */
+
+#include <AP_HAL/AP_HAL.h>
+#include <AP_HAL/utility/StorageJournal.h>
+#include <AP_Math/AP_Math.h>
+#include <stdio.h>
+#include <unistd.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+void setup();
+void loop();
+
+#if HAL_STORAGE_JOURNAL_ENABLED
+
+static constexpr uint16_t storage_size = 16384;
+static constexpr uint8_t line_size = 8;
+static constexpr uint16_t linux_line_size = 512;
+static constexpr const char *path = "journal_benchmark.jnl";
+
+static uint8_t mem[storage_size];
+
+struct Workload {
+    StorageJournal *journal;
+    uint64_t changed_bytes;
+    uint64_t inplace_bytes;
+    uint64_t inplace_linux_bytes;
+};
+
+// bytes in the lines of line_len covering a change
+static uint16_t covering(uint16_t offset, uint16_t length, uint16_t line_len)
+{
+    const uint16_t start = offset - (offset % line_len);
+    const uint16_t end = offset + length;
+    return ((end - start + line_len - 1) / line_len) * line_len;
+}
+
+// change length bytes at offset and pass the covering lines to the journal
+static void change(Workload &w, uint16_t offset, uint16_t length)
+{
+    for (uint16_t i=0; i<length; i++) {
+        mem[offset+i] = get_random16();
+    }
+    const uint16_t n = covering(offset, length, line_size);
+    w.changed_bytes += length;
+    w.inplace_bytes += n;
+    w.inplace_linux_bytes += covering(offset, length, linux_line_size);
+    w.journal->write(offset & ~(line_size-1), n);
+    w.journal->compact_step();
+}
+
+static void report(const char *name, const Workload &w)
+{
+    const auto &stats = w.journal->get_stats();
+    hal.console->printf("%-14s changed %6u  in-place %7u/%8u  journal %7u  amplification %.2f (in-place %.2f/%.2f)  compactions %u\n",
+                        name,
+                        unsigned(w.changed_bytes),
+                        unsigned(w.inplace_bytes),
+                        unsigned(w.inplace_linux_bytes),
+                        unsigned(stats.file_bytes),
+                        double(stats.file_bytes) / w.changed_bytes,
+                        double(w.inplace_bytes) / w.changed_bytes,
+                        double(w.inplace_linux_bytes) / w.changed_bytes,
+                        unsigned(stats.compactions));
+}
+
+static void report_mount(void)
+{
+    static uint8_t copy[storage_size];
+    StorageJournal j(copy, storage_size);
+    if (!j.init(path)) {
+        hal.console->printf("mount failed\n");
+        return;
+    }
+    const auto &stats = j.get_stats();
+    hal.console->printf("    mount %5u us, %5u records%s\n",
+                        unsigned(stats.mount_us), unsigned(stats.records_replayed),
+                        memcmp(copy, mem, storage_size) == 0 ? "" : " MISMATCH");
+}
+
+// parameter saves: a 3 byte header and a float at random places
+static void param_save(uint16_t count)
+{
+    StorageJournal j(mem, storage_size);
+    j.init(path);
+    Workload w {};
+    w.journal = &j;
+    for (uint16_t i=0; i<count; i++) {
+        change(w, get_random16() % (storage_size - 7), 7);
+    }
+    char name[20];
+    snprintf(name, sizeof(name), "param x%u", unsigned(count));
+    report(name, w);
+}
+
+// mission upload: sequential 15 byte items, several changed per tick
+static void mission_upload(uint16_t items)
+{
+    StorageJournal j(mem, storage_size);
+    j.init(path);
+    Workload w {};
+    w.journal = &j;
+    static constexpr uint8_t item_size = 15;
+    static constexpr uint8_t items_per_tick = 4;
+    const uint16_t base = 4096;
+    items = MIN(items, (storage_size - base) / item_size);
+    for (uint16_t i=0; i<items; i+=items_per_tick) {
+        const uint16_t n = MIN(items_per_tick, items - i);
+        change(w, base + i * item_size, n * item_size);
+    }
+    char name[20];
+    snprintf(name, sizeof(name), "mission x%u", unsigned(items));
+    report(name, w);
+}
+
+void setup()
+{
+    hal.console->printf("Storage journal benchmark, %u byte storage\n", unsigned(storage_size));
+    unlink(path);
+    for (const uint16_t count : { 100, 1000, 10000 }) {
+        param_save(count);
+        report_mount();
+    }
+    for (const uint16_t items : { 100, 700 }) {
+        mission_upload(items);
+        report_mount();
+    }
+    unlink(path);
+}
+
+#else
+
+void setup()
+{
+    hal.console->printf("Storage journal not supported on this board\n");
+}
+
+#endif  // HAL_STORAGE_JOURNAL_ENABLED
+
+void loop()
+{
+    hal.scheduler->delay(1000);
+}
+
+AP_HAL_MAIN();
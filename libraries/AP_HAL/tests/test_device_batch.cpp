@@ -0,0 +1,116 @@
+#include <AP_gtest.h>
+#include <AP_HAL/HAL.h>
+#include <AP_HAL/Device.h>
+
+#include <string.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+/*
+  fake register-file device. Reads return the register contents
+  starting at the first register sent, writes set a register. Like
+  all devices it relies on zeroed allocation so must be created with
+  NEW_NOTHROW
+ */
+class FakeDevice : public AP_HAL::Device {
+public:
+    FakeDevice() : AP_HAL::Device(BUS_TYPE_SITL) {
+        for (uint16_t i = 0; i < sizeof(regs); i++) {
+            regs[i] = i;
+        }
+    }
+
+    bool set_speed(Speed speed) override { return true; }
+
+    bool transfer(const uint8_t *send, uint32_t send_len,
+                  uint8_t *recv, uint32_t recv_len) override
+    {
+        transfers++;
+        if (fail_at != 0 && transfers == fail_at) {
+            return false;
+        }
+        if (send_len == 0) {
+            return false;
+        }
+        const uint8_t reg = send[0] & 0x7F;
+        if (recv_len != 0) {
+            memcpy(recv, &regs[reg], recv_len);
+        } else if (send_len == 2) {
+            regs[reg] = send[1];
+        }
+        return true;
+    }
+
+    AP_HAL::Semaphore *get_semaphore() override { return nullptr; }
+    PeriodicHandle register_periodic_callback(uint32_t period_usec, PeriodicCb) override { return nullptr; }
+    bool adjust_periodic_callback(PeriodicHandle h, uint32_t period_usec) override { return false; }
+
+    uint8_t regs[256];
+    uint32_t transfers = 0;
+    uint32_t fail_at = 0;
+};
+
+TEST(DeviceBatch, ReadWrite)
+{
+    FakeDevice *dev = NEW_NOTHROW FakeDevice();
+    ASSERT_NE(dev, nullptr);
+    dev->set_read_flag(0x80);
+
+    uint8_t status = 0;
+    uint8_t data[6] {};
+
+    AP_HAL::Device::Batch batch(*dev);
+    EXPECT_TRUE(batch.write_register(0x10, 0xAA));
+    EXPECT_TRUE(batch.read_registers(0x10, &status, 1));
+    EXPECT_TRUE(batch.read_registers(0x20, data, sizeof(data)));
+    EXPECT_EQ(batch.count(), 3);
+
+    EXPECT_TRUE(batch.submit());
+    EXPECT_EQ(batch.count(), 0);
+    EXPECT_EQ(dev->transfers, 3U);
+    EXPECT_EQ(status, 0xAA);
+    for (uint8_t i = 0; i < sizeof(data); i++) {
+        EXPECT_EQ(data[i], 0x20 + i);
+    }
+    delete dev;
+}
+
+TEST(DeviceBatch, Full)
+{
+    FakeDevice *dev = NEW_NOTHROW FakeDevice();
+    ASSERT_NE(dev, nullptr);
+    uint8_t v[AP_HAL::Device::Batch::MAX_TRANSACTIONS + 1];
+
+    AP_HAL::Device::Batch batch(*dev);
+    for (uint8_t i = 0; i < AP_HAL::Device::Batch::MAX_TRANSACTIONS; i++) {
+        EXPECT_TRUE(batch.read_registers(i, &v[i], 1));
+    }
+    EXPECT_FALSE(batch.read_registers(0, &v[AP_HAL::Device::Batch::MAX_TRANSACTIONS], 1));
+    EXPECT_TRUE(batch.submit());
+    for (uint8_t i = 0; i < AP_HAL::Device::Batch::MAX_TRANSACTIONS; i++) {
+        EXPECT_EQ(v[i], i);
+    }
+    delete dev;
+}
+
+TEST(DeviceBatch, Failure)
+{
+    FakeDevice *dev = NEW_NOTHROW FakeDevice();
+    ASSERT_NE(dev, nullptr);
+    dev->fail_at = 2;
+    uint8_t a, b, c;
+
+    AP_HAL::Device::Batch batch(*dev);
+    batch.read_registers(1, &a, 1);
+    batch.read_registers(2, &b, 1);
+    batch.read_registers(3, &c, 1);
+    EXPECT_FALSE(batch.submit());
+    // the batch stops at the first failed transaction
+    EXPECT_EQ(dev->transfers, 2U);
+
+    // an empty batch is an error, as with transfer() with nothing to do
+    EXPECT_FALSE(batch.submit());
+    delete dev;
+}
+
+AP_GTEST_MAIN()
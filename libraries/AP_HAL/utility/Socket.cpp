@@ -55,6 +55,13 @@
 #define MSG_NOSIGNAL 0
 #endif
 
+// sendmmsg() and recvmmsg() are only available with native sockets on Linux
+#if defined(__linux__) && !(AP_NETWORKING_BACKEND_CHIBIOS || AP_NETWORKING_BACKEND_PPP)
+#define SOCKET_HAVE_MMSG 1
+#else
+#define SOCKET_HAVE_MMSG 0
+#endif
+
 /*
   constructor
  */
@@ -382,6 +389,127 @@ ssize_t SOCKET_CLASS_NAME::recv(void *buf, size_t size, uint32_t timeout_ms)
     return ret;
 }
 
+/*
+  send several datagrams
+ */
+ssize_t SOCKET_CLASS_NAME::send_datagrams(const Datagram *dgrams, uint8_t count, uint32_t address, uint16_t port)
+{
+    if (fd == -1 || count == 0) {
+        return -1;
+    }
+    struct sockaddr_in sockaddr = {};
+    if (address != 0) {
+#ifdef HAVE_SOCK_SIN_LEN
+        sockaddr.sin_len = sizeof(sockaddr);
+#endif
+        sockaddr.sin_port = htons(port);
+        sockaddr.sin_family = AF_INET;
+        sockaddr.sin_addr.s_addr = htonl(address);
+    }
+
+    struct iovec iov[count][2];
+    for (uint8_t i=0; i<count; i++) {
+        for (uint8_t v=0; v<dgrams[i].num_vec; v++) {
+            iov[i][v].iov_base = dgrams[i].vec[v].data;
+            iov[i][v].iov_len = dgrams[i].vec[v].len;
+        }
+    }
+
+#if SOCKET_HAVE_MMSG
+    if (datagram && count > 1) {
+        struct mmsghdr msgs[count];
+        memset(msgs, 0, sizeof(msgs));
+        for (uint8_t i=0; i<count; i++) {
+            if (address != 0) {
+                msgs[i].msg_hdr.msg_name = &sockaddr;
+                msgs[i].msg_hdr.msg_namelen = sizeof(sockaddr);
+            }
+            msgs[i].msg_hdr.msg_iov = iov[i];
+            msgs[i].msg_hdr.msg_iovlen = dgrams[i].num_vec;
+        }
+        const int n = ::sendmmsg(fd, msgs, count, MSG_NOSIGNAL);
+        if (n <= 0) {
+            return -1;
+        }
+        ssize_t total = 0;
+        for (int i=0; i<n; i++) {
+            total += msgs[i].msg_len;
+        }
+        return total;
+    }
+#endif
+
+    ssize_t total = 0;
+    for (uint8_t i=0; i<count; i++) {
+        struct msghdr msg {};
+        if (address != 0) {
+            msg.msg_name = &sockaddr;
+            msg.msg_namelen = sizeof(sockaddr);
+        }
+        msg.msg_iov = iov[i];
+        msg.msg_iovlen = dgrams[i].num_vec;
+        const ssize_t ret = CALL_PREFIX(sendmsg)(fd, &msg, MSG_NOSIGNAL);
+        if (ret <= 0) {
+            break;
+        }
+        total += ret;
+        if (!datagram) {
+            // the stream may not have room for the rest
+            break;
+        }
+    }
+    return total > 0 ? total : -1;
+}
+
+/*
+  receive several datagrams
+ */
+ssize_t SOCKET_CLASS_NAME::recv_datagrams(uint8_t *buf, uint32_t size, uint16_t max_len, uint8_t max_count, uint8_t &count)
+{
+    count = 0;
+#if SOCKET_HAVE_MMSG
+    // multicast sockets need the check for packets from ourselves in recv()
+    if (max_count > size / max_len) {
+        max_count = size / max_len;
+    }
+    if (datagram && fd_in == -1 && max_count > 1) {
+        struct mmsghdr msgs[max_count];
+        struct iovec iov[max_count];
+        uint32_t in_addr[max_count][4];
+        memset(msgs, 0, sizeof(msgs));
+        for (uint8_t i=0; i<max_count; i++) {
+            iov[i].iov_base = &buf[i*max_len];
+            iov[i].iov_len = max_len;
+            msgs[i].msg_hdr.msg_iov = &iov[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+            msgs[i].msg_hdr.msg_name = &in_addr[i][0];
+            msgs[i].msg_hdr.msg_namelen = sizeof(in_addr[i]);
+        }
+        const int n = ::recvmmsg(fd, msgs, max_count, MSG_DONTWAIT, nullptr);
+        if (n <= 0) {
+            return -1;
+        }
+        // pack the datagrams together
+        uint32_t total = 0;
+        for (int i=0; i<n; i++) {
+            const uint32_t len = msgs[i].msg_len;
+            if (total != uint32_t(i*max_len)) {
+                memmove(&buf[total], &buf[i*max_len], len);
+            }
+            total += len;
+        }
+        memcpy(last_in_addr, in_addr[n-1], sizeof(last_in_addr));
+        count = n;
+        return total;
+    }
+#endif
+    const ssize_t ret = recv(buf, (datagram && size > max_len) ? max_len : size, 0);
+    if (ret > 0) {
+        count = 1;
+    }
+    return ret;
+}
+
 /*
   return the IP address and port of the last received packet
  */
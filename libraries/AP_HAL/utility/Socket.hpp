@@ -18,6 +18,7 @@
 
 #include <AP_HAL/AP_HAL.h>
 #include <AP_Networking/AP_Networking_Config.h>
+#include "RingBuffer.h"
 
 #if AP_NETWORKING_SOCKETS_ENABLED || defined(AP_SOCKET_NATIVE_ENABLED)
 
@@ -46,6 +47,32 @@ public:
     ssize_t sendto(const void *buf, size_t size, uint32_t address, uint16_t port);
     ssize_t recv(void *pkt, size_t size, uint32_t timeout_ms);
 
+    // a datagram gathered from up to two parts, such as the two
+    // halves of a ring buffer
+    struct Datagram {
+        ByteBuffer::IoVec vec[2];
+        uint8_t num_vec;
+    };
+
+    /*
+      send several datagrams, with a single system call where the OS
+      supports it. With an address of zero the connected address is
+      used. Returns the number of bytes in the datagrams that were
+      sent, or -1 if none were sent. On a stream socket one datagram
+      may be partly sent
+     */
+    ssize_t send_datagrams(const Datagram *dgrams, uint8_t count, uint32_t address=0, uint16_t port=0);
+
+    /*
+      receive up to max_count datagrams of up to max_len bytes without
+      blocking, with a single system call where the OS supports
+      it. The datagrams are packed together in buf, and the number
+      received is returned in count. Returns the number of bytes
+      received, with the same meaning as recv() for 0 and -1. On a
+      stream socket this is the same as recv()
+     */
+    ssize_t recv_datagrams(uint8_t *buf, uint32_t size, uint16_t max_len, uint8_t max_count, uint8_t &count);
+
     // return the IP address and port of the last received packet
     void last_recv_address(const char *&ip_addr, uint16_t &port) const;
 
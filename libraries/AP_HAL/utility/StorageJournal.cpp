@@ -0,0 +1,316 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "StorageJournal.h"
+
+#if HAL_STORAGE_JOURNAL_ENABLED
+
+#include <AP_HAL/AP_HAL.h>
+#include <AP_Math/AP_Math.h>
+#include <AP_Math/crc.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <libgen.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+StorageJournal::StorageJournal(uint8_t *_mem_buffer, uint16_t _storage_size) :
+    mem_buffer(_mem_buffer),
+    storage_size(_storage_size)
+{
+    // compact once the journal holds about four copies of the storage
+    compact_threshold = 4U * storage_size + sizeof(file_header);
+}
+
+StorageJournal::~StorageJournal()
+{
+    abort_compaction();
+    if (fd != -1) {
+        close(fd);
+    }
+    free(path);
+    free(tmp_path);
+}
+
+uint32_t StorageJournal::header_crc(const file_header &hdr) const
+{
+    return crc_crc32(0, (const uint8_t *)&hdr, offsetof(file_header, crc));
+}
+
+uint32_t StorageJournal::record_crc(const record_header &rec, const uint8_t *data) const
+{
+    const uint32_t crc = crc_crc32(0, (const uint8_t *)&rec, offsetof(record_header, crc));
+    return crc_crc32(crc, data, rec.length);
+}
+
+bool StorageJournal::init(const char *_path)
+{
+    const uint64_t start_us = AP_HAL::micros64();
+
+    free(path);
+    free(tmp_path);
+    path = strdup(_path);
+    if (path == nullptr || asprintf(&tmp_path, "%s.tmp", path) == -1) {
+        tmp_path = nullptr;
+        return false;
+    }
+
+    // a leftover compaction file was never renamed so is incomplete
+    unlink(tmp_path);
+
+    fd = open(path, O_RDWR|O_CLOEXEC);
+    if (fd != -1 && !replay()) {
+        close(fd);
+        fd = -1;
+    }
+    if (fd == -1) {
+        // create the journal from mem_buffer. This is a compaction
+        // done all at once, so the file appears complete or not at all
+        if (!start_compaction()) {
+            return false;
+        }
+        while (tmp_fd != -1) {
+            if (!compact_step()) {
+                abort_compaction();
+                return false;
+            }
+        }
+    }
+
+    stats.mount_us = AP_HAL::micros64() - start_us;
+    return fd != -1;
+}
+
+/*
+  replay the journal into mem_buffer. Returns false if the file header
+  is not valid
+ */
+bool StorageJournal::replay(void)
+{
+    file_header hdr;
+    if (pread(fd, &hdr, sizeof(hdr), 0) != sizeof(hdr) ||
+        hdr.magic != file_magic ||
+        hdr.version != file_version ||
+        hdr.crc != header_crc(hdr)) {
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        return false;
+    }
+
+    uint8_t *data = &record_buf[sizeof(record_header)];
+
+    memset(mem_buffer, 0, storage_size);
+
+    uint32_t ofs = sizeof(hdr);
+    while (ofs + sizeof(record_header) <= uint32_t(st.st_size)) {
+        record_header rec;
+        if (pread(fd, &rec, sizeof(rec), ofs) != sizeof(rec) ||
+            rec.magic != record_magic ||
+            rec.length == 0 ||
+            rec.length > max_record_length ||
+            ofs + sizeof(rec) + rec.length > uint32_t(st.st_size)) {
+            break;
+        }
+        if (pread(fd, data, rec.length, ofs + sizeof(rec)) != rec.length ||
+            rec.crc != record_crc(rec, data)) {
+            break;
+        }
+        // records written with a larger storage size are clipped
+        if (rec.offset < storage_size) {
+            const uint16_t n = MIN(rec.length, uint16_t(storage_size - rec.offset));
+            memcpy(&mem_buffer[rec.offset], data, n);
+        }
+        stats.records_replayed++;
+        ofs += sizeof(rec) + rec.length;
+    }
+
+    // drop anything after the last good record so new records
+    // follow it directly
+    if (ofs < uint32_t(st.st_size)) {
+        stats.bytes_discarded = st.st_size - ofs;
+        if (ftruncate(fd, ofs) != 0) {
+            return false;
+        }
+    }
+    file_end = ofs;
+    return true;
+}
+
+/*
+  append a record of mem_buffer contents to a journal file. The data
+  is copied first so the CRC matches what is written even if
+  mem_buffer changes underneath us
+ */
+bool StorageJournal::append(int wfd, uint32_t &end, uint16_t offset, uint16_t length)
+{
+    record_header &rec = *(record_header *)record_buf;
+    uint8_t *data = &record_buf[sizeof(record_header)];
+    memcpy(data, &mem_buffer[offset], length);
+    rec.magic = record_magic;
+    rec.offset = offset;
+    rec.length = length;
+    rec.reserved = 0;
+    rec.crc = record_crc(rec, data);
+
+    const ssize_t total = sizeof(rec) + length;
+    if (pwrite(wfd, record_buf, total, end) != total) {
+        // don't leave a partial record for later records to follow
+        if (ftruncate(wfd, end) != 0) {
+            return false;
+        }
+        return false;
+    }
+    end += total;
+    stats.file_bytes += total;
+    return true;
+}
+
+bool StorageJournal::write(uint16_t offset, uint16_t length)
+{
+    if (fd == -1 || offset >= storage_size) {
+        return false;
+    }
+    length = MIN(length, uint16_t(storage_size - offset));
+    stats.payload_bytes += length;
+
+    while (length > 0) {
+        const uint16_t n = MIN(length, max_record_length);
+        if (!append(fd, file_end, offset, n)) {
+            return false;
+        }
+        if (tmp_fd != -1 && !append(tmp_fd, tmp_end, offset, n)) {
+            abort_compaction();
+        }
+        offset += n;
+        length -= n;
+    }
+    return true;
+}
+
+bool StorageJournal::sync(void)
+{
+    if (fd == -1) {
+        return false;
+    }
+    return fsync(fd) == 0;
+}
+
+/*
+  start writing a new journal containing a snapshot of mem_buffer
+ */
+bool StorageJournal::start_compaction(void)
+{
+    tmp_fd = open(tmp_path, O_RDWR|O_CREAT|O_TRUNC|O_CLOEXEC, 0644);
+    if (tmp_fd == -1) {
+        return false;
+    }
+    file_header hdr {};
+    hdr.magic = file_magic;
+    hdr.version = file_version;
+    hdr.storage_size = storage_size;
+    hdr.crc = header_crc(hdr);
+    if (pwrite(tmp_fd, &hdr, sizeof(hdr), 0) != sizeof(hdr)) {
+        abort_compaction();
+        return false;
+    }
+    tmp_end = sizeof(hdr);
+    stats.file_bytes += sizeof(hdr);
+    compact_offset = 0;
+    return true;
+}
+
+bool StorageJournal::compact_step(void)
+{
+    if (tmp_fd == -1) {
+        if (fd == -1 || file_end < compact_threshold) {
+            return true;
+        }
+        return start_compaction();
+    }
+
+    // snapshot the next chunk. Replay starts from zeros so all zero
+    // chunks can be skipped
+    const uint16_t n = MIN(uint32_t(max_record_length), storage_size - compact_offset);
+    bool all_zero = true;
+    for (uint16_t i=0; i<n && all_zero; i++) {
+        all_zero = mem_buffer[compact_offset+i] == 0;
+    }
+    if (!all_zero && !append(tmp_fd, tmp_end, compact_offset, n)) {
+        abort_compaction();
+        return false;
+    }
+    compact_offset += n;
+
+    if (compact_offset < storage_size) {
+        return true;
+    }
+    return finish_compaction();
+}
+
+/*
+  make the new journal durable then atomically replace the old one
+ */
+bool StorageJournal::finish_compaction(void)
+{
+    if (fsync(tmp_fd) != 0 || rename(tmp_path, path) != 0) {
+        abort_compaction();
+        return false;
+    }
+    sync_dir();
+    if (fd != -1) {
+        close(fd);
+    }
+    fd = tmp_fd;
+    file_end = tmp_end;
+    tmp_fd = -1;
+    stats.compactions++;
+    return true;
+}
+
+void StorageJournal::abort_compaction(void)
+{
+    if (tmp_fd == -1) {
+        return;
+    }
+    close(tmp_fd);
+    tmp_fd = -1;
+    unlink(tmp_path);
+}
+
+// make a rename durable
+bool StorageJournal::sync_dir(void)
+{
+    char *dir_path = strdup(path);
+    if (dir_path == nullptr) {
+        return false;
+    }
+    const int dfd = open(dirname(dir_path), O_RDONLY|O_CLOEXEC);
+    free(dir_path);
+    if (dfd == -1) {
+        return false;
+    }
+    const bool ret = fsync(dfd) == 0;
+    close(dfd);
+    return ret;
+}
+
+#endif  // HAL_STORAGE_JOURNAL_ENABLED
@@ -0,0 +1,121 @@
+#pragma once
+
+/*
+  log structured journal for file backed storage
+
+  The storage area is mirrored in RAM as with AP_FlashStorage. Changed
+  regions are appended to the journal file as records with a CRC, so
+  a write never modifies data already in the file and a crash or kill
+  part way through a write can at worst lose the record being
+  written. On mount the records are replayed in order, stopping at the
+  first incomplete or corrupt record.
+
+  When the journal grows past a threshold it is compacted by writing
+  a snapshot of the RAM copy to a new file a chunk at a time, then
+  renaming it over the old journal. Records written while a
+  compaction is in progress go to both files, so whichever file
+  exists after a crash is complete.
+ */
+
+#include <AP_HAL/AP_HAL_Boards.h>
+#include <AP_Common/AP_Common.h>
+
+#ifndef HAL_STORAGE_JOURNAL_ENABLED
+#define HAL_STORAGE_JOURNAL_ENABLED (CONFIG_HAL_BOARD == HAL_BOARD_SITL || CONFIG_HAL_BOARD == HAL_BOARD_LINUX)
+#endif
+
+#if HAL_STORAGE_JOURNAL_ENABLED
+
+#include <stdint.h>
+
+class StorageJournal {
+public:
+    // mem_buffer is the RAM copy of the storage area, storage_size bytes
+    StorageJournal(uint8_t *mem_buffer, uint16_t storage_size);
+    ~StorageJournal();
+
+    CLASS_NO_COPY(StorageJournal);
+
+    /*
+      open the journal at path, filling mem_buffer by replaying it. If
+      the journal does not exist it is created from the current
+      contents of mem_buffer, allowing the caller to import existing
+      storage
+     */
+    bool init(const char *path);
+
+    // append the region of mem_buffer at offset as one or more records
+    bool write(uint16_t offset, uint16_t length);
+
+    // flush appended records to the disk
+    bool sync(void);
+
+    // do one step of any compaction which is due. Call when idle
+    bool compact_step(void);
+
+    bool healthy(void) const { return fd != -1; }
+
+    struct Stats {
+        uint32_t mount_us;          // time taken by init()
+        uint32_t records_replayed;  // valid records found by init()
+        uint32_t bytes_discarded;   // torn or corrupt bytes dropped from the end by init()
+        uint64_t payload_bytes;     // storage bytes passed to write()
+        uint64_t file_bytes;        // bytes written to journal files, including compaction
+        uint32_t compactions;
+    };
+    const Stats &get_stats(void) const { return stats; }
+
+    // largest single record, longer writes are split
+    static constexpr uint16_t max_record_length = 1024;
+
+private:
+    struct PACKED file_header {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t storage_size;
+        uint32_t crc;
+    };
+
+    struct PACKED record_header {
+        uint16_t magic;
+        uint16_t offset;
+        uint16_t length;
+        uint16_t reserved;
+        // CRC of the header fields above and the data
+        uint32_t crc;
+    };
+
+    static constexpr uint32_t file_magic = 0x4A535041; // "APSJ"
+    static constexpr uint16_t file_version = 1;
+    static constexpr uint16_t record_magic = 0x524A;
+
+    uint8_t *mem_buffer;
+    const uint16_t storage_size;
+
+    char *path = nullptr;
+    char *tmp_path = nullptr;
+    int fd = -1;
+    uint32_t file_end = 0;
+
+    // compaction state
+    int tmp_fd = -1;
+    uint32_t tmp_end = 0;
+    uint32_t compact_offset = 0;
+    uint32_t compact_threshold;
+
+    Stats stats {};
+
+    // a record being written or replayed
+    uint8_t record_buf[sizeof(record_header) + max_record_length];
+
+    bool replay(void);
+    bool append(int wfd, uint32_t &end, uint16_t offset, uint16_t length);
+    bool start_compaction(void);
+    bool finish_compaction(void);
+    void abort_compaction(void);
+    bool sync_dir(void);
+    uint32_t header_crc(const file_header &hdr) const;
+    uint32_t record_crc(const record_header &rec, const uint8_t *data) const;
+};
+
+#endif  // HAL_STORAGE_JOURNAL_ENABLED
@@ -0,0 +1,229 @@
+#include <AP_gtest.h>
+
+#include <AP_HAL/utility/StorageJournal.h>
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+static constexpr uint16_t storage_size = 4096;
+
+class StorageJournalTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        strcpy(dir, "/tmp/journal_testXXXXXX");
+        ASSERT_NE(mkdtemp(dir), nullptr);
+        snprintf(path, sizeof(path), "%s/storage.jnl", dir);
+    }
+    void TearDown() override {
+        char cmd[200];
+        snprintf(cmd, sizeof(cmd), "rm -rf %s", dir);
+        EXPECT_EQ(system(cmd), 0);
+    }
+
+    off_t file_size(const char *name) {
+        struct stat st;
+        return stat(name, &st) == 0 ? st.st_size : -1;
+    }
+
+    char dir[32];
+    char path[64];
+};
+
+// mount a copy of the storage from path and return it in buf
+static bool mount(const char *path, uint8_t *buf, StorageJournal::Stats *stats=nullptr)
+{
+    memset(buf, 0, storage_size);
+    StorageJournal j(buf, storage_size);
+    if (!j.init(path)) {
+        return false;
+    }
+    if (stats != nullptr) {
+        *stats = j.get_stats();
+    }
+    return true;
+}
+
+TEST_F(StorageJournalTest, RoundTrip)
+{
+    uint8_t mem[storage_size] {};
+    // a new journal is created from the current contents
+    for (uint16_t i = 0; i < 100; i++) {
+        mem[i] = i;
+    }
+    {
+        StorageJournal j(mem, storage_size);
+        ASSERT_TRUE(j.init(path));
+        for (uint16_t n = 0; n < 200; n++) {
+            const uint16_t ofs = (n * 37) % (storage_size - 16);
+            memset(&mem[ofs], n, 16);
+            ASSERT_TRUE(j.write(ofs, 16));
+        }
+        // a write longer than one record is split
+        memset(&mem[1000], 0xAB, 3000);
+        ASSERT_TRUE(j.write(1000, 3000));
+        ASSERT_TRUE(j.sync());
+    }
+
+    uint8_t copy[storage_size];
+    StorageJournal::Stats stats;
+    ASSERT_TRUE(mount(path, copy, &stats));
+    EXPECT_EQ(memcmp(mem, copy, storage_size), 0);
+    EXPECT_EQ(stats.bytes_discarded, 0U);
+}
+
+/*
+  cut the journal at every possible length. The result must always
+  mount, and must match the storage as it was after some whole number
+  of writes
+ */
+TEST_F(StorageJournalTest, TornTail)
+{
+    static constexpr uint8_t num_writes = 20;
+    uint8_t mem[storage_size] {};
+    uint8_t *states = new uint8_t[(num_writes+1) * storage_size];
+    memcpy(states, mem, storage_size);
+    {
+        StorageJournal j(mem, storage_size);
+        ASSERT_TRUE(j.init(path));
+        for (uint8_t n = 0; n < num_writes; n++) {
+            const uint16_t ofs = n * 50;
+            memset(&mem[ofs], n + 1, 40);
+            ASSERT_TRUE(j.write(ofs, 40));
+            memcpy(&states[(n+1) * storage_size], mem, storage_size);
+        }
+    }
+
+    const off_t full_size = file_size(path);
+    ASSERT_GT(full_size, 0);
+    FILE *f = fopen(path, "rb");
+    ASSERT_NE(f, nullptr);
+    uint8_t *contents = new uint8_t[full_size];
+    ASSERT_EQ(fread(contents, 1, full_size, f), size_t(full_size));
+    fclose(f);
+
+    char cut_path[80];
+    snprintf(cut_path, sizeof(cut_path), "%s/cut.jnl", dir);
+    // lengths shorter than the file header give a fresh journal
+    for (off_t len = 12; len <= full_size; len++) {
+        f = fopen(cut_path, "wb");
+        ASSERT_NE(f, nullptr);
+        ASSERT_EQ(fwrite(contents, 1, len, f), size_t(len));
+        fclose(f);
+
+        uint8_t copy[storage_size];
+        StorageJournal::Stats stats;
+        ASSERT_TRUE(mount(cut_path, copy, &stats));
+        ASSERT_LE(stats.records_replayed, num_writes);
+        EXPECT_EQ(memcmp(copy, &states[stats.records_replayed * storage_size], storage_size), 0);
+        // the torn record was dropped so new records are kept
+        if (len < full_size) {
+            EXPECT_EQ(file_size(cut_path) + stats.bytes_discarded, len);
+        }
+    }
+
+    // a corrupt byte in the last record loses only that record
+    contents[full_size-1] ^= 1;
+    f = fopen(cut_path, "wb");
+    ASSERT_NE(f, nullptr);
+    ASSERT_EQ(fwrite(contents, 1, full_size, f), size_t(full_size));
+    fclose(f);
+    uint8_t copy[storage_size];
+    StorageJournal::Stats stats;
+    ASSERT_TRUE(mount(cut_path, copy, &stats));
+    EXPECT_EQ(stats.records_replayed, num_writes - 1U);
+
+    delete[] contents;
+    delete[] states;
+}
+
+TEST_F(StorageJournalTest, Compaction)
+{
+    uint8_t mem[storage_size] {};
+    StorageJournal j(mem, storage_size);
+    ASSERT_TRUE(j.init(path));
+    for (uint32_t n = 0; n < 3000; n++) {
+        const uint16_t ofs = (n * 131) % (storage_size - 32);
+        memset(&mem[ofs], n & 0xFF, 32);
+        ASSERT_TRUE(j.write(ofs, 32));
+        ASSERT_TRUE(j.compact_step());
+    }
+    EXPECT_GT(j.get_stats().compactions, 0U);
+    EXPECT_LT(file_size(path), 6 * storage_size);
+
+    char tmp_path[80];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path);
+    uint8_t copy[storage_size];
+    ASSERT_TRUE(mount(path, copy));
+    EXPECT_EQ(memcmp(mem, copy, storage_size), 0);
+
+    // a compaction left unfinished is discarded on mount
+    FILE *f = fopen(tmp_path, "wb");
+    ASSERT_NE(f, nullptr);
+    fputs("partial", f);
+    fclose(f);
+    ASSERT_TRUE(mount(path, copy));
+    EXPECT_EQ(memcmp(mem, copy, storage_size), 0);
+    EXPECT_EQ(file_size(tmp_path), -1);
+}
+
+/*
+  kill a process with SIGKILL while it is writing and compacting. The
+  storage holds slots of 64 bytes, each filled with copies of a
+  counter incremented on every write to the slot, so a slot with mixed
+  values would show a torn write
+ */
+TEST_F(StorageJournalTest, KillTorture)
+{
+    static constexpr uint16_t slot_size = 64;
+    static constexpr uint16_t num_slots = storage_size / slot_size;
+    static constexpr uint8_t words = slot_size / sizeof(uint32_t);
+    uint32_t last[num_slots] {};
+
+    for (uint8_t run = 0; run < 20; run++) {
+        const pid_t pid = fork();
+        ASSERT_NE(pid, -1);
+        if (pid == 0) {
+            uint32_t mem[storage_size / sizeof(uint32_t)] {};
+            StorageJournal j((uint8_t *)mem, storage_size);
+            if (!j.init(path)) {
+                _exit(1);
+            }
+            for (uint32_t n = 0; ; n++) {
+                const uint16_t slot = (n * 7) % num_slots;
+                uint32_t *v = &mem[slot * words];
+                const uint32_t count = v[0] + 1;
+                for (uint8_t i = 0; i < words; i++) {
+                    v[i] = count;
+                }
+                j.write(slot * slot_size, slot_size);
+                j.compact_step();
+            }
+        }
+        usleep(2000 + (run * 1373) % 20000);
+        kill(pid, SIGKILL);
+        int status;
+        waitpid(pid, &status, 0);
+        ASSERT_TRUE(WIFSIGNALED(status));
+
+        uint32_t copy[storage_size / sizeof(uint32_t)];
+        ASSERT_TRUE(mount(path, (uint8_t *)copy));
+        for (uint16_t s = 0; s < num_slots; s++) {
+            const uint32_t *v = &copy[s * words];
+            for (uint8_t i = 1; i < words; i++) {
+                ASSERT_EQ(v[0], v[i]);
+            }
+            // no completed write is lost
+            EXPECT_GE(v[0], last[s]);
+            last[s] = v[0];
+        }
+    }
+}
+
+AP_GTEST_MAIN()
@@ -476,7 +476,8 @@ bool CANIface::configureFilters(const CanFilterConfig* filter_configs,
         }
     }
     initialised_ = true;
-    return true;
+    // no filters were programmed
+    return false;
 #else
     uint32_t num_extid = 0, num_stdid = 0;
     uint32_t total_available_list_size = MAX_FILTER_LIST_SIZE;
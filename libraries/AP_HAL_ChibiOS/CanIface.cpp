@@ -401,9 +401,10 @@ bool CANIface::configureFilters(const CanFilterConfig* filter_configs,
                                 uint16_t num_configs)
 {
 #if !defined(HAL_BUILD_AP_PERIPH)
-    // only do filtering for AP_Periph
+    // only do filtering for AP_Periph. Return false as no filters
+    // were programmed
     can_->FMR &= ~bxcan::FMR_FINIT;
-    return true;
+    return false;
 #else
     if (mode_ != FilteredMode) {
         return false;
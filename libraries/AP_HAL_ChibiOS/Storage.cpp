@@ -251,6 +251,12 @@ void Storage::_timer_tick(void)
     }
     if (_dirty_mask.empty()) {
         _last_empty_ms = AP_HAL::millis();
+#ifdef STORAGE_FLASH_PAGE
+        if (_initialisedType == StorageBackend::Flash) {
+            // copy the old sector forward while there is nothing to write
+            _flash.compact_step();
+        }
+#endif
         return;
     }
 
@@ -92,6 +92,8 @@ void Storage::_timer_tick(void)
     }
     if (_dirty_mask.empty()) {
         _last_empty_ms = AP_HAL::millis();
+        // copy the old sector forward while there is nothing to write
+        _flash.compact_step();
         return;
     }
 
@@ -0,0 +1,52 @@
+/*
+ * This file is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "BusStats.h"
+
+#include <AP_Common/ExpandingString.h>
+
+using namespace Linux;
+
+void BusStats::info(ExpandingString &str, const char *name)
+{
+    const uint32_t now_us = AP_HAL::micros();
+    const uint32_t dt_us = now_us - last_report.time_us;
+    const uint32_t d_transactions = transactions - last_report.transactions;
+    const uint32_t d_syscalls = syscalls - last_report.syscalls;
+    const uint32_t d_busy_us = busy_us - last_report.busy_us;
+
+    float util_pct = 0;
+    float txn_rate = 0;
+    float syscall_rate = 0;
+    if (last_report.time_us != 0 && dt_us > 0) {
+        util_pct = d_busy_us * 100.0f / dt_us;
+        txn_rate = d_transactions * 1.0e6f / dt_us;
+        syscall_rate = d_syscalls * 1.0e6f / dt_us;
+    }
+
+    str.printf("%-14s TXN=%lu SYS=%lu BYTES=%lu ERR=%lu TXN/s=%.0f SYS/s=%.0f UTIL=%.1f%%\n",
+               name,
+               (unsigned long)transactions,
+               (unsigned long)syscalls,
+               (unsigned long)bytes,
+               (unsigned long)errors,
+               txn_rate,
+               syscall_rate,
+               util_pct);
+
+    last_report.time_us = now_us;
+    last_report.transactions = transactions;
+    last_report.syscalls = syscalls;
+    last_report.busy_us = busy_us;
+}
@@ -0,0 +1,70 @@
+/*
+ * This file is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <inttypes.h>
+
+#include <AP_HAL/AP_HAL.h>
+
+class ExpandingString;
+
+namespace Linux {
+
+/*
+ * Transfer statistics for one SPI or I2C bus. Updated by the devices on
+ * the bus with the bus semaphore held and reported per bus thread in
+ * @SYS/threads.txt. Counters are 32 bit and wrap, only differences
+ * between reports are meaningful for the busy time.
+ */
+class BusStats {
+public:
+    /*
+     * Record a completed bus operation of ntransactions device
+     * transactions issued with nsyscalls ioctls, which started at
+     * start_us
+     */
+    void add(uint32_t ntransactions, uint32_t nsyscalls, uint32_t nbytes,
+             uint32_t start_us)
+    {
+        transactions += ntransactions;
+        syscalls += nsyscalls;
+        bytes += nbytes;
+        busy_us += AP_HAL::micros() - start_us;
+    }
+
+    void add_error() { errors++; }
+
+    /*
+     * Append a line for this bus to str. Rates and utilisation are
+     * calculated over the time since the previous call
+     */
+    void info(ExpandingString &str, const char *name);
+
+private:
+    uint32_t transactions;
+    uint32_t syscalls;
+    uint32_t bytes;
+    uint32_t errors;
+    uint32_t busy_us;
+
+    struct {
+        uint32_t time_us;
+        uint32_t transactions;
+        uint32_t syscalls;
+        uint32_t busy_us;
+    } last_report;
+};
+
+}
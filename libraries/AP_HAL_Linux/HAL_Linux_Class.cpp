@@ -328,6 +328,53 @@ void _usage(void)
     printf("\tcpu affinity:\n");
     printf("\t                   --cpu-affinity 1 (single cpu) or 1,3 (multiple cpus) or 1-3 (range of cpus)\n");
     printf("\t                   -c 1 (single cpu) or 1,3 (multiple cpus) or 1-3 (range of cpus)\n");
+    printf("\tper-thread priority and cpu affinity (repeatable, prio 0 is SCHED_OTHER):\n");
+    printf("\t                   --thread ap-timer:15:2 (name:prio:cpus)\n");
+    printf("\t                   --thread main::3 (keep priority, run on cpu 3)\n");
+    printf("\t                   -T log_io:0\n");
+    printf("\tdisable locking of memory:\n");
+    printf("\t                   --no-mlock\n");
+}
+
+/*
+  parse a --thread option of the form name:prio[:cpus]. An empty
+  priority keeps the default
+ */
+static bool parse_thread_config(Linux::Scheduler *sched, const char *arg)
+{
+    char buf[64];
+    if (strlen(arg) >= sizeof(buf)) {
+        return false;
+    }
+    strcpy(buf, arg);
+
+    char *prio_str = strchr(buf, ':');
+    if (prio_str == nullptr) {
+        return false;
+    }
+    *prio_str++ = '\0';
+    char *cpus_str = strchr(prio_str, ':');
+    if (cpus_str != nullptr) {
+        *cpus_str++ = '\0';
+    }
+
+    int prio = -1;
+    if (*prio_str != '\0') {
+        char *endptr;
+        prio = strtol(prio_str, &endptr, 10);
+        if (*endptr != '\0' || prio < 0) {
+            return false;
+        }
+    }
+
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    if (cpus_str != nullptr && *cpus_str != '\0' &&
+        !utilInstance.parse_cpu_set(cpus_str, &cpus)) {
+        return false;
+    }
+
+    return sched->set_thread_config(buf, prio, cpus);
 }
 
 void HAL_Linux::run(int argc, char* const argv[], Callbacks* callbacks) const
@@ -347,6 +394,7 @@ void HAL_Linux::run(int argc, char* const argv[], Callbacks* callbacks) const
         CMDLINE_SERIAL7,
         CMDLINE_SERIAL8,
         CMDLINE_SERIAL9,
+        CMDLINE_NO_MLOCK,
     };
 
     int opt;
@@ -377,11 +425,13 @@ void HAL_Linux::run(int argc, char* const argv[], Callbacks* callbacks) const
         {"module-directory",    true,  0, 'M'},
         {"defaults",            true,  0, 'd'},
         {"cpu-affinity",        true,  0, 'c'},
+        {"thread",              true,  0, 'T'},
+        {"no-mlock",            false, 0, CMDLINE_NO_MLOCK},
         {"help",                false,  0, 'h'},
         {0, false, 0, 0}
     };
 
-    GetOptLong gopt(argc, argv, "A:B:C:D:E:F:G:H:I:J:l:t:s:he:SM:c:",
+    GetOptLong gopt(argc, argv, "A:B:C:D:E:F:G:H:I:J:l:t:s:he:SM:c:T:",
                     options);
 
     /*
@@ -446,6 +496,15 @@ void HAL_Linux::run(int argc, char* const argv[], Callbacks* callbacks) const
             }
             Linux::Scheduler::from(scheduler)->set_cpu_affinity(cpu_affinity);
             break;
+        case 'T':
+            if (!parse_thread_config(Linux::Scheduler::from(scheduler), gopt.optarg)) {
+                fprintf(stderr, "Could not parse thread config: %s\n", gopt.optarg);
+                exit(1);
+            }
+            break;
+        case CMDLINE_NO_MLOCK:
+            Linux::Scheduler::from(scheduler)->set_mlock(false);
+            break;
         case 'h':
             _usage();
             exit(0);
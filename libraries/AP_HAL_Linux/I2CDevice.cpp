@@ -45,6 +45,7 @@
 #include <AP_HAL/AP_HAL.h>
 #include <AP_Math/AP_Math.h>
 
+#include "BusStats.h"
 #include "PollerThread.h"
 #include "Scheduler.h"
 #include "Semaphores.h"
@@ -91,6 +92,7 @@ public:
 
     PollerThread thread;
     Semaphore sem;
+    BusStats stats;
     int fd = -1;
     uint8_t bus;
     uint8_t ref;
@@ -183,18 +185,94 @@ bool I2CDevice::transfer(const uint8_t *send, uint32_t send_len,
         return false;
     }
 
+    return _rdwr(msgs, nmsgs, 1);
+}
+
+/*
+ * Issue nmsgs messages with a single I2C_RDWR ioctl, retrying on failure,
+ * and account for it in the bus statistics
+ */
+bool I2CDevice::_rdwr(struct i2c_msg *msgs, unsigned nmsgs, uint32_t ntransactions)
+{
     struct i2c_rdwr_ioctl_data i2c_data = { };
 
     i2c_data.msgs = msgs;
     i2c_data.nmsgs = nmsgs;
 
+    uint32_t nbytes = 0;
+    for (unsigned i = 0; i < nmsgs; i++) {
+        nbytes += msgs[i].len;
+    }
+
+    const uint32_t start_us = AP_HAL::micros();
     int r;
+    uint32_t nsyscalls = 0;
     unsigned retries = _retries;
     do {
         r = ::ioctl(_bus.fd, I2C_RDWR, &i2c_data);
+        nsyscalls++;
     } while (r == -1 && retries-- > 0);
 
-    return r != -1;
+    if (r == -1) {
+        _bus.stats.add_error();
+        return false;
+    }
+    _bus.stats.add(ntransactions, nsyscalls, nbytes, start_us);
+
+    return true;
+}
+
+bool I2CDevice::transfer_batch(const Transaction *transactions, uint8_t count)
+{
+    if (_split_transfers) {
+        return AP_HAL::I2CDevice::transfer_batch(transactions, count);
+    }
+
+    struct i2c_msg msgs[I2C_RDRW_IOCTL_MAX_MSGS];
+    unsigned nmsgs = 0;
+    uint32_t ntransactions = 0;
+
+    for (uint8_t i = 0; i < count; i++) {
+        const Transaction &t = transactions[i];
+        const bool has_send = t.send && t.send_len != 0;
+        const bool has_recv = t.recv && t.recv_len != 0;
+        if (!has_send && !has_recv) {
+            return false;
+        }
+
+        /* flush if the next transaction won't fit in this ioctl */
+        if (nmsgs + has_send + has_recv > ARRAY_SIZE(msgs)) {
+            if (!_rdwr(msgs, nmsgs, ntransactions)) {
+                return false;
+            }
+            nmsgs = 0;
+            ntransactions = 0;
+        }
+
+        if (has_send) {
+            msgs[nmsgs] = { };
+            msgs[nmsgs].addr = _address;
+            msgs[nmsgs].flags = 0;
+            msgs[nmsgs].buf = const_cast<uint8_t*>(t.send);
+            msgs[nmsgs].len = t.send_len;
+            nmsgs++;
+        }
+        if (has_recv) {
+            msgs[nmsgs] = { };
+            msgs[nmsgs].addr = _address;
+            msgs[nmsgs].flags = I2C_M_RD;
+            msgs[nmsgs].buf = t.recv;
+            msgs[nmsgs].len = t.recv_len;
+            nmsgs++;
+        }
+        ntransactions++;
+    }
+
+    if (nmsgs == 0) {
+        return false;
+    }
+
+    return _rdwr(msgs, nmsgs, ntransactions);
 }
 
 bool I2CDevice::read_registers_multiple(uint8_t first_reg, uint8_t *recv,
@@ -206,15 +284,12 @@ bool I2CDevice::read_registers_multiple(uint8_t first_reg, uint8_t *recv,
 
     while (times > 0) {
         uint8_t n = MIN(times, max_times);
-        struct i2c_msg msgs[2 * n];
-        struct i2c_rdwr_ioctl_data i2c_data = { };
-
-        memset(msgs, 0, 2 * n * sizeof(*msgs));
+        const unsigned nmsgs = 2 * n;
+        struct i2c_msg msgs[nmsgs];
 
-        i2c_data.msgs = msgs;
-        i2c_data.nmsgs = 2 * n;
+        memset(msgs, 0, nmsgs * sizeof(*msgs));
 
-        for (uint8_t i = 0; i < i2c_data.nmsgs; i += 2) {
+        for (uint8_t i = 0; i < nmsgs; i += 2) {
             msgs[i].addr = _address;
             msgs[i].flags = 0;
             msgs[i].buf = &first_reg;
@@ -227,13 +302,7 @@ bool I2CDevice::read_registers_multiple(uint8_t first_reg, uint8_t *recv,
             recv += recv_len;
         };
 
-        int r;
-        unsigned retries = _retries;
-        do {
-            r = ::ioctl(_bus.fd, I2C_RDWR, &i2c_data);
-        } while (r == -1 && retries-- > 0);
-
-        if (r == -1) {
+        if (!_rdwr(msgs, nmsgs, n)) {
             return false;
         }
 
@@ -375,5 +444,14 @@ uint32_t I2CDeviceManager::get_bus_mask_external(void) const
 {
     return HAL_LINUX_I2C_EXTERNAL_BUS_MASK;
 }
+
+void I2CDeviceManager::bus_info(ExpandingString &str)
+{
+    for (auto *b : _buses) {
+        char name[16];
+        snprintf(name, sizeof(name), "ap-i2c-%u", b->bus);
+        b->stats.info(str, name);
+    }
+}
     
 }
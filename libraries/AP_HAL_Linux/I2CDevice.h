@@ -24,6 +24,9 @@
 
 #include "Semaphores.h"
 
+class ExpandingString;
+struct i2c_msg;
+
 namespace Linux {
 
 class I2CBus;
@@ -59,6 +62,12 @@ public:
     bool read_registers_multiple(uint8_t first_reg, uint8_t *recv,
                                  uint32_t recv_len, uint8_t times) override;
 
+    /*
+     * See AP_HAL::Device::transfer_batch(). Transactions are queued in as
+     * few I2C_RDWR ioctls as possible, with a repeated start between them
+     */
+    bool transfer_batch(const Transaction *transactions, uint8_t count) override;
+
     /* See AP_HAL::Device::get_semaphore() */
     AP_HAL::Semaphore *get_semaphore() override;
 
@@ -76,6 +85,8 @@ public:
     }
     
 protected:
+    bool _rdwr(struct i2c_msg *msgs, unsigned nmsgs, uint32_t ntransactions);
+
     I2CBus &_bus;
     uint8_t _address;
     uint8_t _retries = 0;
@@ -120,7 +131,12 @@ public:
       get mask of bus numbers for all configured internal I2C buses
      */
     uint32_t get_bus_mask_internal(void) const override;
-    
+
+    /*
+     * append transfer statistics for each bus thread to str
+     */
+    void bus_info(ExpandingString &str);
+
 protected:
     void _unregister(I2CBus &b);
     AP_HAL::I2CDevice *_create_device(I2CBus &b, uint8_t address) const;
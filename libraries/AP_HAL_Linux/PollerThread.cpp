@@ -21,6 +21,7 @@
 #include <sys/epoll.h>
 #include <sys/timerfd.h>
 
+#include <AP_HAL/AP_HAL.h>
 #include <AP_Math/AP_Math.h>
 
 namespace Linux {
@@ -37,6 +38,17 @@ void TimerPollable::on_can_read()
         return;
     }
 
+    if (_latency != nullptr && _period_usec != 0 && nevents > 0) {
+        /*
+          the timer is periodic from _start_usec, so the time since the
+          last expiration is the phase within the period. Count missed
+          expirations as whole periods of extra latency
+         */
+        const uint64_t late_usec = (AP_HAL::micros64() - _start_usec) % _period_usec +
+            (nevents - 1) * _period_usec;
+        _latency->record(MIN(late_usec, UINT32_MAX));
+    }
+
     if (_wrapper) {
         _wrapper->start_cb();
     }
@@ -79,9 +91,11 @@ bool TimerPollable::adjust_timer(uint32_t timeout_usec)
     spec.it_interval.tv_nsec = timeout_usec * AP_NSEC_PER_USEC;
     spec.it_value.tv_nsec = timeout_usec * AP_NSEC_PER_USEC;
 
+    _start_usec = AP_HAL::micros64();
     if (timerfd_settime(_fd, 0, &spec, nullptr) < 0) {
         return false;
     }
+    _period_usec = timeout_usec;
 
     return true;
 }
@@ -94,6 +108,9 @@ TimerPollable *PollerThread::add_timer(TimerPollable::PeriodicCb cb,
         return nullptr;
     }
     TimerPollable *p = NEW_NOTHROW TimerPollable(cb, wrapper);
+    if (p) {
+        p->_latency = &_wakeup_latency;
+    }
     if (!p || !p->setup_timer(timeout_usec) ||
         !_poller.register_pollable(p, POLLIN)) {
         delete p;
@@ -57,6 +57,11 @@ protected:
     PeriodicCb _cb;
     WrapperCb *_wrapper;
     bool _removeme = false;
+
+    /* timer phase, to work out how late each expiration is handled */
+    uint64_t _start_usec = 0;
+    uint32_t _period_usec = 0;
+    WakeupHistogram *_latency = nullptr;
 };
 
 
@@ -29,7 +29,9 @@
 
 #include <AP_HAL/AP_HAL.h>
 #include <AP_HAL/utility/OwnPtr.h>
+#include <AP_Math/AP_Math.h>
 
+#include "BusStats.h"
 #include "GPIO.h"
 #include "PollerThread.h"
 #include "Scheduler.h"
@@ -65,6 +67,9 @@ SPIDesc SPIDeviceManager::_device[] = {
 
 #define MAX_SUBDEVS 6
 
+/* transactions queued per SPI_IOC_MESSAGE ioctl by transfer_batch() */
+#define SPI_BATCH_MAX_TRANSACTIONS 16
+
 const uint8_t SPIDeviceManager::_n_device_desc = LINUX_SPI_DEVICE_NUM_DEVICES;
 
 
@@ -85,6 +90,7 @@ public:
 
     PollerThread thread;
     Semaphore sem;
+    BusStats stats;
     int fd[MAX_SUBDEVS];
     uint16_t bus;
     int16_t last_mode = -1;
@@ -230,6 +236,7 @@ bool SPIDevice::transfer(const uint8_t *send, uint32_t send_len,
 #endif
 
     int r;
+    uint32_t nsyscalls = 1;
     if (_desc.mode != _bus.last_mode) {
         r = ioctl(fd, SPI_IOC_WR_MODE, &_desc.mode);
         if (r < 0) {
@@ -238,8 +245,10 @@ bool SPIDevice::transfer(const uint8_t *send, uint32_t send_len,
             return false;
         }
         _bus.last_mode = _desc.mode;
+        nsyscalls++;
     }
 
+    const uint32_t start_us = AP_HAL::micros();
     _cs_assert();
     r = ioctl(fd, SPI_IOC_MESSAGE(nmsgs), &msgs);
     _cs_release();
@@ -247,9 +256,92 @@ bool SPIDevice::transfer(const uint8_t *send, uint32_t send_len,
     if (r == -1) {
         hal.console->printf("SPIDevice: error transferring data fd=%d (%s)\n",
                             fd, strerror(errno));
+        _bus.stats.add_error();
+        return false;
+    }
+    _bus.stats.add(1, nsyscalls, send_len + recv_len, start_us);
+
+    return true;
+}
+
+bool SPIDevice::transfer_batch(const Transaction *transactions, uint8_t count)
+{
+    /*
+      with a userspace chip select we can't toggle it between
+      transactions inside one ioctl
+     */
+    if (_desc.cs_pin != SPI_CS_KERNEL) {
+        return AP_HAL::SPIDevice::transfer_batch(transactions, count);
+    }
+
+    struct spi_ioc_transfer msgs[2 * SPI_BATCH_MAX_TRANSACTIONS];
+    int fd = _bus.fd[_desc.subdev];
+
+    if (count == 0) {
         return false;
     }
 
+    uint32_t nsyscalls = 1;
+    if (_desc.mode != _bus.last_mode) {
+        if (ioctl(fd, SPI_IOC_WR_MODE, &_desc.mode) < 0) {
+            hal.console->printf("SPIDevice: error on setting mode fd=%d (%s)\n",
+                                fd, strerror(errno));
+            return false;
+        }
+        _bus.last_mode = _desc.mode;
+        nsyscalls++;
+    }
+
+    while (count > 0) {
+        const uint8_t n = MIN(count, SPI_BATCH_MAX_TRANSACTIONS);
+        unsigned nmsgs = 0;
+        uint32_t nbytes = 0;
+
+        memset(msgs, 0, sizeof(msgs));
+
+        for (uint8_t i = 0; i < n; i++) {
+            const Transaction &t = transactions[i];
+            const unsigned first = nmsgs;
+
+            if (t.send && t.send_len != 0) {
+                msgs[nmsgs].tx_buf = (uint64_t) t.send;
+                msgs[nmsgs].len = t.send_len;
+                msgs[nmsgs].speed_hz = _speed;
+                msgs[nmsgs].bits_per_word = _desc.bits_per_word;
+                nmsgs++;
+            }
+            if (t.recv && t.recv_len != 0) {
+                msgs[nmsgs].rx_buf = (uint64_t) t.recv;
+                msgs[nmsgs].len = t.recv_len;
+                msgs[nmsgs].speed_hz = _speed;
+                msgs[nmsgs].bits_per_word = _desc.bits_per_word;
+                nmsgs++;
+            }
+            if (nmsgs == first) {
+                return false;
+            }
+            nbytes += t.send_len + t.recv_len;
+
+            /* release chip select at the end of each transaction */
+            if (i != n - 1) {
+                msgs[nmsgs - 1].cs_change = 1;
+            }
+        }
+
+        const uint32_t start_us = AP_HAL::micros();
+        if (ioctl(fd, SPI_IOC_MESSAGE(nmsgs), &msgs) == -1) {
+            hal.console->printf("SPIDevice: error transferring data fd=%d (%s)\n",
+                                fd, strerror(errno));
+            _bus.stats.add_error();
+            return false;
+        }
+        _bus.stats.add(n, nsyscalls, nbytes, start_us);
+        nsyscalls = 1;
+
+        transactions += n;
+        count -= n;
+    }
+
     return true;
 }
 
@@ -278,6 +370,7 @@ bool SPIDevice::transfer_fullduplex(const uint8_t *send, uint8_t *recv,
         return false;
     }
 
+    const uint32_t start_us = AP_HAL::micros();
     _cs_assert();
     r = ioctl(fd, SPI_IOC_MESSAGE(1), &msgs);
     _cs_release();
@@ -285,8 +378,10 @@ bool SPIDevice::transfer_fullduplex(const uint8_t *send, uint8_t *recv,
     if (r == -1) {
         hal.console->printf("SPIDevice: error transferring data fd=%d (%s)\n",
                             fd, strerror(errno));
+        _bus.stats.add_error();
         return false;
     }
+    _bus.stats.add(1, 2, len, start_us);
 
     return true;
 }
@@ -396,6 +491,15 @@ const char* SPIDeviceManager::get_device_name(uint8_t idx)
     return _device[idx].name;
 }
 
+void SPIDeviceManager::bus_info(ExpandingString &str)
+{
+    for (auto *b : _buses) {
+        char name[16];
+        snprintf(name, sizeof(name), "ap-spi-%u", b->bus);
+        b->stats.info(str, name);
+    }
+}
+
 /* Create a new device increasing the bus reference */
 AP_HAL::SPIDevice *
 SPIDeviceManager::_create_device(SPIBus &b, SPIDesc &desc) const
@@ -22,6 +22,8 @@
 #include <AP_HAL/HAL.h>
 #include <AP_HAL/SPIDevice.h>
 
+class ExpandingString;
+
 namespace Linux {
 
 class SPIBus;
@@ -69,6 +71,13 @@ public:
     /* See AP_HAL::SPIDevice::transfer_fullduplex() */
     bool transfer_fullduplex(uint8_t *send_recv, uint32_t len) override;
 
+    /*
+     * See AP_HAL::Device::transfer_batch(). With a kernel chip select the
+     * transactions are queued in a single SPI_IOC_MESSAGE ioctl, with the
+     * chip select released between them
+     */
+    bool transfer_batch(const Transaction *transactions, uint8_t count) override;
+
     /* See AP_HAL::Device::get_semaphore() */
     AP_HAL::Semaphore *get_semaphore() override;
 
@@ -128,6 +137,11 @@ public:
     /* See AP_HAL::SPIDeviceManager::get_device_name() */
     const char *get_device_name(uint8_t idx) override;
 
+    /*
+     * append transfer statistics for each bus thread to str
+     */
+    void bus_info(ExpandingString &str);
+
 protected:
     void _unregister(SPIBus &b);
     AP_HAL::SPIDevice *_create_device(SPIBus &b, SPIDesc &device_desc) const;
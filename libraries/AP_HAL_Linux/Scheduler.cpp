@@ -80,24 +80,86 @@ void Scheduler::init_realtime()
     }
 #endif
 
-    mlockall(MCL_CURRENT|MCL_FUTURE);
+    if (_mlock) {
+        mlockall(MCL_CURRENT|MCL_FUTURE);
+        prefault_stack();
+    }
+
+    int policy = SCHED_FIFO;
+    int prio = APM_LINUX_MAIN_PRIORITY;
+    const ThreadConfig *config = find_thread_config("main");
+    if (config != nullptr && config->prio >= 0) {
+        prio = config->prio;
+        policy = prio == 0 ? SCHED_OTHER : SCHED_FIFO;
+    }
 
-    struct sched_param param = { .sched_priority = APM_LINUX_MAIN_PRIORITY };
-    if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) == -1) {
+    struct sched_param param = { .sched_priority = prio };
+    if (pthread_setschedparam(pthread_self(), policy, &param) == -1) {
         AP_HAL::panic("Scheduler: failed to set scheduling parameters: %s",
                       strerror(errno));
     }
 }
 
+/*
+  touch the main thread stack so that the pages are faulted in (and
+  locked) now rather than on first use in the main loop. Thread stacks
+  are already touched when they are poisoned on thread start
+ */
+void Scheduler::prefault_stack()
+{
+    volatile uint8_t stack[AP_LINUX_MAIN_STACK_PREFAULT];
+    for (uint32_t i = 0; i < sizeof(stack); i += 1024) {
+        stack[i] = 0;
+    }
+}
+
 void Scheduler::init_cpu_affinity()
 {
-    if (!CPU_COUNT(&_cpu_affinity)) {
-        return;
+    if (CPU_COUNT(&_cpu_affinity)) {
+        if (sched_setaffinity(0, sizeof(_cpu_affinity), &_cpu_affinity) != 0) {
+            AP_HAL::panic("Failed to set affinity for main process: %m");
+        }
     }
 
-    if (sched_setaffinity(0, sizeof(_cpu_affinity), &_cpu_affinity) != 0) {
-        AP_HAL::panic("Failed to set affinity for main process: %m");
+    /*
+      threads inherit the affinity of the main thread unless they have
+      their own, so this must come after the process affinity
+     */
+    const ThreadConfig *config = find_thread_config("main");
+    if (config != nullptr && CPU_COUNT(&config->cpus)) {
+        if (pthread_setaffinity_np(pthread_self(), sizeof(config->cpus), &config->cpus) != 0) {
+            AP_HAL::panic("Failed to set affinity for main thread: %m");
+        }
+    }
+}
+
+bool Scheduler::set_thread_config(const char *name, int prio, const cpu_set_t &cpus)
+{
+    if (strlen(name) >= sizeof(ThreadConfig::name) ||
+        prio > APM_LINUX_MAX_PRIORITY) {
+        return false;
+    }
+    ThreadConfig *config = const_cast<ThreadConfig *>(find_thread_config(name));
+    if (config == nullptr) {
+        if (_num_thread_configs >= ARRAY_SIZE(_thread_config)) {
+            return false;
+        }
+        config = &_thread_config[_num_thread_configs++];
+    }
+    strncpy(config->name, name, sizeof(config->name) - 1);
+    config->prio = prio;
+    config->cpus = cpus;
+    return true;
+}
+
+const Scheduler::ThreadConfig *Scheduler::find_thread_config(const char *name) const
+{
+    for (uint8_t i = 0; i < _num_thread_configs; i++) {
+        if (strcmp(_thread_config[i].name, name) == 0) {
+            return &_thread_config[i];
+        }
     }
+    return nullptr;
 }
 
 void Scheduler::init()
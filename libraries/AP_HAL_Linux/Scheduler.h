@@ -10,6 +10,10 @@
 #define LINUX_SCHEDULER_MAX_TIMER_PROCS 10
 #define LINUX_SCHEDULER_MAX_TIMESLICED_PROCS 10
 #define LINUX_SCHEDULER_MAX_IO_PROCS 10
+#define LINUX_SCHEDULER_MAX_THREAD_CONFIGS 16
+
+// amount of main thread stack touched after locking memory
+#define AP_LINUX_MAIN_STACK_PREFAULT (256 * 1024)
 
 #define AP_LINUX_SENSORS_STACK_SIZE  256 * 1024
 #define AP_LINUX_SENSORS_SCHED_POLICY  SCHED_FIFO
@@ -60,6 +64,27 @@ public:
      */
     void set_cpu_affinity(const cpu_set_t &cpu_affinity) { _cpu_affinity = cpu_affinity; }
 
+    /*
+      scheduling overrides for a named thread ("main" for the main
+      loop). A priority of 0 runs the thread with SCHED_OTHER and -1
+      keeps its default priority. An empty cpu set keeps the default
+      affinity. Overrides must be set before init() and only apply to
+      threads started afterwards.
+     */
+    struct ThreadConfig {
+        char name[16];
+        int prio;
+        cpu_set_t cpus;
+    };
+    bool set_thread_config(const char *name, int prio, const cpu_set_t &cpus);
+    const ThreadConfig *find_thread_config(const char *name) const;
+
+    /*
+      enable or disable locking of all memory and prefaulting of the
+      main thread stack on initialization. Enabled by default
+     */
+    void set_mlock(bool enable) { _mlock = enable; }
+
 private:
     class SchedulerThread : public PeriodicThread {
     public:
@@ -78,6 +103,8 @@ private:
 
     void     init_cpu_affinity();
 
+    void     prefault_stack();
+
     void _wait_all_threads();
 
     void     _debug_stack();
@@ -117,6 +144,10 @@ private:
 
     Semaphore _io_semaphore;
     cpu_set_t _cpu_affinity;
+
+    ThreadConfig _thread_config[LINUX_SCHEDULER_MAX_THREAD_CONFIGS];
+    uint8_t _num_thread_configs;
+    bool _mlock = true;
 };
 
 }
@@ -3,6 +3,7 @@
 #include <assert.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <limits.h>
 #include <stdio.h>
 #include <sys/stat.h>
 #include <sys/types.h>
@@ -20,6 +21,7 @@ using namespace Linux;
 // name the storage file after the sketch so you can use the same board
 // card for ArduCopter and ArduPlane
 #define STORAGE_FILE AP_BUILD_TARGET_NAME ".stg"
+#define STORAGE_JOURNAL_FILE AP_BUILD_TARGET_NAME ".jnl"
 
 extern const AP_HAL::HAL& hal;
 
@@ -145,6 +147,12 @@ void Storage::init()
         dpath = HAL_BOARD_STORAGE_DIRECTORY;
     }
 
+#if HAL_LINUX_STORAGE_JOURNAL_ENABLED
+    _journal_init(dpath);
+    _initialised = true;
+    return;
+#endif
+
     int fd = _storage_create(dpath);
     if (fd == -1) {
         AP_HAL::panic("Cannot create storage %s (%m)", dpath);
@@ -174,6 +182,14 @@ void Storage::_mark_dirty(uint16_t loc, uint16_t length)
         return;
     }
     uint16_t end = loc + length - 1;
+#if HAL_LINUX_STORAGE_JOURNAL_ENABLED
+    for (uint16_t line=loc>>LINUX_STORAGE_JOURNAL_LINE_SHIFT;
+         line <= end>>LINUX_STORAGE_JOURNAL_LINE_SHIFT;
+         line++) {
+        _journal_dirty.set(line);
+    }
+    return;
+#endif
     for (uint8_t line=loc>>LINUX_STORAGE_LINE_SHIFT;
          line <= end>>LINUX_STORAGE_LINE_SHIFT;
          line++) {
@@ -204,6 +220,13 @@ void Storage::write_block(uint16_t loc, const void *src, size_t n)
 
 void Storage::_timer_tick(void)
 {
+#if HAL_LINUX_STORAGE_JOURNAL_ENABLED
+    if (_initialised) {
+        _journal_tick();
+    }
+    return;
+#endif
+
     if (!_initialised || _dirty_mask == 0 || _fd == -1) {
         return;
     }
@@ -254,6 +277,78 @@ void Storage::_timer_tick(void)
     }
 }
 
+#if HAL_LINUX_STORAGE_JOURNAL_ENABLED
+/*
+  open the storage journal, importing the storage file when there is
+  no journal yet
+ */
+void Storage::_journal_init(const char *dpath)
+{
+    mkdir_p(dpath, strlen(dpath), 0777);
+
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), "%s/%s", dpath, STORAGE_JOURNAL_FILE);
+    if (access(path, F_OK) != 0) {
+        char stg_path[PATH_MAX];
+        snprintf(stg_path, sizeof(stg_path), "%s/%s", dpath, STORAGE_FILE);
+        const int fd = open(stg_path, O_RDONLY|O_CLOEXEC);
+        if (fd != -1) {
+            if (read(fd, _buffer, sizeof(_buffer)) < 0) {
+                memset(_buffer, 0, sizeof(_buffer));
+            }
+            close(fd);
+        }
+    }
+
+    if (!_journal.init(path)) {
+        AP_HAL::panic("Cannot open storage journal %s (%m)", path);
+    }
+}
+
+/*
+  append the first run of dirty journal lines to the journal, or
+  compact the journal when there is nothing to write. Single clean
+  lines within the run are included as they cost less than the header
+  of another record
+ */
+void Storage::_journal_tick(void)
+{
+    const int16_t i = _journal_dirty.first_set();
+    if (i < 0) {
+        _journal.compact_step();
+        return;
+    }
+
+    const uint16_t max_lines = StorageJournal::max_record_length >> LINUX_STORAGE_JOURNAL_LINE_SHIFT;
+    uint16_t n = 1;
+    while (i + n < LINUX_STORAGE_JOURNAL_NUM_LINES && n < max_lines) {
+        if (_journal_dirty.get(i + n)) {
+            n++;
+        } else if (i + n + 1 < LINUX_STORAGE_JOURNAL_NUM_LINES && n + 1 < max_lines &&
+                   _journal_dirty.get(i + n + 1)) {
+            n += 2;
+        } else {
+            break;
+        }
+    }
+
+    // clear the lines first so a write_block() while the data is
+    // copied marks them dirty again
+    for (uint16_t j=0; j<n; j++) {
+        _journal_dirty.clear(i + j);
+    }
+    if (!_journal.write(i<<LINUX_STORAGE_JOURNAL_LINE_SHIFT, n<<LINUX_STORAGE_JOURNAL_LINE_SHIFT)) {
+        for (uint16_t j=0; j<n; j++) {
+            _journal_dirty.set(i + j);
+        }
+        return;
+    }
+    if (_journal_dirty.empty()) {
+        _journal.sync();
+    }
+}
+#endif  // HAL_LINUX_STORAGE_JOURNAL_ENABLED
+
 /*
   get storage size and ptr
  */
@@ -1,6 +1,17 @@
 #pragma once
 
 #include <AP_HAL/AP_HAL.h>
+#include <AP_HAL/utility/StorageJournal.h>
+#include <AP_Common/Bitmask.h>
+
+/*
+  keep storage in a log structured journal rather than updating the
+  storage file in place, so storage survives power loss part way
+  through a write
+ */
+#ifndef HAL_LINUX_STORAGE_JOURNAL_ENABLED
+#define HAL_LINUX_STORAGE_JOURNAL_ENABLED 0
+#endif
 
 #define LINUX_STORAGE_SIZE HAL_STORAGE_SIZE
 #define LINUX_STORAGE_MAX_WRITE 512
@@ -8,6 +19,10 @@
 #define LINUX_STORAGE_LINE_SIZE (1<<LINUX_STORAGE_LINE_SHIFT)
 #define LINUX_STORAGE_NUM_LINES (LINUX_STORAGE_SIZE/LINUX_STORAGE_LINE_SIZE)
 
+// the journal records changes in much smaller lines
+#define LINUX_STORAGE_JOURNAL_LINE_SHIFT 3
+#define LINUX_STORAGE_JOURNAL_NUM_LINES (LINUX_STORAGE_SIZE>>LINUX_STORAGE_JOURNAL_LINE_SHIFT)
+
 namespace Linux {
 
 class Storage : public AP_HAL::Storage
@@ -44,6 +59,14 @@ protected:
     volatile bool _initialised;
     volatile uint32_t _dirty_mask;
     uint8_t _buffer[LINUX_STORAGE_SIZE];
+
+#if HAL_LINUX_STORAGE_JOURNAL_ENABLED
+    StorageJournal _journal{_buffer, LINUX_STORAGE_SIZE};
+    Bitmask<LINUX_STORAGE_JOURNAL_NUM_LINES> _journal_dirty;
+
+    void _journal_init(const char *dpath);
+    void _journal_tick(void);
+#endif
 };
 
 }
@@ -17,12 +17,15 @@
 #include "Thread.h"
 
 #include <alloca.h>
+#include <errno.h>
 #include <limits.h>
 #include <sys/types.h>
 #include <stdio.h>
+#include <time.h>
 #include <unistd.h>
 #include <utility>
 
+#include <AP_Common/ExpandingString.h>
 #include <AP_HAL/AP_HAL.h>
 #include <AP_Math/AP_Math.h>
 #include "Scheduler.h"
@@ -33,6 +36,87 @@ extern const AP_HAL::HAL &hal;
 
 namespace Linux {
 
+/* started threads, for thread_info() */
+static Thread *thread_list;
+static pthread_mutex_t thread_list_mtx = PTHREAD_MUTEX_INITIALIZER;
+
+const uint16_t WakeupHistogram::_bin_limit_us[NUM_BINS - 1] = {
+    10, 20, 50, 100, 200, 500, 1000
+};
+
+void WakeupHistogram::record(uint32_t latency_us)
+{
+    uint8_t i = 0;
+    while (i < NUM_BINS - 1 && latency_us >= _bin_limit_us[i]) {
+        i++;
+    }
+    _bins[i]++;
+    _count++;
+    _total_us += latency_us;
+    if (latency_us > _max_us) {
+        _max_us = latency_us;
+    }
+}
+
+void WakeupHistogram::info(ExpandingString &str) const
+{
+    if (_count == 0) {
+        str.printf(" WAKE=none\n");
+        return;
+    }
+    str.printf(" WAKE avg=%uus max=%uus",
+               unsigned(_total_us / _count), unsigned(_max_us));
+    for (uint8_t i = 0; i < NUM_BINS; i++) {
+        if (i < NUM_BINS - 1) {
+            str.printf(" <%u:%u", unsigned(_bin_limit_us[i]), unsigned(_bins[i]));
+        } else {
+            str.printf(" >=%u:%u", unsigned(_bin_limit_us[i - 1]), unsigned(_bins[i]));
+        }
+    }
+    str.printf("\n");
+}
+
+void Thread::_register()
+{
+    pthread_mutex_lock(&thread_list_mtx);
+    if (!_registered) {
+        _next = thread_list;
+        thread_list = this;
+        _registered = true;
+    }
+    pthread_mutex_unlock(&thread_list_mtx);
+}
+
+void Thread::_unregister()
+{
+    pthread_mutex_lock(&thread_list_mtx);
+    if (_registered) {
+        for (Thread **t = &thread_list; *t != nullptr; t = &(*t)->_next) {
+            if (*t == this) {
+                *t = _next;
+                break;
+            }
+        }
+        _registered = false;
+    }
+    pthread_mutex_unlock(&thread_list_mtx);
+}
+
+void Thread::thread_info(ExpandingString &str)
+{
+    str.printf("ThreadName     Policy Prio StackUsed\n");
+    pthread_mutex_lock(&thread_list_mtx);
+    for (Thread *t = thread_list; t != nullptr; t = t->_next) {
+        str.printf("%-14s %-6s %4d %9u",
+                   t->_name[0] ? t->_name : "?",
+                   t->_policy == SCHED_FIFO ? "FIFO" : "OTHER",
+                   t->_prio,
+                   unsigned(t->get_stack_usage() * sizeof(uint32_t)));
+        t->_wakeup_latency.info(str);
+    }
+    pthread_mutex_unlock(&thread_list_mtx);
+}
+
 
 void *Thread::_run_trampoline(void *arg)
 {
@@ -164,12 +248,35 @@ bool Thread::start(const char *name, int policy, int prio)
         return false;
     }
 
+    if (name) {
+        strncpy(_name, name, sizeof(_name) - 1);
+    }
+
+    /* per-thread overrides from the command line */
+    const Scheduler::ThreadConfig *config = nullptr;
+    if (name && hal.scheduler != nullptr) {
+        config = Scheduler::from(hal.scheduler)->find_thread_config(name);
+    }
+    if (config != nullptr && config->prio >= 0) {
+        prio = config->prio;
+        policy = prio == 0 ? SCHED_OTHER : SCHED_FIFO;
+    }
+    _policy = policy;
+    _prio = prio;
+
     struct sched_param param = { .sched_priority = prio };
     pthread_attr_t attr;
     int r;
 
     pthread_attr_init(&attr);
 
+    if (config != nullptr && CPU_COUNT(&config->cpus) > 0) {
+        if ((r = pthread_attr_setaffinity_np(&attr, sizeof(config->cpus), &config->cpus)) != 0) {
+            AP_HAL::panic("Failed to set affinity for thread '%s': %s",
+                          name, strerror(r));
+        }
+    }
+
     /*
       we need to run as root to get realtime scheduling. Allow it to
       run as non-root for debugging purposes, plus to allow the Replay
@@ -190,6 +297,9 @@ bool Thread::start(const char *name, int policy, int prio)
         }
     }
 
+    /* register before creating it as an auto-free thread may exit at any time */
+    _register();
+
     r = pthread_create(&_ctx, &attr, &Thread::_run_trampoline, this);
     if (r != 0) {
         AP_HAL::panic("Failed to create thread '%s': %s",
@@ -228,6 +338,19 @@ bool Thread::join()
 }
 
 
+static uint64_t ts_to_nsec(const struct timespec &ts)
+{
+    return ts.tv_sec * AP_NSEC_PER_SEC + ts.tv_nsec;
+}
+
+static struct timespec nsec_to_ts(uint64_t nsec)
+{
+    struct timespec ts;
+    ts.tv_sec = nsec / AP_NSEC_PER_SEC;
+    ts.tv_nsec = nsec % AP_NSEC_PER_SEC;
+    return ts;
+}
+
 bool PeriodicThread::set_rate(uint32_t rate_hz)
 {
     if (_started || rate_hz == 0) {
@@ -256,17 +379,27 @@ bool PeriodicThread::_run()
         return false;
     }
 
-    uint64_t next_run_usec = AP_HAL::micros64() + _period_usec;
+    /*
+      sleep until absolute deadlines so that the time taken by the task
+      and any wakeup latency don't accumulate as drift
+     */
+    const uint64_t period_nsec = _period_usec * AP_NSEC_PER_USEC;
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    uint64_t next_run_nsec = ts_to_nsec(now) + period_nsec;
 
     while (!_should_exit) {
-        uint64_t dt = next_run_usec - AP_HAL::micros64();
-        if (dt > _period_usec) {
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        if (ts_to_nsec(now) >= next_run_nsec) {
             // we've lost sync - restart
-            next_run_usec = AP_HAL::micros64();
+            next_run_nsec = ts_to_nsec(now);
         } else {
-            Scheduler::from(hal.scheduler)->microsleep(dt);
+            const struct timespec deadline = nsec_to_ts(next_run_nsec);
+            while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, nullptr) == EINTR) ;
+            clock_gettime(CLOCK_MONOTONIC, &now);
+            _wakeup_latency.record((ts_to_nsec(now) - next_run_nsec) / AP_NSEC_PER_USEC);
         }
-        next_run_usec += _period_usec;
+        next_run_nsec += period_nsec;
 
         _task();
     }
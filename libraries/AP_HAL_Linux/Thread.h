@@ -22,8 +22,36 @@
 
 #include <AP_HAL/utility/functor.h>
 
+class ExpandingString;
+
 namespace Linux {
 
+/*
+ * Histogram of thread wakeup latency: the time between the deadline a
+ * thread asked to be woken up at and the time it actually ran. Samples
+ * are recorded by the thread itself and read without locking for
+ * reporting, so the values are approximate while the thread runs.
+ */
+class WakeupHistogram {
+public:
+    void record(uint32_t latency_us);
+
+    uint32_t count() const { return _count; }
+    uint32_t max_us() const { return _max_us; }
+
+    void info(ExpandingString &str) const;
+
+private:
+    static constexpr uint8_t NUM_BINS = 8;
+    // upper bound of each bin in microseconds, the last bin is unbounded
+    static const uint16_t _bin_limit_us[NUM_BINS - 1];
+
+    uint32_t _bins[NUM_BINS];
+    uint32_t _count;
+    uint32_t _max_us;
+    uint64_t _total_us;
+};
+
 /*
  * Interface abstracting threads
  */
@@ -33,7 +61,7 @@ public:
 
     Thread(task_t t) : _task(t) { }
 
-    virtual ~Thread() { }
+    virtual ~Thread() { _unregister(); }
 
     bool start(const char *name, int policy, int prio);
 
@@ -51,6 +79,20 @@ public:
 
     bool join();
 
+    const char *get_name() const { return _name; }
+
+    /*
+     * Wakeup latency of this thread, for threads that sleep until a
+     * deadline
+     */
+    WakeupHistogram &wakeup_latency() { return _wakeup_latency; }
+
+    /*
+     * Append a line for each running thread with its scheduling
+     * parameters, stack usage and wakeup latency histogram to str
+     */
+    static void thread_info(ExpandingString &str);
+
 protected:
     static void *_run_trampoline(void *arg);
 
@@ -75,6 +117,17 @@ protected:
     } _stack_debug;
 
     size_t _stack_size = 0;
+
+    char _name[16] {};
+    int _policy = 0;
+    int _prio = 0;
+    WakeupHistogram _wakeup_latency{};
+
+    /* list of started threads for thread_info() */
+    void _register();
+    void _unregister();
+    Thread *_next = nullptr;
+    bool _registered = false;
 };
 
 class PeriodicThread : public Thread {
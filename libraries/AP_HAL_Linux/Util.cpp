@@ -9,7 +9,12 @@
 
 #include <AP_HAL/AP_HAL.h>
 
+#include <AP_Common/ExpandingString.h>
+
 #include "Heat_Pwm.h"
+#include "I2CDevice.h"
+#include "SPIDevice.h"
+#include "Thread.h"
 #include "Util.h"
 
 using namespace Linux;
@@ -259,6 +264,18 @@ bool Util::get_random_vals(uint8_t* data, size_t size)
     return true;
 }
 
+/*
+  report scheduling, stack usage and wakeup latency of each thread,
+  then per bus thread transfer statistics
+ */
+void Util::thread_info(ExpandingString &str)
+{
+    Thread::thread_info(str);
+    str.printf("BusThread      Stats\n");
+    SPIDeviceManager::from(hal.spi)->bus_info(str);
+    I2CDeviceManager::from(hal.i2c_mgr)->bus_info(str);
+}
+
 bool Util::parse_cpu_set(const char *str, cpu_set_t *cpu_set) const
 {
     unsigned long cpu1, cpu2;
@@ -95,6 +95,9 @@ public:
     // fills data with random values of requested size
     bool get_random_vals(uint8_t* data, size_t size) override;
 
+    // request information on running threads
+    void thread_info(ExpandingString &str) override;
+
 private:
 #if CONFIG_HAL_BOARD_SUBTYPE == HAL_BOARD_SUBTYPE_LINUX_DISCO
     static ToneAlarm_Disco _toneAlarm;
@@ -19,6 +19,7 @@
 #include <pthread.h>
 #include <unistd.h>
 
+#include <AP_Common/ExpandingString.h>
 #include <AP_HAL/AP_HAL.h>
 #include <AP_HAL_Linux/Thread.h>
 #include <AP_HAL_Linux/PollerThread.h>
@@ -115,6 +116,24 @@ TEST(LinuxThread, periodic_thread)
 
     EXPECT_TRUE(thr.stop());
     EXPECT_TRUE(thr.join());
+
+    // each wakeup from its deadline sleep is recorded
+    EXPECT_GT(thr.wakeup_latency().count(), 0U);
+}
+
+TEST(LinuxThread, wakeup_histogram)
+{
+    WakeupHistogram h {};
+    h.record(5);
+    h.record(15);
+    h.record(2500);
+    EXPECT_EQ(h.count(), 3U);
+    EXPECT_EQ(h.max_us(), 2500U);
+
+    ExpandingString str;
+    h.info(str);
+    EXPECT_NE(strstr(str.get_string(), "<10:1 <20:1"), nullptr);
+    EXPECT_NE(strstr(str.get_string(), ">=1000:1"), nullptr);
 }
 
 AP_GTEST_MAIN()
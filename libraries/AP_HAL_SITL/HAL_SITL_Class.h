@@ -26,6 +26,10 @@ public:
         storage_fram_enabled = _enabled;
     }
     bool get_storage_fram_enabled() const { return storage_fram_enabled; }
+    void set_storage_journal_enabled(bool _enabled) {
+        storage_journal_enabled = _enabled;
+    }
+    bool get_storage_journal_enabled() const { return storage_journal_enabled; }
 
     /*
       instructs the simulation to wipe any storage as it opens it:
@@ -54,6 +58,7 @@ private:
     bool storage_posix_enabled = true;
     bool storage_flash_enabled;
     bool storage_fram_enabled;
+    bool storage_journal_enabled;
 
     // set to true if simulation is to wipe storage as it is opened:
     bool wipe_storage;
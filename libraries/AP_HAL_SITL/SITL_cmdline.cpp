@@ -311,6 +311,9 @@ void SITL_State::_parse_command_line(int argc, char * const argv[])
 #endif
 #if STORAGE_USE_FRAM
         CMDLINE_SET_STORAGE_FRAM_ENABLED,
+#endif
+#if STORAGE_USE_JOURNAL
+        CMDLINE_SET_STORAGE_JOURNAL_ENABLED,
 #endif
     };
 
@@ -371,6 +374,9 @@ void SITL_State::_parse_command_line(int argc, char * const argv[])
 #endif
 #if STORAGE_USE_FRAM
         {"set-storage-fram-enabled", true,   0, CMDLINE_SET_STORAGE_FRAM_ENABLED},
+#endif
+#if STORAGE_USE_JOURNAL
+        {"set-storage-journal-enabled", true,   0, CMDLINE_SET_STORAGE_JOURNAL_ENABLED},
 #endif
         {"vehicle",           true,   0, 'v'},
         {0, false, 0, 0}
@@ -385,6 +391,7 @@ void SITL_State::_parse_command_line(int argc, char * const argv[])
     bool storage_posix_enabled = true;
     bool storage_flash_enabled = false;
     bool storage_fram_enabled = false;
+    bool storage_journal_enabled = false;
     bool erase_all_storage = false;
 
     if (asprintf(&autotest_dir, AP_BUILD_ROOT "/Tools/autotest") <= 0) {
@@ -559,6 +566,11 @@ void SITL_State::_parse_command_line(int argc, char * const argv[])
         case CMDLINE_SET_STORAGE_FRAM_ENABLED:
             storage_fram_enabled = atoi(gopt.optarg);
             break;
+#endif
+#if STORAGE_USE_JOURNAL
+        case CMDLINE_SET_STORAGE_JOURNAL_ENABLED:
+            storage_journal_enabled = atoi(gopt.optarg);
+            break;
 #endif
         case 'h':
             _usage();
@@ -625,6 +637,10 @@ void SITL_State::_parse_command_line(int argc, char * const argv[])
         printf("Only one of flash or posix storage may be selected");
         exit(1);
     }
+    if (storage_journal_enabled && (storage_posix_enabled || storage_flash_enabled)) {
+        printf("Journal storage can't be used with flash or posix storage");
+        exit(1);
+    }
 
     if (AP::sitl()) {
         // Set SITL start time.
@@ -634,6 +650,7 @@ void SITL_State::_parse_command_line(int argc, char * const argv[])
     hal.set_storage_posix_enabled(storage_posix_enabled);
     hal.set_storage_flash_enabled(storage_flash_enabled);
     hal.set_storage_fram_enabled(storage_fram_enabled);
+    hal.set_storage_journal_enabled(storage_journal_enabled);
 
     if (erase_all_storage) {
         AP_Param::erase_all();
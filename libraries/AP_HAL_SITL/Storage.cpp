@@ -21,6 +21,16 @@
 #endif
 #endif
 
+#ifndef HAL_STORAGE_JOURNAL_FILE
+#if APM_BUILD_TYPE(APM_BUILD_Replay)
+#define HAL_STORAGE_JOURNAL_FILE "eeprom-replay.jnl"
+#elif APM_BUILD_TYPE(APM_BUILD_AP_Periph)
+#define HAL_STORAGE_JOURNAL_FILE "eeprom-periph.jnl"
+#else
+#define HAL_STORAGE_JOURNAL_FILE "eeprom.jnl"
+#endif
+#endif
+
 using namespace HALSITL;
 
 extern HAL_SITL& hal;
@@ -80,6 +90,14 @@ void Storage::_storage_open(void)
     }
 #endif // STORAGE_USE_FLASH
 
+#if STORAGE_USE_JOURNAL
+    if (hal.get_storage_journal_enabled()) {
+        _journal_load();
+        _initialisedType = StorageBackend::Journal;
+        return;
+    }
+#endif
+
 #if STORAGE_USE_POSIX
     if (hal.get_storage_posix_enabled()) {
         // if we have failed filesystem init don't try again (this is
@@ -167,6 +185,23 @@ void Storage::_timer_tick(void)
     }
     if (_dirty_mask.empty()) {
         _last_empty_ms = AP_HAL::millis();
+#if STORAGE_USE_FLASH
+        if (_initialisedType == StorageBackend::Flash) {
+            // copy the old sector forward while there is nothing to write
+            _flash.compact_step();
+        }
+#endif
+#if STORAGE_USE_JOURNAL
+        if (_initialisedType == StorageBackend::Journal) {
+            // flush once a burst of writes is done, and only compact
+            // when there is nothing else to do
+            if (_journal_sync_pending) {
+                _journal_sync_pending = !_journal.sync();
+            } else {
+                _journal.compact_step();
+            }
+        }
+#endif
         return;
     }
 
@@ -190,6 +225,13 @@ void Storage::_timer_tick(void)
         }
 #endif
 
+#if STORAGE_USE_JOURNAL
+    if (_initialisedType == StorageBackend::Journal) {
+        _journal_write(i);
+        return;
+    }
+#endif
+
 #if STORAGE_USE_POSIX
     if (hal.get_storage_posix_enabled()) {
         if (log_fd != -1) {
@@ -376,6 +418,67 @@ bool Storage::_flash_erase_ok(void)
 
 #endif // STORAGE_USE_FLASH
 
+#if STORAGE_USE_JOURNAL
+
+/*
+  load storage from the journal. If there is no journal yet it is
+  created from the posix storage file, if any
+ */
+void Storage::_journal_load(void)
+{
+    if (access(HAL_STORAGE_JOURNAL_FILE, F_OK) != 0) {
+        const int fd = open(HAL_STORAGE_FILE, O_RDONLY|O_CLOEXEC);
+        if (fd != -1) {
+            if (read(fd, _buffer, HAL_STORAGE_SIZE) > 0) {
+                ::printf("Storage: importing " HAL_STORAGE_FILE "\n");
+            }
+            close(fd);
+        }
+    }
+    if (!_journal.init(HAL_STORAGE_JOURNAL_FILE)) {
+        AP_HAL::panic("unable to init journal storage");
+    }
+    const auto &stats = _journal.get_stats();
+    ::printf("Storage: journal replayed %u records in %u us, discarded %u bytes\n",
+             unsigned(stats.records_replayed), unsigned(stats.mount_us), unsigned(stats.bytes_discarded));
+}
+
+/*
+  write the run of dirty lines starting at line as one journal
+  record. Single clean lines within the run are included as they cost
+  less than the header of another record
+ */
+void Storage::_journal_write(uint16_t line)
+{
+    const uint16_t max_lines = StorageJournal::max_record_length / STORAGE_LINE_SIZE;
+    uint16_t n = 1;
+    while (line + n < STORAGE_NUM_LINES && n < max_lines) {
+        if (_dirty_mask.get(line + n)) {
+            n++;
+        } else if (line + n + 1 < STORAGE_NUM_LINES && n + 1 < max_lines &&
+                   _dirty_mask.get(line + n + 1)) {
+            n += 2;
+        } else {
+            break;
+        }
+    }
+
+    // mark the lines clean before the data is copied, so a
+    // write_block() which races with us marks them dirty again
+    for (uint16_t i=0; i<n; i++) {
+        _dirty_mask.clear(line + i);
+    }
+    if (!_journal.write(line*STORAGE_LINE_SIZE, n*STORAGE_LINE_SIZE)) {
+        for (uint16_t i=0; i<n; i++) {
+            _dirty_mask.set(line + i);
+        }
+        return;
+    }
+    _journal_sync_pending = true;
+}
+
+#endif // STORAGE_USE_JOURNAL
+
 /*
   consider storage healthy if we have nothing to write sometime in the
   last 2 seconds
@@ -385,6 +488,11 @@ bool Storage::healthy(void)
     if (_initialisedType == StorageBackend::None) {
         return false;
     }
+#if STORAGE_USE_JOURNAL
+    if (_initialisedType == StorageBackend::Journal && !_journal.healthy()) {
+        return false;
+    }
+#endif
     return AP_HAL::millis() - _last_empty_ms < 2000;
 }
 
@@ -5,6 +5,7 @@
 #include "AP_HAL_SITL_Namespace.h"
 #include <AP_FlashStorage/AP_FlashStorage.h>
 #include <AP_RAMTRON/AP_RAMTRON.h>
+#include <AP_HAL/utility/StorageJournal.h>
 
 #ifndef STORAGE_USE_FLASH
 #define STORAGE_USE_FLASH 1
@@ -18,6 +19,10 @@
 #define STORAGE_USE_FRAM HAL_WITH_RAMTRON
 #endif
 
+#ifndef STORAGE_USE_JOURNAL
+#define STORAGE_USE_JOURNAL HAL_STORAGE_JOURNAL_ENABLED
+#endif
+
 #define STORAGE_LINE_SHIFT 3
 
 #define STORAGE_LINE_SIZE (1<<STORAGE_LINE_SHIFT)
@@ -39,6 +44,7 @@ private:
         FRAM,
         Flash,
         SDCard,  // AKA POSIX
+        Journal,
     };
     StorageBackend _initialisedType = StorageBackend::None;
 
@@ -78,4 +84,12 @@ private:
 #if STORAGE_USE_FRAM
     AP_RAMTRON fram;
 #endif
+
+#if STORAGE_USE_JOURNAL
+    StorageJournal _journal{_buffer, HAL_STORAGE_SIZE};
+    bool _journal_sync_pending;
+
+    void _journal_load(void);
+    void _journal_write(uint16_t line);
+#endif
 };
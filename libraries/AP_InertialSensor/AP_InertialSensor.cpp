@@ -698,6 +698,12 @@ const AP_Param::GroupInfo AP_InertialSensor::var_info[] = {
 
     // indexes 57 and 58 used by INS_HNTC3 and INS_HNTC4
 
+#if AP_INERTIALSENSOR_RAWSTREAM_ENABLED
+    // @Group: _RSTR_
+    // @Path: AP_InertialSensor_RawStream.cpp
+    AP_SUBGROUPINFO(rawstream, "_RSTR_", 59, AP_InertialSensor, AP_InertialSensor_RawStream),
+#endif
+
     /*
       NOTE: parameter indexes have gaps above. When adding new
       parameters check for conflicts carefully
@@ -981,6 +987,10 @@ AP_InertialSensor::init(uint16_t loop_rate)
     // initialise IMU batch logging
     batchsampler.init();
 #endif
+#if AP_INERTIALSENSOR_RAWSTREAM_ENABLED
+    // start continuous raw sample capture
+    rawstream.init();
+#endif
 
 #if HAL_GYROFFT_ENABLED
     AP_GyroFFT* fft = AP::fft();
@@ -20,6 +20,7 @@
 #include <AP_SerialManager/AP_SerialManager_config.h>
 #include "AP_InertialSensor_Params.h"
 #include "AP_InertialSensor_tempcal.h"
+#include "AP_InertialSensor_RawStream.h"
 
 #ifndef AP_SIM_INS_ENABLED
 #define AP_SIM_INS_ENABLED AP_SIM_ENABLED
@@ -259,6 +260,15 @@ public:
     // retrieve and clear accelerometer clipping count
     uint32_t get_accel_clip_count(uint8_t instance) const;
 
+    // number of samples the raw stream capture has dropped
+    uint32_t get_rawstream_dropped_count() const {
+#if AP_INERTIALSENSOR_RAWSTREAM_ENABLED
+        return rawstream.get_dropped_count();
+#else
+        return 0;
+#endif
+    }
+
     // check for vibration movement. True when all axis show nearly zero movement
     bool is_still();
 
@@ -426,6 +436,11 @@ public:
     BatchSampler batchsampler{*this};
 #endif
 
+#if AP_INERTIALSENSOR_RAWSTREAM_ENABLED
+    // continuous raw sample capture to a file
+    AP_InertialSensor_RawStream rawstream;
+#endif
+
 #if AP_EXTERNAL_AHRS_ENABLED
     // handle external AHRS data
     void handle_external(const AP_ExternalAHRS::ins_data_message_t &pkt);
@@ -817,12 +832,15 @@ public:
     void disable_fast_rate_buffer();
     // get the next available gyro sample from the fast rate buffer
     bool get_next_gyro_sample(Vector3f& gyro);
+    // get the next available gyro sample and the time in microseconds
+    // at which the backend read it from the sensor
+    bool get_next_gyro_sample(Vector3f& gyro, uint32_t& sample_us);
     // get the number of available gyro samples in the fast rate buffer
     uint32_t get_num_gyro_samples();
     // set the rate at which samples are collected, unused samples are dropped
     void set_rate_decimation(uint8_t rdec);
     // push a new gyro sample into the fast rate buffer
-    bool push_next_gyro_sample(const Vector3f& gyro);
+    bool push_next_gyro_sample(const Vector3f& gyro, uint32_t sample_us);
     // run the filter parmeter update code.
     void update_backend_filters();
     // are rate loop samples enabled for this instance?
@@ -399,7 +399,7 @@ void AP_InertialSensor_BMI088::read_fifo_gyro(void)
         return;
     }
     const float scale = radians(2000.0f) / 32767.0f;
-    const uint8_t max_frames = 8;
+    const uint8_t max_frames = INS_MAX_FIFO_BURST_SAMPLES;
     const Vector3i bad_frame{INT16_MIN,INT16_MIN,INT16_MIN};
     Vector3i data[max_frames];
 
@@ -426,16 +426,20 @@ void AP_InertialSensor_BMI088::read_fifo_gyro(void)
         goto check_next;
     }
 
-    // data is 16 bits with 2000dps range
-    for (uint8_t i = 0; i < num_frames; i++) {
-        if (data[i] == bad_frame) {
-            continue;
+    {
+        // data is 16 bits with 2000dps range
+        gyro_fifo.n = 0;
+        for (uint8_t i = 0; i < num_frames; i++) {
+            if (data[i] == bad_frame) {
+                continue;
+            }
+            Vector3f gyro(data[i].x, data[i].y, data[i].z);
+            gyro *= scale;
+            gyro_fifo.add(gyro);
         }
-        Vector3f gyro(data[i].x, data[i].y, data[i].z);
-        gyro *= scale;
 
-        _rotate_and_correct_gyro(gyro_instance, gyro);
-        _notify_new_gyro_raw_sample(gyro_instance, gyro);
+        _rotate_and_correct_gyro_samples(gyro_instance, gyro_fifo);
+        _notify_new_gyro_raw_samples(gyro_instance, gyro_fifo);
     }
 
 check_next:
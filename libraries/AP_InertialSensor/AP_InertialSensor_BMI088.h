@@ -86,4 +86,7 @@ private:
 
     bool done_accel_config;
     uint32_t accel_config_count;
+
+    // gyro samples from the FIFO, kept off the stack of the bus thread
+    FIFOSamples gyro_fifo;
 };
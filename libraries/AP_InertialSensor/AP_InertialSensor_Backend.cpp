@@ -169,6 +169,156 @@ void AP_InertialSensor_Backend::_rotate_and_correct_gyro(uint8_t instance, Vecto
     gyro.rotate(_imu._board_orientation);
 }
 
+/*
+  rotate a burst of samples. Rotations which only swap and negate
+  axes, which covers most boards, are applied as a copy of each
+  source axis so the result is bit for bit the same as
+  Vector3f::rotate(). Other rotations are applied sample by sample
+ */
+void AP_InertialSensor_Backend::rotate_samples(FIFOSamples &s, enum Rotation rotation)
+{
+    if (rotation == ROTATION_NONE) {
+        return;
+    }
+
+    // find the source axis and sign of each output axis
+    const Vector3f unit[3] { {1,0,0}, {0,1,0}, {0,0,1} };
+    uint8_t src[3] {};
+    float sign[3] {};
+    for (uint8_t j = 0; j < 3; j++) {
+        Vector3f col = unit[j];
+        col.rotate(rotation);
+        for (uint8_t k = 0; k < 3; k++) {
+            if (col[k] == 1 || col[k] == -1) {
+                src[k] = j;
+                sign[k] = col[k];
+            } else if (col[k] != 0) {
+                for (uint8_t i = 0; i < s.n; i++) {
+                    Vector3f v = s.get(i);
+                    v.rotate(rotation);
+                    s.set(i, v);
+                }
+                return;
+            }
+        }
+    }
+
+    float in[3][INS_MAX_FIFO_BURST_SAMPLES];
+    memcpy(in[0], s.x, s.n*sizeof(float));
+    memcpy(in[1], s.y, s.n*sizeof(float));
+    memcpy(in[2], s.z, s.n*sizeof(float));
+    float *out[3] { s.x, s.y, s.z };
+    for (uint8_t k = 0; k < 3; k++) {
+        const float *from = in[src[k]];
+        float *to = out[k];
+        if (sign[k] > 0) {
+            memcpy(to, from, s.n*sizeof(float));
+        } else {
+            for (uint8_t i = 0; i < s.n; i++) {
+                to[i] = -from[i];
+            }
+        }
+    }
+}
+
+/*
+  rotate and correct a burst of accel samples from a FIFO. This gives
+  the same result as calling _rotate_and_correct_accel() on each
+  sample, but looks up the orientation, calibration state, offsets
+  and temperature correction once for the whole burst
+ */
+void AP_InertialSensor_Backend::_rotate_and_correct_accel_samples(uint8_t instance, FIFOSamples &accel)
+{
+#if HAL_INS_TEMPERATURE_CAL_ENABLE
+    if (_imu.tcal_learning) {
+        // learning needs to see every sample in sensor frame
+        for (uint8_t i = 0; i < accel.n; i++) {
+            Vector3f a = accel.get(i);
+            _rotate_and_correct_accel(instance, a);
+            accel.set(i, a);
+        }
+        return;
+    }
+#endif
+
+    // rotate for sensor orientation
+    rotate_samples(accel, _imu._accel_orientation[instance]);
+
+    if (!_imu._calibrating_accel && (_imu._acal == nullptr
+#if HAL_INS_ACCELCAL_ENABLED
+        || !_imu._acal->running()
+#endif
+    )) {
+
+#if HAL_INS_TEMPERATURE_CAL_ENABLE
+        // apply temperature corrections
+        _imu.tcal(instance).correct_accel_samples(_imu.get_temperature(instance), _imu.caltemp_accel(instance),
+                                                  accel.x, accel.y, accel.z, accel.n);
+#endif
+
+        // apply offsets and scaling
+        const Vector3f accel_offset = _imu._accel_offset(instance).get();
+        const Vector3f accel_scale = _imu._accel_scale(instance).get();
+        for (uint8_t i = 0; i < accel.n; i++) {
+            accel.x[i] = (accel.x[i] - accel_offset.x) * accel_scale.x;
+        }
+        for (uint8_t i = 0; i < accel.n; i++) {
+            accel.y[i] = (accel.y[i] - accel_offset.y) * accel_scale.y;
+        }
+        for (uint8_t i = 0; i < accel.n; i++) {
+            accel.z[i] = (accel.z[i] - accel_offset.z) * accel_scale.z;
+        }
+    }
+
+    // rotate to body frame
+    rotate_samples(accel, _imu._board_orientation);
+}
+
+/*
+  rotate and correct a burst of gyro samples from a FIFO, see
+  _rotate_and_correct_accel_samples()
+ */
+void AP_InertialSensor_Backend::_rotate_and_correct_gyro_samples(uint8_t instance, FIFOSamples &gyro)
+{
+#if HAL_INS_TEMPERATURE_CAL_ENABLE
+    if (_imu.tcal_learning) {
+        // learning needs to see every sample in sensor frame
+        for (uint8_t i = 0; i < gyro.n; i++) {
+            Vector3f g = gyro.get(i);
+            _rotate_and_correct_gyro(instance, g);
+            gyro.set(i, g);
+        }
+        return;
+    }
+#endif
+
+    // rotate for sensor orientation
+    rotate_samples(gyro, _imu._gyro_orientation[instance]);
+
+    if (!_imu._calibrating_gyro) {
+
+#if HAL_INS_TEMPERATURE_CAL_ENABLE
+        // apply temperature corrections
+        _imu.tcal(instance).correct_gyro_samples(_imu.get_temperature(instance), _imu.caltemp_gyro(instance),
+                                                 gyro.x, gyro.y, gyro.z, gyro.n);
+#endif
+
+        // gyro calibration is always assumed to have been done in sensor frame
+        const Vector3f gyro_offset = _imu._gyro_offset(instance).get();
+        for (uint8_t i = 0; i < gyro.n; i++) {
+            gyro.x[i] -= gyro_offset.x;
+        }
+        for (uint8_t i = 0; i < gyro.n; i++) {
+            gyro.y[i] -= gyro_offset.y;
+        }
+        for (uint8_t i = 0; i < gyro.n; i++) {
+            gyro.z[i] -= gyro_offset.z;
+        }
+    }
+
+    rotate_samples(gyro, _imu._board_orientation);
+}
+
 /*
   rotate gyro vector and add the gyro offset
  */
@@ -266,7 +416,7 @@ void AP_InertialSensor_Backend::apply_gyro_filters(const uint8_t instance, const
 
 #if AP_INERTIALSENSOR_FAST_SAMPLE_WINDOW_ENABLED
     if (_imu.is_rate_loop_gyro_enabled(instance)) {
-        if (_imu.push_next_gyro_sample(gyro_filtered)) {
+        if (_imu.push_next_gyro_sample(gyro_filtered, uint32_t(_imu._gyro_last_sample_us[instance]))) {
             // if we used the value, record it for publication to the front-end
             _imu._gyro_filtered[instance] = gyro_filtered;
         }
@@ -461,6 +611,9 @@ void AP_InertialSensor_Backend::_notify_new_delta_angle(uint8_t instance, const
 
 void AP_InertialSensor_Backend::log_gyro_raw(uint8_t instance, const uint64_t sample_us, const Vector3f &raw_gyro, const Vector3f &filtered_gyro)
 {
+#if AP_INERTIALSENSOR_RAWSTREAM_ENABLED
+    _imu.rawstream.sample(instance, AP_InertialSensor::IMU_SENSOR_TYPE_GYRO, sample_us, raw_gyro);
+#endif
 #if HAL_LOGGING_ENABLED
     AP_Logger *logger = AP_Logger::get_singleton();
     if (logger == nullptr) {
@@ -603,6 +756,10 @@ void AP_InertialSensor_Backend::_notify_new_accel_raw_sample(uint8_t instance,
         _imu._new_accel_data[instance] = true;
     }
 
+#if AP_INERTIALSENSOR_RAWSTREAM_ENABLED
+    _imu.rawstream.sample(instance, AP_InertialSensor::IMU_SENSOR_TYPE_ACCEL, sample_us, accel);
+#endif
+
     // 5us
 #if AP_INERTIALSENSOR_BATCHSAMPLER_ENABLED
     if (!_imu.batchsampler.doing_post_filter_logging()) {
@@ -616,6 +773,268 @@ void AP_InertialSensor_Backend::_notify_new_accel_raw_sample(uint8_t instance,
 #endif
 }
 
+/*
+  handle a burst of accel samples from a FIFO based sensor. The
+  samples must already be rotated and corrected. This is equivalent to
+  calling _notify_new_accel_raw_sample() with sample_us=0 on each
+  sample, with a single hold of the backend semaphore per burst
+ */
+void AP_InertialSensor_Backend::_notify_new_accel_raw_samples(uint8_t instance, FIFOSamples &accel)
+{
+    notify_fifo_samples(instance, &accel, 0, nullptr);
+}
+
+/*
+  handle a burst of gyro samples from a FIFO based sensor, see
+  _notify_new_accel_raw_samples()
+ */
+void AP_InertialSensor_Backend::_notify_new_gyro_raw_samples(uint8_t instance, FIFOSamples &gyro)
+{
+    notify_fifo_samples(0, nullptr, instance, &gyro);
+}
+
+/*
+  handle a burst of samples from a sensor with a combined accel and
+  gyro FIFO. Each accel sample is handled before the gyro sample from the same FIFO
+  entry, as happens when the per-sample functions are called on each
+  entry in turn
+ */
+void AP_InertialSensor_Backend::_notify_new_raw_samples(uint8_t _accel_instance, FIFOSamples &accel,
+                                                        uint8_t _gyro_instance, FIFOSamples &gyro)
+{
+    notify_fifo_samples(_accel_instance, &accel, _gyro_instance, &gyro);
+}
+
+void AP_InertialSensor_Backend::notify_fifo_samples(uint8_t _accel_instance, FIFOSamples *accel,
+                                                    uint8_t _gyro_instance, FIFOSamples *gyro)
+{
+    if (accel != nullptr && (accel->n == 0 || has_been_killed(_accel_instance))) {
+        accel = nullptr;
+    }
+    if (gyro != nullptr && (gyro->n == 0 || has_been_killed(_gyro_instance))) {
+        gyro = nullptr;
+    }
+    if (accel == nullptr && gyro == nullptr) {
+        return;
+    }
+    const uint8_t n = MAX(accel != nullptr ? accel->n : 0, gyro != nullptr ? gyro->n : 0);
+
+    uint64_t accel_last_sample_us = 0;
+    if (accel != nullptr) {
+        accel_last_sample_us = _imu._accel_last_sample_us[_accel_instance];
+        accel->accepted_mask = 0;
+    }
+    uint64_t gyro_last_sample_us = 0;
+    if (gyro != nullptr) {
+        gyro_last_sample_us = _imu._gyro_last_sample_us[_gyro_instance];
+        gyro->accepted_mask = 0;
+    }
+
+    for (uint8_t i = 0; i < n; i++) {
+        if (accel != nullptr && i < accel->n) {
+            accel_sample_prepare(_accel_instance, *accel, i);
+        }
+        if (gyro != nullptr && i < gyro->n) {
+            gyro_sample_prepare(_gyro_instance, *gyro, i);
+        }
+    }
+
+    const bool accel_accepted = accel != nullptr && accel->accepted_mask != 0;
+    const bool gyro_accepted = gyro != nullptr && gyro->accepted_mask != 0;
+    if (accel_accepted || gyro_accepted) {
+        WITH_SEMAPHORE(_sem);
+        const uint64_t now = AP_HAL::micros64();
+        // only the first sample of a burst can follow a gap
+        bool accel_check_gap = true;
+        bool gyro_check_gap = true;
+
+        for (uint8_t i = 0; i < n; i++) {
+            if (accel_accepted && (accel->accepted_mask & (1U<<i)) != 0) {
+                accel_sample_integrate(_accel_instance, *accel, i, accel_check_gap, accel_last_sample_us, now);
+                accel_check_gap = false;
+            }
+            if (gyro_accepted && (gyro->accepted_mask & (1U<<i)) != 0) {
+                gyro_sample_integrate(_gyro_instance, *gyro, i, gyro_check_gap, gyro_last_sample_us, now);
+                gyro_check_gap = false;
+            }
+        }
+
+        if (accel_accepted) {
+            _imu._new_accel_data[_accel_instance] = true;
+        }
+        if (gyro_accepted) {
+            _imu._new_gyro_data[_gyro_instance] = true;
+        }
+    }
+
+    for (uint8_t i = 0; i < n; i++) {
+        if (accel_accepted && (accel->accepted_mask & (1U<<i)) != 0) {
+            accel_sample_log(_accel_instance, *accel, i);
+        }
+        if (gyro_accepted && (gyro->accepted_mask & (1U<<i)) != 0) {
+            log_gyro_raw(_gyro_instance, gyro->sample_us[i], gyro->get(i), gyro->filtered[i]);
+        }
+    }
+
+    if (gyro != nullptr) {
+        update_primary();
+    }
+}
+
+/*
+  the part of _notify_new_accel_raw_sample() that runs before the
+  backend semaphore is taken
+ */
+void AP_InertialSensor_Backend::accel_sample_prepare(uint8_t instance, FIFOSamples &accel, uint8_t i)
+{
+    _update_sensor_rate(_imu._sample_accel_count[instance], _imu._sample_accel_start_us[instance],
+                        _imu._accel_raw_sample_rates[instance]);
+
+    // don't accept below 40Hz
+    if (_imu._accel_raw_sample_rates[instance] < 40) {
+        return;
+    }
+    accel.accepted_mask |= 1U<<i;
+
+    accel.dt[i] = 1.0f / _imu._accel_raw_sample_rates[instance];
+    accel.sample_us[i] = AP_HAL::micros64();
+
+    const Vector3f a = accel.get(i);
+
+#if AP_MODULE_SUPPORTED
+    // call accel_sample hook if any
+    AP_Module::call_hook_accel_sample(instance, accel.dt[i], a, false);
+#endif
+
+    _imu.calc_vibration_and_clipping(instance, a, accel.dt[i]);
+}
+
+/*
+  the part of _notify_new_accel_raw_sample() that runs with the backend
+  semaphore held
+ */
+void AP_InertialSensor_Backend::accel_sample_integrate(uint8_t instance, FIFOSamples &accel, uint8_t i,
+                                                       bool check_gap, uint64_t last_sample_us, uint64_t now)
+{
+    float dt = accel.dt[i];
+    const Vector3f a = accel.get(i);
+
+    _imu._accel_last_sample_us[instance] = accel.sample_us[i];
+
+    if (check_gap && now - last_sample_us > 100000U) {
+        // zero accumulator if sensor was unhealthy for 0.1s
+        _imu._delta_velocity_acc[instance].zero();
+        _imu._delta_velocity_acc_dt[instance] = 0;
+        dt = 0;
+    }
+
+    // delta velocity
+    _imu._delta_velocity_acc[instance] += a * dt;
+    _imu._delta_velocity_acc_dt[instance] += dt;
+
+    _imu._accel_filtered[instance] = _imu._accel_filter[instance].apply(a);
+    if (_imu._accel_filtered[instance].is_nan() || _imu._accel_filtered[instance].is_inf()) {
+        _imu._accel_filter[instance].reset();
+    }
+
+    _imu.set_accel_peak_hold(instance, _imu._accel_filtered[instance]);
+    accel.filtered[i] = _imu._accel_filtered[instance];
+}
+
+/*
+  the part of _notify_new_accel_raw_sample() that runs after the
+  backend semaphore is released
+ */
+void AP_InertialSensor_Backend::accel_sample_log(uint8_t instance, const FIFOSamples &accel, uint8_t i)
+{
+    const Vector3f a = accel.get(i);
+#if AP_INERTIALSENSOR_RAWSTREAM_ENABLED
+    _imu.rawstream.sample(instance, AP_InertialSensor::IMU_SENSOR_TYPE_ACCEL, accel.sample_us[i], a);
+#endif
+#if AP_INERTIALSENSOR_BATCHSAMPLER_ENABLED
+    if (!_imu.batchsampler.doing_post_filter_logging()) {
+        log_accel_raw(instance, accel.sample_us[i], a);
+    } else {
+        log_accel_raw(instance, accel.sample_us[i], accel.filtered[i]);
+    }
+#else
+    // assume we're doing pre-filter logging:
+    log_accel_raw(instance, accel.sample_us[i], a);
+#endif
+}
+
+/*
+  the part of _notify_new_gyro_raw_sample() that runs before the
+  backend semaphore is taken
+ */
+void AP_InertialSensor_Backend::gyro_sample_prepare(uint8_t instance, FIFOSamples &gyro, uint8_t i)
+{
+    _update_sensor_rate(_imu._sample_gyro_count[instance], _imu._sample_gyro_start_us[instance],
+                        _imu._gyro_raw_sample_rates[instance]);
+
+    // don't accept below 40Hz
+    if (_imu._gyro_raw_sample_rates[instance] < 40) {
+        return;
+    }
+    gyro.accepted_mask |= 1U<<i;
+
+    gyro.dt[i] = 1.0f / _imu._gyro_raw_sample_rates[instance];
+    gyro.sample_us[i] = AP_HAL::micros64();
+
+    const Vector3f g = gyro.get(i);
+
+#if AP_MODULE_SUPPORTED
+    // call gyro_sample hook if any
+    AP_Module::call_hook_gyro_sample(instance, gyro.dt[i], g);
+#endif
+
+    // push gyros if optical flow present
+    if (hal.opticalflow) {
+        hal.opticalflow->push_gyro(g.x, g.y, gyro.dt[i]);
+    }
+}
+
+/*
+  the part of _notify_new_gyro_raw_sample() that runs with the backend
+  semaphore held
+ */
+void AP_InertialSensor_Backend::gyro_sample_integrate(uint8_t instance, FIFOSamples &gyro, uint8_t i,
+                                                      bool check_gap, uint64_t last_sample_us, uint64_t now)
+{
+    float dt = gyro.dt[i];
+    const Vector3f g = gyro.get(i);
+
+    // the filters push this sample to the fast rate buffer with the
+    // last sample time, so it must be the time of this sample
+    _imu._gyro_last_sample_us[instance] = gyro.sample_us[i];
+
+    // compute delta angle and coning correction, see _notify_new_gyro_raw_sample()
+    Vector3f delta_angle = (g + _imu._last_raw_gyro[instance]) * 0.5f * dt;
+    Vector3f delta_coning = (_imu._delta_angle_acc[instance] +
+                             _imu._last_delta_angle[instance] * (1.0f / 6.0f));
+    delta_coning = delta_coning % delta_angle;
+    delta_coning *= 0.5f;
+
+    if (check_gap && now - last_sample_us > 100000U) {
+        // zero accumulator if sensor was unhealthy for 0.1s
+        _imu._delta_angle_acc[instance].zero();
+        _imu._delta_angle_acc_dt[instance] = 0;
+        dt = 0;
+        delta_angle.zero();
+    }
+
+    _imu._delta_angle_acc[instance] += delta_angle + delta_coning;
+    _imu._delta_angle_acc_dt[instance] += dt;
+
+    // save previous delta angle for coning correction
+    _imu._last_delta_angle[instance] = delta_angle;
+    _imu._last_raw_gyro[instance] = g;
+
+    // apply gyro filters and sample for FFT
+    apply_gyro_filters(instance, g);
+    gyro.filtered[i] = _imu._gyro_filtered[instance];
+}
+
 /*
   handle a delta-velocity sample from the backend. This assumes FIFO style sampling and
   the sample should not be rotated or corrected for offsets
@@ -681,6 +1100,10 @@ void AP_InertialSensor_Backend::_notify_new_delta_velocity(uint8_t instance, con
         _imu._new_accel_data[instance] = true;
     }
 
+#if AP_INERTIALSENSOR_RAWSTREAM_ENABLED
+    _imu.rawstream.sample(instance, AP_InertialSensor::IMU_SENSOR_TYPE_ACCEL, sample_us, accel);
+#endif
+
 #if AP_INERTIALSENSOR_BATCHSAMPLER_ENABLED
     if (!_imu.batchsampler.doing_post_filter_logging()) {
         log_accel_raw(instance, sample_us, accel);
@@ -33,6 +33,10 @@
 #define HAL_INS_HIGHRES_SAMPLE 0
 #endif
 
+// maximum number of samples in a FIFO burst passed to the batch
+// sample interface
+#define INS_MAX_FIFO_BURST_SAMPLES 8
+
 class AuxiliaryBus;
 class AP_Logger;
 
@@ -204,6 +208,45 @@ protected:
 
     // alternative interface using delta-velocities. Rotation and correction is handled inside this function
     void _notify_new_delta_velocity(uint8_t instance, const Vector3f &dvelocity);
+
+    /*
+      a burst of samples from a FIFO, held as one array per axis so
+      the rotation and correction of a burst are per-axis loops
+     */
+    struct FIFOSamples {
+        float x[INS_MAX_FIFO_BURST_SAMPLES];
+        float y[INS_MAX_FIFO_BURST_SAMPLES];
+        float z[INS_MAX_FIFO_BURST_SAMPLES];
+        uint8_t n;
+
+        // per-sample state used by the notify functions
+        float dt[INS_MAX_FIFO_BURST_SAMPLES];
+        uint64_t sample_us[INS_MAX_FIFO_BURST_SAMPLES];
+        Vector3f filtered[INS_MAX_FIFO_BURST_SAMPLES];
+        uint16_t accepted_mask;
+
+        Vector3f get(uint8_t i) const { return Vector3f{x[i], y[i], z[i]}; }
+        void set(uint8_t i, const Vector3f &v) { x[i] = v.x; y[i] = v.y; z[i] = v.z; }
+        void add(const Vector3f &v) { set(n++, v); }
+        bool full() const { return n == INS_MAX_FIFO_BURST_SAMPLES; }
+    };
+
+    /*
+      batch interface for FIFO based sensors. These process a whole
+      FIFO burst with the same semantics as calling the per-sample
+      functions on each sample in turn, but evaluate the per-burst
+      invariants (orientation, calibration state, temperature
+      correction) once and take the backend semaphore once per
+      burst. Sensors with both an accel and gyro FIFO should use
+      _notify_new_raw_samples(), which handles each accel sample
+      followed by the gyro sample from the same FIFO entry
+     */
+    void _rotate_and_correct_accel_samples(uint8_t instance, FIFOSamples &accel) __RAMFUNC__;
+    void _rotate_and_correct_gyro_samples(uint8_t instance, FIFOSamples &gyro) __RAMFUNC__;
+    void _notify_new_accel_raw_samples(uint8_t instance, FIFOSamples &accel) __RAMFUNC__;
+    void _notify_new_gyro_raw_samples(uint8_t instance, FIFOSamples &gyro) __RAMFUNC__;
+    void _notify_new_raw_samples(uint8_t accel_instance, FIFOSamples &accel,
+                                 uint8_t gyro_instance, FIFOSamples &gyro) __RAMFUNC__;
     
     // set the amount of oversamping a accel is doing
     void _set_accel_oversampling(uint8_t instance, uint8_t n);
@@ -362,6 +405,17 @@ protected:
 
 private:
 
+    // helpers for the batch interface. The _prepare, _integrate and
+    // _log steps handle sample i of a burst
+    void rotate_samples(FIFOSamples &s, enum Rotation rotation) __RAMFUNC__;
+    void notify_fifo_samples(uint8_t accel_instance, FIFOSamples *accel,
+                             uint8_t gyro_instance, FIFOSamples *gyro) __RAMFUNC__;
+    void accel_sample_prepare(uint8_t instance, FIFOSamples &accel, uint8_t i) __RAMFUNC__;
+    void accel_sample_integrate(uint8_t instance, FIFOSamples &accel, uint8_t i, bool check_gap, uint64_t last_sample_us, uint64_t now) __RAMFUNC__;
+    void accel_sample_log(uint8_t instance, const FIFOSamples &accel, uint8_t i) __RAMFUNC__;
+    void gyro_sample_prepare(uint8_t instance, FIFOSamples &gyro, uint8_t i) __RAMFUNC__;
+    void gyro_sample_integrate(uint8_t instance, FIFOSamples &gyro, uint8_t i, bool check_gap, uint64_t last_sample_us, uint64_t now) __RAMFUNC__;
+
     bool should_log_imu_raw() const ;
     void log_accel_raw(uint8_t instance, const uint64_t sample_us, const Vector3f &accel) __RAMFUNC__;
     void log_gyro_raw(uint8_t instance, const uint64_t sample_us, const Vector3f &raw_gyro, const Vector3f &filtered_gyro) __RAMFUNC__;
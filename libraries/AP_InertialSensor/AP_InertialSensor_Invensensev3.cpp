@@ -442,11 +442,30 @@ void AP_InertialSensor_Invensensev3::accumulate()
     // nothing to do
 }
 
+/*
+  rotate, correct and pass the pending samples to the frontend
+ */
+void AP_InertialSensor_Invensensev3::notify_samples(void)
+{
+    if (accel_fifo.n == 0) {
+        return;
+    }
+    _rotate_and_correct_accel_samples(accel_instance, accel_fifo);
+    _rotate_and_correct_gyro_samples(gyro_instance, gyro_fifo);
+
+    _notify_new_raw_samples(accel_instance, accel_fifo, gyro_instance, gyro_fifo);
+
+    accel_fifo.n = 0;
+    gyro_fifo.n = 0;
+}
+
 bool AP_InertialSensor_Invensensev3::accumulate_samples(const FIFOData *data, uint8_t n_samples)
 {
 #if INV3_ENABLE_FIFO_LOGGING
     const uint64_t tstart = AP_HAL::micros64();
 #endif
+    bool ret = true;
+
     for (uint8_t i = 0; i < n_samples; i++) {
         const FIFOData &d = data[i];
 
@@ -456,7 +475,8 @@ bool AP_InertialSensor_Invensensev3::accumulate_samples(const FIFOData *data, ui
         // ICM42688 - HEADER_TIMESTAMP_FSYNC bit 2-3 : 10
         if ((d.header & 0xFC) != 0x68) { // ACCEL_EN | GYRO_EN | TMST_FIELD_EN
             // no or bad data
-            return false;
+            ret = false;
+            break;
         }
 
         Vector3f accel{float(d.accel[0]), float(d.accel[1]), float(d.accel[2])};
@@ -470,17 +490,17 @@ bool AP_InertialSensor_Invensensev3::accumulate_samples(const FIFOData *data, ui
 #endif
 
         const float temp = d.temperature * temp_sensitivity + temp_zero;
-
-        // these four calls are about 40us
-        _rotate_and_correct_accel(accel_instance, accel);
-        _rotate_and_correct_gyro(gyro_instance, gyro);
-
-        _notify_new_accel_raw_sample(accel_instance, accel, 0);
-        _notify_new_gyro_raw_sample(gyro_instance, gyro);
-
         temp_filtered = temp_filter.apply(temp);
+
+        accel_fifo.add(accel);
+        gyro_fifo.add(gyro);
+        if (accel_fifo.full()) {
+            notify_samples();
+        }
     }
-    return true;
+    // samples before any corruption are still good
+    notify_samples();
+    return ret;
 }
 
 #if HAL_INS_HIGHRES_SAMPLE
@@ -508,6 +528,8 @@ bool AP_InertialSensor_Invensensev3::accumulate_highres_samples(const FIFODataHi
 #if INV3_ENABLE_FIFO_LOGGING
     const uint64_t tstart = AP_HAL::micros64();
 #endif
+    bool ret = true;
+
     for (uint8_t i = 0; i < n_samples; i++) {
         const FIFODataHighRes &d = data[i];
 
@@ -515,7 +537,8 @@ bool AP_InertialSensor_Invensensev3::accumulate_highres_samples(const FIFODataHi
         // about with the temperature registers
         if ((d.header & 0xFC) != 0x78) { // ACCEL_EN | GYRO_EN | HIRES_EN | TMST_FIELD_EN
             // no or bad data
-            return false;
+            ret = false;
+            break;
         }
 
         Vector3f accel{uint20_to_float(d.accel[1], d.accel[0], d.ax),
@@ -532,17 +555,17 @@ bool AP_InertialSensor_Invensensev3::accumulate_highres_samples(const FIFODataHi
         Write_GYR(gyro_instance, tstart+(i*backend_period_us), gyro, true);
 #endif
         const float temp = d.temperature * temp_sensitivity + temp_zero;
-
-        // these four calls are about 40us
-        _rotate_and_correct_accel(accel_instance, accel);
-        _rotate_and_correct_gyro(gyro_instance, gyro);
-
-        _notify_new_accel_raw_sample(accel_instance, accel, 0);
-        _notify_new_gyro_raw_sample(gyro_instance, gyro);
-
         temp_filtered = temp_filter.apply(temp);
+
+        accel_fifo.add(accel);
+        gyro_fifo.add(gyro);
+        if (accel_fifo.full()) {
+            notify_samples();
+        }
     }
-    return true;
+    // samples before any corruption are still good
+    notify_samples();
+    return ret;
 }
 #endif
 
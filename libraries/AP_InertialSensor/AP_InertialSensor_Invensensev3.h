@@ -77,6 +77,7 @@ private:
 
     bool accumulate_samples(const struct FIFOData *data, uint8_t n_samples);
     bool accumulate_highres_samples(const struct FIFODataHighRes *data, uint8_t n_samples);
+    void notify_samples(void);
 
     // get the gyro backend rate in Hz at which the FIFO is being read
     uint16_t get_gyro_backend_rate_hz() const override {
@@ -138,6 +139,11 @@ private:
     // pre-calculated backend period
     uint32_t backend_period_us;
 
+    // samples read from the FIFO waiting to be passed to the
+    // frontend. These are kept off the stack of the bus thread
+    FIFOSamples accel_fifo;
+    FIFOSamples gyro_fifo;
+
     AP_HAL::OwnPtr<AP_HAL::Device> dev;
     AP_HAL::Device::PeriodicHandle periodic_handle;
 
@@ -0,0 +1,295 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/*
+  continuous capture of raw IMU samples to a file
+ */
+#include "AP_InertialSensor_RawStream.h"
+
+#if AP_INERTIALSENSOR_RAWSTREAM_ENABLED
+
+#include <AP_Filesystem/AP_Filesystem.h>
+#include <GCS_MAVLink/GCS.h>
+#include <stdio.h>
+
+extern const AP_HAL::HAL& hal;
+
+static_assert(sizeof(AP_InertialSensor_RawStream::FileHeader) == 16, "FileHeader must be 16 bytes");
+static_assert(sizeof(AP_InertialSensor_RawStream::Record) == 20, "Record must be 20 bytes");
+
+// maximum time a partly filled buffer is held before being written
+#define RAWSTREAM_FLUSH_MS 200
+
+// time between attempts to open a capture file, doubling after each
+// failure, and the number of attempts before capture is stopped
+#define RAWSTREAM_RETRY_MS 1000U
+#define RAWSTREAM_RETRY_MAX_MS 32000U
+#define RAWSTREAM_MAX_OPEN_ATTEMPTS 10
+
+const AP_Param::GroupInfo AP_InertialSensor_RawStream::var_info[] = {
+    // @Param: MASK
+    // @DisplayName: Raw IMU stream sensor mask
+    // @Description: Bitmask of IMUs to continuously capture to a file in the log directory. Every raw gyro sample (and optionally accel sample) is written, independent of the DataFlash log. Zero disables capture. This option takes effect on the next reboot.
+    // @Bitmask: 0:IMU1,1:IMU2,2:IMU3,3:IMU4,4:IMU5,5:IMU6,6:IMU7,7:IMU8
+    // @User: Advanced
+    // @RebootRequired: True
+    AP_GROUPINFO("MASK", 1, AP_InertialSensor_RawStream, imu_mask, 0),
+
+    // @Param: OPT
+    // @DisplayName: Raw IMU stream options
+    // @Description: Options for raw IMU stream capture
+    // @Bitmask: 0:Capture accelerometer samples
+    // @User: Advanced
+    AP_GROUPINFO("OPT", 2, AP_InertialSensor_RawStream, options, 0),
+
+    // @Param: BUF
+    // @DisplayName: Raw IMU stream buffer size
+    // @Description: Size of each of the two capture buffers. Larger buffers cope with longer filesystem stalls without dropping samples. This option takes effect on the next reboot.
+    // @Units: KB
+    // @Range: 16 4096
+    // @User: Advanced
+    // @RebootRequired: True
+    AP_GROUPINFO("BUF", 3, AP_InertialSensor_RawStream, buffer_kb, 256),
+
+    AP_GROUPEND
+};
+
+AP_InertialSensor_RawStream::AP_InertialSensor_RawStream(void)
+{
+    AP_Param::setup_object_defaults(this, var_info);
+}
+
+/*
+  allocate buffers and start the writer thread
+ */
+void AP_InertialSensor_RawStream::init()
+{
+    if (imu_mask == 0 || enabled()) {
+        return;
+    }
+
+    capacity = (constrain_int16(buffer_kb, 16, 4096) * 1024U) / sizeof(Record);
+    for (uint8_t i=0; i<2; i++) {
+        buffers[i] = (Record *)calloc(capacity, sizeof(Record));
+        if (buffers[i] == nullptr) {
+            free(buffers[0]);
+            buffers[0] = nullptr;
+            GCS_SEND_TEXT(MAV_SEVERITY_WARNING, "INS: failed to allocate raw stream buffers");
+            return;
+        }
+    }
+
+    if (!hal.scheduler->thread_create(FUNCTOR_BIND_MEMBER(&AP_InertialSensor_RawStream::io_thread, void),
+                                      "imu_stream", 4096, AP_HAL::Scheduler::PRIORITY_IO, 1)) {
+        free(buffers[0]);
+        free(buffers[1]);
+        buffers[0] = buffers[1] = nullptr;
+        GCS_SEND_TEXT(MAV_SEVERITY_WARNING, "INS: failed to start raw stream thread");
+        return;
+    }
+}
+
+/*
+  add a sample to the fill buffer. Called from the backend threads so
+  must be cheap
+ */
+void AP_InertialSensor_RawStream::sample(uint8_t instance, uint8_t type, uint64_t sample_us, const Vector3f &v)
+{
+    if (!capturing || (imu_mask & (1U<<instance)) == 0) {
+        return;
+    }
+    if (type == uint8_t(RecordType::ACCEL) && !option_set(Option::CAPTURE_ACCEL)) {
+        return;
+    }
+
+    WITH_SEMAPHORE(sem);
+
+    if (!capturing) {
+        return;
+    }
+    if (buffer_full[fill_idx]) {
+        // writer has not kept up, both buffers are full
+        dropped_count++;
+        return;
+    }
+
+    Record &r = buffers[fill_idx][buffer_count[fill_idx]++];
+    r.time_us = uint32_t(sample_us);
+    r.instance = instance;
+    r.type = type;
+    r.reserved = 0;
+    r.x = v.x;
+    r.y = v.y;
+    r.z = v.z;
+
+    if (buffer_count[fill_idx] == capacity) {
+        buffer_full[fill_idx] = true;
+        fill_idx ^= 1;
+        notify.signal();
+    }
+}
+
+/*
+  open a new capture file in the log directory
+ */
+bool AP_InertialSensor_RawStream::open_file()
+{
+    AP::FS().mkdir(HAL_BOARD_LOG_DIRECTORY);
+
+    char fname[64];
+    for (uint16_t n=1; n<1000; n++) {
+        hal.util->snprintf(fname, sizeof(fname), HAL_BOARD_LOG_DIRECTORY "/IMUSTRM%03u.BIN", unsigned(n));
+        struct stat st;
+        if (AP::FS().stat(fname, &st) != 0) {
+            break;
+        }
+    }
+
+    fd = AP::FS().open(fname, O_WRONLY|O_CREAT|O_TRUNC);
+    if (fd == -1) {
+        return false;
+    }
+
+    const FileHeader hdr {
+        MAGIC,
+        VERSION,
+        sizeof(Record),
+        AP_HAL::micros64(),
+    };
+    if (AP::FS().write(fd, &hdr, sizeof(hdr)) != sizeof(hdr)) {
+        AP::FS().close(fd);
+        fd = -1;
+        return false;
+    }
+    GCS_SEND_TEXT(MAV_SEVERITY_INFO, "INS: streaming raw IMU to %s", fname);
+    return true;
+}
+
+// write records to the file, returning false if the write failed
+bool AP_InertialSensor_RawStream::write_records(const Record *r, uint32_t count)
+{
+    if (count == 0) {
+        return true;
+    }
+    const ssize_t len = count * sizeof(Record);
+    return AP::FS().write(fd, r, len) == len;
+}
+
+/*
+  open a new capture file, retrying with increasing delays. If no file
+  can be opened capture is stopped for the rest of the boot, so the
+  backends no longer do any capture work
+ */
+void AP_InertialSensor_RawStream::open_file_with_backoff()
+{
+    uint32_t delay_ms = RAWSTREAM_RETRY_MS;
+    for (uint8_t attempt=0; attempt<RAWSTREAM_MAX_OPEN_ATTEMPTS; attempt++) {
+        if (open_file()) {
+            WITH_SEMAPHORE(sem);
+            capturing = true;
+            return;
+        }
+        hal.scheduler->delay(delay_ms);
+        delay_ms = MIN(delay_ms*2, RAWSTREAM_RETRY_MAX_MS);
+    }
+    GCS_SEND_TEXT(MAV_SEVERITY_WARNING, "INS: raw stream stopped, unable to open file");
+}
+
+/*
+  stop capturing after a write failure. Buffered samples are counted
+  as dropped, and a new file is opened
+ */
+void AP_InertialSensor_RawStream::write_failed()
+{
+    GCS_SEND_TEXT(MAV_SEVERITY_WARNING, "INS: raw stream write failed, reopening");
+    AP::FS().close(fd);
+    fd = -1;
+    {
+        WITH_SEMAPHORE(sem);
+        capturing = false;
+        for (uint8_t i=0; i<2; i++) {
+            dropped_count += buffer_count[i];
+            buffer_count[i] = 0;
+            buffer_full[i] = false;
+        }
+    }
+    open_file_with_backoff();
+}
+
+/*
+  writer thread. Writes full buffers as they become available and
+  flushes a partly filled buffer if it has been held for too long
+ */
+void AP_InertialSensor_RawStream::io_thread()
+{
+    uint32_t last_flush_ms = AP_HAL::millis();
+
+    open_file_with_backoff();
+
+    while (true) {
+        IGNORE_RETURN(notify.wait(RAWSTREAM_FLUSH_MS * 1000U));
+
+        if (fd == -1) {
+            // no file could be opened, capture has stopped
+            continue;
+        }
+
+        uint8_t idx;
+        uint32_t dropped;
+        {
+            WITH_SEMAPHORE(sem);
+            if (buffer_full[0] && buffer_full[1]) {
+                // the fill buffer was filled first
+                idx = fill_idx;
+            } else if (buffer_full[fill_idx^1]) {
+                idx = fill_idx^1;
+            } else if (buffer_count[fill_idx] > 0 &&
+                       AP_HAL::millis() - last_flush_ms >= RAWSTREAM_FLUSH_MS) {
+                idx = fill_idx;
+                buffer_full[idx] = true;
+                fill_idx ^= 1;
+            } else {
+                continue;
+            }
+            dropped = dropped_count;
+        }
+
+        // write outside the lock so backends can keep filling the other buffer
+        bool ok = write_records(buffers[idx], buffer_count[idx]);
+        last_flush_ms = AP_HAL::millis();
+
+        if (ok && dropped != dropped_reported) {
+            const Record r {
+                AP_HAL::micros(),
+                0,
+                uint8_t(RecordType::DROPPED),
+                0,
+                float(dropped - dropped_reported), 0, 0,
+            };
+            ok = write_records(&r, 1);
+            dropped_reported = dropped;
+        }
+
+        if (!ok) {
+            write_failed();
+            continue;
+        }
+
+        WITH_SEMAPHORE(sem);
+        buffer_count[idx] = 0;
+        buffer_full[idx] = false;
+    }
+}
+
+#endif // AP_INERTIALSENSOR_RAWSTREAM_ENABLED
@@ -0,0 +1,132 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/*
+  continuous capture of raw IMU samples to a file
+
+  Every raw (rotated and corrected, pre-filter) sample of the selected
+  IMUs is written to a binary file in the log directory, bypassing
+  AP_Logger message framing. Samples are put into one of two buffers
+  by the backends and a dedicated writer thread writes out full
+  buffers. If both buffers are full the sample is dropped and counted.
+
+  File format, all fields little-endian:
+
+  header (16 bytes):
+    uint32_t magic        0x53524d49 ("IMRS")
+    uint16_t version      1
+    uint16_t record_size  size of each record in bytes (20)
+    uint64_t start_us     boot time of file creation in microseconds
+
+  followed by records (20 bytes each):
+    uint32_t time_us      low 32 bits of sample time in microseconds
+    uint8_t  instance     IMU instance
+    uint8_t  type         0: accel m/s/s, 1: gyro rad/s, 2: dropped samples
+    uint16_t reserved
+    float    x, y, z      sample in body frame. For type 2 x holds the
+                          number of samples dropped since the previous
+                          type 2 record
+
+  Tools/scripts/imu_stream_decode.py converts a capture to CSV.
+ */
+#pragma once
+
+#include "AP_InertialSensor_config.h"
+
+#if AP_INERTIALSENSOR_RAWSTREAM_ENABLED
+
+#include <AP_HAL/AP_HAL.h>
+#include <AP_Param/AP_Param.h>
+#include <AP_Math/AP_Math.h>
+
+class AP_InertialSensor_RawStream {
+public:
+    AP_InertialSensor_RawStream(void);
+
+    /* Do not allow copies */
+    CLASS_NO_COPY(AP_InertialSensor_RawStream);
+
+    static const struct AP_Param::GroupInfo var_info[];
+
+    void init();
+
+    // called from the backends for every raw sample
+    void sample(uint8_t instance, uint8_t type, uint64_t sample_us, const Vector3f &v) __RAMFUNC__;
+
+    // total number of samples dropped because both buffers were full
+    uint32_t get_dropped_count() const { return dropped_count; }
+
+    bool enabled() const { return buffers[0] != nullptr; }
+
+    static constexpr uint32_t MAGIC = 0x53524d49;
+    static constexpr uint16_t VERSION = 1;
+
+    enum class RecordType : uint8_t {
+        ACCEL = 0,
+        GYRO = 1,
+        DROPPED = 2,
+    };
+
+    struct PACKED FileHeader {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t record_size;
+        uint64_t start_us;
+    };
+
+    struct PACKED Record {
+        uint32_t time_us;
+        uint8_t instance;
+        uint8_t type;
+        uint16_t reserved;
+        float x, y, z;
+    };
+
+private:
+    enum class Option : uint8_t {
+        CAPTURE_ACCEL = (1U<<0),
+    };
+    bool option_set(Option opt) const { return (uint8_t(options.get()) & uint8_t(opt)) != 0; }
+
+    AP_Int16 imu_mask;
+    AP_Int8 options;
+    AP_Int16 buffer_kb;
+
+    void io_thread();
+    bool open_file();
+    bool write_records(const Record *r, uint32_t count);
+    void open_file_with_backoff();
+    void write_failed();
+
+    // double buffers, filled by the backends and emptied by io_thread
+    Record *buffers[2];
+    uint32_t buffer_count[2];
+    bool buffer_full[2];
+    uint8_t fill_idx;
+    uint32_t capacity;
+
+    uint32_t dropped_count;
+    uint32_t dropped_reported;
+
+    HAL_Semaphore sem;
+    HAL_BinarySemaphore notify;
+
+    int fd = -1;
+
+    // true while a file is open and samples are being captured. The
+    // backends skip capture while this is false
+    bool capturing;
+};
+
+#endif // AP_INERTIALSENSOR_RAWSTREAM_ENABLED
@@ -74,6 +74,10 @@
 #define AP_INERTIALSENSOR_BATCHSAMPLER_ENABLED (AP_INERTIALSENSOR_ENABLED && HAL_LOGGING_ENABLED)
 #endif
 
+#ifndef AP_INERTIALSENSOR_RAWSTREAM_ENABLED
+#define AP_INERTIALSENSOR_RAWSTREAM_ENABLED (AP_INERTIALSENSOR_ENABLED && HAL_LOGGING_ENABLED && (CONFIG_HAL_BOARD == HAL_BOARD_SITL || CONFIG_HAL_BOARD == HAL_BOARD_LINUX))
+#endif
+
 #ifndef AP_INERTIALSENSOR_KILL_IMU_ENABLED
 #define AP_INERTIALSENSOR_KILL_IMU_ENABLED 1
 #endif
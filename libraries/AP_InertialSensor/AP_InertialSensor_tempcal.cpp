@@ -231,6 +231,38 @@ void AP_InertialSensor_TCal::correct_sensor(float temperature, float cal_temp, c
     v += polynomial_eval(cal_temp - TEMP_REFERENCE, coeff);
 }
 
+/*
+  correct a burst of samples, held as one array per axis, for the
+  current temperature. The polynomials are only evaluated once as the
+  whole burst shares the same temperature. The subtract and add are
+  kept as two steps so the result is identical to calling
+  correct_sensor() on each sample
+ */
+void AP_InertialSensor_TCal::correct_sensor_samples(float temperature, float cal_temp, const AP_Vector3f coeff[3], float *x, float *y, float *z, uint8_t n_samples) const
+{
+    if (enable != Enable::Enabled) {
+        return;
+    }
+    temperature = constrain_float(temperature, temp_min, temp_max);
+    cal_temp = constrain_float(cal_temp, temp_min, temp_max);
+
+    const Vector3f temp_correction = polynomial_eval(temperature - TEMP_REFERENCE, coeff);
+    const Vector3f cal_correction = polynomial_eval(cal_temp - TEMP_REFERENCE, coeff);
+
+    for (uint8_t i = 0; i < n_samples; i++) {
+        x[i] -= temp_correction.x;
+        x[i] += cal_correction.x;
+    }
+    for (uint8_t i = 0; i < n_samples; i++) {
+        y[i] -= temp_correction.y;
+        y[i] += cal_correction.y;
+    }
+    for (uint8_t i = 0; i < n_samples; i++) {
+        z[i] -= temp_correction.z;
+        z[i] += cal_correction.z;
+    }
+}
+
 void AP_InertialSensor_TCal::correct_accel(float temperature, float cal_temp, Vector3f &accel) const
 {
     correct_sensor(temperature, cal_temp, accel_coeff, accel);
@@ -241,6 +273,16 @@ void AP_InertialSensor_TCal::correct_gyro(float temperature, float cal_temp, Vec
     correct_sensor(temperature, cal_temp, gyro_coeff, gyro);
 }
 
+void AP_InertialSensor_TCal::correct_accel_samples(float temperature, float cal_temp, float *x, float *y, float *z, uint8_t n_samples) const
+{
+    correct_sensor_samples(temperature, cal_temp, accel_coeff, x, y, z, n_samples);
+}
+
+void AP_InertialSensor_TCal::correct_gyro_samples(float temperature, float cal_temp, float *x, float *y, float *z, uint8_t n_samples) const
+{
+    correct_sensor_samples(temperature, cal_temp, gyro_coeff, x, y, z, n_samples);
+}
+
 /*
   for SITL we don't apply the temperature limits and use mid-point as
   reference. This makes the SITL data independent of TEMP_REFERENCE
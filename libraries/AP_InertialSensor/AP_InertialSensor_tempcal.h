@@ -11,6 +11,9 @@ public:
     static const struct AP_Param::GroupInfo var_info[];
     void correct_accel(float temperature, float cal_temp, Vector3f &accel) const;
     void correct_gyro(float temperature, float cal_temp, Vector3f &accel) const;
+    // correct a burst of samples all taken at the same temperature
+    void correct_accel_samples(float temperature, float cal_temp, float *x, float *y, float *z, uint8_t n_samples) const;
+    void correct_gyro_samples(float temperature, float cal_temp, float *x, float *y, float *z, uint8_t n_samples) const;
     void sitl_apply_accel(float temperature, Vector3f &accel) const;
     void sitl_apply_gyro(float temperature, Vector3f &accel) const;
 
@@ -74,6 +77,7 @@ private:
     Learn *learn;
 
     void correct_sensor(float temperature, float cal_temp, const AP_Vector3f coeff[3], Vector3f &v) const;
+    void correct_sensor_samples(float temperature, float cal_temp, const AP_Vector3f coeff[3], float *x, float *y, float *z, uint8_t n_samples) const;
     Vector3f polynomial_eval(float temperature, const AP_Vector3f coeff[3]) const;
 
     // get instance number
@@ -91,16 +91,23 @@ bool AP_InertialSensor::is_dynamic_fifo_enabled(uint8_t instance) const
 
 // get the next available gyro sample from the fast rate buffer
 bool AP_InertialSensor::get_next_gyro_sample(Vector3f& gyro)
+{
+    uint32_t sample_us;
+    return get_next_gyro_sample(gyro, sample_us);
+}
+
+// get the next available gyro sample and its read time from the fast rate buffer
+bool AP_InertialSensor::get_next_gyro_sample(Vector3f& gyro, uint32_t& sample_us)
 {
     if (!fast_rate_buffer_enabled || fast_rate_buffer == nullptr) {
         return false;
     }
 
-    return fast_rate_buffer->get_next_gyro_sample(gyro);
+    return fast_rate_buffer->get_next_gyro_sample(gyro, sample_us);
 }
 
 
-bool FastRateBuffer::get_next_gyro_sample(Vector3f& gyro)
+bool FastRateBuffer::get_next_gyro_sample(Vector3f& gyro, uint32_t& sample_us)
 {
     if (!use_rate_loop_gyro_samples()) {
         return false;
@@ -110,17 +117,23 @@ bool FastRateBuffer::get_next_gyro_sample(Vector3f& gyro)
         _notifier.wait_blocking();
     }
 
-    WITH_SEMAPHORE(_mutex);
-
-    return _rate_loop_gyro_window.pop(gyro);
+    // lock-free, we are the only reader
+    GyroSample sample;
+    if (!_rate_loop_gyro_window.pop(sample)) {
+        return false;
+    }
+    gyro = sample.gyro;
+    sample_us = sample.sample_us;
+    return true;
 }
 
 void FastRateBuffer::reset()
 {
+    WITH_SEMAPHORE(_mutex);
     _rate_loop_gyro_window.clear();
 }
 
-bool AP_InertialSensor::push_next_gyro_sample(const Vector3f& gyro)
+bool AP_InertialSensor::push_next_gyro_sample(const Vector3f& gyro, uint32_t sample_us)
 {
     if (!fast_rate_buffer_enabled || fast_rate_buffer == nullptr) {
         return false;
@@ -134,7 +147,7 @@ bool AP_InertialSensor::push_next_gyro_sample(const Vector3f& gyro)
     */
     WITH_SEMAPHORE(fast_rate_buffer->_mutex);
 
-    if (!fast_rate_buffer->_rate_loop_gyro_window.push(gyro)) {
+    if (!fast_rate_buffer->_rate_loop_gyro_window.push(FastRateBuffer::GyroSample{gyro, sample_us})) {
         debug("dropped rate loop sample");
     }
     fast_rate_buffer->rate_decimation_count = 0;
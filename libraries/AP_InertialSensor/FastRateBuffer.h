@@ -29,7 +29,7 @@ class FastRateBuffer
 {
     friend class AP_InertialSensor;
 public:
-    bool get_next_gyro_sample(Vector3f& gyro);
+    bool get_next_gyro_sample(Vector3f& gyro, uint32_t& sample_us);
     uint32_t get_num_gyro_samples() { return _rate_loop_gyro_window.available(); }
     void set_rate_decimation(uint8_t rdec) { rate_decimation = rdec; }
     // whether or not to push the current gyro sample
@@ -38,13 +38,26 @@ public:
     void reset();
 
 private:
+    // filtered gyro sample along with the time the backend read it
+    struct GyroSample {
+        Vector3f gyro;
+        uint32_t sample_us;
+    };
+
     /*
-      binary semaphore for rate loop to use to start a rate loop when
-      we hav finished filtering the primary IMU
+      the window is single-reader: only the rate thread pops, and does
+      so without taking _mutex. The ring buffer indexes are atomic so
+      this is safe against a concurrent push. _mutex serialises
+      producers (two backends may briefly push across a primary
+      change) and reset()
      */
-    ObjectBuffer<Vector3f> _rate_loop_gyro_window{AP_INERTIAL_SENSOR_RATE_LOOP_BUFFER_SIZE};
+    ObjectBuffer<GyroSample> _rate_loop_gyro_window{AP_INERTIAL_SENSOR_RATE_LOOP_BUFFER_SIZE};
     uint8_t rate_decimation; // 0 means off
     uint8_t rate_decimation_count;
+    /*
+      binary semaphore for rate loop to use to start a rate loop when
+      we hav finished filtering the primary IMU
+     */
     HAL_BinarySemaphore _notifier;
     HAL_Semaphore _mutex;
 };
@@ -0,0 +1,122 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/*
+  cost of passing FIFO bursts from an accel and gyro FIFO to the
+  frontend, sample by sample and through the batch interface. The
+  argument is the sensor orientation, as swap and negate rotations
+  take a different path in the batch interface to other rotations
+ */
+#include <AP_gbenchmark.h>
+
+#include <AP_InertialSensor/AP_InertialSensor.h>
+#include <AP_InertialSensor/AP_InertialSensor_Backend.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+static AP_InertialSensor ins;
+
+// number of bursts in the FIFO dump, at 8 samples per burst
+#define FIFO_DUMP_BURSTS 64
+
+/*
+  a backend fed from a FIFO dump of a vibrating, slowly rotating
+  sensor sampled at 8kHz
+ */
+class AP_InertialSensor_FIFODump : public AP_InertialSensor_Backend
+{
+public:
+    AP_InertialSensor_FIFODump(AP_InertialSensor &imu, enum Rotation rotation) :
+        AP_InertialSensor_Backend(imu)
+    {
+        accel_instance = 0;
+        gyro_instance = 0;
+        _set_accel_raw_sample_rate(accel_instance, 8000);
+        _set_gyro_raw_sample_rate(gyro_instance, 8000);
+        set_accel_orientation(accel_instance, rotation);
+        set_gyro_orientation(gyro_instance, rotation);
+
+        for (uint16_t i = 0; i < ARRAY_SIZE(accel_dump); i++) {
+            const float t = i / 8000.0f;
+            const float vibe = sinf(t * 2 * M_PI * 180);
+            accel_dump[i] = Vector3f(0.3f * vibe, -0.2f * vibe, -GRAVITY_MSS + vibe);
+            gyro_dump[i] = Vector3f(0.02f * vibe, 0.01f * cosf(t * 2 * M_PI * 180), 0.1f);
+        }
+    }
+
+    bool update() override { return true; }
+
+    // pass the dump to the frontend one sample at a time
+    void notify_per_sample(void) {
+        for (uint16_t i = 0; i < ARRAY_SIZE(accel_dump); i++) {
+            Vector3f accel = accel_dump[i];
+            Vector3f gyro = gyro_dump[i];
+            _rotate_and_correct_accel(accel_instance, accel);
+            _rotate_and_correct_gyro(gyro_instance, gyro);
+            _notify_new_accel_raw_sample(accel_instance, accel);
+            _notify_new_gyro_raw_sample(gyro_instance, gyro);
+        }
+    }
+
+    // pass the dump to the frontend a burst at a time
+    void notify_batch(void) {
+        for (uint16_t i = 0; i < ARRAY_SIZE(accel_dump); i++) {
+            accel_fifo.add(accel_dump[i]);
+            gyro_fifo.add(gyro_dump[i]);
+            if (accel_fifo.full()) {
+                _rotate_and_correct_accel_samples(accel_instance, accel_fifo);
+                _rotate_and_correct_gyro_samples(gyro_instance, gyro_fifo);
+                _notify_new_raw_samples(accel_instance, accel_fifo, gyro_instance, gyro_fifo);
+                accel_fifo.n = 0;
+                gyro_fifo.n = 0;
+            }
+        }
+    }
+
+private:
+    Vector3f accel_dump[FIFO_DUMP_BURSTS * INS_MAX_FIFO_BURST_SAMPLES];
+    Vector3f gyro_dump[FIFO_DUMP_BURSTS * INS_MAX_FIFO_BURST_SAMPLES];
+    FIFOSamples accel_fifo;
+    FIFOSamples gyro_fifo;
+};
+
+static void BM_FIFOPerSample(benchmark::State& state)
+{
+    auto *backend = NEW_NOTHROW AP_InertialSensor_FIFODump(ins, Rotation(state.range_x()));
+
+    while (state.KeepRunning()) {
+        backend->notify_per_sample();
+        gbenchmark_escape(backend);
+    }
+    state.SetItemsProcessed(state.iterations() * FIFO_DUMP_BURSTS * INS_MAX_FIFO_BURST_SAMPLES);
+    delete backend;
+}
+
+BENCHMARK(BM_FIFOPerSample)->Arg(ROTATION_NONE)->Arg(ROTATION_YAW_270)->Arg(ROTATION_ROLL_180_YAW_45);
+
+static void BM_FIFOBatch(benchmark::State& state)
+{
+    auto *backend = NEW_NOTHROW AP_InertialSensor_FIFODump(ins, Rotation(state.range_x()));
+
+    while (state.KeepRunning()) {
+        backend->notify_batch();
+        gbenchmark_escape(backend);
+    }
+    state.SetItemsProcessed(state.iterations() * FIFO_DUMP_BURSTS * INS_MAX_FIFO_BURST_SAMPLES);
+    delete backend;
+}
+
+BENCHMARK(BM_FIFOBatch)->Arg(ROTATION_NONE)->Arg(ROTATION_YAW_270)->Arg(ROTATION_ROLL_180_YAW_45);
+
+BENCHMARK_MAIN();
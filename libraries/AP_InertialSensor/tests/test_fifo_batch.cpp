@@ -0,0 +1,143 @@
+/*
+  check that FIFO bursts passed to the frontend through the batch
+  interface give exactly the same filtered samples and delta
+  angle/velocity accumulators as passing each sample in turn
+ */
+#include <AP_gtest.h>
+
+#include <AP_InertialSensor/AP_InertialSensor.h>
+#include <AP_InertialSensor/AP_InertialSensor_Backend.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+static AP_InertialSensor ins;
+
+// number of bursts fed to each backend
+#define FIFO_TEST_BURSTS 64
+
+/*
+  a backend fed with a vibrating, slowly rotating sensor sampled at
+  8kHz, either one sample at a time or a burst at a time
+ */
+class AP_InertialSensor_FIFOTest : public AP_InertialSensor_Backend
+{
+public:
+    AP_InertialSensor_FIFOTest(AP_InertialSensor &imu, uint8_t instance, enum Rotation rotation) :
+        AP_InertialSensor_Backend(imu)
+    {
+        accel_instance = instance;
+        gyro_instance = instance;
+        _set_accel_raw_sample_rate(accel_instance, 8000);
+        _set_gyro_raw_sample_rate(gyro_instance, 8000);
+        set_accel_orientation(accel_instance, rotation);
+        set_gyro_orientation(gyro_instance, rotation);
+        // set up the frontend filters for the sample rate
+        update_accel(accel_instance);
+        update_gyro(gyro_instance);
+    }
+
+    bool update() override { return true; }
+
+    static Vector3f accel_sample(uint16_t i) {
+        const float t = i / 8000.0f;
+        const float vibe = sinf(t * 2 * M_PI * 180);
+        return Vector3f(0.3f * vibe, -0.2f * vibe, -GRAVITY_MSS + vibe);
+    }
+
+    static Vector3f gyro_sample(uint16_t i) {
+        const float t = i / 8000.0f;
+        const float vibe = sinf(t * 2 * M_PI * 180);
+        return Vector3f(0.02f * vibe, 0.01f * cosf(t * 2 * M_PI * 180), 0.1f);
+    }
+
+    // pass burst b to the frontend one sample at a time
+    void notify_per_sample(uint16_t b, uint8_t n) {
+        for (uint8_t i = 0; i < n; i++) {
+            Vector3f accel = accel_sample(b * INS_MAX_FIFO_BURST_SAMPLES + i);
+            Vector3f gyro = gyro_sample(b * INS_MAX_FIFO_BURST_SAMPLES + i);
+            _rotate_and_correct_accel(accel_instance, accel);
+            _rotate_and_correct_gyro(gyro_instance, gyro);
+            _notify_new_accel_raw_sample(accel_instance, accel);
+            _notify_new_gyro_raw_sample(gyro_instance, gyro);
+        }
+    }
+
+    // pass burst b to the frontend in one go, from a combined FIFO or
+    // from separate accel and gyro FIFOs
+    void notify_batch(uint16_t b, uint8_t n, bool combined) {
+        FIFOSamples accel_fifo {};
+        FIFOSamples gyro_fifo {};
+        for (uint8_t i = 0; i < n; i++) {
+            accel_fifo.add(accel_sample(b * INS_MAX_FIFO_BURST_SAMPLES + i));
+            gyro_fifo.add(gyro_sample(b * INS_MAX_FIFO_BURST_SAMPLES + i));
+        }
+        _rotate_and_correct_accel_samples(accel_instance, accel_fifo);
+        _rotate_and_correct_gyro_samples(gyro_instance, gyro_fifo);
+        if (combined) {
+            _notify_new_raw_samples(accel_instance, accel_fifo, gyro_instance, gyro_fifo);
+        } else {
+            _notify_new_accel_raw_samples(accel_instance, accel_fifo);
+            _notify_new_gyro_raw_samples(gyro_instance, gyro_fifo);
+        }
+    }
+
+    // publish the filtered samples and accumulators to the frontend
+    void publish(void) {
+        update_accel(accel_instance);
+        update_gyro(gyro_instance);
+    }
+};
+
+static void expect_vector_eq(const Vector3f &a, const Vector3f &b)
+{
+    EXPECT_EQ(a.x, b.x);
+    EXPECT_EQ(a.y, b.y);
+    EXPECT_EQ(a.z, b.z);
+}
+
+static void check_batch_matches_per_sample(enum Rotation rotation, bool combined)
+{
+    AP_InertialSensor_FIFOTest per_sample(ins, 0, rotation);
+    AP_InertialSensor_FIFOTest batch(ins, 1, rotation);
+
+    for (uint16_t b = 0; b < FIFO_TEST_BURSTS; b++) {
+        // include short bursts as well as full ones
+        const uint8_t n = (b % 4 == 3) ? 3 : INS_MAX_FIFO_BURST_SAMPLES;
+        per_sample.notify_per_sample(b, n);
+        batch.notify_batch(b, n, combined);
+        per_sample.publish();
+        batch.publish();
+
+        expect_vector_eq(ins.get_accel(0), ins.get_accel(1));
+        expect_vector_eq(ins.get_gyro(0), ins.get_gyro(1));
+
+        Vector3f dvel0, dvel1, dang0, dang1;
+        float dvel_dt0, dvel_dt1, dang_dt0, dang_dt1;
+        EXPECT_TRUE(ins.get_delta_velocity(0, dvel0, dvel_dt0));
+        EXPECT_TRUE(ins.get_delta_velocity(1, dvel1, dvel_dt1));
+        EXPECT_TRUE(ins.get_delta_angle(0, dang0, dang_dt0));
+        EXPECT_TRUE(ins.get_delta_angle(1, dang1, dang_dt1));
+        expect_vector_eq(dvel0, dvel1);
+        expect_vector_eq(dang0, dang1);
+        EXPECT_EQ(dvel_dt0, dvel_dt1);
+        EXPECT_EQ(dang_dt0, dang_dt1);
+    }
+}
+
+// swap and negate rotations take a different path in the batch
+// interface to other rotations
+TEST(InertialSensorFIFO, BatchMatchesPerSample)
+{
+    check_batch_matches_per_sample(ROTATION_NONE, true);
+    check_batch_matches_per_sample(ROTATION_YAW_270, true);
+    check_batch_matches_per_sample(ROTATION_ROLL_180_YAW_45, true);
+}
+
+TEST(InertialSensorFIFO, SeparateBatchesMatchPerSample)
+{
+    check_batch_matches_per_sample(ROTATION_NONE, false);
+    check_batch_matches_per_sample(ROTATION_YAW_270, false);
+    check_batch_matches_per_sample(ROTATION_ROLL_180_YAW_45, false);
+}
+
+AP_GTEST_MAIN()
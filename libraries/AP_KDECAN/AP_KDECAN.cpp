@@ -79,6 +79,11 @@ void AP_KDECAN::update()
 
 AP_KDECAN_Driver::AP_KDECAN_Driver() : CANSensor("KDECAN")
 {
+    // we only want extended frames sent to us
+    const frame_id_t id { { .object_address = 0, .destination_id = AUTOPILOT_NODE_ID, .source_id = 0, .priority = 0, .unused = 0 } };
+    const frame_id_t mask { { .object_address = 0, .destination_id = 0xFF, .source_id = 0, .priority = 0, .unused = 0 } };
+    add_rx_filter(AP_HAL::CANFrame::FlagEFF | id.value, AP_HAL::CANFrame::FlagEFF | mask.value);
+
     register_driver(AP_CAN::Protocol::KDECAN);
 
     // start thread for receiving and sending CAN frames. Tests show we use about 640 bytes of stack
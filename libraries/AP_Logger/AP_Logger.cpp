@@ -831,6 +831,12 @@ int16_t AP_Logger::get_log_data(uint16_t log_num, uint16_t page, uint32_t offset
     }
     return backends[0]->get_log_data(log_num, page, offset, len, data);
 }
+bool AP_Logger::log_data_ready(uint16_t log_num, uint16_t page, uint32_t offset, uint16_t len) {
+    if (_next_backend == 0) {
+        return true;
+    }
+    return backends[0]->log_data_ready(log_num, page, offset, len);
+}
 uint16_t AP_Logger::get_num_logs(void) {
     if (_next_backend == 0) {
         return 0;
@@ -1447,6 +1453,8 @@ void AP_Logger::io_thread(void)
 
         FOR_EACH_BACKEND(io_timer());
 
+        FOR_EACH_BACKEND(prepare_startup_messages());
+
         if (now - last_stack_us > 100000U) {
             last_stack_us = now;
             hal.util->log_stack_info();
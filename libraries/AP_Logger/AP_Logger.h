@@ -605,6 +605,7 @@ private:
     void get_log_info(uint16_t log_num, uint32_t &size, uint32_t &time_utc);
 
     int16_t get_log_data(uint16_t log_num, uint16_t page, uint32_t offset, uint16_t len, uint8_t *data);
+    bool log_data_ready(uint16_t log_num, uint16_t page, uint32_t offset, uint16_t len);
 
     /* end support for retrieving logs via mavlink: */
 
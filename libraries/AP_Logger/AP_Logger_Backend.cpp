@@ -141,6 +141,28 @@ void AP_Logger_Backend::WriteMoreStartupMessages()
     _writing_startup_messages = false;
 }
 
+// serialize startup messages from the IO thread, so the main thread
+// only has to copy them into the log
+void AP_Logger_Backend::prepare_startup_messages(void)
+{
+#if !APM_BUILD_TYPE(APM_BUILD_Replay)
+    if (logging_started()) {
+        _startup_messagewriter->stage_params();
+    }
+#endif
+}
+
+bool AP_Logger_Backend::WriteStartupBlock(const void *pBuffer, uint16_t size)
+{
+    if (!ShouldLog(true)) {
+        return false;
+    }
+    if (!WritesOK()) {
+        return false;
+    }
+    return _WritePrioritisedBlock(pBuffer, size, true);
+}
+
 /*
  * support for Write():
  */
@@ -76,6 +76,9 @@ public:
     virtual void get_log_boundaries(uint16_t list_entry, uint32_t & start_page, uint32_t & end_page) = 0;
     virtual void get_log_info(uint16_t list_entry, uint32_t &size, uint32_t &time_utc) = 0;
     virtual int16_t get_log_data(uint16_t list_entry, uint16_t page, uint32_t offset, uint16_t len, uint8_t *data) = 0;
+    // return false if get_log_data() for this range would have to wait
+    // on the storage, so the caller can try again later
+    virtual bool log_data_ready(uint16_t list_entry, uint16_t page, uint32_t offset, uint16_t len) { return true; }
     virtual void end_log_transfer() = 0;
     virtual uint16_t get_num_logs() = 0;
     virtual uint16_t find_oldest_log();
@@ -137,6 +140,16 @@ public:
     bool have_emitted_format_for_type(LogMessages a_type) const {
         return _formats_written.get(uint8_t(a_type));
     }
+    // record a FMT message written as part of a startup block
+    void set_format_emitted(uint8_t msg_type) {
+        _formats_written.set(msg_type);
+    }
+    // write a block of whole startup messages whose formats are
+    // already in the log
+    bool WriteStartupBlock(const void *pBuffer, uint16_t size);
+    // serialize startup messages ahead of the main thread, called
+    // from the logging IO thread
+    void prepare_startup_messages(void);
     bool Write_Message(const char *message);
     bool Write_MessageF(const char *fmt, ...);
     bool Write_Mission_Cmd(const AP_Mission &mission,
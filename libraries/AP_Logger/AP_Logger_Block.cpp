@@ -286,6 +286,13 @@ void AP_Logger_Block::EraseAll()
     // throw away everything
     log_write_started = false;
     writebuf.clear();
+#if HAL_LOGGER_BLOCK_READAHEAD_SIZE > 0
+    {
+        // log numbers are about to be reused
+        WITH_SEMAPHORE(readahead.sem);
+        readahead_restart(0, 0, 0);
+    }
+#endif
 
     // reset the format version and wrapped status so that any incomplete erase will be caught
     Sector4kErase(get_sector(df_NumPages));
@@ -323,6 +330,10 @@ void AP_Logger_Block::periodic_1Hz()
             warning_decimation_counter = 0;
         }
     }
+
+#if HAL_LOGGER_BLOCK_READAHEAD_SIZE > 0
+    readahead_expire();
+#endif
 }
 
 // EraseAll is asynchronous, but we must not start a new
@@ -417,16 +428,14 @@ void AP_Logger_Block::validate_log_structure()
     }
 }
 
-/**
- * get raw data from a log - page is the start page of the log, offset is the offset within the log starting at that page
- */
-int16_t AP_Logger_Block::get_log_data_raw(uint16_t log_num, uint32_t page, uint32_t offset, uint16_t len, uint8_t *data)
+// offset is the true offset in the file, so we have to calculate the
+// page and offset accounting for page headers
+uint32_t AP_Logger_Block::page_for_offset(uint32_t start_page, uint32_t &offset) const
 {
-    WITH_SEMAPHORE(sem);
     const uint16_t data_page_size = df_PageSize - sizeof(struct PageHeader);
     const uint16_t first_page_size = data_page_size - sizeof(struct FileHeader);
 
-    // offset is the true offset in the file, so we have to calculate the offset accounting for page headers
+    uint32_t page = start_page;
     if (offset >= first_page_size) {
         offset -= first_page_size;
         page = page + offset / data_page_size + 1;
@@ -436,6 +445,16 @@ int16_t AP_Logger_Block::get_log_data_raw(uint16_t log_num, uint32_t page, uint3
             page = page % df_NumPages;
         }
     }
+    return page;
+}
+
+/**
+ * get raw data from a log - page is the start page of the log, offset is the offset within the log starting at that page
+ */
+int16_t AP_Logger_Block::get_log_data_raw(uint16_t log_num, uint32_t page, uint32_t offset, uint16_t len, uint8_t *data)
+{
+    WITH_SEMAPHORE(sem);
+    page = page_for_offset(page, offset);
 
     // Sanity check we haven't been asked for an offset beyond the end of the log
     if (StartRead(page) != log_num) {
@@ -464,6 +483,15 @@ int16_t AP_Logger_Block::get_log_data(uint16_t list_entry, uint16_t page, uint32
     }
 
     //printf("get_log_data(%d, %d, %d, %d)\n", log_num, page, offset, len);
+#if HAL_LOGGER_BLOCK_READAHEAD_SIZE > 0
+    {
+        WITH_SEMAPHORE(readahead.sem);
+        if (readahead_read(log_num, page, offset, len, data)) {
+            return len;
+        }
+    }
+#endif
+
     WITH_SEMAPHORE(sem);
 
     uint16_t ret = 0;
@@ -478,6 +506,126 @@ int16_t AP_Logger_Block::get_log_data(uint16_t list_entry, uint16_t page, uint32
     return ret;
 }
 
+#if HAL_LOGGER_BLOCK_READAHEAD_SIZE > 0
+/*
+  return true if the read-ahead buffer holds the data for a request,
+  otherwise move the read-ahead to it and return false so the caller
+  waits for the IO thread rather than reading the chip itself
+ */
+bool AP_Logger_Block::log_data_ready(uint16_t list_entry, uint16_t page, uint32_t offset, uint16_t len)
+{
+    const uint16_t log_num = log_num_from_list_entry(list_entry);
+    if (log_num == 0 || len == 0 || !io_thread_alive()) {
+        // get_log_data() will deal with it
+        return true;
+    }
+
+    WITH_SEMAPHORE(readahead.sem);
+
+    if (readahead.buf == nullptr) {
+        readahead.buf = NEW_NOTHROW ByteBuffer(HAL_LOGGER_BLOCK_READAHEAD_SIZE);
+        if (readahead.buf == nullptr || readahead.buf->get_size() == 0) {
+            // no memory, read directly from the chip
+            delete readahead.buf;
+            readahead.buf = nullptr;
+            return true;
+        }
+        readahead.log_num = 0;
+    }
+    readahead.last_ms = AP_HAL::millis();
+
+    if (log_num == readahead.log_num && page == readahead.start_page &&
+        offset >= readahead.offset && offset <= readahead.fill_offset) {
+        // at the end of the log get_log_data() reads the short tail
+        return offset + len <= readahead.fill_offset || readahead.eof;
+    }
+
+    readahead_restart(log_num, page, offset);
+    return false;
+}
+
+void AP_Logger_Block::readahead_restart(uint16_t log_num, uint32_t start_page, uint32_t offset)
+{
+    if (readahead.buf != nullptr) {
+        readahead.buf->clear();
+    }
+    readahead.log_num = log_num;
+    readahead.start_page = start_page;
+    readahead.offset = offset;
+    readahead.fill_offset = offset;
+    readahead.eof = log_num == 0;
+    readahead.generation++;
+}
+
+bool AP_Logger_Block::readahead_read(uint16_t log_num, uint32_t start_page, uint32_t offset, uint16_t len, uint8_t *data)
+{
+    if (readahead.buf == nullptr ||
+        log_num != readahead.log_num ||
+        start_page != readahead.start_page ||
+        offset < readahead.offset ||
+        offset + len > readahead.fill_offset) {
+        return false;
+    }
+    // discard anything the GCS skipped over
+    readahead.buf->advance(offset - readahead.offset);
+    readahead.buf->read(data, len);
+    readahead.offset = offset + len;
+    return true;
+}
+
+// read up to readahead_pages_per_tick pages into the read-ahead buffer
+void AP_Logger_Block::readahead_fill(void)
+{
+    const uint16_t data_page_size = df_PageSize - sizeof(struct PageHeader);
+
+    for (uint8_t i=0; i<readahead_pages_per_tick; i++) {
+        uint16_t log_num;
+        uint32_t start_page;
+        uint32_t offset;
+        uint8_t generation;
+        {
+            WITH_SEMAPHORE(readahead.sem);
+            if (readahead.buf == nullptr || readahead.eof ||
+                readahead.buf->space() < data_page_size) {
+                return;
+            }
+            log_num = readahead.log_num;
+            start_page = readahead.start_page;
+            offset = readahead.fill_offset;
+            generation = readahead.generation;
+        }
+
+        // the main thread only waits on readahead.sem for a copy, not for the chip
+        WITH_SEMAPHORE(sem);
+        const uint32_t page = page_for_offset(start_page, offset);
+        const bool eof = erase_started || StartRead(page) != log_num;
+
+        WITH_SEMAPHORE(readahead.sem);
+        if (generation != readahead.generation) {
+            // restarted while we were reading
+            continue;
+        }
+        if (eof) {
+            readahead.eof = true;
+            return;
+        }
+        const uint16_t idx = df_Read_BufferIdx + offset;
+        readahead.fill_offset += readahead.buf->write(&buffer[idx], df_PageSize - idx);
+    }
+}
+
+void AP_Logger_Block::readahead_expire(void)
+{
+    WITH_SEMAPHORE(readahead.sem);
+    if (readahead.buf != nullptr &&
+        AP_HAL::millis() - readahead.last_ms > readahead_timeout_ms) {
+        delete readahead.buf;
+        readahead.buf = nullptr;
+        readahead_restart(0, 0, 0);
+    }
+}
+#endif  // HAL_LOGGER_BLOCK_READAHEAD_SIZE > 0
+
 
 // This function determines the number of whole log files in the AP_Logger
 // partial logs are rejected as without the headers they are relatively useless
@@ -879,6 +1027,13 @@ void AP_Logger_Block::io_timer(void)
         df_EraseFrom = 0;
     }
 
+#if HAL_LOGGER_BLOCK_READAHEAD_SIZE > 0
+    // log download is only allowed while disarmed
+    if (CardInserted() && !hal.util->get_soft_armed()) {
+        readahead_fill();
+    }
+#endif
+
     if (!CardInserted() || new_log_pending || chip_full) {
         return;
     }
@@ -24,6 +24,9 @@ public:
     void get_log_boundaries(uint16_t list_entry, uint32_t & start_page, uint32_t & end_page) override;
     void get_log_info(uint16_t list_entry, uint32_t &size, uint32_t &time_utc) override;
     int16_t get_log_data(uint16_t list_entry, uint16_t page, uint32_t offset, uint16_t len, uint8_t *data) override WARN_IF_UNUSED;
+#if HAL_LOGGER_BLOCK_READAHEAD_SIZE > 0
+    bool log_data_ready(uint16_t list_entry, uint16_t page, uint32_t offset, uint16_t len) override;
+#endif
     void end_log_transfer() override { }
     uint16_t get_num_logs() override;
     void start_new_log(void) override;
@@ -140,6 +143,9 @@ private:
 
     // internal high level functions
     int16_t get_log_data_raw(uint16_t log_num, uint32_t page, uint32_t offset, uint16_t len, uint8_t *data) WARN_IF_UNUSED;
+    // return the page holding offset in a log starting at start_page,
+    // leaving offset as the offset into the data of that page
+    uint32_t page_for_offset(uint32_t start_page, uint32_t &offset) const;
     // read from the page address and return the file number at that location
     uint16_t StartRead(uint32_t PageAdr);
     // read the headers at the current read point returning the file number
@@ -159,6 +165,40 @@ private:
 
     void _print_log_formats(AP_HAL::BetterStream *port);
 
+#if HAL_LOGGER_BLOCK_READAHEAD_SIZE > 0
+    /*
+      log data read from the chip by the IO thread ahead of a MAVLink
+      log download. buf holds the log from offset onwards and
+      fill_offset is the offset of the next byte to read from the
+      chip. The buffer is kept after a transfer ends so a GCS can
+      resume, and is freed once downloads stop
+     */
+    struct {
+        HAL_Semaphore sem;
+        ByteBuffer *buf;
+        uint16_t log_num;
+        uint32_t start_page;
+        uint32_t offset;
+        uint32_t fill_offset;
+        uint32_t last_ms;
+        // changed on every restart, so the IO thread can discard a
+        // page read while the read-ahead moved
+        uint8_t generation;
+        bool eof;
+    } readahead;
+    static const uint32_t readahead_timeout_ms = 5000;
+    static const uint8_t readahead_pages_per_tick = 4;
+
+    // start reading ahead from an offset in a log. Called with readahead.sem held
+    void readahead_restart(uint16_t log_num, uint32_t start_page, uint32_t offset);
+    // copy data from the read-ahead buffer if it holds all of it. Called with readahead.sem held
+    bool readahead_read(uint16_t log_num, uint32_t start_page, uint32_t offset, uint16_t len, uint8_t *data);
+    // read pages into the read-ahead buffer on the IO thread
+    void readahead_fill(void);
+    // free the read-ahead buffer if downloads have stopped
+    void readahead_expire(void);
+#endif
+
     // callback on IO thread
     bool io_thread_alive() const;
     void write_log_page();
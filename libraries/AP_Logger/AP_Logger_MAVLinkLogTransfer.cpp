@@ -108,6 +108,9 @@ void AP_Logger::handle_log_request_data(GCS_MAVLINK &link, const mavlink_message
 {
     WITH_SEMAPHORE(_log_send_sem);
 
+    mavlink_log_request_data_t packet;
+    mavlink_msg_log_request_data_decode(&msg, &packet);
+
     if (_log_sending_link != nullptr) {
         // some GCS (e.g. MAVProxy) attempt to stream request_data
         // messages when they're filling gaps in the downloaded logs.
@@ -115,13 +118,21 @@ void AP_Logger::handle_log_request_data(GCS_MAVLINK &link, const mavlink_message
         // of silently dropping any repeated attempts to start logging
         if (_log_sending_link->get_chan() != link.get_chan()) {
             link.send_text(MAV_SEVERITY_INFO, "Log download in progress");
+            return;
+        }
+        // a request from the same link for the rest of the log being
+        // sent resumes the transfer from the requested offset, so a
+        // GCS which has lost packets doesn't need to wait for the
+        // whole transfer to finish. Gap filling requests are dropped
+        // as before
+        const bool resume = transfer_activity == TransferActivity::SENDING &&
+            packet.id == _log_num_data &&
+            uint64_t(packet.ofs) + packet.count >= _log_data_size;
+        if (!resume) {
+            return;
         }
-        return;
     }
 
-    mavlink_log_request_data_t packet;
-    mavlink_msg_log_request_data_decode(&msg, &packet);
-
     // consider opening or switching logs:
     if (transfer_activity != TransferActivity::SENDING || _log_num_data != packet.id) {
 
@@ -218,7 +229,7 @@ void AP_Logger::handle_log_sending()
 
 #if CONFIG_HAL_BOARD == HAL_BOARD_SITL
     // assume USB speeds in SITL for the purposes of log download
-    const uint8_t num_sends = 40;
+    uint8_t num_sends = 250;
 #else
     uint8_t num_sends = 1;
     if (_log_sending_link->is_high_bandwidth() && hal.gpio->usb_connected()) {
@@ -233,6 +244,15 @@ void AP_Logger::handle_log_sending()
     }
 #endif
 
+    // only queue what fits in the transmit buffer now, leaving the
+    // rest of the packets for the next call rather than spinning on a
+    // full link
+    const mavlink_channel_t chan = _log_sending_link->get_chan();
+    const uint16_t fits = comm_get_txspace(chan) / PAYLOAD_SIZE(chan, LOG_DATA);
+    if (fits < num_sends) {
+        num_sends = fits;
+    }
+
     for (uint8_t i=0; i<num_sends; i++) {
         if (transfer_activity != TransferActivity::SENDING) {
             // may have completed sending data
@@ -305,6 +325,11 @@ bool AP_Logger::handle_log_send_data()
         len = MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN;
     }
 
+    if (!log_data_ready(_log_num_data, _log_data_page, _log_data_offset, len)) {
+        // the logger is still reading this from storage
+        return false;
+    }
+
     nbytes = get_log_data(_log_num_data, _log_data_page, _log_data_offset, len, packet.data);
 
     if (nbytes < 0) {
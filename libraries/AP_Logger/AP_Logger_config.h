@@ -51,6 +51,28 @@
 #define HAL_LOGGER_FILE_CONTENTS_ENABLED HAL_LOGGING_FILESYSTEM_ENABLED && !AP_FILESYSTEM_LITTLEFS_ENABLED
 #endif
 
+// build the FMT, UNIT, MULT and FMTU messages once into memory, so
+// they can be written in large blocks at the start of each log
+#ifndef HAL_LOGGER_FORMAT_BLOB_ENABLED
+#define HAL_LOGGER_FORMAT_BLOB_ENABLED HAL_LOGGING_ENABLED && HAL_MEM_CLASS >= HAL_MEM_CLASS_500
+#endif
+
+// number of PARM messages the IO thread can serialize ahead of the
+// startup message writer. Zero writes parameters from the main thread
+#ifndef HAL_LOGGER_PARAM_STAGING_COUNT
+#define HAL_LOGGER_PARAM_STAGING_COUNT 32
+#endif
+
+// bytes of log data the IO thread of a block logger reads ahead of a
+// MAVLink log download. Zero reads from the chip on the main thread
+#ifndef HAL_LOGGER_BLOCK_READAHEAD_SIZE
+#if HAL_MEM_CLASS >= HAL_MEM_CLASS_500
+#define HAL_LOGGER_BLOCK_READAHEAD_SIZE 16384
+#else
+#define HAL_LOGGER_BLOCK_READAHEAD_SIZE 4096
+#endif
+#endif
+
 // range of IDs to allow for new messages during replay. It is very
 // useful to be able to add new messages during a replay, but we need
 // to avoid colliding with existing messages
@@ -545,6 +545,8 @@ struct PACKED log_Performance {
     uint32_t i2c_isr_count;
     uint32_t extra_loop_us;
     uint64_t rtc;
+    uint32_t parallel_time_saved_us;
+    uint32_t imu_stream_dropped;
 };
 
 struct PACKED log_SRTL {
@@ -881,6 +883,8 @@ struct PACKED log_VER {
 // @Field: I2CI: Number of i2c interrupts serviced
 // @Field: Ex: number of microseconds being added to each loop to address scheduler overruns
 // @Field: R: RTC time, time since Unix epoch
+// @Field: PSav: main loop time saved by running work in parallel on other threads, such as EKF lanes
+// @Field: ISDr: number of samples dropped by the raw IMU stream capture (INS_RSTR_MASK) since boot
 
 // @LoggerMessage: POWR
 // @Description: System power information
@@ -1193,7 +1197,7 @@ LOG_STRUCTURE_FROM_MOUNT \
     LOG_STRUCTURE_FROM_BEACON                                       \
     LOG_STRUCTURE_FROM_PROXIMITY                                    \
     { LOG_PERFORMANCE_MSG, sizeof(log_Performance),                     \
-      "PM",  "QHHHIIHHIIIIIIQ", "TimeUS,LR,NLon,NL,MaxT,Mem,Load,ErrL,InE,ErC,SPIC,I2CC,I2CI,Ex,R", "sz---b%------ss", "F----0A------FF" }, \
+      "PM",  "QHHHIIHHIIIIIIQII", "TimeUS,LR,NLon,NL,MaxT,Mem,Load,ErrL,InE,ErC,SPIC,I2CC,I2CI,Ex,R,PSav,ISDr", "sz---b%------sss-", "F----0A------FFF-" }, \
     { LOG_SRTL_MSG, sizeof(log_SRTL), \
       "SRTL", "QBHHBfff", "TimeUS,Active,NumPts,MaxPts,Action,N,E,D", "s----mmm", "F----000" }, \
 LOG_STRUCTURE_FROM_AVOIDANCE \
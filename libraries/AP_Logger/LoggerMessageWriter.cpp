@@ -26,6 +26,9 @@
 // the budget as possible in order that logging can begin in earnest as early as possible
 #define MIN_LOOP_TIME_REMAINING_FOR_MESSAGE_WRITE_US 50
 
+// largest block of startup messages written at once
+#define MAX_STARTUP_BLOCK_WRITE 2048U
+
 extern const AP_HAL::HAL& hal;
 
 /* LogStartup - these are simple state machines which allow us to
@@ -68,8 +71,18 @@ void LoggerMessageWriter_DFLogStart::reset()
     _next_unit_to_send = 0;
     _next_multiplier_to_send = 0;
     _next_format_unit_to_send = 0;
-    param_default = AP::logger().quiet_nanf();
-    ap = AP_Param::first(&token, &type, &param_default);
+#if HAL_LOGGER_FORMAT_BLOB_ENABLED
+    format_blob_ofs = 0;
+#endif
+
+    {
+        WITH_SEMAPHORE(param_sem);
+        if (_param_staging != nullptr) {
+            _param_staging->clear();
+        }
+        param_default = AP::logger().quiet_nanf();
+        ap = AP_Param::first(&token, &type, &param_default);
+    }
 }
 
 bool LoggerMessageWriter_DFLogStart::out_of_time_for_writing_messages_df() const
@@ -98,6 +111,231 @@ bool LoggerMessageWriter_DFLogStart::check_process_limit(uint32_t start_us)
     return false;
 }
 
+#if HAL_LOGGER_FORMAT_BLOB_ENABLED
+uint8_t *LoggerMessageWriter_DFLogStart::format_blob;
+uint32_t LoggerMessageWriter_DFLogStart::format_blob_len;
+bool LoggerMessageWriter_DFLogStart::format_blob_failed;
+
+/*
+  build the FMT, UNIT, MULT and FMTU messages for all structures into
+  one block of memory. This only depends on the structures, so is
+  done once and shared by all backends
+ */
+bool LoggerMessageWriter_DFLogStart::build_format_blob(void)
+{
+    if (format_blob != nullptr) {
+        return true;
+    }
+    if (format_blob_failed) {
+        return false;
+    }
+    const uint8_t num_types = _logger_backend->num_types();
+    const uint8_t num_units = _logger_backend->num_units();
+    const uint8_t num_multipliers = _logger_backend->num_multipliers();
+    const uint32_t len = num_types * (sizeof(log_Format) + sizeof(log_Format_Units)) +
+        num_units * sizeof(log_Unit) +
+        num_multipliers * sizeof(log_Format_Multiplier);
+    uint8_t *blob = NEW_NOTHROW uint8_t[len];
+    if (blob == nullptr) {
+        format_blob_failed = true;
+        return false;
+    }
+
+    uint32_t ofs = 0;
+    for (uint8_t i=0; i<num_types; i++) {
+        struct log_Format pkt;
+        _logger_backend->Fill_Format(_logger_backend->structure(i), pkt);
+        memcpy(&blob[ofs], &pkt, sizeof(pkt));
+        ofs += sizeof(pkt);
+    }
+    for (uint8_t i=0; i<num_units; i++) {
+        const struct UnitStructure *u = _logger_backend->unit(i);
+        struct log_Unit pkt{
+            LOG_PACKET_HEADER_INIT(LOG_UNIT_MSG),
+            time_us : 0,
+            type    : u->ID,
+            unit    : { }
+        };
+        strncpy_noterm(pkt.unit, u->unit, sizeof(pkt.unit));
+        memcpy(&blob[ofs], &pkt, sizeof(pkt));
+        ofs += sizeof(pkt);
+    }
+    for (uint8_t i=0; i<num_multipliers; i++) {
+        const struct MultiplierStructure *m = _logger_backend->multiplier(i);
+        const struct log_Format_Multiplier pkt{
+            LOG_PACKET_HEADER_INIT(LOG_MULT_MSG),
+            time_us      : 0,
+            type         : m->ID,
+            multiplier   : m->multiplier,
+        };
+        memcpy(&blob[ofs], &pkt, sizeof(pkt));
+        ofs += sizeof(pkt);
+    }
+    for (uint8_t i=0; i<num_types; i++) {
+        struct log_Format_Units pkt;
+        _logger_backend->Fill_Format_Units(_logger_backend->structure(i), pkt);
+        memcpy(&blob[ofs], &pkt, sizeof(pkt));
+        ofs += sizeof(pkt);
+    }
+
+    format_blob_len = len;
+    format_blob = blob;
+    return true;
+}
+
+/*
+  write as many whole messages from the format blob as fit in the
+  buffer in one block, setting the timestamps of those which have one
+ */
+bool LoggerMessageWriter_DFLogStart::write_format_blob(uint32_t start_us)
+{
+    while (format_blob_ofs < format_blob_len) {
+        const uint32_t space = MIN(_logger_backend->bufferspace_available(), MAX_STARTUP_BLOCK_WRITE);
+        const uint64_t now_us = AP_HAL::micros64();
+        uint32_t n = 0;
+        while (format_blob_ofs + n < format_blob_len) {
+            uint8_t *msg = &format_blob[format_blob_ofs + n];
+            if (msg[2] == LOG_FORMAT_MSG &&
+                _logger_backend->have_emitted_format_for_type((LogMessages)((const struct log_Format *)msg)->type)) {
+                // already in the log; write up to here and skip it
+                // on the next pass
+                if (n == 0) {
+                    format_blob_ofs += sizeof(log_Format);
+                    continue;
+                }
+                break;
+            }
+            uint16_t msg_len;
+            switch (msg[2]) {
+            case LOG_FORMAT_MSG:
+                msg_len = sizeof(log_Format);
+                break;
+            case LOG_UNIT_MSG:
+                msg_len = sizeof(log_Unit);
+                break;
+            case LOG_MULT_MSG:
+                msg_len = sizeof(log_Format_Multiplier);
+                break;
+            default:
+                msg_len = sizeof(log_Format_Units);
+                break;
+            }
+            if (n + msg_len > space) {
+                break;
+            }
+            if (msg[2] != LOG_FORMAT_MSG) {
+                // all but FMT have a timestamp after the header
+                memcpy(&msg[3], &now_us, sizeof(now_us));
+            }
+            n += msg_len;
+        }
+        if (n == 0) {
+            if (format_blob_ofs >= format_blob_len) {
+                // skipped the last formats
+                break;
+            }
+            return false; // call me again!
+        }
+        if (!_logger_backend->WriteStartupBlock(&format_blob[format_blob_ofs], n)) {
+            return false; // call me again!
+        }
+        // record the formats we have written
+        for (uint32_t ofs=format_blob_ofs; ofs<format_blob_ofs+n; ofs+=sizeof(log_Format)) {
+            const uint8_t *msg = &format_blob[ofs];
+            if (msg[2] != LOG_FORMAT_MSG) {
+                break;
+            }
+            _logger_backend->set_format_emitted(((const struct log_Format *)msg)->type);
+        }
+        format_blob_ofs += n;
+        if (check_process_limit(start_us)) {
+            return false; // call me again!
+        }
+    }
+    return true;
+}
+#endif // HAL_LOGGER_FORMAT_BLOB_ENABLED
+
+/*
+  serialize parameters into the staging buffer. This is called from
+  the IO thread so the main thread only has to copy the messages into
+  the log, and from process() if the IO thread falls behind
+ */
+void LoggerMessageWriter_DFLogStart::stage_params(void)
+{
+#if HAL_LOGGER_PARAM_STAGING_COUNT > 0
+    if (ap == nullptr || _param_staging_failed || !param_sem.take_nonblocking()) {
+        return;
+    }
+    if (_param_staging == nullptr) {
+        // only allocated once a log needs its parameters written
+        _param_staging = NEW_NOTHROW ObjectBuffer<struct log_Parameter>(HAL_LOGGER_PARAM_STAGING_COUNT);
+        if (_param_staging == nullptr || _param_staging->get_size() == 0) {
+            delete _param_staging;
+            _param_staging = nullptr;
+            _param_staging_failed = true;
+            param_sem.give();
+            return;
+        }
+    }
+    while (ap != nullptr && _param_staging->space() > 0) {
+        char name[16];
+        ap->copy_name_token(token, &name[0], sizeof(name), true);
+        struct log_Parameter pkt{
+            LOG_PACKET_HEADER_INIT(LOG_PARAMETER_MSG),
+            time_us : 0,  // set when written
+            name  : {},
+            value : ap->cast_to_float(type),
+            default_value : param_default
+        };
+        strncpy_noterm(pkt.name, name, sizeof(pkt.name));
+        _param_staging->push(pkt);
+        param_default = AP::logger().quiet_nanf();
+        ap = AP_Param::next_scalar(&token, &type, &param_default);
+    }
+    param_sem.give();
+#endif
+}
+
+/*
+  write staged parameters in blocks of whole messages
+ */
+bool LoggerMessageWriter_DFLogStart::write_staged_params(uint32_t start_us)
+{
+    while (true) {
+        if (_param_staging->is_empty()) {
+            stage_params();
+        }
+        uint32_t n = 0;
+        const struct log_Parameter *pkts = _param_staging->readptr(n);
+        if (pkts == nullptr) {
+            WITH_SEMAPHORE(param_sem);
+            // the IO thread may have staged more since we looked
+            return ap == nullptr && _param_staging->is_empty();
+        }
+        const uint32_t space = MIN(_logger_backend->bufferspace_available(), MAX_STARTUP_BLOCK_WRITE);
+        n = MIN(n, space / sizeof(*pkts));
+        if (n == 0) {
+            return false; // call me again!
+        }
+        // timestamp the messages as they are written rather than
+        // when they were staged. The IO thread only adds messages, so
+        // these are ours to change
+        struct log_Parameter *write_pkts = const_cast<struct log_Parameter *>(pkts);
+        const uint64_t now_us = AP_HAL::micros64();
+        for (uint32_t i=0; i<n; i++) {
+            write_pkts[i].time_us = now_us;
+        }
+        if (!_logger_backend->WriteStartupBlock(pkts, n * sizeof(*pkts))) {
+            return false; // call me again!
+        }
+        _param_staging->advance(n);
+        if (check_process_limit(start_us)) {
+            return false; // call me again!
+        }
+    }
+}
+
 void LoggerMessageWriter_DFLogStart::process()
 {
     if (out_of_time_for_writing_messages_df()) {
@@ -108,40 +346,36 @@ void LoggerMessageWriter_DFLogStart::process()
 
     switch(stage) {
     case Stage::FORMATS:
-        // write log formats so the log is self-describing
-        while (next_format_to_send < _logger_backend->num_types()) {
-            const auto &s { _logger_backend->structure(next_format_to_send) };
-            if (_logger_backend->have_emitted_format_for_type((LogMessages)s->msg_type)) {
-                next_format_to_send++;
-                continue;
-            }
-            if (!_logger_backend->Write_Format(s)) {
+#if HAL_LOGGER_FORMAT_BLOB_ENABLED
+        if (build_format_blob()) {
+            // the blob has all the formats, units and multipliers
+            if (!write_format_blob(start_us)) {
                 return; // call me again!
             }
-            next_format_to_send++;
-            if (check_process_limit(start_us)) {
-                return; // call me again!
+            _next_unit_to_send = _logger_backend->num_units();
+            _next_multiplier_to_send = _logger_backend->num_multipliers();
+            _next_format_unit_to_send = _logger_backend->num_types();
+        } else
+#endif
+        {
+            // write log formats so the log is self-describing
+            while (next_format_to_send < _logger_backend->num_types()) {
+                const auto &s { _logger_backend->structure(next_format_to_send) };
+                if (_logger_backend->have_emitted_format_for_type((LogMessages)s->msg_type)) {
+                    next_format_to_send++;
+                    continue;
+                }
+                if (!_logger_backend->Write_Format(s)) {
+                    return; // call me again!
+                }
+                next_format_to_send++;
+                if (check_process_limit(start_us)) {
+                    return; // call me again!
+                }
             }
         }
         _fmt_done = true;
-        stage = Stage::PARMS;
-        FALLTHROUGH;
-
-    case Stage::PARMS: {
-        while (ap) {
-            if (!_logger_backend->Write_Parameter(ap, token, type, param_default)) {
-                return;
-            }
-            param_default = AP::logger().quiet_nanf();
-            ap = AP_Param::next_scalar(&token, &type, &param_default);
-            if (check_process_limit(start_us)) {
-                return; // call me again!
-            }
-        }
-
-        _params_done = true;
         stage = Stage::UNITS;
-        }
         FALLTHROUGH;
 
     case Stage::UNITS:
@@ -167,7 +401,7 @@ void LoggerMessageWriter_DFLogStart::process()
                 return; // call me again!
             }
         }
-        stage = Stage::UNITS;
+        stage = Stage::FORMAT_UNITS;
         FALLTHROUGH;
 
     case Stage::FORMAT_UNITS:
@@ -180,6 +414,46 @@ void LoggerMessageWriter_DFLogStart::process()
                 return; // call me again!
             }
         }
+        stage = Stage::PARMS;
+        FALLTHROUGH;
+
+    case Stage::PARMS:
+        if (_param_staging == nullptr) {
+            // the IO thread may not have got to us yet
+            stage_params();
+        }
+        if (_param_staging != nullptr) {
+            if (!write_staged_params(start_us)) {
+                return; // call me again!
+            }
+        } else {
+            WITH_SEMAPHORE(param_sem);
+            while (ap) {
+                if (!_logger_backend->Write_Parameter(ap, token, type, param_default)) {
+                    return;
+                }
+                param_default = AP::logger().quiet_nanf();
+                ap = AP_Param::next_scalar(&token, &type, &param_default);
+                if (check_process_limit(start_us)) {
+                    return; // call me again!
+                }
+            }
+        }
+
+        _params_done = true;
+        stage = Stage::VEHICLE_MESSAGES;
+        FALLTHROUGH;
+
+    case Stage::VEHICLE_MESSAGES:
+        // we guarantee 200 bytes of space for the vehicle startup
+        // messages.  This allows them to be simple functions rather
+        // than e.g. LoggerMessageWriter-based state machines
+        if (_logger_backend->vehicle_message_writer()) {
+            if (_logger_backend->bufferspace_available() < 200) {
+                return;
+            }
+            (_logger_backend->vehicle_message_writer())();
+        }
         stage = Stage::RUNNING_SUBWRITERS;
         FALLTHROUGH;
 
@@ -204,21 +478,9 @@ void LoggerMessageWriter_DFLogStart::process()
                 }
             }
         }
-        stage = Stage::VEHICLE_MESSAGES;
-        FALLTHROUGH;
-    }
-    case Stage::VEHICLE_MESSAGES:
-        // we guarantee 200 bytes of space for the vehicle startup
-        // messages.  This allows them to be simple functions rather
-        // than e.g. LoggerMessageWriter-based state machines
-        if (_logger_backend->vehicle_message_writer()) {
-            if (_logger_backend->bufferspace_available() < 200) {
-                return;
-            }
-            (_logger_backend->vehicle_message_writer())();
-        }
         stage = Stage::DONE;
         FALLTHROUGH;
+    }
 
     case Stage::DONE:
         break;
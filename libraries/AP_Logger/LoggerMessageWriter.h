@@ -2,6 +2,7 @@
 
 #include "AP_Logger_Backend.h"
 #include <AP_Rally/AP_Rally.h>
+#include <AP_HAL/utility/RingBuffer.h>
 
 class LoggerMessageWriter {
 public:
@@ -131,6 +132,10 @@ public:
     bool fmt_done() const { return _fmt_done; }
     bool params_done() const { return _params_done; }
 
+    // serialize parameters into the staging buffer ahead of
+    // process(). Called from the logging IO thread
+    void stage_params(void);
+
     // reset some writers so we push stuff out to logs again.  Will
     // only work if we are in state DONE!
 #if AP_MISSION_ENABLED
@@ -170,11 +175,41 @@ private:
     uint8_t _next_format_unit_to_send;
     uint8_t _next_multiplier_to_send;
 
+#if HAL_LOGGER_FORMAT_BLOB_ENABLED
+    /*
+      the FMT, UNIT, MULT and FMTU messages for all structures are
+      built once into a blob shared by all backends, which is written
+      in large blocks of whole messages
+     */
+    static uint8_t *format_blob;
+    static uint32_t format_blob_len;
+    static bool format_blob_failed;
+    uint32_t format_blob_ofs;
+
+    bool build_format_blob(void);
+
+    // write more of the format blob, returning true when it is all written
+    bool write_format_blob(uint32_t start_us);
+#endif
+
+    /*
+      parameter iteration state, protected by param_sem as
+      stage_params() may be called from the IO thread
+     */
+    HAL_Semaphore param_sem;
     AP_Param::ParamToken token;
     AP_Param *ap;
     float param_default;
     enum ap_var_type type;
 
+    // PARM messages serialized by stage_params() waiting to be
+    // written, allocated when first needed
+    ObjectBuffer<struct log_Parameter> *_param_staging;
+    bool _param_staging_failed;
+
+    // write staged parameters, returning true when all are written
+    bool write_staged_params(uint32_t start_us);
+
 
     LoggerMessageWriter_WriteSysInfo _writesysinfo;
 #if AP_MISSION_ENABLED
@@ -11,6 +11,7 @@
 #include "definitions.h"
 #include "crc.h"
 #include "matrix3.h"
+#include "matrix_kernels.h"
 #include "polygon.h"
 #include "quaternion.h"
 #include "rotations.h"
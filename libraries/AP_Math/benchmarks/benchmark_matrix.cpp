@@ -21,4 +21,118 @@ static void BM_MatrixMultiplication(benchmark::State& state)
 
 BENCHMARK(BM_MatrixMultiplication);
 
+/*
+  the NxN kernels with runtime and compile time dimensions, on a
+  symmetric positive definite matrix like the J'J of a calibration fit
+ */
+template <uint8_t N>
+static void fill_spd(float *A, float *b)
+{
+    for (uint8_t i = 0; i < N; i++) {
+        for (uint8_t j = 0; j < N; j++) {
+            A[i*N + j] = 1.0f / (1 + i + j);
+        }
+        A[i*N + i] += N;
+        b[i] = i + 1;
+    }
+}
+
+template <uint8_t N>
+static void BM_MatMul(benchmark::State& state)
+{
+    float A[N*N], B[N*N], C[N*N], b[N];
+    fill_spd<N>(A, b);
+    fill_spd<N>(B, b);
+
+    while (state.KeepRunning()) {
+        mat_mul(A, B, C, N);
+        gbenchmark_escape(C);
+    }
+}
+
+template <uint8_t N>
+static void BM_MatMulFixed(benchmark::State& state)
+{
+    float A[N*N], B[N*N], C[N*N], b[N];
+    fill_spd<N>(A, b);
+    fill_spd<N>(B, b);
+
+    while (state.KeepRunning()) {
+        mat_mul_fixed<float,N>(A, B, C);
+        gbenchmark_escape(C);
+    }
+}
+
+// the old way of taking a Gauss-Newton step: invert then multiply
+template <uint8_t N>
+static void BM_MatInverseSolve(benchmark::State& state)
+{
+    float A[N*N], Ainv[N*N], b[N], x[N];
+    fill_spd<N>(A, b);
+
+    while (state.KeepRunning()) {
+        if (mat_inverse(A, Ainv, N)) {
+            mat_vec_mul_fixed<float,N>(Ainv, b, x);
+        }
+        gbenchmark_escape(x);
+    }
+}
+
+template <uint8_t N>
+static void BM_MatLDLTSolve(benchmark::State& state)
+{
+    float A[N*N], b[N], x[N];
+    fill_spd<N>(A, b);
+
+    while (state.KeepRunning()) {
+        if (mat_ldlt_solve<float,N>(A, b, x)) {
+            gbenchmark_escape(x);
+        }
+    }
+}
+
+// accumulating J'J one sample at a time
+template <uint8_t N>
+static void BM_MatOuterUpdate(benchmark::State& state)
+{
+    float A[N*N] {}, x[N];
+    for (uint8_t i = 0; i < N; i++) {
+        x[i] = 0.1f * (i + 1);
+    }
+
+    while (state.KeepRunning()) {
+        for (uint8_t i = 0; i < N; i++) {
+            for (uint8_t j = 0; j < N; j++) {
+                A[i*N + j] += x[i] * x[j];
+            }
+        }
+        gbenchmark_escape(A);
+    }
+}
+
+template <uint8_t N>
+static void BM_MatSymRank1Update(benchmark::State& state)
+{
+    float A[N*N] {}, x[N];
+    for (uint8_t i = 0; i < N; i++) {
+        x[i] = 0.1f * (i + 1);
+    }
+
+    while (state.KeepRunning()) {
+        mat_sym_rank1_update<float,N>(A, x, 1.0f);
+        gbenchmark_escape(A);
+    }
+}
+
+BENCHMARK_TEMPLATE(BM_MatMul, 4);
+BENCHMARK_TEMPLATE(BM_MatMulFixed, 4);
+BENCHMARK_TEMPLATE(BM_MatMul, 9);
+BENCHMARK_TEMPLATE(BM_MatMulFixed, 9);
+BENCHMARK_TEMPLATE(BM_MatInverseSolve, 4);
+BENCHMARK_TEMPLATE(BM_MatLDLTSolve, 4);
+BENCHMARK_TEMPLATE(BM_MatInverseSolve, 9);
+BENCHMARK_TEMPLATE(BM_MatLDLTSolve, 9);
+BENCHMARK_TEMPLATE(BM_MatOuterUpdate, 9);
+BENCHMARK_TEMPLATE(BM_MatSymRank1Update, 9);
+
 BENCHMARK_MAIN();
@@ -441,6 +441,14 @@ bool mat_inverse(const T x[], T y[], uint16_t dim)
 template <typename T>
 void mat_mul(const T *A, const T *B, T *C, uint16_t n)
 {
+    switch (n) {
+    case 3:
+        mat_mul_fixed<T,3>(A, B, C);
+        return;
+    case 4:
+        mat_mul_fixed<T,4>(A, B, C);
+        return;
+    }
     memset(C, 0, sizeof(T)*n*n);
     for(uint16_t i = 0; i < n; i++) {
         for(uint16_t j = 0; j < n; j++) {
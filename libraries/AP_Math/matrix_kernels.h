@@ -0,0 +1,164 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/*
+  matrix kernels for square row-major NxN matrices with the dimension
+  fixed at compile time. With constant loop bounds the compiler can
+  unroll and keep intermediate values in registers, and all working
+  storage is on the stack, unlike mat_mul() and mat_inverse() which
+  take the dimension at runtime and allocate for larger matrices.
+
+  Callers give the dimension explicitly, for example:
+
+    float JTJ[9*9], JTFI[9], delta[9];
+    if (mat_ldlt_solve<float,9>(JTJ, JTFI, delta)) { ... }
+ */
+#pragma once
+
+#include <stdint.h>
+#include <cmath>
+
+// C = A * B. C must not be A or B
+template <typename T, uint8_t N>
+inline void mat_mul_fixed(const T *A, const T *B, T *C)
+{
+    for (uint8_t i = 0; i < N; i++) {
+        T row[N] {};
+        for (uint8_t k = 0; k < N; k++) {
+            const T a = A[i*N + k];
+            for (uint8_t j = 0; j < N; j++) {
+                row[j] += a * B[k*N + j];
+            }
+        }
+        for (uint8_t j = 0; j < N; j++) {
+            C[i*N + j] = row[j];
+        }
+    }
+}
+
+// y = A * x. y must not be x
+template <typename T, uint8_t N>
+inline void mat_vec_mul_fixed(const T *A, const T *x, T *y)
+{
+    for (uint8_t i = 0; i < N; i++) {
+        T sum = 0;
+        for (uint8_t k = 0; k < N; k++) {
+            sum += A[i*N + k] * x[k];
+        }
+        y[i] = sum;
+    }
+}
+
+/*
+  symmetric rank one update A += scale * x * x', as used to accumulate
+  J'J in least squares fits and for P -= K*H*P in a scalar Kalman
+  update. Only the upper triangle is computed and it is mirrored, so
+  A stays exactly symmetric
+ */
+template <typename T, uint8_t N>
+inline void mat_sym_rank1_update(T *A, const T *x, const T scale)
+{
+    for (uint8_t i = 0; i < N; i++) {
+        const T sx = scale * x[i];
+        for (uint8_t j = i; j < N; j++) {
+            A[i*N + j] += sx * x[j];
+        }
+    }
+    for (uint8_t i = 1; i < N; i++) {
+        for (uint8_t j = 0; j < i; j++) {
+            A[i*N + j] = A[j*N + i];
+        }
+    }
+}
+
+/*
+  in-place LDL' decomposition of a symmetric positive definite matrix,
+  using the lower triangle. On return the strict lower triangle holds
+  the unit lower triangular L and the diagonal holds D. Returns false
+  if the matrix is not positive definite
+ */
+template <typename T, uint8_t N>
+inline bool mat_ldlt_decompose(T *A)
+{
+    for (uint8_t j = 0; j < N; j++) {
+        T d = A[j*N + j];
+        for (uint8_t k = 0; k < j; k++) {
+            const T ljk = A[j*N + k];
+            d -= ljk * ljk * A[k*N + k];
+        }
+        if (!(d > 0) || !std::isfinite(d)) {
+            return false;
+        }
+        A[j*N + j] = d;
+        const T dinv = 1 / d;
+        for (uint8_t i = j + 1; i < N; i++) {
+            T s = A[i*N + j];
+            for (uint8_t k = 0; k < j; k++) {
+                s -= A[i*N + k] * A[j*N + k] * A[k*N + k];
+            }
+            A[i*N + j] = s * dinv;
+        }
+    }
+    return true;
+}
+
+// solve A*x = b given the output of mat_ldlt_decompose(). x may be b
+template <typename T, uint8_t N>
+inline void mat_ldlt_substitute(const T *LD, const T *b, T *x)
+{
+    T y[N];
+    // L*z = b
+    for (uint8_t i = 0; i < N; i++) {
+        T s = b[i];
+        for (uint8_t k = 0; k < i; k++) {
+            s -= LD[i*N + k] * y[k];
+        }
+        y[i] = s;
+    }
+    // D*w = z
+    for (uint8_t i = 0; i < N; i++) {
+        y[i] /= LD[i*N + i];
+    }
+    // L'*x = w
+    for (int16_t i = N - 1; i >= 0; i--) {
+        T s = y[i];
+        for (uint8_t k = i + 1; k < N; k++) {
+            s -= LD[k*N + i] * y[k];
+        }
+        y[i] = s;
+    }
+    for (uint8_t i = 0; i < N; i++) {
+        x[i] = y[i];
+    }
+}
+
+/*
+  solve A*x = b for a symmetric positive definite A, leaving A
+  unchanged. This is cheaper and more accurate than forming the
+  inverse when only the product with one vector is needed. Returns
+  false if A is not positive definite. x may be b
+ */
+template <typename T, uint8_t N>
+inline bool mat_ldlt_solve(const T *A, const T *b, T *x)
+{
+    T LD[N*N];
+    for (uint16_t i = 0; i < N*N; i++) {
+        LD[i] = A[i];
+    }
+    if (!mat_ldlt_decompose<T,N>(LD)) {
+        return false;
+    }
+    mat_ldlt_substitute<T,N>(LD, b, x);
+    return true;
+}
@@ -0,0 +1,105 @@
+#include "math_test.h"
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+// fill a symmetric positive definite matrix, as for J'J plus damping
+template <uint8_t N>
+static void fill_spd(float *A)
+{
+    float J[N];
+    for (uint8_t i = 0; i < N*N; i++) {
+        A[i] = 0;
+    }
+    for (uint8_t k = 0; k < 3*N; k++) {
+        for (uint8_t i = 0; i < N; i++) {
+            J[i] = sinf(0.7f * k + 1.3f * i) + 0.1f * i;
+        }
+        mat_sym_rank1_update<float,N>(A, J, 1.0f);
+    }
+    for (uint8_t i = 0; i < N; i++) {
+        A[i*N + i] += 1.0f;
+    }
+}
+
+TEST(MatrixKernelsTest, MatMulFixed)
+{
+    float A[5*5], B[5*5], C[5*5], expected[5*5];
+    for (uint8_t i = 0; i < 5*5; i++) {
+        A[i] = i - 12;
+        B[i] = 0.5f * (i % 7);
+    }
+    mat_mul(A, B, expected, 5);
+    mat_mul_fixed<float,5>(A, B, C);
+    for (uint8_t i = 0; i < 5*5; i++) {
+        EXPECT_FLOAT_EQ(expected[i], C[i]);
+    }
+
+    // 3x3 and 4x4 go through the fixed kernels in mat_mul()
+    float M[4*4], out[4*4];
+    mat_identity(M, 4);
+    M[1] = 2;
+    mat_mul(M, A, out, 4);
+    for (uint8_t j = 0; j < 4; j++) {
+        EXPECT_FLOAT_EQ(A[j] + 2 * A[4 + j], out[j]);
+        EXPECT_FLOAT_EQ(A[4 + j], out[4 + j]);
+    }
+}
+
+TEST(MatrixKernelsTest, SymRank1Update)
+{
+    float A[4*4] {}, expected[4*4] {};
+    const float x[4] { 1.0f, -2.0f, 0.5f, 3.0f };
+    mat_sym_rank1_update<float,4>(A, x, 2.0f);
+    for (uint8_t i = 0; i < 4; i++) {
+        for (uint8_t j = 0; j < 4; j++) {
+            expected[i*4 + j] = 2.0f * x[i] * x[j];
+        }
+    }
+    for (uint8_t i = 0; i < 4*4; i++) {
+        EXPECT_FLOAT_EQ(expected[i], A[i]);
+    }
+}
+
+TEST(MatrixKernelsTest, LDLTSolveMatchesInverse)
+{
+    float A[9*9], Ainv[9*9], b[9], x[9], x_inv[9];
+    fill_spd<9>(A);
+    for (uint8_t i = 0; i < 9; i++) {
+        b[i] = i - 4.0f;
+    }
+
+    EXPECT_TRUE((mat_ldlt_solve<float,9>(A, b, x)));
+    EXPECT_TRUE(mat_inverse(A, Ainv, 9));
+    mat_vec_mul_fixed<float,9>(Ainv, b, x_inv);
+
+    // residual of the solution
+    float Ax[9];
+    mat_vec_mul_fixed<float,9>(A, x, Ax);
+    for (uint8_t i = 0; i < 9; i++) {
+        EXPECT_NEAR(b[i], Ax[i], 1.0e-3f);
+        EXPECT_NEAR(x_inv[i], x[i], 1.0e-3f * (1 + fabsf(x[i])));
+    }
+
+    // solving in place
+    EXPECT_TRUE((mat_ldlt_solve<float,9>(A, b, b)));
+    for (uint8_t i = 0; i < 9; i++) {
+        EXPECT_FLOAT_EQ(x[i], b[i]);
+    }
+}
+
+TEST(MatrixKernelsTest, LDLTRejectsIndefinite)
+{
+    float A[3*3] {
+        1, 2, 0,
+        2, 1, 0,
+        0, 0, 1,
+    };
+    const float b[3] { 1, 1, 1 };
+    float x[3];
+    EXPECT_FALSE((mat_ldlt_solve<float,3>(A, b, x)));
+
+    float Z[3*3] {};
+    EXPECT_FALSE((mat_ldlt_solve<float,3>(Z, b, x)));
+}
+
+AP_GTEST_MAIN()
@@ -17,10 +17,46 @@
 #pragma once
 
 #include <stdint.h>
+#include <AP_HAL/AP_HAL.h>
 #include <AP_Math/AP_Math.h>
 #include <AP_Math/vectorN.h>
 #include "AP_Nav_Common.h"
 
+#if CONFIG_HAL_BOARD == HAL_BOARD_SITL || CONFIG_HAL_BOARD == HAL_BOARD_LINUX
+#include <time.h>
+#endif
+
+/*
+  on boards where EKF lanes may run on separate threads each thread
+  needs its own scratch space
+ */
+#ifndef NAVEKF_SCRATCH_PER_THREAD
+#define NAVEKF_SCRATCH_PER_THREAD (CONFIG_HAL_BOARD == HAL_BOARD_SITL || CONFIG_HAL_BOARD == HAL_BOARD_LINUX)
+#endif
+
+#if NAVEKF_SCRATCH_PER_THREAD
+#define NAVEKF_SCRATCH_STORAGE thread_local
+#else
+#define NAVEKF_SCRATCH_STORAGE
+#endif
+
+/*
+  return a monotonic timestamp in nanoseconds, for timing the EKF
+  itself. SITL and Replay run on a simulated clock which does not
+  advance while the EKF runs, so the host clock is used directly where
+  it is available
+ */
+static inline uint64_t NavEKF_host_time_ns(void)
+{
+#if CONFIG_HAL_BOARD == HAL_BOARD_SITL || CONFIG_HAL_BOARD == HAL_BOARD_LINUX
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec*1000000000ULL + ts.tv_nsec;
+#else
+    return AP_HAL::micros64() * 1000ULL;
+#endif
+}
+
 /*
   this declares a common parent class for AP_NavEKF2 and
   AP_NavEKF3. The purpose of this class is to hold common static
@@ -42,10 +78,10 @@ public:
 #endif
 
 protected:
-    static Matrix24 KH;                   // intermediate result used for covariance updates
-    static Matrix24 KHP;                  // intermediate result used for covariance updates
-    static Matrix24 nextP;                // Predicted covariance matrix before addition of process noise to diagonals
-    static Vector28 Kfusion;              // intermediate fusion vector
+    static NAVEKF_SCRATCH_STORAGE Matrix24 KH;      // intermediate result used for covariance updates
+    static NAVEKF_SCRATCH_STORAGE Matrix24 KHP;     // intermediate result used for covariance updates
+    static NAVEKF_SCRATCH_STORAGE Matrix24 nextP;   // Predicted covariance matrix before addition of process noise to diagonals
+    static NAVEKF_SCRATCH_STORAGE Vector28 Kfusion; // intermediate fusion vector
 
     // fill all the common scratch variables with NaN on SITL
     void fill_scratch_variables(void);
@@ -0,0 +1,72 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/*
+  cost of the yaw estimator bank run by each EKF lane: the prediction
+  runs for every IMU sample and the velocity fusion for every GPS sample
+ */
+#include <AP_gbenchmark.h>
+
+#include <AP_NavEKF/EKFGSF_yaw.h>
+#include <new>
+#include <stdlib.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+static const ftype imu_dt = 0.0025;
+
+// hovering vehicle turning slowly, with velocity fusion running
+static EKFGSF_yaw *setup_gsf(Vector3F &del_ang, Vector3F &del_vel)
+{
+    EKFGSF_yaw *gsf = new (calloc(1, sizeof(EKFGSF_yaw))) EKFGSF_yaw();
+    del_ang = Vector3F(0, 0, 0.1 * imu_dt);
+    del_vel = Vector3F(0.05 * imu_dt, 0, -GRAVITY_MSS * imu_dt);
+    for (uint16_t i = 0; i < 800; i++) {
+        gsf->update(del_ang, del_vel, imu_dt, imu_dt, true, 0);
+        if (i % 40 == 0) {
+            gsf->fuseVelData(Vector2F(), 0.3);
+        }
+    }
+    return gsf;
+}
+
+static void BM_EKFGSFPredict(benchmark::State& state)
+{
+    Vector3F del_ang, del_vel;
+    EKFGSF_yaw *gsf = setup_gsf(del_ang, del_vel);
+
+    while (state.KeepRunning()) {
+        gsf->update(del_ang, del_vel, imu_dt, imu_dt, true, 0);
+        gbenchmark_escape(gsf);
+    }
+    free(gsf);
+}
+
+BENCHMARK(BM_EKFGSFPredict);
+
+static void BM_EKFGSFFuseVelData(benchmark::State& state)
+{
+    Vector3F del_ang, del_vel;
+    EKFGSF_yaw *gsf = setup_gsf(del_ang, del_vel);
+
+    while (state.KeepRunning()) {
+        gsf->fuseVelData(Vector2F(), 0.3);
+        gbenchmark_escape(gsf);
+    }
+    free(gsf);
+}
+
+BENCHMARK(BM_EKFGSFFuseVelData);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,132 @@
+#include <AP_gtest.h>
+
+/*
+  tests for AP_NavEKF/EKFGSF_yaw.cpp
+ */
+
+#include <AP_NavEKF/EKFGSF_yaw.h>
+#include <new>
+#include <stdlib.h>
+
+#include <AP_HAL/AP_HAL.h>
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+#if CONFIG_HAL_BOARD == HAL_BOARD_SITL || CONFIG_HAL_BOARD == HAL_BOARD_LINUX
+
+static const ftype imu_dt = 0.0025;
+
+/*
+  fly a level vehicle with a slowly varying yaw rate through horizontal
+  accelerations, fusing a GPS velocity every 40 IMU samples, and
+  return the final true yaw
+ */
+static ftype fly(EKFGSF_yaw &gsf, ftype yaw, uint32_t n_samples)
+{
+    Vector2F vel;
+    uint32_t seed = 1;
+    auto noise = [&seed]() {
+        seed = seed * 1103515245U + 12345U;
+        return ftype((seed >> 8) & 0xFFFF) / 65535 - 0.5;
+    };
+    for (uint32_t i = 0; i < n_samples; i++) {
+        const ftype t = i * imu_dt;
+        const ftype yaw_rate = 0.3 * sinF(0.2 * t);
+        const Vector2F accel_ne { 2 * cosF(0.7 * t), 2 * sinF(0.5 * t) };
+        const Vector3F del_ang { 0.001f * noise(), 0.001f * noise(), yaw_rate * imu_dt + 0.0005f * noise() };
+        const ftype cos_yaw = cosF(yaw);
+        const ftype sin_yaw = sinF(yaw);
+        const Vector3F del_vel {
+            ( cos_yaw * accel_ne.x + sin_yaw * accel_ne.y) * imu_dt + 0.002f * noise(),
+            (-sin_yaw * accel_ne.x + cos_yaw * accel_ne.y) * imu_dt + 0.002f * noise(),
+            -GRAVITY_MSS * imu_dt
+        };
+        vel += accel_ne * imu_dt;
+        yaw = wrap_PI(yaw + yaw_rate * imu_dt);
+
+        gsf.update(del_ang, del_vel, imu_dt, imu_dt, i > 400, 0);
+        if (i % 40 == 0) {
+            gsf.fuseVelData(vel + Vector2F(0.1f * noise(), 0.1f * noise()), 0.3);
+        }
+    }
+    return yaw;
+}
+
+// the estimator is normally allocated from zeroed memory by the EKF
+static EKFGSF_yaw *new_gsf()
+{
+    return new (calloc(1, sizeof(EKFGSF_yaw))) EKFGSF_yaw();
+}
+
+TEST(EKFGSF_yaw, NoYawBeforeVelocityFusion)
+{
+    EKFGSF_yaw *gsf = new_gsf();
+    ftype yaw, yaw_variance, innov_length;
+    EXPECT_FALSE(gsf->getYawData(yaw, yaw_variance));
+    EXPECT_FALSE(gsf->getVelInnovLength(innov_length));
+
+    // nothing is fused until the EKF's are allowed to run
+    fly(*gsf, 0, 400);
+    EXPECT_FALSE(gsf->getYawData(yaw, yaw_variance));
+    fly(*gsf, 0, 500);
+    EXPECT_TRUE(gsf->getYawData(yaw, yaw_variance));
+    EXPECT_TRUE(gsf->getVelInnovLength(innov_length));
+    free(gsf);
+}
+
+TEST(EKFGSF_yaw, ConvergesFromAnyYaw)
+{
+    for (const ftype initial_yaw : { -3.0, -1.5, 0.0, 1.0, 2.5 }) {
+        EKFGSF_yaw *gsf = new_gsf();
+        const ftype true_yaw = fly(*gsf, initial_yaw, 60 / imu_dt);
+        ftype yaw, yaw_variance, innov_length;
+        uint8_t n_clips;
+        EXPECT_TRUE(gsf->getYawData(yaw, yaw_variance, &n_clips));
+        EXPECT_LT(fabsF(wrap_PI(yaw - true_yaw)), radians(10));
+        EXPECT_LT(yaw_variance, sq(radians(15)));
+        EXPECT_LT(n_clips, N_MODELS_EKFGSF);
+        EXPECT_TRUE(gsf->getVelInnovLength(innov_length));
+        EXPECT_LT(innov_length, 1);
+        free(gsf);
+    }
+}
+
+/*
+  the outputs after a fixed IMU and GPS sequence must match those of
+  the model bank before it was stored as arrays indexed by model. The
+  reference values are from that code built with double precision
+  ftype, and the tolerances cover the difference to single precision
+ */
+TEST(EKFGSF_yaw, MatchesReference)
+{
+    const struct {
+        ftype initial_yaw;
+        uint32_t n_samples;
+        ftype yaw;
+        ftype yaw_variance;
+        ftype innov_length;
+        uint8_t n_clips;
+    } reference[] {
+        // still converging, with a mix of models clipped
+        { -2.5, 1200,  2.98603688, 0.0137847084,  0.634672761, 2 },
+        {  0.0, 4000,  1.77451757, 0.00404364249, 1.77198035,  4 },
+        // converged
+        {  1.0, 24000, 1.29061527, 0.000361947901, 0.46409776, 0 },
+    };
+    for (const auto &ref : reference) {
+        EKFGSF_yaw *gsf = new_gsf();
+        fly(*gsf, ref.initial_yaw, ref.n_samples);
+        ftype yaw, yaw_variance, innov_length;
+        uint8_t n_clips;
+        EXPECT_TRUE(gsf->getYawData(yaw, yaw_variance, &n_clips));
+        EXPECT_TRUE(gsf->getVelInnovLength(innov_length));
+        EXPECT_NEAR(yaw, ref.yaw, 1e-4);
+        EXPECT_NEAR(yaw_variance, ref.yaw_variance, ref.yaw_variance * 1e-3);
+        EXPECT_NEAR(innov_length, ref.innov_length, 1e-4);
+        EXPECT_EQ(n_clips, ref.n_clips);
+        free(gsf);
+    }
+}
+
+AP_GTEST_MAIN()
+
+#endif // HAL_SITL or HAL_LINUX
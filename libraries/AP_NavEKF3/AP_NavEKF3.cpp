@@ -739,8 +739,8 @@ const AP_Param::GroupInfo NavEKF3::var_info2[] = {
 
     // @Param: OPTIONS
     // @DisplayName: Optional EKF behaviour
-    // @Description: EKF optional behaviour. Bit 0 (JammingExpected): Setting JammingExpected will change the EKF behaviour such that if dead reckoning navigation is possible it will require the preflight alignment GPS quality checks controlled by EK3_GPS_CHECK and EK3_CHECK_SCALE to pass before resuming GPS use if GPS lock is lost for more than 2 seconds to prevent bad position estimate. Bit 1 (Manual lane switching): DANGEROUS – If enabled, this disables automatic lane switching. If the active lane becomes unhealthy, no automatic switching will occur. Users must manually set EK3_PRIMARY to change lanes. No health checks will be performed on the selected lane. Use with extreme caution.
-    // @Bitmask: 0:JammingExpected, 1: ManualLaneSwitching
+    // @Description: EKF optional behaviour. Bit 0 (JammingExpected): Setting JammingExpected will change the EKF behaviour such that if dead reckoning navigation is possible it will require the preflight alignment GPS quality checks controlled by EK3_GPS_CHECK and EK3_CHECK_SCALE to pass before resuming GPS use if GPS lock is lost for more than 2 seconds to prevent bad position estimate. Bit 1 (Manual lane switching): DANGEROUS – If enabled, this disables automatic lane switching. If the active lane becomes unhealthy, no automatic switching will occur. Users must manually set EK3_PRIMARY to change lanes. No health checks will be performed on the selected lane. Use with extreme caution. Bit 2 (LaneThreads): On Linux and SITL, update each lane on its own thread so lanes run on separate CPU cores. The results are the same on every run, so logs can be replayed with this option set. The main loop time saved is logged in the PSav field of the PM message.
+    // @Bitmask: 0:JammingExpected, 1: ManualLaneSwitching, 2:LaneThreads
     // @User: Advanced
     AP_GROUPINFO("OPTIONS",  11, NavEKF3, _options, 0),
 
@@ -903,6 +903,20 @@ bool NavEKF3::coreBetterScore(uint8_t new_core, uint8_t current_core) const
     return coreRelativeErrors[new_core] < coreRelativeErrors[current_core];
 }
 
+// return true if a core may run its prediction step this frame
+bool NavEKF3::allowStatePrediction(uint8_t core_index)
+{
+    // if we have not overrun by more than 3 IMU frames, and we
+    // have already used more than 1/3 of the CPU budget for this
+    // loop then suppress the prediction step. This allows
+    // multiple EKF instances to cooperate on scheduling
+    if (core[core_index].getFramesSincePredict() < (_framesPerPrediction+3) &&
+        dal.ekf_low_time_remaining(AP_DAL::EKFType::EKF3, core_index)) {
+        return false;
+    }
+    return true;
+}
+
 /* 
   Update Filter States - this should be called whenever new IMU data is available
   Execution speed governed by SCHED_LOOP_RATE
@@ -917,17 +931,13 @@ void NavEKF3::UpdateFilter(void)
 
     imuSampleTime_us = dal.micros64();
 
-    for (uint8_t i=0; i<num_cores; i++) {
-        // if we have not overrun by more than 3 IMU frames, and we
-        // have already used more than 1/3 of the CPU budget for this
-        // loop then suppress the prediction step. This allows
-        // multiple EKF instances to cooperate on scheduling
-        bool allow_state_prediction = true;
-        if (core[i].getFramesSincePredict() < (_framesPerPrediction+3) &&
-            dal.ekf_low_time_remaining(AP_DAL::EKFType::EKF3, i)) {
-            allow_state_prediction = false;
+#if EK3_FEATURE_LANE_THREADS
+    if (!updateLanesInParallel())
+#endif
+    {
+        for (uint8_t i=0; i<num_cores; i++) {
+            core[i].UpdateFilter(allowStatePrediction(i));
         }
-        core[i].UpdateFilter(allow_state_prediction);
     }
 
     // If the current core selected has a bad error score or is unhealthy, switch to a healthy core with the lowest fault score
@@ -2116,3 +2126,14 @@ const EKFGSF_yaw *NavEKF3::get_yawEstimator(void) const
     }
     return nullptr;
 }
+
+#if EK3_FEATURE_STEP_TIMING
+// get the time spent in each step of the filter by a core
+const EK3_StepTiming *NavEKF3::getStepTiming(uint8_t core_index) const
+{
+    if (!core || core_index >= num_cores) {
+        return nullptr;
+    }
+    return &core[core_index].getStepTiming();
+}
+#endif
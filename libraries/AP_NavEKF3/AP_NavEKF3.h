@@ -24,6 +24,8 @@
 #include <AP_Param/AP_Param.h>
 #include <AP_NavEKF/AP_Nav_Common.h>
 #include <AP_NavEKF/AP_NavEKF_Source.h>
+#include "AP_NavEKF3_feature.h"
+#include "AP_NavEKF3_StepTiming.h"
 
 class NavEKF3_core;
 class EKFGSF_yaw;
@@ -368,6 +370,12 @@ public:
     // get a yaw estimator instance
     const EKFGSF_yaw *get_yawEstimator(void) const;
 
+#if EK3_FEATURE_STEP_TIMING
+    // get the time spent in each step of the filter by a core,
+    // returning nullptr if the core is not active
+    const EK3_StepTiming *getStepTiming(uint8_t core_index) const;
+#endif
+
 private:
     class AP_DAL &dal;
 
@@ -459,6 +467,7 @@ private:
     enum class Option {
         JammingExpected     = (1<<0),
         ManualLaneSwitch   = (1<<1),
+        LaneThreads        = (1<<2),
     };
     bool option_is_enabled(Option option) const {
         return (_options & (uint32_t)option) != 0;
@@ -547,6 +556,46 @@ private:
     // origin set by one of the cores
     Location common_EKF_origin;
     bool common_origin_valid;
+
+    // return true if a core may run its prediction step this frame
+    bool allowStatePrediction(uint8_t core_index);
+
+#if EK3_FEATURE_LANE_THREADS
+    // worker threads used to update lanes in parallel. Lane 0 runs on
+    // the calling thread
+    struct {
+        struct {
+            AP_HAL::BinarySemaphore *start;
+            AP_HAL::BinarySemaphore *done;
+            bool allow_state_prediction;
+            uint32_t run_time_us;
+        } lane[MAX_EKF_CORES];
+        uint8_t starting_lane;  // lane index for the thread being started
+        bool started;
+        bool failed;
+        bool running;           // true while lanes are being updated in parallel
+    } lane_threads;
+
+    // start the lane worker threads, returning false on failure
+    bool startLaneThreads(void);
+
+    // main loop of a lane worker thread
+    void laneThread(void);
+
+    // update all lanes in parallel, waiting for them all to
+    // finish. Returns false if lanes need to be run sequentially
+    bool updateLanesInParallel(void);
+#endif
+
+    // return true if lanes are being updated in parallel, in which
+    // case cores must not change state shared between lanes
+    bool laneThreadsRunning(void) const {
+#if EK3_FEATURE_LANE_THREADS
+        return lane_threads.running;
+#else
+        return false;
+#endif
+    }
     
     // update the yaw reset data to capture changes due to a lane switch
     // new_primary - index of the ekf instance that we are about to switch to as the primary
@@ -19,6 +19,8 @@
 */
 void NavEKF3_core::FuseAirspeed()
 {
+    EK3_TIME_STEP(FuseAirspeed);
+
     // declarations
     ftype SH_TAS[3];
     ftype SK_TAS[2];
@@ -474,6 +476,8 @@ void NavEKF3_core::FuseSideslip()
 */
 void NavEKF3_core::FuseDragForces()
 {
+    EK3_TIME_STEP(FuseDragForces);
+
     // drag model parameters
     const ftype bcoef_x = frontend->_ballisticCoef_x.get();
     const ftype bcoef_y = frontend->_ballisticCoef_y.get();
@@ -3,6 +3,7 @@
 #include "AP_NavEKF3.h"
 #include "AP_NavEKF3_core.h"
 #include <GCS_MAVLink/GCS.h>
+#include <AP_Logger/AP_Logger.h>
 
 #include "AP_DAL/AP_DAL.h"
 
@@ -714,14 +715,48 @@ bool NavEKF3_core::setOrigin(const Location &loc)
 
     GCS_SEND_TEXT(MAV_SEVERITY_INFO, "EKF3 IMU%u origin set",(unsigned)imu_index);
 
+    // when lanes run in parallel the frontend publishes the origin
+    // after all lanes finish, so the same lane always wins
+    originPublishPending = true;
+    if (!frontend->laneThreadsRunning()) {
+        publishOrigin();
+    }
+
+    return true;
+}
+
+// put our origin in the frontend if no other lane has set it yet
+void NavEKF3_core::publishOrigin()
+{
+    if (!originPublishPending) {
+        return;
+    }
+    originPublishPending = false;
     if (!frontend->common_origin_valid) {
         frontend->common_origin_valid = true;
         // put origin in frontend as well to ensure it stays in sync between lanes
         public_origin = EKF_origin;
     }
+}
 
-
-    return true;
+// apply what was held back while lanes were updated in parallel
+void NavEKF3_core::publishDeferred()
+{
+    publishOrigin();
+    if (deferred.takeoff_expected) {
+        deferred.takeoff_expected = false;
+        dal.set_takeoff_expected();
+    }
+#if HAL_LOGGING_ENABLED
+    if (deferred.xktv_pending) {
+        deferred.xktv_pending = false;
+        AP::logger().WriteBlock(&deferred.xktv, sizeof(deferred.xktv));
+    }
+    if (deferred.xkfm_pending) {
+        deferred.xkfm_pending = false;
+        AP::logger().WriteBlock(&deferred.xkfm, sizeof(deferred.xkfm));
+    }
+#endif
 }
 
 // record all requested yaw resets completed
@@ -0,0 +1,130 @@
+/*
+  update EKF3 lanes in parallel on worker threads
+
+  Each lane other than the first is updated on its own thread while
+  the first lane runs on the calling thread. All lanes finish before
+  lane selection and the outputs are used, and cores do not change
+  state shared between lanes while running in parallel, so the result
+  does not depend on thread timing and logs replay the same way.
+ */
+#include "AP_NavEKF3.h"
+
+#if EK3_FEATURE_LANE_THREADS
+
+#include "AP_NavEKF3_core.h"
+
+#include <AP_HAL/AP_HAL.h>
+#include <AP_DAL/AP_DAL.h>
+
+#if !NAVEKF_SCRATCH_PER_THREAD
+#error "EK3_FEATURE_LANE_THREADS needs NAVEKF_SCRATCH_PER_THREAD"
+#endif
+
+extern const AP_HAL::HAL& hal;
+
+// stack size for each lane thread
+#define EK3_LANE_THREAD_STACK 32768
+
+/*
+  start the lane worker threads. Returns false if they could not be
+  started, in which case lanes are updated sequentially
+ */
+bool NavEKF3::startLaneThreads(void)
+{
+    if (lane_threads.started) {
+        return true;
+    }
+    if (lane_threads.failed) {
+        return false;
+    }
+    for (uint8_t i=1; i<num_cores; i++) {
+        auto &lane = lane_threads.lane[i];
+        lane.start = NEW_NOTHROW HAL_BinarySemaphore;
+        lane.done = NEW_NOTHROW HAL_BinarySemaphore;
+        if (lane.start == nullptr || lane.done == nullptr) {
+            lane_threads.failed = true;
+            return false;
+        }
+        lane_threads.starting_lane = i;
+        if (!hal.scheduler->thread_create(FUNCTOR_BIND_MEMBER(&NavEKF3::laneThread, void),
+                                          "EKF3",
+                                          EK3_LANE_THREAD_STACK,
+                                          AP_HAL::Scheduler::PRIORITY_MAIN, 0)) {
+            lane_threads.failed = true;
+            return false;
+        }
+        // wait for the thread to take its lane index
+        lane.done->wait_blocking();
+    }
+    lane_threads.started = true;
+    return true;
+}
+
+// main loop of a lane worker thread
+void NavEKF3::laneThread(void)
+{
+    const uint8_t i = lane_threads.starting_lane;
+    auto &lane = lane_threads.lane[i];
+    lane.done->signal();
+
+    while (true) {
+        lane.start->wait_blocking();
+        const uint64_t start_ns = NavEKF_host_time_ns();
+        core[i].UpdateFilter(lane.allow_state_prediction);
+        lane.run_time_us = uint32_t((NavEKF_host_time_ns() - start_ns) / 1000U);
+        lane.done->signal();
+    }
+}
+
+/*
+  update all lanes in parallel and wait for them to finish. Returns
+  false if the lanes need to be updated sequentially instead
+ */
+bool NavEKF3::updateLanesInParallel(void)
+{
+    if (!option_is_enabled(Option::LaneThreads) || num_cores < 2) {
+        return false;
+    }
+    if (!startLaneThreads()) {
+        return false;
+    }
+
+    // decide on prediction for all lanes before any of them run, so
+    // the decision can't depend on how far the other lanes have got
+    for (uint8_t i=0; i<num_cores; i++) {
+        lane_threads.lane[i].allow_state_prediction = allowStatePrediction(i);
+    }
+
+    // times are taken from the host clock, as on SITL and Replay the
+    // simulated clock does not advance while the lanes run
+    const uint64_t start_ns = NavEKF_host_time_ns();
+    lane_threads.running = true;
+    for (uint8_t i=1; i<num_cores; i++) {
+        lane_threads.lane[i].start->signal();
+    }
+    core[0].UpdateFilter(lane_threads.lane[0].allow_state_prediction);
+    uint32_t total_run_time_us = uint32_t((NavEKF_host_time_ns() - start_ns) / 1000U);
+
+    // wait for all the other lanes to finish
+    for (uint8_t i=1; i<num_cores; i++) {
+        lane_threads.lane[i].done->wait_blocking();
+        total_run_time_us += lane_threads.lane[i].run_time_us;
+    }
+    lane_threads.running = false;
+    const uint32_t elapsed_us = uint32_t((NavEKF_host_time_ns() - start_ns) / 1000U);
+
+    // publish any newly set origin, shared state changes and log
+    // messages in lane order, so the lowest lane to set an origin this
+    // frame is the one used by all lanes and logs replay the same way
+    for (uint8_t i=0; i<num_cores; i++) {
+        core[i].publishDeferred();
+    }
+
+    if (total_run_time_us > elapsed_us) {
+        dal.ekf_parallel_time_saved(total_run_time_us - elapsed_us);
+    }
+
+    return true;
+}
+
+#endif  // EK3_FEATURE_LANE_THREADS
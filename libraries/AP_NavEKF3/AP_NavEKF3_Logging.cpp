@@ -443,7 +443,70 @@ void NavEKF3_core::Log_Write_Timing(uint64_t time_us)
     memset(&timing, 0, sizeof(timing));
 
     AP::logger().WriteBlock(&xkt, sizeof(xkt));
+
+#if EK3_FEATURE_STEP_TIMING
+    Log_Write_StepTiming(time_us);
+#endif
+}
+
+#if EK3_FEATURE_STEP_TIMING
+const char *EK3_StepTiming::name(EK3_TimedStep s)
+{
+    switch (s) {
+    case EK3_TimedStep::UpdateFilter:
+        return "UpdateFilter";
+    case EK3_TimedStep::CovariancePrediction:
+        return "CovariancePrediction";
+    case EK3_TimedStep::FuseVelPosNED:
+        return "FuseVelPosNED";
+    case EK3_TimedStep::FuseMagnetometer:
+        return "FuseMagnetometer";
+    case EK3_TimedStep::FuseOptFlow:
+        return "FuseOptFlow";
+    case EK3_TimedStep::FuseAirspeed:
+        return "FuseAirspeed";
+    case EK3_TimedStep::FuseDragForces:
+        return "FuseDragForces";
+    case EK3_TimedStep::FuseRngBcn:
+        return "FuseRngBcn";
+    case EK3_TimedStep::COUNT:
+        break;
+    }
+    return "";
+}
+
+/*
+  log the time spent in each step since the last XKTS message, as
+  microseconds per IMU sample
+ */
+void NavEKF3_core::Log_Write_StepTiming(uint64_t time_us)
+{
+    float step_us[uint8_t(EK3_TimedStep::COUNT)];
+    const uint64_t samples = stepTiming.step[uint8_t(EK3_TimedStep::UpdateFilter)].calls -
+        stepTimingLogged.step[uint8_t(EK3_TimedStep::UpdateFilter)].calls;
+    for (uint8_t i=0; i<ARRAY_SIZE(step_us); i++) {
+        const uint64_t dt_ns = stepTiming.step[i].total_ns - stepTimingLogged.step[i].total_ns;
+        step_us[i] = samples > 0 ? dt_ns * 1.0e-3 / samples : 0;
+    }
+    stepTimingLogged = stepTiming;
+
+    const struct log_XKTS xkts{
+        LOG_PACKET_HEADER_INIT(LOG_XKTS_MSG),
+        time_us      : time_us,
+        core         : core_index,
+        samples      : uint32_t(samples),
+        update_us    : step_us[uint8_t(EK3_TimedStep::UpdateFilter)],
+        cov_pred_us  : step_us[uint8_t(EK3_TimedStep::CovariancePrediction)],
+        velpos_us    : step_us[uint8_t(EK3_TimedStep::FuseVelPosNED)],
+        mag_us       : step_us[uint8_t(EK3_TimedStep::FuseMagnetometer)],
+        flow_us      : step_us[uint8_t(EK3_TimedStep::FuseOptFlow)],
+        airspeed_us  : step_us[uint8_t(EK3_TimedStep::FuseAirspeed)],
+        drag_us      : step_us[uint8_t(EK3_TimedStep::FuseDragForces)],
+        rngbcn_us    : step_us[uint8_t(EK3_TimedStep::FuseRngBcn)],
+    };
+    AP::logger().WriteBlock(&xkts, sizeof(xkts));
 }
+#endif  // EK3_FEATURE_STEP_TIMING
 
 void NavEKF3_core::Log_Write_GSF(uint64_t time_us)
 {
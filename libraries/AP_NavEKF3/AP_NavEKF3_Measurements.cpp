@@ -1454,7 +1454,12 @@ void NavEKF3_core::updateMovementCheck(void)
             gyro_diff_ratio    : float(gyro_diff_ratio),
             accel_diff_ratio   : float(accel_diff_ratio),
         };
-        AP::logger().WriteBlock(&pkt, sizeof(pkt));
+        if (frontend->laneThreadsRunning()) {
+            deferred.xkfm = pkt;
+            deferred.xkfm_pending = true;
+        } else {
+            AP::logger().WriteBlock(&pkt, sizeof(pkt));
+        }
 #endif
     }
 }
@@ -1512,9 +1517,9 @@ void NavEKF3_core::SampleDragData(const imu_elements &imu)
  */
 void NavEKF3_core::getEarthFieldTable(const Location &loc)
 {
-    table_earth_field_ga = AP_Declination::get_earth_field_ga(loc).toftype();
-    table_declination = radians(AP_Declination::get_declination(loc.lat*1.0e-7,
-                                                                loc.lng*1.0e-7));
+    table_earth_field_ga = earth_field_model.get_earth_field_ga(loc).toftype();
+    table_declination = radians(earth_field_model.get_declination(loc.lat*1.0e-7,
+                                                                  loc.lng*1.0e-7));
     have_table_earth_field = true;
 }
 
@@ -693,6 +693,8 @@ void NavEKF3_core::SelectVelPosFusion()
 // fuse selected position, velocity and height measurements
 void NavEKF3_core::FuseVelPosNED()
 {
+    EK3_TIME_STEP(FuseVelPosNED);
+
     // declare variables used to control access to arrays
     bool fuseData[6] {};
     uint8_t stateIndex;
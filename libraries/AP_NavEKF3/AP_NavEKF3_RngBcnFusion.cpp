@@ -94,6 +94,8 @@ void NavEKF3_core::SelectRngBcnFusion()
 
 void NavEKF3_core::FuseRngBcn()
 {
+    EK3_TIME_STEP(FuseRngBcn);
+
     // declarations
     ftype pn;
     ftype pe;
@@ -0,0 +1,83 @@
+/*
+  per-step timing counters for EKF3
+
+  Each timed step adds the time spent in it to a per-lane total. The
+  totals are never reset, so callers take differences between two
+  reads to get the time spent over an interval.
+ */
+#pragma once
+
+#include "AP_NavEKF3_feature.h"
+
+#if EK3_FEATURE_STEP_TIMING
+
+#include <stdint.h>
+#include <AP_HAL/AP_HAL.h>
+#include <AP_NavEKF/AP_NavEKF_core_common.h>
+
+// steps of the filter with their own counters. UpdateFilter covers
+// the whole update of a lane for one IMU sample
+enum class EK3_TimedStep : uint8_t {
+    UpdateFilter = 0,
+    CovariancePrediction,
+    FuseVelPosNED,
+    FuseMagnetometer,
+    FuseOptFlow,
+    FuseAirspeed,
+    FuseDragForces,
+    FuseRngBcn,
+    COUNT
+};
+
+struct EK3_StepTiming {
+    struct {
+        uint64_t calls;
+        uint64_t total_ns;
+        uint32_t max_ns;
+    } step[uint8_t(EK3_TimedStep::COUNT)];
+
+    // name of a step, as used in benchmark output
+    static const char *name(EK3_TimedStep s);
+
+    // monotonic timestamp in nanoseconds, see NavEKF_host_time_ns()
+    static uint64_t now_ns(void) {
+        return NavEKF_host_time_ns();
+    }
+
+    void record(EK3_TimedStep s, uint32_t dt_ns) {
+        auto &st = step[uint8_t(s)];
+        st.calls++;
+        st.total_ns += dt_ns;
+        if (dt_ns > st.max_ns) {
+            st.max_ns = dt_ns;
+        }
+    }
+};
+
+/*
+  time the rest of the enclosing scope as one call of a step
+ */
+class EK3_StepTimer {
+public:
+    EK3_StepTimer(EK3_StepTiming &_timing, EK3_TimedStep _s) :
+        timing(_timing),
+        s(_s),
+        start_ns(EK3_StepTiming::now_ns()) {}
+
+    ~EK3_StepTimer() {
+        timing.record(s, uint32_t(EK3_StepTiming::now_ns() - start_ns));
+    }
+
+    CLASS_NO_COPY(EK3_StepTimer);
+
+private:
+    EK3_StepTiming &timing;
+    const EK3_TimedStep s;
+    const uint64_t start_ns;
+};
+
+#define EK3_TIME_STEP(step) EK3_StepTimer _step_timer(stepTiming, EK3_TimedStep::step)
+
+#else
+#define EK3_TIME_STEP(step)
+#endif  // EK3_FEATURE_STEP_TIMING
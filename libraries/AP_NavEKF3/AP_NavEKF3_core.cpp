@@ -280,6 +280,8 @@ void NavEKF3_core::InitialiseVariables()
     inhibitDelAngBiasStates = true;
     gndOffsetValid =  false;
     validOrigin = false;
+    originPublishPending = false;
+    memset(&deferred, 0, sizeof(deferred));
     gpsSpdAccuracy = 0.0f;
     gpsPosAccuracy = 0.0f;
     gpsHgtAccuracy = 0.0f;
@@ -631,6 +633,8 @@ void NavEKF3_core::UpdateFilter(bool predict)
         return;
     }
 
+    EK3_TIME_STEP(UpdateFilter);
+
     fill_scratch_variables();
 
     // update sensor selection (for affinity)
@@ -899,7 +903,11 @@ void NavEKF3_core::calcOutputStates()
     if (!inFlight && !dal.get_takeoff_expected() && assume_zero_sideslip()) {
         const ftype launchDelVel = imuDataNew.delVel.x + GRAVITY_MSS * imuDataNew.delVelDT * Tbn_temp.c.x;
         if (launchDelVel > GRAVITY_MSS * imuDataNew.delVelDT) {
-            dal.set_takeoff_expected();
+            if (frontend->laneThreadsRunning()) {
+                deferred.takeoff_expected = true;
+            } else {
+                dal.set_takeoff_expected();
+            }
         }
     }
 
@@ -1009,6 +1017,8 @@ void NavEKF3_core::calcOutputStates()
 */
 void NavEKF3_core::CovariancePrediction(Vector3F *rotVarVecPtr)
 {
+    EK3_TIME_STEP(CovariancePrediction);
+
     ftype daxVar;       // X axis delta angle noise variance rad^2
     ftype dayVar;       // Y axis delta angle noise variance rad^2
     ftype dazVar;       // Z axis delta angle noise variance rad^2
@@ -2247,7 +2257,12 @@ void NavEKF3_core::verifyTiltErrorVariance()
             tvs          : float(tiltErrorVariance),
             tvd          : float(tiltErrorVarianceAlt),
         };
-        AP::logger().WriteBlock(&msg, sizeof(msg));
+        if (frontend->laneThreadsRunning()) {
+            deferred.xktv = msg;
+            deferred.xktv_pending = true;
+        } else {
+            AP::logger().WriteBlock(&msg, sizeof(msg));
+        }
     }
 #endif  // HAL_LOGGING_ENABLED
 }
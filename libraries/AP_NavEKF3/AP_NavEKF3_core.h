@@ -25,7 +25,9 @@
 #endif
 
 #include "AP_NavEKF3_feature.h"
+#include "AP_NavEKF3_StepTiming.h"
 #include <AP_Common/Location.h>
+#include <AP_Declination/AP_Declination.h>
 #include <AP_Math/AP_Math.h>
 #include <AP_Math/vectorN.h>
 #include <AP_NavEKF/AP_NavEKF_core_common.h>
@@ -33,6 +35,7 @@
 #include <AP_NavEKF/EKF_Buffer.h>
 #include <AP_InertialSensor/AP_InertialSensor.h>
 #include <AP_RangeFinder/AP_RangeFinder.h>
+#include <AP_Logger/LogStructure.h>
 
 #include "AP_NavEKF/EKFGSF_yaw.h"
 
@@ -230,6 +233,16 @@ public:
     // returns false if the origin has already been set
     bool setOriginLLH(const Location &loc);
 
+    // copy a newly set origin to the frontend if no lane has done so
+    // already. Called by the frontend once lanes updated in parallel
+    // have finished
+    void publishOrigin();
+
+    // apply changes to shared state and write log messages held back
+    // while lanes were updated in parallel, including any new origin.
+    // Called by the frontend in lane order once all lanes have finished
+    void publishDeferred();
+
     // Set the EKF's NE horizontal position states and their corresponding variances from a supplied WGS-84 location and uncertainty
     // The altitude element of the location is not used.
     // Returns true if the set was successful
@@ -464,6 +477,11 @@ public:
     // get a yaw estimator instance
     const EKFGSF_yaw *get_yawEstimator(void) const { return yawEstimator; }
 
+#if EK3_FEATURE_STEP_TIMING
+    // get the accumulated time spent in each step of the filter
+    const EK3_StepTiming &getStepTiming(void) const { return stepTiming; }
+#endif
+
     // per-core pre-arm checks. returns false if we fail arming
     // checks, in which case the buffer will be populated with a
     // failure message
@@ -1157,6 +1175,19 @@ private:
     Location EKF_origin;     // LLH origin of the NED axis system, internal only
     Location &public_origin; // LLH origin of the NED axis system, public functions
     bool validOrigin;               // true when the EKF origin is valid
+    bool originPublishPending;      // true when the origin has been set but not yet copied to the frontend
+
+    // changes to shared state and log messages held back while lanes
+    // are updated in parallel, applied by publishDeferred()
+    struct {
+        bool takeoff_expected;      // true when a launch has been detected
+#if HAL_LOGGING_ENABLED
+        bool xktv_pending;          // true when xktv is waiting to be written
+        bool xkfm_pending;          // true when xkfm is waiting to be written
+        struct log_XKTV xktv;
+        struct log_XKFM xkfm;
+#endif
+    } deferred;
     ftype gpsSpdAccuracy;           // estimated speed accuracy in m/s returned by the GPS receiver
     ftype gpsPosAccuracy;           // estimated position accuracy in m returned by the GPS receiver
     ftype gpsHgtAccuracy;           // estimated height accuracy in m returned by the GPS receiver
@@ -1545,6 +1576,7 @@ private:
     bool have_table_earth_field;   // true when we have initialised table_earth_field_ga
     Vector3F table_earth_field_ga; // earth field from WMM tables
     ftype table_declination;       // declination in radians from the tables
+    AP_Declination::LocalField earth_field_model; // tables for the area around the vehicle
 
     // 1Hz update
     uint32_t last_oneHz_ms;
@@ -1560,6 +1592,12 @@ private:
     // timing statistics
     struct ekf_timing timing;
 
+#if EK3_FEATURE_STEP_TIMING
+    // time spent in each step, and the values when last logged
+    EK3_StepTiming stepTiming;
+    EK3_StepTiming stepTimingLogged;
+#endif
+
     // when was attitude filter status last non-zero?
     uint32_t last_filter_ok_ms;
     
@@ -1644,5 +1682,8 @@ private:
     void Log_Write_BodyOdom(uint64_t time_us);
     void Log_Write_State_Variances(uint64_t time_us);
     void Log_Write_Timing(uint64_t time_us);
+#if EK3_FEATURE_STEP_TIMING
+    void Log_Write_StepTiming(uint64_t time_us);
+#endif
     void Log_Write_GSF(uint64_t time_us);
 };
@@ -46,3 +46,16 @@
 #ifndef EK3_FEATURE_OPTFLOW_FUSION
 #define EK3_FEATURE_OPTFLOW_FUSION HAL_NAVEKF3_AVAILABLE && AP_OPTICALFLOW_ENABLED
 #endif
+
+// option to run lanes in parallel on worker threads, on boards with
+// enough CPU cores
+#ifndef EK3_FEATURE_LANE_THREADS
+#define EK3_FEATURE_LANE_THREADS (CONFIG_HAL_BOARD == HAL_BOARD_SITL || CONFIG_HAL_BOARD == HAL_BOARD_LINUX)
+#endif
+
+// per-step timing counters, logged in XKTS and used by Replay
+// benchmarking. Off by default on vehicles as the timer calls add to
+// the cost of every step
+#ifndef EK3_FEATURE_STEP_TIMING
+#define EK3_FEATURE_STEP_TIMING (CONFIG_HAL_BOARD == HAL_BOARD_SITL)
+#endif
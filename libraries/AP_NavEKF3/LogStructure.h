@@ -15,6 +15,7 @@
     LOG_XKFS_MSG, \
     LOG_XKQ_MSG,  \
     LOG_XKT_MSG,  \
+    LOG_XKTS_MSG, \
     LOG_XKTV_MSG, \
     LOG_XKV1_MSG, \
     LOG_XKV2_MSG, \
@@ -297,6 +298,35 @@ struct PACKED log_XKT {
 };
 
 
+// @LoggerMessage: XKTS
+// @Description: EKF3 time spent in each step, averaged per IMU sample over the interval since the last message
+// @Field: TimeUS: Time since system startup
+// @Field: C: EKF core this message instance applies to
+// @Field: N: number of IMU samples processed in this interval
+// @Field: UF: total time to update the core
+// @Field: CP: time in covariance prediction
+// @Field: VP: time in velocity and position fusion
+// @Field: MF: time in magnetometer fusion
+// @Field: OF: time in optical flow fusion
+// @Field: AS: time in airspeed fusion
+// @Field: DF: time in drag fusion
+// @Field: RB: time in range beacon fusion
+struct PACKED log_XKTS {
+    LOG_PACKET_HEADER;
+    uint64_t time_us;
+    uint8_t core;
+    uint32_t samples;
+    float update_us;
+    float cov_pred_us;
+    float velpos_us;
+    float mag_us;
+    float flow_us;
+    float airspeed_us;
+    float drag_us;
+    float rngbcn_us;
+};
+
+
 // @LoggerMessage: XKFM
 // @Description: EKF3 diagnostic data for on-ground-and-not-moving check
 // @Field: TimeUS: Time since system startup
@@ -451,6 +481,8 @@ struct PACKED log_XKV {
     { LOG_XKQ_MSG, sizeof(log_XKQ), "XKQ", "QBffff", "TimeUS,C,Q1,Q2,Q3,Q4", "s#????", "F-????" , true }, \
     { LOG_XKT_MSG, sizeof(log_XKT),   \
       "XKT", "QBIffffffff", "TimeUS,C,Cnt,IMUMin,IMUMax,EKFMin,EKFMax,AngMin,AngMax,VMin,VMax", "s#sssssssss", "F-000000000", true }, \
+    { LOG_XKTS_MSG, sizeof(log_XKTS),   \
+      "XKTS", "QBIffffffff", "TimeUS,C,N,UF,CP,VP,MF,OF,AS,DF,RB", "s#-ssssssss", "F--FFFFFFFF", true }, \
     { LOG_XKTV_MSG, sizeof(log_XKTV),                         \
       "XKTV", "QBff", "TimeUS,C,TVS,TVD", "s#rr", "F-00", true }, \
     { LOG_XKV1_MSG, sizeof(log_XKV), \
@@ -251,6 +251,9 @@ void AP_Networking::update()
     }
     backend->update();
     announce_address_changes();
+#if AP_NETWORKING_REGISTER_PORT_ENABLED && HAL_LOGGING_ENABLED
+    ports_log();
+#endif
 }
 
 uint32_t AP_Networking::convert_netmask_bitcount_to_ip(const uint32_t netmask_bitcount)
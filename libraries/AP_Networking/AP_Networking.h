@@ -11,6 +11,7 @@
 #include "AP_Networking_CAN.h"
 #include <AP_SerialManager/AP_SerialManager.h>
 #include <AP_HAL/utility/RingBuffer.h>
+#include <AP_Logger/AP_Logger_config.h>
 
 /*
   Note! all uint32_t IPv4 addresses are in host byte order
@@ -243,6 +244,7 @@ private:
         AP_Enum<NetworkPortType> type;
         AP_Networking_IPV4 ip {"0.0.0.0"};
         AP_Int32 port;
+        AP_Int8 coalesce_ms;
         SocketAPM *sock;
         SocketAPM *listen_sock;
 
@@ -265,7 +267,14 @@ private:
 
         bool send_receive(void);
 
+#if HAL_LOGGING_ENABLED
+        void log_stats(void);
+#endif
+
     private:
+        bool receive_data(void);
+        bool send_data(void);
+
         bool init_buffers(const uint32_t size_rx, const uint32_t size_tx);
         void thread_create(AP_HAL::MemberProc);
 
@@ -297,9 +306,36 @@ private:
         bool close_on_recv_error;
         uint32_t last_udp_srv_recv_time_ms;
 
+        // time the oldest byte in writebuffer was written
+        uint32_t tx_first_write_us;
+
+        // buffer for received datagrams before they go in readbuffer
+        uint8_t *rx_scratch;
+
+        // buffer for packets taken from writebuffer while they are sent
+        uint8_t *tx_scratch;
+
         // statistics
         uint32_t tx_stats_bytes;
         uint32_t rx_stats_bytes;
+        uint32_t tx_stats_packets;
+        uint32_t rx_stats_packets;
+        uint32_t tx_stats_syscalls;
+        // sum and maximum of the time the oldest byte in each send
+        // was held before sending
+        uint32_t tx_stats_delay_sum_us;
+        uint32_t tx_stats_delay_max_us;
+#if HAL_LOGGING_ENABLED
+        struct {
+            uint32_t tx_bytes;
+            uint32_t rx_bytes;
+            uint32_t tx_packets;
+            uint32_t rx_packets;
+            uint32_t tx_syscalls;
+            uint32_t tx_delay_sum_us;
+            uint32_t time_ms;
+        } last_log;
+#endif
 
         HAL_Semaphore sem;
 
@@ -353,6 +389,10 @@ private:
     bool sendfile_thread_started;
 
     void ports_init(void);
+#if AP_NETWORKING_REGISTER_PORT_ENABLED && HAL_LOGGING_ENABLED
+    void ports_log(void);
+    uint32_t ports_log_ms;
+#endif
 };
 
 namespace AP
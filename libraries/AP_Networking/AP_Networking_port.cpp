@@ -13,6 +13,7 @@
 #include <AP_Math/AP_Math.h>
 #include <AP_SerialManager/AP_SerialManager.h>
 #include <AP_HAL/utility/packetise.h>
+#include <AP_Logger/AP_Logger.h>
 #include <errno.h>
 
 extern const AP_HAL::HAL& hal;
@@ -29,6 +30,33 @@ extern const AP_HAL::HAL& hal;
 #define AP_NETWORKING_PORT_STACK_SIZE 1024
 #endif
 
+// largest UDP payload in a 1500 byte ethernet frame
+#ifndef AP_NETWORKING_PORT_MTU
+#define AP_NETWORKING_PORT_MTU 1472
+#endif
+
+// largest send and receive when not coalescing
+#define AP_NETWORKING_PORT_CHUNK 300U
+
+// number of packets sent or received with one call
+#ifndef AP_NETWORKING_PORT_MAX_BATCH
+#if AP_NETWORKING_NEED_LWIP
+#define AP_NETWORKING_PORT_MAX_BATCH 1
+#else
+#define AP_NETWORKING_PORT_MAX_BATCH 4
+#endif
+#endif
+
+#if AP_NETWORKING_PORT_MAX_BATCH > 1
+#define AP_NETWORKING_PORT_RX_SCRATCH (AP_NETWORKING_PORT_MAX_BATCH*AP_NETWORKING_PORT_MTU)
+#else
+#define AP_NETWORKING_PORT_RX_SCRATCH AP_NETWORKING_PORT_CHUNK
+#endif
+
+// outgoing packets are copied here so the socket is written without
+// holding the port semaphore
+#define AP_NETWORKING_PORT_TX_SCRATCH (AP_NETWORKING_PORT_MAX_BATCH*AP_NETWORKING_PORT_MTU)
+
 const AP_Param::GroupInfo AP_Networking::Port::var_info[] = {
     // @Param: TYPE
     // @DisplayName: Port type
@@ -58,6 +86,15 @@ const AP_Param::GroupInfo AP_Networking::Port::var_info[] = {
     // @RebootRequired: True
     // @User: Advanced
     AP_GROUPINFO("PORT", 4,  AP_Networking::Port, port, 0),
+
+    // @Param: COALESCE
+    // @DisplayName: Transmit coalescing time
+    // @Description: Maximum time to hold outgoing data so that small writes are combined into full sized packets. With MAVLink packets are only combined on MAVLink message boundaries. Zero sends data as soon as it is written.
+    // @Units: ms
+    // @Range: 0 50
+    // @RebootRequired: True
+    // @User: Advanced
+    AP_GROUPINFO("COALESCE", 5,  AP_Networking::Port, coalesce_ms, 0),
     
     AP_GROUPEND
 };
@@ -314,41 +351,178 @@ void AP_Networking::Port::tcp_client_loop(void)
 }
 
 /*
-  run one send/receive loop
+  receive into readbuffer
  */
-bool AP_Networking::Port::send_receive(void)
+bool AP_Networking::Port::receive_data(void)
 {
-
-    bool active = false;
     uint32_t space;
-
-
-    // handle incoming packets
     {
         WITH_SEMAPHORE(sem);
         space = readbuffer->space();
     }
-    if (space > 0) {
-        const uint32_t n = MIN(300U, space);
-        uint8_t buf[n];
-        const auto ret = sock->recv(buf, n, 0);
-        if (close_on_recv_error && ret == 0) {
-            GCS_SEND_TEXT(MAV_SEVERITY_INFO, "TCP[%u]: closed connection", unsigned(state.idx));
-            delete sock;
-            sock = nullptr;
+    if (space == 0) {
+        return false;
+    }
+    uint8_t count;
+    const auto ret = sock->recv_datagrams(rx_scratch, MIN(uint32_t(AP_NETWORKING_PORT_RX_SCRATCH), space),
+                                          AP_NETWORKING_PORT_MTU, AP_NETWORKING_PORT_MAX_BATCH, count);
+    if (close_on_recv_error && ret == 0) {
+        GCS_SEND_TEXT(MAV_SEVERITY_INFO, "TCP[%u]: closed connection", unsigned(state.idx));
+        delete sock;
+        sock = nullptr;
+        return false;
+    }
+    if (ret <= 0) {
+        return false;
+    }
+
+    WITH_SEMAPHORE(sem);
+    readbuffer->write(rx_scratch, ret);
+
+    // Cant track dropped read packets because we only read in what there is space for
+    // The socket buffer becomes full and data is lost there
+    rx_stats_bytes += ret;
+    rx_stats_packets += count;
+
+    have_received = true;
+    return true;
+}
+
+/*
+  send from writebuffer. The packets are copied out with the semaphore
+  held, and the semaphore is released while the socket is written so
+  writers are not held up by the send
+ */
+bool AP_Networking::Port::send_data(void)
+{
+    SocketAPM::Datagram dgrams[AP_NETWORKING_PORT_MAX_BATCH];
+    uint8_t count = 0;
+    uint32_t held_us;
+    {
+        WITH_SEMAPHORE(sem);
+
+        const uint32_t available = writebuffer->available();
+        if (available == 0) {
+            return false;
+        }
+
+        const uint32_t now_us = AP_HAL::micros();
+        held_us = now_us - tx_first_write_us;
+        const bool coalesce = coalesce_ms > 0;
+        if (coalesce && available < AP_NETWORKING_PORT_MTU && held_us < uint32_t(coalesce_ms)*1000U) {
+            // wait for a full packet or the deadline
             return false;
         }
-        if (ret > 0) {
-            WITH_SEMAPHORE(sem);
-            readbuffer->write(buf, ret);
 
-            // Cant track dropped read packets because we only read in what there is space for
-            // The socket buffer becomes full and data is lost there
-            rx_stats_bytes += ret;
+        ByteBuffer::IoVec vec[2];
+        const uint8_t num_vec = writebuffer->peekiovec(vec, available);
+        if (num_vec == 0) {
+            return false;
+        }
+
+        // split the buffer into packets, copying each into tx_scratch
+        // from the one or two parts of the ring buffer
+        const uint32_t max_len = coalesce ? AP_NETWORKING_PORT_MTU : AP_NETWORKING_PORT_CHUNK;
+        uint32_t ofs = 0;
+        while (count < ARRAY_SIZE(dgrams) && ofs < available) {
+            uint32_t len = MIN(max_len, available - ofs);
+#if AP_MAVLINK_PACKETISE_ENABLED
+            if (packetise) {
+                // only send whole MAVLink packets, combining them if coalescing
+                uint32_t plen = 0;
+                while (plen < len) {
+                    const uint16_t n = mavlink_packetise(*writebuffer, len - plen, ofs + plen);
+                    if (n == 0) {
+                        break;
+                    }
+                    plen += n;
+                    if (!coalesce) {
+                        break;
+                    }
+                }
+                len = plen;
+            }
+#endif
+            if (len == 0) {
+                break;
+            }
+            uint8_t *data = &tx_scratch[count * AP_NETWORKING_PORT_MTU];
+            uint32_t vofs = ofs;
+            uint32_t copied = 0;
+            for (uint8_t i=0; i<num_vec && copied < len; i++) {
+                if (vofs >= vec[i].len) {
+                    vofs -= vec[i].len;
+                    continue;
+                }
+                const uint32_t n = MIN(len - copied, vec[i].len - vofs);
+                memcpy(&data[copied], vec[i].data + vofs, n);
+                copied += n;
+                vofs = 0;
+            }
+            auto &d = dgrams[count++];
+            d.vec[0].data = data;
+            d.vec[0].len = len;
+            d.num_vec = 1;
+            ofs += len;
+            if (type == NetworkPortType::TCP_CLIENT || type == NetworkPortType::TCP_SERVER) {
+                // packet boundaries don't matter on a stream
+                break;
+            }
+        }
+    }
+    if (count == 0) {
+        return false;
+    }
+
+    ssize_t ret = -1;
+    if (type == NetworkPortType::UDP_SERVER) {
+        // UDP Server uses sendto, allowing us to change the destination address port on the fly
+        if (last_udp_connect_address != 0 && last_udp_connect_port != 0) {
+            ret = sock->send_datagrams(dgrams, count, last_udp_connect_address, last_udp_connect_port);
+        }
+    } else {
+        // TCP Server and Client and UDP Client use the connected address
+        ret = sock->send_datagrams(dgrams, count);
+    }
 
-            active = true;
-            have_received = true;
+    if (ret > 0) {
+        WITH_SEMAPHORE(sem);
+        writebuffer->advance(ret);
+        tx_stats_bytes += ret;
+        tx_stats_syscalls++;
+        // count the packets that were completely sent
+        uint32_t sent = 0;
+        for (uint8_t i=0; i<count; i++) {
+            sent += dgrams[i].vec[0].len;
+            if (sent > uint32_t(ret)) {
+                break;
+            }
+            tx_stats_packets++;
         }
+        tx_stats_delay_sum_us += held_us;
+        tx_stats_delay_max_us = MAX(tx_stats_delay_max_us, held_us);
+        return true;
+    }
+    if (errno == ENOTCONN &&
+        (type == NetworkPortType::TCP_CLIENT || type == NetworkPortType::TCP_SERVER)) {
+        // close socket and mark as disconnected, so we can reconnect with another client or when server comes back
+        GCS_SEND_TEXT(MAV_SEVERITY_INFO, "TCP[%u]: disconnected", unsigned(state.idx));
+        sock->close();
+        delete sock;
+        sock = nullptr;
+        connected = false;
+    }
+    return false;
+}
+
+/*
+  run one send/receive loop
+ */
+bool AP_Networking::Port::send_receive(void)
+{
+    bool active = receive_data();
+    if (sock == nullptr) {
+        return false;
     }
 
     if (type == NetworkPortType::UDP_SERVER && have_received) {
@@ -375,64 +549,85 @@ bool AP_Networking::Port::send_receive(void)
         }
     }
 
-    if (connected) {
-        // handle outgoing packets
-        uint32_t available;
-
-        {
-            WITH_SEMAPHORE(sem);
-            available = writebuffer->available();
-            available = MIN(300U, available);
-#if AP_MAVLINK_PACKETISE_ENABLED
-            if (packetise) {
-                available = mavlink_packetise(*writebuffer, available);
-            }
-#endif
-            if (available == 0) {
-                return active;
-            }
-        }
-        uint8_t buf[available];
-        uint32_t n;
-        {
-            WITH_SEMAPHORE(sem);
-            n = writebuffer->peekbytes(buf, available);
-        }
+    if (connected && send_data()) {
+        active = true;
+    }
 
-        // nothing to send return
-        if (n <= 0) {
-            return active;
-        }
+    return active;
+}
 
-        ssize_t ret = -1;
-        if (type == NetworkPortType::UDP_SERVER) {
-            // UDP Server uses sendto, allowing us to change the destination address port on the fly
-            if(last_udp_connect_address != 0 && last_udp_connect_port != 0) {
-                ret = sock->sendto(buf, n, last_udp_connect_address, last_udp_connect_port);
-            }
-        } else {
-            // TCP Server and Client and UDP Client use send
-            ret = sock->send(buf, n);
-        }
+#if HAL_LOGGING_ENABLED
+/*
+  log port statistics, called at 1Hz
+ */
+void AP_Networking::Port::log_stats(void)
+{
+    const uint32_t now_ms = AP_HAL::millis();
+    const uint32_t dt_ms = now_ms - last_log.time_ms;
+    if (dt_ms == 0) {
+        return;
+    }
+    const uint32_t tx_bytes = tx_stats_bytes - last_log.tx_bytes;
+    const uint32_t rx_bytes = rx_stats_bytes - last_log.rx_bytes;
+    const uint32_t tx_packets = tx_stats_packets - last_log.tx_packets;
+    const uint32_t rx_packets = rx_stats_packets - last_log.rx_packets;
+    const uint32_t tx_syscalls = tx_stats_syscalls - last_log.tx_syscalls;
+    const uint32_t tx_delay_sum_us = tx_stats_delay_sum_us - last_log.tx_delay_sum_us;
+    const uint32_t tx_delay_max_us = tx_stats_delay_max_us;
+    tx_stats_delay_max_us = 0;
+
+    last_log.tx_bytes += tx_bytes;
+    last_log.rx_bytes += rx_bytes;
+    last_log.tx_packets += tx_packets;
+    last_log.rx_packets += rx_packets;
+    last_log.tx_syscalls += tx_syscalls;
+    last_log.tx_delay_sum_us += tx_delay_sum_us;
+    last_log.time_ms = now_ms;
+
+// @LoggerMessage: NETP
+// @Description: Networked serial port packet statistics
+// @Field: TimeUS: Time since system startup
+// @Field: I: port instance
+// @Field: TxP: packets sent per second
+// @Field: TxB: average bytes per packet sent
+// @Field: TxC: send calls per second
+// @Field: RxP: packets received per second
+// @Field: RxB: average bytes per packet received
+// @Field: Dly: average time the oldest byte of a send was held
+// @Field: DlyM: maximum time the oldest byte of a send was held
+    AP::logger().WriteStreaming("NETP",
+                                "TimeUS,I,TxP,TxB,TxC,RxP,RxB,Dly,DlyM",
+                                "s#-------",
+                                "F--------",
+                                "QBfHfHfII",
+                                AP_HAL::micros64(),
+                                uint8_t(state.idx - AP_SERIALMANAGER_NET_PORT_1),
+                                tx_packets * 1000.0f / dt_ms,
+                                uint16_t(tx_packets ? tx_bytes / tx_packets : 0),
+                                tx_syscalls * 1000.0f / dt_ms,
+                                rx_packets * 1000.0f / dt_ms,
+                                uint16_t(rx_packets ? rx_bytes / rx_packets : 0),
+                                tx_syscalls ? tx_delay_sum_us / tx_syscalls : 0,
+                                tx_delay_max_us);
+}
 
-        if (ret > 0) {
-            WITH_SEMAPHORE(sem);
-            writebuffer->advance(ret);
-            tx_stats_bytes += ret;
-            active = true;
-        } else if (errno == ENOTCONN &&
-            (type == NetworkPortType::TCP_CLIENT || type == NetworkPortType::TCP_SERVER)) {
-            // close socket and mark as disconnected, so we can reconnect with another client or when server comes back
-            GCS_SEND_TEXT(MAV_SEVERITY_INFO, "TCP[%u]: disconnected", unsigned(state.idx));
-            sock->close();
-            delete sock;
-            sock = nullptr;
-            connected = false;
+/*
+  log statistics for active ports
+ */
+void AP_Networking::ports_log(void)
+{
+    const uint32_t now_ms = AP_HAL::millis();
+    if (now_ms - ports_log_ms < 1000) {
+        return;
+    }
+    ports_log_ms = now_ms;
+    for (auto &p : ports) {
+        if (p.sock != nullptr) {
+            p.log_stats();
         }
     }
-
-    return active;
 }
+#endif // HAL_LOGGING_ENABLED
 
 /*
   available space in outgoing buffer
@@ -453,6 +648,9 @@ void AP_Networking::Port::_begin(uint32_t b, uint16_t rxS, uint16_t txS)
 size_t AP_Networking::Port::_write(const uint8_t *buffer, size_t size)
 {
     WITH_SEMAPHORE(sem);
+    if (writebuffer->available() == 0) {
+        tx_first_write_us = AP_HAL::micros();
+    }
     return writebuffer->write(buffer, size);
 }
 
@@ -496,9 +694,15 @@ bool AP_Networking::Port::init_buffers(const uint32_t size_rx, const uint32_t si
     } else {
         writebuffer->set_size_best(size_tx);
     }
+    if (rx_scratch == nullptr) {
+        rx_scratch = NEW_NOTHROW uint8_t[AP_NETWORKING_PORT_RX_SCRATCH];
+    }
+    if (tx_scratch == nullptr) {
+        tx_scratch = NEW_NOTHROW uint8_t[AP_NETWORKING_PORT_TX_SCRATCH];
+    }
     last_size_rx = size_rx;
     last_size_tx = size_tx;
-    return readbuffer != nullptr && writebuffer != nullptr;
+    return readbuffer != nullptr && writebuffer != nullptr && rx_scratch != nullptr && tx_scratch != nullptr;
 }
 
 /*
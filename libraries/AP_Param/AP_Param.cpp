@@ -102,6 +102,7 @@ uint8_t AP_Param::_dynamic_table_sizes[AP_PARAM_MAX_DYNAMIC];
 uint16_t AP_Param::_parameter_count;
 uint16_t AP_Param::_count_marker;
 uint16_t AP_Param::_count_marker_done;
+uint32_t AP_Param::_change_marker;
 HAL_Semaphore AP_Param::_count_sem;
 
 // storage and naming information about all types that can be saved
@@ -1119,6 +1120,8 @@ AP_Param::find_object(const char *name)
 
 // notify GCS of current value of parameter
 void AP_Param::notify() const {
+    _change_marker++;
+
     uint32_t group_element = 0;
     const struct GroupInfo *ginfo;
     struct GroupNesting group_nesting {};
@@ -1149,6 +1152,8 @@ void AP_Param::notify() const {
 */
 void AP_Param::save_sync(bool force_save, bool send_to_gcs)
 {
+    _change_marker++;
+
     uint32_t group_element = 0;
     const struct GroupInfo *ginfo;
     struct GroupNesting group_nesting {};
@@ -1260,6 +1265,8 @@ void AP_Param::save_sync(bool force_save, bool send_to_gcs)
 */
 void AP_Param::save(bool force_save)
 {
+    _change_marker++;
+
     struct param_save p, p2;
     p.param = this;
     p.force_save = force_save;
@@ -2249,6 +2256,7 @@ void AP_Param::set_float(float value, enum ap_var_type var_type)
     if (isnan(value) || isinf(value)) {
         return;
     }
+    _change_marker++;
 
     // add a small amount before casting parameter values
     // from float to integer to avoid truncating to the
@@ -2730,6 +2738,7 @@ void AP_Param::invalidate_count(void)
     // not-equal test is strong enough to ensure we get the right
     // answer
     _count_marker++;
+    _change_marker++;
 }
 
 /*
@@ -579,6 +579,11 @@ public:
     // invalidate parameter count
     static void invalidate_count(void);
 
+    // marker which changes whenever a parameter is set, saved or
+    // notified through AP_Param, or the parameter tree changes. Used
+    // to invalidate cached copies of parameter values
+    static uint32_t get_change_marker(void) { return _change_marker; }
+
     static void set_hide_disabled_groups(bool value) { _hide_disabled_groups = value; }
 
     // set frame type flags. Used to unhide frame specific parameters
@@ -816,6 +821,7 @@ private:
     static uint16_t             _parameter_count;
     static uint16_t             _count_marker;
     static uint16_t             _count_marker_done;
+    static uint32_t             _change_marker;
     static HAL_Semaphore        _count_sem;
     static const struct Info *  _var_info;
 
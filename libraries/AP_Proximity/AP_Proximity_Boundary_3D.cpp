@@ -38,6 +38,7 @@ void AP_Proximity_Boundary_3D::init()
             _sector_edge_vector[layer][sector].offset_bearing(angle_rad, pitch, 100.0f);
             _boundary_points[layer][sector] = _sector_edge_vector[layer][sector] * PROXIMITY_BOUNDARY_DIST_DEFAULT;
         }
+        _obstacle_vector_stale[layer] = 0xFF;
     }
 }
 
@@ -64,7 +65,7 @@ void AP_Proximity_Boundary_3D::set_face_attributes(const Face &face, float pitch
     }
 
     // ignore update if another instance has provided a shorter distance within the last 0.2 seconds
-    if ((prx_instance != _prx_instance[face.layer][face.sector]) && _distance_valid[face.layer][face.sector] && (_filtered_distance[face.layer][face.sector].get() < distance)) {
+    if ((prx_instance != _prx_instance[face.layer][face.sector]) && distance_valid(face.layer, face.sector) && (_filtered_distance[face.layer][face.sector].get() < distance)) {
         // check if recent
         const uint32_t now_ms = AP_HAL::millis();
         if (now_ms - _last_update_ms[face.layer][face.sector] < PROXIMITY_FACE_RESET_MS) {
@@ -72,12 +73,19 @@ void AP_Proximity_Boundary_3D::set_face_attributes(const Face &face, float pitch
         }
     }
 
+    // must be done before the distance is changed
+    const bool closest_changed = update_closest_object(face, distance);
+
     _angle[face.layer][face.sector] = angle;
     _pitch[face.layer][face.sector] = pitch;
     _distance[face.layer][face.sector] = distance;
-    _distance_valid[face.layer][face.sector] = true;
+    set_distance_valid(face, true);
     _prx_instance[face.layer][face.sector] = prx_instance;
 
+    if (closest_changed) {
+        find_closest_object();
+    }
+
     // apply filter
     set_filtered_distance(face, distance);
 
@@ -135,39 +143,43 @@ void AP_Proximity_Boundary_3D::update_boundary(const Face &face)
 
     // boundary point lies on the line between the two sectors at the shorter distance found in the two sectors
     float shortest_distance = PROXIMITY_BOUNDARY_DIST_DEFAULT;
-    if (_distance_valid[layer][sector] && _distance_valid[layer][next_sector]) {
+    if (distance_valid(layer, sector) && distance_valid(layer, next_sector)) {
         shortest_distance = MIN(_filtered_distance[layer][sector].get(), _filtered_distance[layer][next_sector].get());
-    } else if (_distance_valid[layer][sector]) {
+    } else if (distance_valid(layer, sector)) {
         shortest_distance = _filtered_distance[layer][sector].get();
-    } else if (_distance_valid[layer][next_sector]) {
+    } else if (distance_valid(layer, next_sector)) {
         shortest_distance = _filtered_distance[layer][next_sector].get();
     }
     if (shortest_distance < PROXIMITY_BOUNDARY_DIST_MIN) {
         shortest_distance = PROXIMITY_BOUNDARY_DIST_MIN;
     }
     _boundary_points[layer][sector] = _sector_edge_vector[layer][sector] * shortest_distance;
+    boundary_point_changed(layer, sector);
 
     // if the next sector (clockwise) has an invalid distance, set boundary to create a cup like boundary
-    if (!_distance_valid[layer][next_sector]) {
+    if (!distance_valid(layer, next_sector)) {
         _boundary_points[layer][next_sector] = _sector_edge_vector[layer][next_sector] * shortest_distance;
+        boundary_point_changed(layer, next_sector);
     }
 
     // repeat for edge between sector and previous sector
     const uint8_t prev_sector = get_prev_sector(sector);
     shortest_distance = PROXIMITY_BOUNDARY_DIST_DEFAULT;
-    if (_distance_valid[layer][prev_sector] && _distance_valid[layer][sector]) {
+    if (distance_valid(layer, prev_sector) && distance_valid(layer, sector)) {
         shortest_distance = MIN(_filtered_distance[layer][prev_sector].get(), _filtered_distance[layer][sector].get());
-    } else if (_distance_valid[layer][prev_sector]) {
+    } else if (distance_valid(layer, prev_sector)) {
         shortest_distance = _filtered_distance[layer][prev_sector].get();
-    } else if (_distance_valid[layer][sector]) {
+    } else if (distance_valid(layer, sector)) {
         shortest_distance = _filtered_distance[layer][sector].get();
     }
     _boundary_points[layer][prev_sector] = _sector_edge_vector[layer][prev_sector] * shortest_distance;
+    boundary_point_changed(layer, prev_sector);
 
     // if the sector counter-clockwise from the previous sector has an invalid distance, set boundary to create a cup-like boundary
     const uint8_t prev_sector_ccw = get_prev_sector(prev_sector);
-    if (!_distance_valid[layer][prev_sector_ccw]) {
+    if (!distance_valid(layer, prev_sector_ccw)) {
         _boundary_points[layer][prev_sector_ccw] = _sector_edge_vector[layer][prev_sector_ccw] * shortest_distance;
+        boundary_point_changed(layer, prev_sector_ccw);
     }
 }
 
@@ -175,10 +187,88 @@ void AP_Proximity_Boundary_3D::update_boundary(const Face &face)
 void AP_Proximity_Boundary_3D::reset()
 {
     for (uint8_t layer=0; layer < PROXIMITY_NUM_LAYERS; layer++) {
-        for (uint8_t sector=0; sector < PROXIMITY_NUM_SECTORS; sector++) {
-            _distance_valid[layer][sector] = false;
+        _distance_valid[layer] = 0;
+    }
+    _closest_face = Face();
+}
+
+// mark a face as having a valid distance or not
+void AP_Proximity_Boundary_3D::set_distance_valid(const Face &face, bool valid)
+{
+    if (valid) {
+        _distance_valid[face.layer] |= (1U << face.sector);
+        return;
+    }
+    _distance_valid[face.layer] &= ~(1U << face.sector);
+    if (face == _closest_face) {
+        // the closest object has gone, search for the next closest
+        find_closest_object();
+    }
+}
+
+// true if face a is closer than face b. Ties go to the face that
+// comes first in layer then sector order, so the closest object is
+// the same however the cache was updated
+bool AP_Proximity_Boundary_3D::is_closer(const Face &a, const Face &b) const
+{
+    const float dist_a = _distance[a.layer][a.sector];
+    const float dist_b = _distance[b.layer][b.sector];
+    if (dist_a != dist_b) {
+        return dist_a < dist_b;
+    }
+    return (a.layer < b.layer) || (a.layer == b.layer && a.sector < b.sector);
+}
+
+// update the closest object cache for a new distance for a valid face.
+// Must be called before the face's distance is changed. Returns true
+// if the closest object has moved further away, in which case
+// find_closest_object() must be called once the distance is set
+bool AP_Proximity_Boundary_3D::update_closest_object(const Face &face, float distance)
+{
+    if (face.layer < PROXIMITY_MIDDLE_LAYER) {
+        // lower layers are not used
+        return false;
+    }
+    if (face == _closest_face) {
+        // another face may now be closer
+        return distance > _distance[face.layer][face.sector];
+    }
+    if (!_closest_face.valid()) {
+        _closest_face = face;
+        return false;
+    }
+    // compare using the new distance for this face
+    const float old_distance = _distance[face.layer][face.sector];
+    _distance[face.layer][face.sector] = distance;
+    if (is_closer(face, _closest_face)) {
+        _closest_face = face;
+    }
+    _distance[face.layer][face.sector] = old_distance;
+    return false;
+}
+
+// search the boundary for the closest object. Only the middle layer
+// and higher are checked, as lower layers might contain ground, which
+// would give a false pre-arm failure
+void AP_Proximity_Boundary_3D::find_closest_object()
+{
+    Face closest;
+    for (uint8_t layer=PROXIMITY_MIDDLE_LAYER; layer<PROXIMITY_NUM_LAYERS; layer++) {
+        for (uint8_t sector=0; sector<PROXIMITY_NUM_SECTORS; sector++) {
+            const Face face{layer, sector};
+            if (distance_valid(layer, sector) &&
+                (!closest.valid() || is_closer(face, closest))) {
+                closest = face;
+            }
         }
     }
+    _closest_face = closest;
+}
+
+// mark the obstacles on either side of a boundary point as needing recalculation
+void AP_Proximity_Boundary_3D::boundary_point_changed(uint8_t layer, uint8_t sector)
+{
+    _obstacle_vector_stale[layer] |= (1U << sector) | (1U << get_prev_sector(sector));
 }
 
 // Reset this location, specified by Face object, back to default
@@ -191,7 +281,7 @@ void AP_Proximity_Boundary_3D::reset_face(const Face &face, uint8_t prx_instance
     }
 
     // return immediately if face already has no valid distance
-    if (!_distance_valid[face.layer][face.sector]) {
+    if (!distance_valid(face.layer, face.sector)) {
         return;
     }
 
@@ -203,7 +293,7 @@ void AP_Proximity_Boundary_3D::reset_face(const Face &face, uint8_t prx_instance
         }
     }
 
-    _distance_valid[face.layer][face.sector] = false;
+    set_distance_valid(face, false);
 
     // update simple avoidance boundary
     update_boundary(face);
@@ -221,11 +311,12 @@ void AP_Proximity_Boundary_3D::check_face_timeout()
 
     for (uint8_t layer=0; layer < PROXIMITY_NUM_LAYERS; layer++) {
         for (uint8_t sector=0; sector < PROXIMITY_NUM_SECTORS; sector++) {
-            if (_distance_valid[layer][sector]) {
+            if (distance_valid(layer, sector)) {
                 if ((now_ms - _last_update_ms[layer][sector]) > PROXIMITY_FACE_RESET_MS) {
                     // this face has a valid distance but wasn't updated for a long time, reset it
-                    _distance_valid[layer][sector] = false;
-                    update_boundary(AP_Proximity_Boundary_3D::Face{layer, sector});
+                    const AP_Proximity_Boundary_3D::Face face{layer, sector};
+                    set_distance_valid(face, false);
+                    update_boundary(face);
                 }
             }
         }
@@ -238,7 +329,7 @@ bool AP_Proximity_Boundary_3D::get_distance(const Face &face, float &distance) c
     if (!face.valid()) {
         return false;
     }
-    if (_distance_valid[face.layer][face.sector]) {
+    if (distance_valid(face.layer, face.sector)) {
         distance = _distance[face.layer][face.sector];
         return true;
     }
@@ -265,18 +356,11 @@ bool AP_Proximity_Boundary_3D::convert_obstacle_num_to_face(uint8_t obstacle_num
     face.sector = sector;
     face.layer = layer;
 
-    uint8_t valid_sector = sector;
-    // check for 3 adjacent sectors
-    for (uint8_t i=0; i < 3; i++) {
-        if (_distance_valid[layer][valid_sector]) {
-            // update boundary has manipulated this face
-            return true;
-        }
-        valid_sector = get_next_sector(valid_sector);
-    }
-
-    // this face was not manipulated by "update_boundary" and is stale. Don't use it
-    return false;
+    // check for 3 adjacent sectors. If none are valid this face was
+    // not manipulated by "update_boundary" and is stale. Don't use it
+    const uint8_t next_sector = get_next_sector(sector);
+    const uint8_t adjacent = (1U << sector) | (1U << next_sector) | (1U << get_next_sector(next_sector));
+    return (_distance_valid[layer] & adjacent) != 0;
 }
 
 // Appropriate layer and sector are found from the passed obstacle_num
@@ -291,12 +375,17 @@ bool AP_Proximity_Boundary_3D::get_obstacle(uint8_t obstacle_num, Vector3f& vec_
         // not a valid face
         return false;
     }
-    const uint8_t sector_end = face.sector;
-    const uint8_t sector_start = get_next_sector(face.sector);
-    
-    const Vector3f start = _boundary_points[face.layer][sector_start];
-    const Vector3f end = _boundary_points[face.layer][sector_end];
-    vec_to_obstacle = Vector3f::point_on_line_closest_to_other_point(start, end, Vector3f{});
+    const uint8_t bit = 1U << face.sector;
+    if (_obstacle_vector_stale[face.layer] & bit) {
+        const uint8_t sector_end = face.sector;
+        const uint8_t sector_start = get_next_sector(face.sector);
+
+        const Vector3f start = _boundary_points[face.layer][sector_start];
+        const Vector3f end = _boundary_points[face.layer][sector_end];
+        _obstacle_vector[face.layer][face.sector] = Vector3f::point_on_line_closest_to_other_point(start, end, Vector3f{});
+        _obstacle_vector_stale[face.layer] &= ~bit;
+    }
+    vec_to_obstacle = _obstacle_vector[face.layer][face.sector];
     return true;
 }
 
@@ -335,30 +424,14 @@ bool AP_Proximity_Boundary_3D::closest_point_from_segment_to_obstacle(uint8_t ob
 //   returns true on success, false if no valid readings
 bool AP_Proximity_Boundary_3D::get_closest_object(float& angle_deg, float &distance) const
 {
-    bool closest_found = false;
-    uint8_t closest_sector = 0;
-    uint8_t closest_layer = 0;
-
-    // check boundary for shortest distance
-    // only check for middle layers and higher
-    // lower layers might contain ground, which will give false pre-arm failure
-    for (uint8_t layer=PROXIMITY_MIDDLE_LAYER; layer<PROXIMITY_NUM_LAYERS; layer++) {
-        for (uint8_t sector=0; sector<PROXIMITY_NUM_SECTORS; sector++) {
-            if (_distance_valid[layer][sector]) {
-                if (!closest_found || (_distance[layer][sector] < _distance[closest_layer][closest_sector])) {
-                    closest_layer = layer;
-                    closest_sector = sector;
-                    closest_found = true;
-                }
-            }
-        }
-    }
-
-    if (closest_found) {
-        angle_deg = _angle[closest_layer][closest_sector];
-        distance = _distance[closest_layer][closest_sector];
+    // take one copy, as the cache may be updated by another thread
+    const Face closest = _closest_face;
+    if (!closest.valid()) {
+        return false;
     }
-    return closest_found;
+    angle_deg = _angle[closest.layer][closest.sector];
+    distance = _distance[closest.layer][closest.sector];
+    return true;
 }
 
 // get number of objects, used for non-GPS avoidance
@@ -371,7 +444,7 @@ uint8_t AP_Proximity_Boundary_3D::get_horizontal_object_count() const
 // returns false if no angle or distance could be returned for some reason
 bool AP_Proximity_Boundary_3D::get_horizontal_object_angle_and_distance(uint8_t object_number, float &angle_deg, float &distance) const
 {
-    if ((object_number < PROXIMITY_NUM_SECTORS) && _distance_valid[PROXIMITY_MIDDLE_LAYER][object_number]) {
+    if ((object_number < PROXIMITY_NUM_SECTORS) && distance_valid(PROXIMITY_MIDDLE_LAYER, object_number)) {
         angle_deg = _angle[PROXIMITY_MIDDLE_LAYER][object_number];
         distance = _filtered_distance[PROXIMITY_MIDDLE_LAYER][object_number].get();
         return true;
@@ -386,7 +459,7 @@ bool AP_Proximity_Boundary_3D::get_obstacle_info(uint8_t obstacle_num, float &an
     // obstacle num is just "flattened layers, and sectors"
     const uint8_t layer = obstacle_num / PROXIMITY_NUM_SECTORS;
     const uint8_t sector = obstacle_num % PROXIMITY_NUM_SECTORS;
-    if (_distance_valid[layer][sector]) {
+    if (distance_valid(layer, sector)) {
         angle_deg = _angle[layer][sector];
         pitch_deg = _pitch[layer][sector];
         distance = _filtered_distance[layer][sector].get();
@@ -403,7 +476,7 @@ bool AP_Proximity_Boundary_3D::get_filtered_distance(const Face &face, float &di
         return false;
     }
 
-    if (!_distance_valid[face.layer][face.sector]) {
+    if (!distance_valid(face.layer, face.sector)) {
         // invalid distace
         return false;
     }
@@ -167,13 +167,47 @@ private:
     // Return filtered distance for the passed in face
     bool get_filtered_distance(const Face &face, float &distance) const;
 
+    // true if a valid distance has been received for a face
+    bool distance_valid(uint8_t layer, uint8_t sector) const { return (_distance_valid[layer] & (1U<<sector)) != 0; }
+
+    // mark a face as having a valid distance or not, keeping the closest object cache up to date
+    void set_distance_valid(const Face &face, bool valid);
+
+    // update the closest object cache for a new distance for a face,
+    // returning true if it must be found again once the distance is set
+    bool update_closest_object(const Face &face, float distance);
+
+    // search the boundary for the closest object
+    void find_closest_object();
+
+    // true if face a is closer than face b, with ties going to the first face found when scanning the boundary
+    bool is_closer(const Face &a, const Face &b) const;
+
+    // mark the obstacles using a boundary point as needing recalculation
+    void boundary_point_changed(uint8_t layer, uint8_t sector);
+
     Vector3f _sector_edge_vector[PROXIMITY_NUM_LAYERS][PROXIMITY_NUM_SECTORS];
     Vector3f _boundary_points[PROXIMITY_NUM_LAYERS][PROXIMITY_NUM_SECTORS];
 
     float _angle[PROXIMITY_NUM_LAYERS][PROXIMITY_NUM_SECTORS];          // yaw angle in degrees to closest object within each sector and layer
     float _pitch[PROXIMITY_NUM_LAYERS][PROXIMITY_NUM_SECTORS];          // pitch angle in degrees to the closest object within each sector and layer
     float _distance[PROXIMITY_NUM_LAYERS][PROXIMITY_NUM_SECTORS];       // distance to closest object within each sector and layer
-    bool _distance_valid[PROXIMITY_NUM_LAYERS][PROXIMITY_NUM_SECTORS];  // true if a valid distance received for each sector and layer
+    static_assert(PROXIMITY_NUM_SECTORS <= 8, "sector bitmap must fit in a uint8_t");
+    uint8_t _distance_valid[PROXIMITY_NUM_LAYERS];                      // bitmap of sectors with a valid distance for each layer
+
+    // closest object in the middle layer and above, as returned by
+    // get_closest_object(), invalid if there is no closest object.
+    // Only written when distances are set, and only found again by
+    // searching the boundary when the closest face gets further away
+    // or becomes invalid. get_closest_object() may be called from
+    // other threads so this is only written with a complete face
+    Face _closest_face;
+
+    // closest point on the boundary line for each face, as returned
+    // by get_obstacle(), recalculated only when the boundary points
+    // either side of it have changed
+    mutable Vector3f _obstacle_vector[PROXIMITY_NUM_LAYERS][PROXIMITY_NUM_SECTORS];
+    mutable uint8_t _obstacle_vector_stale[PROXIMITY_NUM_LAYERS];       // bitmap of sectors needing recalculation
     uint32_t _last_update_ms[PROXIMITY_NUM_LAYERS][PROXIMITY_NUM_SECTORS]; // time when distance was last updated
     uint8_t _prx_instance[PROXIMITY_NUM_LAYERS][PROXIMITY_NUM_SECTORS]; // proximity sensor backend instance that provided the distance
     LowPassFilterFloat _filtered_distance[PROXIMITY_NUM_LAYERS][PROXIMITY_NUM_SECTORS]; // low pass filter
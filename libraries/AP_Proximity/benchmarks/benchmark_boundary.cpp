@@ -0,0 +1,76 @@
+#include <AP_gbenchmark.h>
+
+#include <AP_Proximity/AP_Proximity_Boundary_3D.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+static AP_Proximity_Boundary_3D boundary;
+static AP_Proximity_Temp_Boundary temp_boundary;
+static uint32_t scan_count;
+
+/*
+  feed one revolution of a 360 degree lidar with a sample every degree
+  into the boundary, as a scanning lidar backend does
+ */
+static void lidar_scan()
+{
+    temp_boundary.reset();
+    for (uint16_t i=0; i<360; i++) {
+        const float yaw = i;
+        const float distance = 2.0f + 0.01f * ((i * 7 + scan_count * 13) % 300);
+        const AP_Proximity_Boundary_3D::Face face = boundary.get_face(0, yaw);
+        temp_boundary.add_distance(face, yaw, distance);
+    }
+    temp_boundary.update_3D_boundary(0, boundary);
+    scan_count++;
+}
+
+// the queries made by AC_Avoid and the GCS in each loop of the main thread
+static void query_boundary()
+{
+    float angle, distance;
+    bool found = boundary.get_closest_object(angle, distance);
+    gbenchmark_escape(&found);
+    for (uint8_t i=0; i<boundary.get_obstacle_count(); i++) {
+        Vector3f vec;
+        found = boundary.get_obstacle(i, vec);
+        gbenchmark_escape(&vec);
+    }
+}
+
+static void BM_BoundaryScan(benchmark::State &state)
+{
+    boundary.set_filter_freq(0);
+    while (state.KeepRunning()) {
+        lidar_scan();
+    }
+}
+
+BENCHMARK(BM_BoundaryScan);
+
+static void BM_BoundaryQuery(benchmark::State &state)
+{
+    boundary.set_filter_freq(0);
+    lidar_scan();
+    while (state.KeepRunning()) {
+        query_boundary();
+    }
+}
+
+BENCHMARK(BM_BoundaryQuery);
+
+// a 10Hz lidar with the boundary queried by a 400Hz main loop
+static void BM_BoundaryScanAndQuery(benchmark::State &state)
+{
+    boundary.set_filter_freq(0);
+    while (state.KeepRunning()) {
+        lidar_scan();
+        for (uint8_t i=0; i<40; i++) {
+            query_boundary();
+        }
+    }
+}
+
+BENCHMARK(BM_BoundaryScanAndQuery);
+
+BENCHMARK_MAIN();
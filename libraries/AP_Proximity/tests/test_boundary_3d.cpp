@@ -0,0 +1,124 @@
+#include <AP_gtest.h>
+
+#include <AP_Proximity/AP_Proximity_Boundary_3D.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+/*
+  pseudo random sequence of boundary updates, the same on every run
+ */
+class BoundaryUpdates {
+public:
+    // apply the next update to one or more boundaries
+    void apply(AP_Proximity_Boundary_3D &a, AP_Proximity_Boundary_3D *b=nullptr) {
+        const uint32_t r = next();
+        const AP_Proximity_Boundary_3D::Face face{uint8_t(r % PROXIMITY_NUM_LAYERS), uint8_t((r >> 8) % PROXIMITY_NUM_SECTORS)};
+        const float yaw = face.sector * 45.0f + ((r >> 16) % 40) - 20;
+        const float pitch = a._pitch_middle_deg[face.layer];
+        const float distance = 0.2f + ((r >> 4) % 2000) * 0.01f;
+        switch ((r >> 24) % 8) {
+        case 0:
+            a.reset_face(face, 0);
+            if (b != nullptr) {
+                b->reset_face(face, 0);
+            }
+            break;
+        case 1:
+            if ((r >> 28) == 0) {
+                a.reset();
+                if (b != nullptr) {
+                    b->reset();
+                }
+            }
+            break;
+        default:
+            a.set_face_attributes(face, pitch, yaw, distance, 0);
+            if (b != nullptr) {
+                b->set_face_attributes(face, pitch, yaw, distance, 0);
+            }
+            break;
+        }
+    }
+
+private:
+    uint32_t next() {
+        state = state * 1664525U + 1013904223U;
+        return state ^ (state >> 13);
+    }
+    uint32_t state = 1;
+};
+
+// closest object found by searching every face, as get_closest_object() did before it was cached
+static bool closest_by_search(const AP_Proximity_Boundary_3D &boundary, float &angle_deg, float &distance)
+{
+    bool found = false;
+    for (uint8_t layer=PROXIMITY_MIDDLE_LAYER; layer<PROXIMITY_NUM_LAYERS; layer++) {
+        for (uint8_t sector=0; sector<PROXIMITY_NUM_SECTORS; sector++) {
+            float d;
+            if (!boundary.get_distance(AP_Proximity_Boundary_3D::Face{layer, sector}, d)) {
+                continue;
+            }
+            if (!found || d < distance) {
+                float pitch_deg, filt_distance;
+                found = boundary.get_obstacle_info(layer*PROXIMITY_NUM_SECTORS+sector, angle_deg, pitch_deg, filt_distance);
+                distance = d;
+            }
+        }
+    }
+    return found;
+}
+
+// the boundary is a large object, so keep it off the stack
+static AP_Proximity_Boundary_3D boundary;
+static AP_Proximity_Boundary_3D boundary2;
+
+TEST(Boundary3D, ClosestObject)
+{
+    // no filtering, so results don't depend on timing
+    boundary.set_filter_freq(0);
+    boundary.reset();
+
+    float angle, distance;
+    EXPECT_FALSE(boundary.get_closest_object(angle, distance));
+
+    BoundaryUpdates updates;
+    for (uint32_t i=0; i<20000; i++) {
+        updates.apply(boundary);
+        float angle2 = 0, distance2 = 0;
+        const bool found = closest_by_search(boundary, angle2, distance2);
+        ASSERT_EQ(boundary.get_closest_object(angle, distance), found);
+        if (found) {
+            EXPECT_EQ(angle, angle2);
+            EXPECT_EQ(distance, distance2);
+        }
+    }
+}
+
+TEST(Boundary3D, Obstacles)
+{
+    boundary.set_filter_freq(0);
+    boundary2.set_filter_freq(0);
+    boundary.reset();
+    boundary2.reset();
+
+    // query one boundary after every update and the other at the end,
+    // so the cached obstacles must have been recalculated correctly
+    BoundaryUpdates updates;
+    for (uint32_t i=0; i<5000; i++) {
+        updates.apply(boundary, &boundary2);
+        for (uint8_t j=0; j<boundary.get_obstacle_count(); j++) {
+            Vector3f vec;
+            boundary.get_obstacle(j, vec);
+        }
+    }
+    for (uint8_t j=0; j<boundary.get_obstacle_count(); j++) {
+        Vector3f vec, vec2;
+        const bool valid = boundary.get_obstacle(j, vec);
+        ASSERT_EQ(valid, boundary2.get_obstacle(j, vec2));
+        if (valid) {
+            EXPECT_EQ(vec, vec2);
+        }
+    }
+}
+
+AP_GTEST_MAIN()
@@ -72,34 +72,92 @@ const uint8_t *AP_ROMFS::find_decompress(const char *name, uint32_t &size)
         return decompressed_data;
     }
 
-    TINF_DATA *d = (TINF_DATA *)malloc(sizeof(TINF_DATA));
-    if (!d) {
+    if (f->block_size == 0) {
+        if (!decompress(f->contents, f->compressed_size, decompressed_data, f->decompressed_size)) {
+            ::free(decompressed_data);
+            return nullptr;
+        }
+    } else {
+        for (uint32_t ofs=0, block=0; ofs < f->decompressed_size; ofs += f->block_size, block++) {
+            if (decompress_block(f, block, &decompressed_data[ofs]) < 0) {
+                ::free(decompressed_data);
+                return nullptr;
+            }
+        }
+    }
+
+    if (crc32_small(0, decompressed_data, f->decompressed_size) != f->crc) {
         ::free(decompressed_data);
         return nullptr;
     }
+    
+    size = f->decompressed_size;
+    return decompressed_data;
+#endif
+}
+
+/*
+  decompress a raw deflate stream, producing exactly length bytes
+*/
+bool AP_ROMFS::decompress(const uint8_t *src, uint32_t src_len, uint8_t *dest, uint32_t length)
+{
+    TINF_DATA *d = (TINF_DATA *)malloc(sizeof(TINF_DATA));
+    if (!d) {
+        return false;
+    }
     uzlib_uncompress_init(d, NULL, 0);
 
-    d->source = f->contents;
-    d->source_limit = f->contents + f->compressed_size;
-    d->dest = decompressed_data;
-    d->destSize = f->decompressed_size;
+    d->source = src;
+    d->source_limit = src + src_len;
+    d->dest = dest;
+    d->destSize = length;
 
     int res = uzlib_uncompress(d);
 
     ::free(d);
-    
-    if (res != TINF_OK) {
-        ::free(decompressed_data);
+
+    return res == TINF_OK;
+}
+
+/*
+  find a file stored in independently compressed blocks
+*/
+const AP_ROMFS::embedded_file *AP_ROMFS::find_block_file(const char *name)
+{
+#ifdef HAL_ROMFS_UNCOMPRESSED
+    return nullptr;
+#else
+    const struct embedded_file *f = find_file(name);
+    if (f == nullptr || f->block_size == 0) {
         return nullptr;
     }
+    return f;
+#endif
+}
 
-    if (crc32_small(0, decompressed_data, f->decompressed_size) != f->crc) {
-        ::free(decompressed_data);
-        return nullptr;
+/*
+  decompress one block of a blocked file
+*/
+int32_t AP_ROMFS::decompress_block(const embedded_file *f, uint32_t block, uint8_t *buf)
+{
+#ifdef HAL_ROMFS_UNCOMPRESSED
+    return -1;
+#else
+    const uint64_t ofs = uint64_t(block) * f->block_size;
+    if (f->block_size == 0 || ofs >= f->decompressed_size) {
+        return -1;
     }
-    
-    size = f->decompressed_size;
-    return decompressed_data;
+    const uint32_t remaining = f->decompressed_size - ofs;
+    const uint32_t length = remaining < f->block_size ? remaining : f->block_size;
+    const uint32_t start = f->block_offsets[block];
+    const uint32_t end = f->block_offsets[block+1];
+    if (end <= start || end > f->compressed_size) {
+        return -1;
+    }
+    if (!decompress(&f->contents[start], end - start, buf, length)) {
+        return -1;
+    }
+    return length;
 #endif
 }
 
@@ -26,17 +26,38 @@ public:
     */
     static const char *dir_list(const char *dirname, uint16_t &ofs);
 
-private:
     struct embedded_file {
         const char *filename;
         uint32_t compressed_size;
         uint32_t decompressed_size;
         uint32_t crc;
         const uint8_t *contents;
+        // zero unless the file is compressed in independent blocks,
+        // in which case block_offsets[n] is the offset of block n
+        // in contents, with one extra entry for the end
+        uint32_t block_size;
+        const uint32_t *block_offsets;
     };
 
+    /*
+      random access to files embedded in blocks (see the
+      --romfs-block-size build option). Any range of such a file can
+      be read by decompressing only the blocks it covers. Returns
+      nullptr if the file is not found or is not stored in blocks
+    */
+    static const embedded_file *find_block_file(const char *name);
+
+    // decompress one block of a file from find_block_file() into buf,
+    // which must be block_size bytes. Returns the length of the block,
+    // which is less than block_size for the last block, or -1 on error
+    static int32_t decompress_block(const embedded_file *f, uint32_t block, uint8_t *buf);
+
+private:
     // find an embedded file
     static const AP_ROMFS::embedded_file *find_file(const char *name);
 
+    // decompress length bytes of compressed data into dest
+    static bool decompress(const uint8_t *src, uint32_t src_len, uint8_t *dest, uint32_t length);
+
     static const struct embedded_file files[];
 };
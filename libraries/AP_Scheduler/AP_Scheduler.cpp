@@ -475,6 +475,8 @@ void AP_Scheduler::Log_Write_Performance()
         i2c_isr_count    : pd.i2c_isr_count,
         extra_loop_us    : extra_loop_us,
         rtc              : rtc,
+        parallel_time_saved_us : perf_info.get_parallel_time_saved(),
+        imu_stream_dropped : AP::ins().get_rawstream_dropped_count(),
     };
     AP::logger().WriteCriticalBlock(&pkt, sizeof(pkt));
 }
@@ -31,6 +31,7 @@ void AP::PerfInfo::reset()
     long_running = 0;
     sigma_time = 0;
     sigmasquared_time = 0;
+    parallel_time_saved_us = 0;
     if (_task_info != nullptr) {
         memset(_task_info, 0, (_num_tasks) * sizeof(TaskInfo));
     }
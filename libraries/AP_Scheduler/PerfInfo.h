@@ -42,6 +42,10 @@ public:
     float get_filtered_loop_rate_hz() const;
     void set_loop_rate(uint16_t rate_hz);
 
+    // record main loop time saved by running work in parallel on other threads
+    void add_parallel_time_saved(uint32_t time_us) { parallel_time_saved_us += time_us; }
+    uint32_t get_parallel_time_saved() const { return parallel_time_saved_us; }
+
     void update_logging() const;
 
     // allocate the array of task statistics for use by @SYS/tasks.txt
@@ -72,6 +76,7 @@ private:
     uint64_t sigmasquared_time;
     uint16_t long_running;
     uint32_t last_check_us;
+    uint32_t parallel_time_saved_us;
     float filtered_loop_time;
     bool ignore_loop;
     // performance monitoring
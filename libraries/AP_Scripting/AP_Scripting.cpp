@@ -364,6 +364,16 @@ void AP_Scripting::thread(void) {
         _serialdevice.clear();
 #endif
 
+#if AP_SCRIPTING_CAN_SENSOR_ENABLED
+        // free CAN buffers and their filters
+        if (_CAN_dev != nullptr) {
+            _CAN_dev->clear_buffers();
+        }
+        if (_CAN_dev2 != nullptr) {
+            _CAN_dev2->clear_buffers();
+        }
+#endif
+
 #if AP_CRSF_SCRIPTING_ENABLED
         AP::crsf_telem()->clear_menus();
 #endif // AP_CRSF_SCRIPTING_ENABLED
@@ -20,6 +20,8 @@
 
 #if AP_SCRIPTING_CAN_SENSOR_ENABLED
 
+extern const AP_HAL::HAL& hal;
+
 // handler for outgoing frames, using uint32
 bool ScriptingCANSensor::write_frame(AP_HAL::CANFrame &out_frame, const uint32_t timeout_us)
 {
@@ -29,25 +31,78 @@ bool ScriptingCANSensor::write_frame(AP_HAL::CANFrame &out_frame, const uint32_t
 // handler for incoming frames, add to buffers
 void ScriptingCANSensor::handle_frame(AP_HAL::CANFrame &frame)
 {
-    WITH_SEMAPHORE(sem);
-    if (buffer_list != nullptr) {
-        buffer_list->handle_frame(frame);
+    dispatching++;
+    DispatchTable::ConsumerMask consumers = dispatch.match(frame.id);
+    const uint8_t n = num_buffers.load();
+    for (uint8_t i = 0; i < n && consumers != 0; i++) {
+        const DispatchTable::ConsumerMask bit = 1U << i;
+        if ((consumers & bit) == 0) {
+            continue;
+        }
+        consumers &= ~bit;
+        if (!buffers[i]->handle_frame(frame)) {
+            count_rx_drop();
+        }
     }
+    dispatching--;
 }
 
 // add a new buffer to this sensor
 ScriptingCANBuffer* ScriptingCANSensor::add_buffer(uint32_t buffer_len)
 {
     WITH_SEMAPHORE(sem);
-    ScriptingCANBuffer *new_buff = NEW_NOTHROW ScriptingCANBuffer(*this, buffer_len);
-    if (buffer_list == nullptr) {
-        buffer_list = new_buff;
-    } else {
-        buffer_list->add_buffer(new_buff);
+    const uint8_t n = num_buffers.load(std::memory_order_relaxed);
+    if (n >= ARRAY_SIZE(buffers)) {
+        return nullptr;
+    }
+    ScriptingCANBuffer *new_buff = NEW_NOTHROW ScriptingCANBuffer(*this, buffer_len, n);
+    if (new_buff == nullptr) {
+        return nullptr;
     }
+    // a new buffer gets all frames until it has a filter
+    buffers[n] = new_buff;
+    dispatch.add_consumer(n);
+    num_buffers.store(n+1, std::memory_order_release);
+    hw_filters_changed();
     return new_buff;
 }
 
+// add a filter for a buffer
+bool ScriptingCANSensor::add_filter(uint8_t index, uint32_t mask, uint32_t value)
+{
+    WITH_SEMAPHORE(sem);
+    if (!dispatch.add_filter(index, value, mask)) {
+        return false;
+    }
+    hw_filters_changed();
+    return true;
+}
+
+/*
+  remove all buffers, so a restarted script starts with none in use.
+  Frames are dispatched without the semaphore, so once the buffers are
+  unpublished this waits for any dispatch which may still be using
+  them before freeing them
+ */
+void ScriptingCANSensor::clear_buffers(void)
+{
+    WITH_SEMAPHORE(sem);
+    const uint8_t n = num_buffers.load(std::memory_order_relaxed);
+    if (n == 0) {
+        return;
+    }
+    num_buffers.store(0);
+    dispatch.clear();
+    while (dispatching.load() != 0) {
+        hal.scheduler->delay_microseconds(100);
+    }
+    for (uint8_t i = 0; i < n; i++) {
+        delete buffers[i];
+        buffers[i] = nullptr;
+    }
+    hw_filters_changed();
+}
+
 // Call main sensor write method
 bool ScriptingCANBuffer::write_frame(AP_HAL::CANFrame &out_frame, const uint32_t timeout_us)
 {
@@ -60,54 +115,23 @@ bool ScriptingCANBuffer::read_frame(AP_HAL::CANFrame &frame)
     return buffer.pop(frame);
 }
 
-// recursively add frame to buffer
-void ScriptingCANBuffer::handle_frame(AP_HAL::CANFrame &frame)
+// add frame to buffer for scripting to read
+bool ScriptingCANBuffer::handle_frame(const AP_HAL::CANFrame &frame)
 {
-    // accept everything if no filters are setup
-    bool accept = num_filters == 0;
-
-    // Check if frame matches any filters
-    for (uint8_t i = 0; i < MIN(num_filters, ARRAY_SIZE(filter)); i++) {
-        if ((frame.id & filter[i].mask) == filter[i].value) {
-            accept = true;
-            break;
-        }
-    }
-
-    WITH_SEMAPHORE(sem);
-
-    // Add to buffer for scripting to read
-    if (accept) {
-        buffer.push(frame);
-    }
-
-    // filtering is not applied to other buffers
-    if (next != nullptr) {
-        next->handle_frame(frame);
-    }
-}
-
-// recursively add new buffer
-void ScriptingCANBuffer::add_buffer(ScriptingCANBuffer* new_buff) {
-    WITH_SEMAPHORE(sem);
-    if (next == nullptr) {
-        next = new_buff;
-        return;
-    }
-    next->add_buffer(new_buff);
+    return buffer.push(frame);
 }
 
 // Add a filter, will pass ID's that match value given the mask
 bool ScriptingCANBuffer::add_filter(uint32_t mask, uint32_t value) {
 
     // Run out of filters
-    if (num_filters >= ARRAY_SIZE(filter)) {
+    if (num_filters >= max_filters) {
         return false;
     }
 
-    // Add to list and increment
-    filter[num_filters].mask = mask;
-    filter[num_filters].value = value & mask;
+    if (!sensor.add_filter(index, mask, value)) {
+        return false;
+    }
     num_filters++;
     return true;
 }
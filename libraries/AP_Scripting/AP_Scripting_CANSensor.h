@@ -31,6 +31,12 @@
 
 #include <AP_CANManager/AP_CANSensor.h>
 
+// filters over all the buffers of a scripting CAN device, beyond
+// which add_filter() fails
+#ifndef AP_SCRIPTING_CAN_MAX_FILTERS
+#define AP_SCRIPTING_CAN_MAX_FILTERS 32
+#endif
+
 class ScriptingCANBuffer;
 class ScriptingCANSensor : public CANSensor {
 public:
@@ -46,23 +52,51 @@ public:
     // handler for incoming frames, add to buffers
     void handle_frame(AP_HAL::CANFrame &frame) override;
 
-    // add a new buffer to this sensor
+    // add a new buffer to this sensor, returns nullptr if there are too many
     ScriptingCANBuffer* add_buffer(uint32_t buffer_len);
 
+    // add a filter for a buffer
+    bool add_filter(uint8_t index, uint32_t mask, uint32_t value);
+
+    // remove and free all buffers and their filters, called when
+    // scripting restarts once nothing refers to the buffers
+    void clear_buffers(void);
+
+protected:
+
+    // hardware filters are the combined filters of all buffers
+    bool get_hw_filters(AP_HAL::CANIface::CanFilterConfig *configs, uint16_t max_configs, uint16_t &num_configs) const override {
+        return dispatch.get_hw_filters(configs, max_configs, num_configs);
+    }
+
 private:
 
+    typedef CANDispatchTable<AP_SCRIPTING_CAN_MAX_FILTERS> DispatchTable;
+
+    // protects adding buffers and filters, frames are dispatched
+    // without it
     HAL_Semaphore sem;
 
-    ScriptingCANBuffer *buffer_list;
+    // a buffer is set before num_buffers is increased with release
+    // ordering. Buffers are only freed by clear_buffers(), which waits
+    // for any handle_frame() call using them to finish
+    ScriptingCANBuffer *buffers[DispatchTable::max_consumers];
+    std::atomic<uint8_t> num_buffers{0};
+
+    // number of handle_frame() calls in progress
+    std::atomic<uint8_t> dispatching{0};
+
+    DispatchTable dispatch;
 
 };
 
 class ScriptingCANBuffer {
 public:
 
-    ScriptingCANBuffer(ScriptingCANSensor &_sensor, uint32_t buffer_size):
+    ScriptingCANBuffer(ScriptingCANSensor &_sensor, uint32_t buffer_size, uint8_t _index):
         buffer(buffer_size),
-        sensor(_sensor)
+        sensor(_sensor),
+        index(_index)
     {};
 
     // Call main sensor write method
@@ -71,29 +105,23 @@ public:
     // read a frame from the buffer
     bool read_frame(AP_HAL::CANFrame &frame);
 
-    // recursively add frame to buffer
-    void handle_frame(AP_HAL::CANFrame &frame);
-
-    // recursively add new buffer
-    void add_buffer(ScriptingCANBuffer* new_buff);
+    // add frame to buffer, returning false if the buffer is full
+    bool handle_frame(const AP_HAL::CANFrame &frame);
 
     // Add a filter to this buffer
     bool add_filter(uint32_t mask, uint32_t value);
 
 private:
 
+    // single producer, single consumer, so no lock is needed
     ObjectBuffer<AP_HAL::CANFrame> buffer;
 
     ScriptingCANSensor &sensor;
 
-    ScriptingCANBuffer *next;
-
-    HAL_Semaphore sem;
+    // index of this buffer in the sensor dispatch table
+    const uint8_t index;
 
-    struct {
-        uint32_t mask;
-        uint32_t value;
-    } filter[8];
+    static const uint8_t max_filters = 8;
     uint8_t num_filters;
 
 };
@@ -404,12 +404,12 @@ function efi:get_backend(instance) end
 -- CAN bus interaction
 CAN = {}
 
--- get a CAN bus device handler first scripting driver, will return nil if no driver with protocol Scripting is configured
+-- get a CAN bus device handler first scripting driver, will return nil if no driver with protocol Scripting is configured or if 16 buffers are already in use
 ---@param buffer_len uint32_t_ud|integer|number -- buffer length 1 to 25
 ---@return ScriptingCANBuffer_ud|nil
 function CAN:get_device(buffer_len) end
 
--- get a CAN bus device handler second scripting driver, will return nil if no driver with protocol Scripting2 is configured
+-- get a CAN bus device handler second scripting driver, will return nil if no driver with protocol Scripting2 is configured or if 16 buffers are already in use
 ---@param buffer_len uint32_t_ud|integer|number -- buffer length 1 to 25
 ---@return ScriptingCANBuffer_ud|nil
 function CAN:get_device2(buffer_len) end
@@ -1212,10 +1212,10 @@ function ScriptingCANBuffer_ud:read_frame() end
 
 -- Add a filter to the CAN buffer, mask is bitwise ANDed with the frame id and compared to value if not match frame is not buffered
 -- By default no filters are added and all frames are buffered, write is not affected by filters
--- Maximum number of filters is 8
+-- Maximum number of filters is 8 per buffer, and 32 over all the buffers of a device, frames are only passed to the buffers whose filters they match
 ---@param mask uint32_t_ud|integer|number
 ---@param value uint32_t_ud|integer|number
----@return boolean -- returns true if the filler was added successfully
+---@return boolean -- returns true if the filter was added successfully, false if either limit is reached
 function ScriptingCANBuffer_ud:add_filter(mask, value) end
 
 -- desc
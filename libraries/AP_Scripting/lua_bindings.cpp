@@ -708,7 +708,12 @@ int lua_get_CAN_device(lua_State *L) {
         return 0;
     }
 
-    *new_ScriptingCANBuffer(L) = scripting->_CAN_dev->add_buffer(buffer_len);
+    ScriptingCANBuffer *buffer = scripting->_CAN_dev->add_buffer(buffer_len);
+    if (buffer == nullptr) {
+        // too many buffers, return nil
+        return 0;
+    }
+    *new_ScriptingCANBuffer(L) = buffer;
 
     return 1;
 }
@@ -738,7 +743,12 @@ int lua_get_CAN_device2(lua_State *L) {
         return 0;
     }
 
-    *new_ScriptingCANBuffer(L) = scripting->_CAN_dev2->add_buffer(buffer_len);
+    ScriptingCANBuffer *buffer = scripting->_CAN_dev2->add_buffer(buffer_len);
+    if (buffer == nullptr) {
+        // too many buffers, return nil
+        return 0;
+    }
+    *new_ScriptingCANBuffer(L) = buffer;
 
     return 1;
 }
@@ -0,0 +1,34 @@
+-- take CAN buffers with filters, to check they are freed when
+-- scripting restarts. Run with CAN_D1_PROTOCOL set to scripting
+
+local buffers = {}
+local ok = true
+for i = 1, 4 do
+  local buf = CAN:get_device(8)
+  if not buf then
+    ok = false
+    break
+  end
+  for f = 1, 4 do
+    if not buf:add_filter(uint32_t(0x7FF), uint32_t(i * 16 + f)) then
+      ok = false
+    end
+  end
+  buffers[i] = buf
+end
+
+if ok then
+  gcs:send_text(6, "CAN buffers good")
+else
+  gcs:send_text(0, "CAN buffers failed")
+end
+
+function update()
+  -- keep the buffers in use
+  for _, buf in ipairs(buffers) do
+    buf:read_frame()
+  end
+  return update, 100
+end
+
+return update, 100
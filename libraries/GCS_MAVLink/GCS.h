@@ -794,6 +794,7 @@ private:
         uint8_t rssi;
         uint32_t received_ms; // time RADIO_STATUS received
         uint8_t txbuf = 100;
+        mavlink_channel_t chan; // channel RADIO_STATUS received on
     } last_radio_status;
 
     enum class Flags {
@@ -1029,15 +1030,58 @@ private:
         Write,
     };
 
-    struct ftp_state {
-        ObjectBuffer<pending_ftp> *requests;
+    // file data read ahead of sending for a burst read. Each slot
+    // holds one packet, the first at offset
+    struct ftp_readahead {
+        uint32_t offset;
+        uint8_t read_size;
+        uint8_t head;
+        uint8_t count;
+        bool eof;       // end of file or a read error
+        int err;        // errno of a failed read
+        uint8_t len[AP_MAVLINK_FTP_READAHEAD_PACKETS];
+        uint8_t data[AP_MAVLINK_FTP_READAHEAD_PACKETS][sizeof(pending_ftp::data)];
+    };
 
-        // session specific info, currently only support a single session over all links
+    struct ftp_session {
+        // the semaphore protects fd and readahead from the read-ahead thread
+        HAL_Semaphore sem;
         int fd = -1;
         FTP_FILE_MODE mode; // work around AP_Filesystem not supporting file modes
-        int16_t current_session;
+        uint8_t id;         // session number given by the GCS
+        uint8_t sysid;
+        uint8_t compid;
+        mavlink_channel_t chan;
+        uint32_t last_ms;
+        ftp_readahead *readahead;
+
+        // burst read in progress
+        bool burst_active;
+        bool loss_noted;    // a lost packet has been seen for the current burst
+        uint16_t burst_seq;
+        uint16_t burst_left;
+        uint32_t sent_end;  // offset after the furthest data sent in bursts
+        uint8_t window;     // packets sent in each pass over the sessions
+        uint8_t bw_pct;     // percentage of bandwidth used on links without flow control
+        uint32_t next_send_us;
+
+        // statistics
+        uint32_t start_ms;
+        uint32_t bytes_sent;
+        uint16_t losses;
+    };
+
+    struct ftp_state {
+        ObjectBuffer<pending_ftp> *requests;
+
+        ftp_session sessions[AP_MAVLINK_FTP_MAX_SESSIONS];
+        uint8_t next_session; // session served first by the next pass of burst sends
         uint32_t last_send_ms;
         uint8_t need_banner_send_mask;
+#if AP_MAVLINK_FTP_READAHEAD_THREAD_ENABLED
+        // signalled when the read-ahead thread may have work to do
+        HAL_BinarySemaphore *readahead_sem;
+#endif
     };
     static struct ftp_state ftp;
 
@@ -1045,12 +1089,24 @@ private:
     static bool ftp_check_name_len(const struct pending_ftp &request);
     static int gen_dir_entry(char *dest, size_t space, const char * path, const struct dirent * entry); // FTP helper for emitting a dir response
     static void ftp_list_dir(struct pending_ftp &request, struct pending_ftp &response);
+    static ftp_session *ftp_find_session(const struct pending_ftp &request);
+    static void ftp_no_session_error(struct pending_ftp &response);
+    static ftp_session *ftp_alloc_session(const struct pending_ftp &request, uint32_t now_ms);
+    static void ftp_close_session(ftp_session &session);
+    static bool ftp_burst_start(ftp_session &session, const struct pending_ftp &request, struct pending_ftp &response);
+    static bool ftp_readahead_fill(ftp_session &session);
+    static bool ftp_readahead_fill_locked(ftp_session &session);
+    static void ftp_readahead_wake(void);
 
     bool ftp_init(void);
     void handle_file_transfer_protocol(const mavlink_message_t &msg);
     bool send_ftp_reply(const pending_ftp &reply);
     void ftp_worker(void);
     void ftp_push_replies(pending_ftp &reply);
+    bool ftp_send_bursts(void);
+#if AP_MAVLINK_FTP_READAHEAD_THREAD_ENABLED
+    void ftp_readahead_worker(void);
+#endif
 #endif  // AP_MAVLINK_FTP_ENABLED
 
     void send_distance_sensor(const class AP_RangeFinder_Backend *sensor, const uint8_t instance) const;
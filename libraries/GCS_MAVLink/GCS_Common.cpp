@@ -900,6 +900,7 @@ void GCS_MAVLINK::handle_radio_status(const mavlink_message_t &msg)
 
     last_radio_status.received_ms = now;
     last_radio_status.rssi = packet.rssi;
+    last_radio_status.chan = chan;
 
     // record if the GCS has been receiving radio messages from
     // the aircraft
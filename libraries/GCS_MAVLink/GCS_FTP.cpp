@@ -26,6 +26,7 @@
 #include <AP_Filesystem/AP_Filesystem.h>
 #include <AP_HAL/utility/sparse-endian.h>
 #include <AP_BoardConfig/AP_BoardConfig.h>
+#include <AP_Logger/AP_Logger.h>
 
 extern const AP_HAL::HAL& hal;
 
@@ -34,6 +35,16 @@ struct GCS_MAVLINK::ftp_state GCS_MAVLINK::ftp;
 // timeout for session inactivity
 #define FTP_SESSION_TIMEOUT 3000
 
+// limits of the adaptive burst window and bandwidth share
+#define FTP_BURST_WINDOW_INITIAL 4
+#define FTP_BURST_WINDOW_MAX 32
+#define FTP_BW_PCT_INITIAL 33
+#define FTP_BW_PCT_MIN 10
+#define FTP_BW_PCT_MAX 60
+
+// number of packets in a burst read
+#define FTP_BURST_PACKETS 500
+
 bool GCS_MAVLINK::ftp_init(void) {
 
     // check if ftp is disabled for memory savings
@@ -48,7 +59,7 @@ bool GCS_MAVLINK::ftp_init(void) {
         return true;
     }
 
-    ftp.requests = NEW_NOTHROW ObjectBuffer<pending_ftp>(5);
+    ftp.requests = NEW_NOTHROW ObjectBuffer<pending_ftp>(4 + AP_MAVLINK_FTP_MAX_SESSIONS);
     if (ftp.requests == nullptr || ftp.requests->get_size() == 0) {
         goto failed;
     }
@@ -57,6 +68,18 @@ bool GCS_MAVLINK::ftp_init(void) {
                                       "FTP", 2560, AP_HAL::Scheduler::PRIORITY_IO, 0)) {
         goto failed;
     }
+#if AP_MAVLINK_FTP_READAHEAD_THREAD_ENABLED
+    ftp.readahead_sem = NEW_NOTHROW HAL_BinarySemaphore;
+    if (ftp.readahead_sem == nullptr ||
+        !hal.scheduler->thread_create(FUNCTOR_BIND_MEMBER(&GCS_MAVLINK::ftp_readahead_worker, void),
+                                      "FTPR", 2560, AP_HAL::Scheduler::PRIORITY_IO, 0)) {
+        // the FTP thread is already running, so carry on and fill
+        // the read-ahead from there
+        delete ftp.readahead_sem;
+        ftp.readahead_sem = nullptr;
+        DEV_PRINTF("FTPR thread failed\n");
+    }
+#endif
 
     return true;
 
@@ -97,11 +120,14 @@ void GCS_MAVLINK::handle_file_transfer_protocol(const mavlink_message_t &msg) {
 
 bool GCS_MAVLINK::send_ftp_reply(const pending_ftp &reply)
 {
-    if (!last_txbuf_is_greater(33)) { // It helps avoid GCS timeout if this is less than the threshold where we slow down normal streams (<=49)
+    // the radio transmit buffer only limits the channel its
+    // RADIO_STATUS came in on
+    if (reply.chan == last_radio_status.chan &&
+        !last_txbuf_is_greater(33)) { // It helps avoid GCS timeout if this is less than the threshold where we slow down normal streams (<=49)
         return false;
     }
     WITH_SEMAPHORE(comm_chan_lock(reply.chan));
-    if (!HAVE_PAYLOAD_SPACE(chan, FILE_TRANSFER_PROTOCOL)) {
+    if (!HAVE_PAYLOAD_SPACE(reply.chan, FILE_TRANSFER_PROTOCOL)) {
         return false;
     }
     uint8_t payload[251] = {};
@@ -178,21 +204,391 @@ void GCS_MAVLINK::ftp_push_replies(pending_ftp &reply)
     }
 }
 
+/*
+  error for a request on a session which isn't open. A client with no
+  files open gets FileNotFound, otherwise the session is invalid
+ */
+void GCS_MAVLINK::ftp_no_session_error(struct pending_ftp &response)
+{
+    for (const auto &s : ftp.sessions) {
+        if (s.fd != -1) {
+            ftp_error(response, FTP_ERROR::InvalidSession);
+            return;
+        }
+    }
+    ftp_error(response, FTP_ERROR::FileNotFound);
+}
+
+// find the open session for a request
+GCS_MAVLINK::ftp_session *GCS_MAVLINK::ftp_find_session(const struct pending_ftp &request)
+{
+    for (auto &s : ftp.sessions) {
+        if (s.fd != -1 && s.id == request.session &&
+            s.sysid == request.sysid && s.compid == request.compid) {
+            return &s;
+        }
+    }
+    return nullptr;
+}
+
+// get a free session, closing one which has been idle for too long if needed
+GCS_MAVLINK::ftp_session *GCS_MAVLINK::ftp_alloc_session(const struct pending_ftp &request, uint32_t now_ms)
+{
+    ftp_session *ret = nullptr;
+    for (auto &s : ftp.sessions) {
+        if (s.fd == -1) {
+            ret = &s;
+            break;
+        }
+        if (ret == nullptr && now_ms - s.last_ms >= FTP_SESSION_TIMEOUT) {
+            ret = &s;
+        }
+    }
+    if (ret == nullptr) {
+        return nullptr;
+    }
+    if (ret->fd != -1) {
+        // the client has timed out, close the file
+        ftp_close_session(*ret);
+    }
+    ret->id = request.session;
+    ret->sysid = request.sysid;
+    ret->compid = request.compid;
+    ret->chan = request.chan;
+    ret->last_ms = now_ms;
+    ret->burst_active = false;
+    ret->loss_noted = false;
+    ret->sent_end = 0;
+    ret->window = FTP_BURST_WINDOW_INITIAL;
+    ret->bw_pct = FTP_BW_PCT_INITIAL;
+    ret->start_ms = now_ms;
+    ret->bytes_sent = 0;
+    ret->losses = 0;
+    return ret;
+}
+
+// close the file of a session
+void GCS_MAVLINK::ftp_close_session(ftp_session &s)
+{
+    WITH_SEMAPHORE(s.sem);
+    if (s.fd == -1) {
+        return;
+    }
+    AP::FS().close(s.fd);
+    s.fd = -1;
+    s.burst_active = false;
+    delete s.readahead;
+    s.readahead = nullptr;
+
+#if HAL_LOGGING_ENABLED
+    if (s.bytes_sent == 0) {
+        return;
+    }
+    const uint32_t time_ms = MAX(AP_HAL::millis() - s.start_ms, 1U);
+// @LoggerMessage: FTPS
+// @Description: MAVFTP read session statistics, written when a session closes
+// @Field: TimeUS: Time since system startup
+// @Field: Sess: session number given by the GCS
+// @Field: Chan: MAVLink channel
+// @Field: Bytes: file data sent
+// @Field: Time: time the session was open
+// @Field: Rate: average file data rate
+// @Field: Win: burst window when the session closed
+// @Field: BW: bandwidth percentage used on links without flow control when the session closed
+// @Field: Loss: number of bursts with lost packets
+    AP::logger().WriteStreaming("FTPS", "TimeUS,Sess,Chan,Bytes,Time,Rate,Win,BW,Loss",
+                                "s#-bsB-%-", "F--0C0---",
+                                "QBBIIfBBH",
+                                AP_HAL::micros64(),
+                                s.id,
+                                uint8_t(s.chan),
+                                s.bytes_sent,
+                                time_ms,
+                                s.bytes_sent * 1000.0f / time_ms,
+                                s.window,
+                                s.bw_pct,
+                                s.losses);
+#endif
+}
+
+/*
+  read the next packet for a burst into the read-ahead, returning true
+  if a packet was read. Must be called with the session semaphore held
+ */
+bool GCS_MAVLINK::ftp_readahead_fill_locked(ftp_session &s)
+{
+    ftp_readahead *ra = s.readahead;
+    if (s.fd == -1 || ra == nullptr || ra->eof || ra->count >= AP_MAVLINK_FTP_READAHEAD_PACKETS) {
+        return false;
+    }
+    const uint8_t slot = (ra->head + ra->count) % AP_MAVLINK_FTP_READAHEAD_PACKETS;
+    const uint32_t offset = ra->offset + ra->count * uint32_t(ra->read_size);
+    if (AP::FS().lseek(s.fd, offset, SEEK_SET) == -1) {
+        ra->err = errno;
+        ra->eof = true;
+        return false;
+    }
+    const ssize_t read_bytes = AP::FS().read(s.fd, ra->data[slot], ra->read_size);
+    if (read_bytes == -1) {
+        ra->err = errno;
+        ra->eof = true;
+        return false;
+    }
+    if (read_bytes < ra->read_size) {
+        ra->eof = true;
+        if (read_bytes == 0) {
+            return false;
+        }
+        // don't send any old data
+        memset(&ra->data[slot][read_bytes], 0, sizeof(ra->data[slot]) - read_bytes);
+    }
+    ra->len[slot] = read_bytes;
+    ra->count++;
+    return true;
+}
+
+bool GCS_MAVLINK::ftp_readahead_fill(ftp_session &s)
+{
+    WITH_SEMAPHORE(s.sem);
+    return ftp_readahead_fill_locked(s);
+}
+
+#if AP_MAVLINK_FTP_READAHEAD_THREAD_ENABLED
+/*
+  thread which reads file data ahead of sending for burst reads, so
+  sending doesn't wait on storage
+ */
+void GCS_MAVLINK::ftp_readahead_worker(void)
+{
+    while (true) {
+        bool did_read = false;
+        for (auto &s : ftp.sessions) {
+            if (s.readahead != nullptr && ftp_readahead_fill(s)) {
+                did_read = true;
+            }
+        }
+        if (!did_read) {
+            // wait for a burst to start or take data from the read-ahead
+            ftp.readahead_sem->wait_blocking();
+        }
+    }
+}
+#endif
+
+// wake the read-ahead thread, if there is one
+void GCS_MAVLINK::ftp_readahead_wake(void)
+{
+#if AP_MAVLINK_FTP_READAHEAD_THREAD_ENABLED
+    if (ftp.readahead_sem != nullptr) {
+        ftp.readahead_sem->signal();
+    }
+#endif
+}
+
+/*
+  start a burst read for a session, returning false with an error in
+  the response if it can't be started
+ */
+bool GCS_MAVLINK::ftp_burst_start(ftp_session &s, const struct pending_ftp &request, struct pending_ftp &response)
+{
+    const uint8_t max_read = (request.size == 0?sizeof(response.data):request.size);
+
+    /*
+      the GCS asking again for data we have sent means packets were
+      lost, so halve the window and bandwidth share. If it continues
+      from where the last burst finished then all the data arrived and
+      we can use more of the link
+     */
+    if (request.offset < s.sent_end) {
+        if (!s.loss_noted) {
+            s.window = MAX(s.window / 2, 1);
+            s.bw_pct = MAX(s.bw_pct / 2, FTP_BW_PCT_MIN);
+            s.losses++;
+        }
+    } else if (request.offset == s.sent_end && s.sent_end != 0 && !s.loss_noted) {
+        s.bw_pct = MIN(s.bw_pct + 5, FTP_BW_PCT_MAX);
+    }
+    s.loss_noted = false;
+
+    WITH_SEMAPHORE(s.sem);
+    ftp_readahead *ra = s.readahead;
+    // when continuing from the last burst keep the data read ahead
+    const bool keep = ra != nullptr && ra->offset == request.offset &&
+        ra->read_size == max_read && ra->err == 0;
+    if (ra == nullptr) {
+        ra = NEW_NOTHROW ftp_readahead;
+        if (ra == nullptr) {
+            errno = ENOMEM;
+            ftp_error(response, FTP_ERROR::FailErrno);
+            return false;
+        }
+        s.readahead = ra;
+    }
+    if (!keep) {
+        ra->offset = request.offset;
+        ra->read_size = max_read;
+        ra->head = 0;
+        ra->count = 0;
+        ra->eof = false;
+        ra->err = 0;
+    }
+
+    s.burst_active = true;
+    s.burst_seq = request.seq_number + 1;
+    s.burst_left = FTP_BURST_PACKETS;
+    s.next_send_us = AP_HAL::micros();
+    ftp_readahead_wake();
+    return true;
+}
+
+/*
+  send packets for the burst reads in progress, taking turns between
+  the sessions. Returns true if anything was sent
+ */
+bool GCS_MAVLINK::ftp_send_bursts(void)
+{
+    bool sent = false;
+    for (uint8_t n=0; n<AP_MAVLINK_FTP_MAX_SESSIONS; n++) {
+        ftp_session &s = ftp.sessions[(ftp.next_session + n) % AP_MAVLINK_FTP_MAX_SESSIONS];
+        if (!s.burst_active) {
+            continue;
+        }
+        if (int32_t(AP_HAL::micros() - s.next_send_us) < 0) {
+            // pacing for a link without flow control
+            continue;
+        }
+        if (!s.sem.take_nonblocking()) {
+            // the read-ahead thread is reading for this session
+            continue;
+        }
+        ftp_readahead *ra = s.readahead;
+
+        /*
+          calculate a packet delay so that FTP burst transfer only
+          uses a share of available bandwidth on links that don't have
+          flow control. This reduces the chance of lost packets a lot,
+          which results in overall faster transfers. Links fast enough
+          to need less than a millisecond per packet, such as network
+          ports, are not paced
+         */
+        uint32_t packet_delay_us = 0;
+        if (valid_channel(s.chan)) {
+            auto *port = mavlink_comm_port[s.chan];
+            if (port != nullptr && port->get_flow_control() != AP_HAL::UARTDriver::FLOW_CONTROL_ENABLE) {
+                const uint32_t bw = MAX(port->bw_in_bytes_per_second(), 1U);
+                const uint16_t pkt_size = PAYLOAD_SIZE(s.chan, FILE_TRANSFER_PROTOCOL) - (sizeof(pending_ftp::data) - ra->read_size);
+                packet_delay_us = (100000000ULL * pkt_size) / (uint64_t(bw) * s.bw_pct);
+                if (packet_delay_us < 1000) {
+                    packet_delay_us = 0;
+                }
+            }
+        }
+        if (packet_delay_us != 0) {
+            // token bucket holding up to a window of packets, so time
+            // spent idle doesn't allow a longer burst than that
+            const uint32_t depth_us = packet_delay_us * s.window;
+            const uint32_t now_us = AP_HAL::micros();
+            if (int32_t(now_us - s.next_send_us) > int32_t(depth_us)) {
+                s.next_send_us = now_us - depth_us;
+            }
+        }
+
+        uint8_t count = 0;
+        while (s.burst_active && count < s.window) {
+            if (packet_delay_us != 0 && int32_t(AP_HAL::micros() - s.next_send_us) < 0) {
+                // used this pass's share of the link
+                break;
+            }
+            if (ra->count == 0) {
+                ftp_readahead_fill_locked(s);
+            }
+            pending_ftp reply {};
+            reply.chan = s.chan;
+            reply.sysid = s.sysid;
+            reply.compid = s.compid;
+            reply.session = s.id;
+            reply.seq_number = s.burst_seq;
+            reply.req_opcode = FTP_OP::BurstReadFile;
+            reply.offset = ra->offset;
+            if (ra->count == 0) {
+                if (!ra->eof) {
+                    // nothing read yet
+                    break;
+                }
+                if (ra->err != 0) {
+                    errno = ra->err;
+                    ftp_error(reply, FTP_ERROR::FailErrno);
+                } else {
+                    ftp_error(reply, FTP_ERROR::EndOfFile);
+                }
+                if (!send_ftp_reply(reply)) {
+                    break;
+                }
+                s.burst_active = false;
+                count++;
+                break;
+            }
+            const uint8_t len = ra->len[ra->head];
+            reply.opcode = FTP_OP::Ack;
+            reply.size = len;
+            reply.burst_complete = (len < ra->read_size) || (s.burst_left == 1);
+            memcpy(reply.data, ra->data[ra->head], sizeof(reply.data));
+            if (!send_ftp_reply(reply)) {
+                // no space to send, try again on the next pass
+                break;
+            }
+            ra->head = (ra->head + 1) % AP_MAVLINK_FTP_READAHEAD_PACKETS;
+            ra->count--;
+            ra->offset += len;
+            s.burst_seq++;
+            s.burst_left--;
+            s.bytes_sent += len;
+            s.sent_end = MAX(s.sent_end, ra->offset);
+            count++;
+            if (s.burst_left == 0) {
+                s.burst_active = false;
+            }
+            s.next_send_us += packet_delay_us;
+        }
+        if (count == s.window) {
+            // the link took all we had, try more next time
+            s.window = MIN(s.window + 1, FTP_BURST_WINDOW_MAX);
+        }
+        s.sem.give();
+        if (count > 0) {
+            sent = true;
+            s.last_ms = AP_HAL::millis();
+            // there is room in the read-ahead
+            ftp_readahead_wake();
+        }
+    }
+    ftp.next_session = (ftp.next_session + 1) % AP_MAVLINK_FTP_MAX_SESSIONS;
+    if (sent) {
+        ftp.last_send_ms = AP_HAL::millis(); // Used to detect active FTP session
+    }
+    return sent;
+}
+
 void GCS_MAVLINK::ftp_worker(void) {
     pending_ftp request;
     pending_ftp reply = {};
-    reply.session = -1; // flag the reply as invalid for any reuse
+    bool have_reply = false;
 
     while (true) {
         bool skip_push_reply = false;
 
-        while (ftp.requests == nullptr || !ftp.requests->pop(request)) {
-            // nothing to handle, delay ourselves a bit then check again. Ideally we'd use conditional waits here
-            hal.scheduler->delay(2);
+        if (ftp.requests == nullptr || !ftp.requests->pop(request)) {
+            // nothing to handle, carry on with any burst reads then
+            // delay ourselves a bit then check again. Ideally we'd
+            // use conditional waits here
+            if (!ftp_send_bursts()) {
+                hal.scheduler->delay(1);
+            }
+            continue;
         }
 
         // if it's a rerequest and we still have the last response then send it
-        if ((request.sysid == reply.sysid) && (request.compid == reply.compid) &&
+        if (have_reply && (request.sysid == reply.sysid) && (request.compid == reply.compid) &&
             (request.session == reply.session) && (request.seq_number + 1 == reply.seq_number)) {
             ftp_push_replies(reply);
             continue;
@@ -206,6 +602,7 @@ void GCS_MAVLINK::ftp_worker(void) {
         reply.chan = request.chan;
         reply.sysid = request.sysid;
         reply.compid = request.compid;
+        have_reply = true;
 
         // sanity check the request size
         if (request.size > sizeof(request.data)) {
@@ -214,383 +611,334 @@ void GCS_MAVLINK::ftp_worker(void) {
             continue;
         }
 
-        uint32_t now = AP_HAL::millis();
+        const uint32_t now = AP_HAL::millis();
+        ftp_session *session = ftp_find_session(request);
+        if (session != nullptr && now - session->last_ms >= FTP_SESSION_TIMEOUT &&
+            (request.opcode == FTP_OP::OpenFileRO || request.opcode == FTP_OP::OpenFileWO ||
+             request.opcode == FTP_OP::CreateFile)) {
+            // no activity for 3s, assume client has timed out
+            // receiving open reply, close the file
+            ftp_close_session(*session);
+            session = nullptr;
+        }
+        if (session != nullptr) {
+            session->last_ms = now;
+        }
+
+        // dispatch the command as needed
+        switch (request.opcode) {
+            case FTP_OP::None:
+                reply.opcode = FTP_OP::Ack;
+                break;
+            case FTP_OP::TerminateSession:
+                if (session != nullptr) {
+                    ftp_close_session(*session);
+                }
+                reply.opcode = FTP_OP::Ack;
+                break;
+            case FTP_OP::ResetSessions:
+                // close all sessions of this client
+                for (auto &s : ftp.sessions) {
+                    if (s.sysid == request.sysid && s.compid == request.compid) {
+                        ftp_close_session(s);
+                    }
+                }
+                reply.opcode = FTP_OP::Ack;
+                break;
+            case FTP_OP::ListDirectory:
+                ftp_list_dir(request, reply);
+                break;
+            case FTP_OP::OpenFileRO:
+                {
+                    // only allow one file to be open per session
+                    if (session != nullptr) {
+                        ftp_error(reply, FTP_ERROR::Fail);
+                        break;
+                    }
+
+                    // sanity check that our the request looks well formed
+                    if (!ftp_check_name_len(request)) {
+                        ftp_error(reply, FTP_ERROR::InvalidDataSize);
+                        break;
+                    }
+
+                    request.data[sizeof(request.data) - 1] = 0; // ensure the path is null terminated
+
+                    // get the file size
+                    struct stat st;
+                    if (AP::FS().stat((char *)request.data, &st)) {
+                        ftp_error(reply, FTP_ERROR::FailErrno);
+                        break;
+                    }
+                    const size_t file_size = st.st_size;
+
+                    session = ftp_alloc_session(request, now);
+                    if (session == nullptr) {
+                        ftp_error(reply, FTP_ERROR::NoSessionsAvailable);
+                        break;
+                    }
+
+                    // actually open the file
+                    const int fd = AP::FS().open((char *)request.data, O_RDONLY);
+                    if (fd == -1) {
+                        ftp_error(reply, FTP_ERROR::FailErrno);
+                        break;
+                    }
+                    session->mode = FTP_FILE_MODE::Read;
+                    session->fd = fd;
 
-        // check for session termination
-        if (request.session != ftp.current_session &&
-            (request.opcode == FTP_OP::TerminateSession || request.opcode == FTP_OP::ResetSessions)) {
-            // terminating a different session, just ack
-            reply.opcode = FTP_OP::Ack;
-        } else if (ftp.fd != -1 && request.session != ftp.current_session &&
-                   now - ftp.last_send_ms < FTP_SESSION_TIMEOUT) {
-            // if we have an open file and the session isn't right
-            // then reject. This prevents IO on the wrong file
-            ftp_error(reply, FTP_ERROR::InvalidSession);
-        } else {
-            if (ftp.fd != -1 &&
-                request.session != ftp.current_session &&
-                now - ftp.last_send_ms >= FTP_SESSION_TIMEOUT) {
-                // if a new session appears and the old session has
-                // been idle for more than the timeout then force
-                // close the old session
-                AP::FS().close(ftp.fd);
-                ftp.fd = -1;
-                ftp.current_session = -1;
-            }
-            // dispatch the command as needed
-            switch (request.opcode) {
-                case FTP_OP::None:
                     reply.opcode = FTP_OP::Ack;
+                    reply.size = sizeof(uint32_t);
+                    put_le32_ptr(reply.data, (uint32_t)file_size);
+
+                    // provide compatibility with old protocol banner download
+                    if (strncmp((const char *)request.data, "@PARAM/param.pck", 16) == 0) {
+                        ftp.need_banner_send_mask |= 1U<<reply.chan;
+                    }
                     break;
-                case FTP_OP::TerminateSession:
-                case FTP_OP::ResetSessions:
-                    // we already handled this, just listed for completeness
-                    if (ftp.fd != -1) {
-                        AP::FS().close(ftp.fd);
-                        ftp.fd = -1;
+                }
+            case FTP_OP::ReadFile:
+                {
+                    // must actually be working on a file
+                    if (session == nullptr) {
+                        ftp_no_session_error(reply);
+                        break;
                     }
-                    ftp.current_session = -1;
+
+                    // must have the file in read mode
+                    if ((session->mode != FTP_FILE_MODE::Read)) {
+                        ftp_error(reply, FTP_ERROR::Fail);
+                        break;
+                    }
+
+                    if (request.offset < session->sent_end && !session->loss_noted) {
+                        // filling in a packet lost from a burst
+                        session->window = MAX(session->window / 2, 1);
+                        session->bw_pct = MAX(session->bw_pct / 2, FTP_BW_PCT_MIN);
+                        session->losses++;
+                        session->loss_noted = true;
+                    }
+
+                    WITH_SEMAPHORE(session->sem);
+
+                    // seek to requested offset
+                    if (AP::FS().lseek(session->fd, request.offset, SEEK_SET) == -1) {
+                        ftp_error(reply, FTP_ERROR::FailErrno);
+                        break;
+                    }
+
+                    // fill the buffer
+                    const ssize_t read_bytes = AP::FS().read(session->fd, reply.data, MIN(sizeof(reply.data),request.size));
+                    if (read_bytes == -1) {
+                        ftp_error(reply, FTP_ERROR::FailErrno);
+                        break;
+                    }
+                    if (read_bytes == 0) {
+                        ftp_error(reply, FTP_ERROR::EndOfFile);
+                        break;
+                    }
+
                     reply.opcode = FTP_OP::Ack;
+                    reply.offset = request.offset;
+                    reply.size = (uint8_t)read_bytes;
+                    session->bytes_sent += read_bytes;
                     break;
-                case FTP_OP::ListDirectory:
-                    ftp_list_dir(request, reply);
-                    break;
-                case FTP_OP::OpenFileRO:
-                    {
-                        // only allow one file to be open per session
-                        if (ftp.fd != -1 && now - ftp.last_send_ms > FTP_SESSION_TIMEOUT) {
-                            // no activity for 3s, assume client has
-                            // timed out receiving open reply, close
-                            // the file
-                            AP::FS().close(ftp.fd);
-                            ftp.fd = -1;
-                            ftp.current_session = -1;
-                        }
-                        if (ftp.fd != -1) {
-                            ftp_error(reply, FTP_ERROR::Fail);
-                            break;
-                        }
-
-                        // sanity check that our the request looks well formed
-                        if (!ftp_check_name_len(request)) {
-                            ftp_error(reply, FTP_ERROR::InvalidDataSize);
-                            break;
-                        }
-
-                        request.data[sizeof(request.data) - 1] = 0; // ensure the path is null terminated
-
-                        // get the file size
-                        struct stat st;
-                        if (AP::FS().stat((char *)request.data, &st)) {
-                            ftp_error(reply, FTP_ERROR::FailErrno);
-                            break;
-                        }
-                        const size_t file_size = st.st_size;
-
-                        // actually open the file
-                        ftp.fd = AP::FS().open((char *)request.data, O_RDONLY);
-                        if (ftp.fd == -1) {
-                            ftp_error(reply, FTP_ERROR::FailErrno);
-                            break;
-                        }
-                        ftp.mode = FTP_FILE_MODE::Read;
-                        ftp.current_session = request.session;
-
-                        reply.opcode = FTP_OP::Ack;
-                        reply.size = sizeof(uint32_t);
-                        put_le32_ptr(reply.data, (uint32_t)file_size);
-
-                        // provide compatibility with old protocol banner download
-                        if (strncmp((const char *)request.data, "@PARAM/param.pck", 16) == 0) {
-                            ftp.need_banner_send_mask |= 1U<<reply.chan;
-                        }
+                }
+            case FTP_OP::Ack:
+            case FTP_OP::Nack:
+                // eat these, we just didn't expect them
+                continue;
+                break;
+            case FTP_OP::OpenFileWO:
+            case FTP_OP::CreateFile:
+                {
+                    // only allow one file to be open per session
+                    if (session != nullptr) {
+                        ftp_error(reply, FTP_ERROR::Fail);
                         break;
                     }
-                case FTP_OP::ReadFile:
-                    {
-                        // must actually be working on a file
-                        if (ftp.fd == -1) {
-                            ftp_error(reply, FTP_ERROR::FileNotFound);
-                            break;
-                        }
-
-                        // must have the file in read mode
-                        if ((ftp.mode != FTP_FILE_MODE::Read)) {
-                            ftp_error(reply, FTP_ERROR::Fail);
-                            break;
-                        }
-
-                        // seek to requested offset
-                        if (AP::FS().lseek(ftp.fd, request.offset, SEEK_SET) == -1) {
-                            ftp_error(reply, FTP_ERROR::FailErrno);
-                            break;
-                        }
-
-                        // fill the buffer
-                        const ssize_t read_bytes = AP::FS().read(ftp.fd, reply.data, MIN(sizeof(reply.data),request.size));
-                        if (read_bytes == -1) {
-                            ftp_error(reply, FTP_ERROR::FailErrno);
-                            break;
-                        }
-                        if (read_bytes == 0) {
-                            ftp_error(reply, FTP_ERROR::EndOfFile);
-                            break;
-                        }
-
-                        reply.opcode = FTP_OP::Ack;
-                        reply.offset = request.offset;
-                        reply.size = (uint8_t)read_bytes;
+
+                    // sanity check that our the request looks well formed
+                    if (!ftp_check_name_len(request)) {
+                        ftp_error(reply, FTP_ERROR::InvalidDataSize);
                         break;
                     }
-                case FTP_OP::Ack:
-                case FTP_OP::Nack:
-                    // eat these, we just didn't expect them
-                    continue;
+
+                    request.data[sizeof(request.data) - 1] = 0; // ensure the path is null terminated
+
+                    session = ftp_alloc_session(request, now);
+                    if (session == nullptr) {
+                        ftp_error(reply, FTP_ERROR::NoSessionsAvailable);
+                        break;
+                    }
+
+                    // actually open the file
+                    const int fd = AP::FS().open((char *)request.data,
+                                                 (request.opcode == FTP_OP::CreateFile) ? O_WRONLY|O_CREAT|O_TRUNC : O_WRONLY);
+                    if (fd == -1) {
+                        ftp_error(reply, FTP_ERROR::FailErrno);
+                        break;
+                    }
+                    session->mode = FTP_FILE_MODE::Write;
+                    session->fd = fd;
+
+                    reply.opcode = FTP_OP::Ack;
                     break;
-                case FTP_OP::OpenFileWO:
-                case FTP_OP::CreateFile:
-                    {
-                        // only allow one file to be open per session
-                        if (ftp.fd != -1) {
-                            ftp_error(reply, FTP_ERROR::Fail);
-                            break;
-                        }
-
-                        // sanity check that our the request looks well formed
-                        if (!ftp_check_name_len(request)) {
-                            ftp_error(reply, FTP_ERROR::InvalidDataSize);
-                            break;
-                        }
-
-                        request.data[sizeof(request.data) - 1] = 0; // ensure the path is null terminated
-
-                        // actually open the file
-                        ftp.fd = AP::FS().open((char *)request.data,
-                                               (request.opcode == FTP_OP::CreateFile) ? O_WRONLY|O_CREAT|O_TRUNC : O_WRONLY);
-                        if (ftp.fd == -1) {
-                            ftp_error(reply, FTP_ERROR::FailErrno);
-                            break;
-                        }
-                        ftp.mode = FTP_FILE_MODE::Write;
-                        ftp.current_session = request.session;
-
-                        reply.opcode = FTP_OP::Ack;
+                }
+            case FTP_OP::WriteFile:
+                {
+                    // must actually be working on a file
+                    if (session == nullptr) {
+                        ftp_no_session_error(reply);
                         break;
                     }
-                case FTP_OP::WriteFile:
-                    {
-                        // must actually be working on a file
-                        if (ftp.fd == -1) {
-                            ftp_error(reply, FTP_ERROR::FileNotFound);
-                            break;
-                        }
-
-                        // must have the file in write mode
-                        if ((ftp.mode != FTP_FILE_MODE::Write)) {
-                            ftp_error(reply, FTP_ERROR::Fail);
-                            break;
-                        }
-
-                        // seek to requested offset
-                        if (AP::FS().lseek(ftp.fd, request.offset, SEEK_SET) == -1) {
-                            ftp_error(reply, FTP_ERROR::FailErrno);
-                            break;
-                        }
-
-                        // fill the buffer
-                        const ssize_t write_bytes = AP::FS().write(ftp.fd, request.data, request.size);
-                        if (write_bytes == -1) {
-                            ftp_error(reply, FTP_ERROR::FailErrno);
-                            break;
-                        }
-
-                        reply.opcode = FTP_OP::Ack;
-                        reply.offset = request.offset;
+
+                    // must have the file in write mode
+                    if ((session->mode != FTP_FILE_MODE::Write)) {
+                        ftp_error(reply, FTP_ERROR::Fail);
                         break;
                     }
-                case FTP_OP::CreateDirectory:
-                    {
-                        // sanity check that our the request looks well formed
-                        if (!ftp_check_name_len(request)) {
-                            ftp_error(reply, FTP_ERROR::InvalidDataSize);
-                            break;
-                        }
-
-                        request.data[sizeof(request.data) - 1] = 0; // ensure the path is null terminated
-
-                        // actually make the directory
-                        if (AP::FS().mkdir((char *)request.data) == -1) {
-                            ftp_error(reply, FTP_ERROR::FailErrno);
-                            break;
-                        }
-
-                        reply.opcode = FTP_OP::Ack;
+
+                    WITH_SEMAPHORE(session->sem);
+
+                    // seek to requested offset
+                    if (AP::FS().lseek(session->fd, request.offset, SEEK_SET) == -1) {
+                        ftp_error(reply, FTP_ERROR::FailErrno);
                         break;
                     }
-                case FTP_OP::RemoveDirectory:
-                case FTP_OP::RemoveFile:
-                    {
-                        // sanity check that our the request looks well formed
-                        if (!ftp_check_name_len(request)) {
-                            ftp_error(reply, FTP_ERROR::InvalidDataSize);
-                            break;
-                        }
-
-                        request.data[sizeof(request.data) - 1] = 0; // ensure the path is null terminated
-
-                        // remove the file/dir
-                        if (AP::FS().unlink((char *)request.data) == -1) {
-                            ftp_error(reply, FTP_ERROR::FailErrno);
-                            break;
-                        }
-
-                        reply.opcode = FTP_OP::Ack;
+
+                    // fill the buffer
+                    const ssize_t write_bytes = AP::FS().write(session->fd, request.data, request.size);
+                    if (write_bytes == -1) {
+                        ftp_error(reply, FTP_ERROR::FailErrno);
                         break;
                     }
-                case FTP_OP::CalcFileCRC32:
-                    {
-                        // sanity check that our the request looks well formed
-                        if (!ftp_check_name_len(request)) {
-                            ftp_error(reply, FTP_ERROR::InvalidDataSize);
-                            break;
-                        }
-
-                        request.data[sizeof(request.data) - 1] = 0; // ensure the path is null terminated
-
-                        uint32_t checksum = 0;
-                        if (!AP::FS().crc32((char *)request.data, checksum)) {
-                            ftp_error(reply, FTP_ERROR::FailErrno);
-                            break;
-                        }
-
-                        // reset our scratch area so we don't leak data, and can leverage trimming
-                        memset(reply.data, 0, sizeof(reply.data));
-                        reply.size = sizeof(uint32_t);
-                        put_le32_ptr(reply.data, checksum);
-                        reply.opcode = FTP_OP::Ack;
+
+                    reply.opcode = FTP_OP::Ack;
+                    reply.offset = request.offset;
+                    break;
+                }
+            case FTP_OP::CreateDirectory:
+                {
+                    // sanity check that our the request looks well formed
+                    if (!ftp_check_name_len(request)) {
+                        ftp_error(reply, FTP_ERROR::InvalidDataSize);
                         break;
                     }
-                case FTP_OP::BurstReadFile:
-                    {
-                        const uint16_t max_read = (request.size == 0?sizeof(reply.data):request.size);
-                        // must actually be working on a file
-                        if (ftp.fd == -1) {
-                            ftp_error(reply, FTP_ERROR::FileNotFound);
-                            break;
-                        }
-
-                        // must have the file in read mode
-                        if ((ftp.mode != FTP_FILE_MODE::Read)) {
-                            ftp_error(reply, FTP_ERROR::Fail);
-                            break;
-                        }
-
-                        // seek to requested offset
-                        if (AP::FS().lseek(ftp.fd, request.offset, SEEK_SET) == -1) {
-                            ftp_error(reply, FTP_ERROR::FailErrno);
-                            break;
-                        }
-
-                        /*
-                          calculate a burst delay so that FTP burst
-                          transfer doesn't use more than 1/3 of
-                          available bandwidth on links that don't have
-                          flow control. This reduces the chance of
-                          lost packets a lot, which results in overall
-                          faster transfers
-                         */
-                        uint32_t burst_delay_ms = 0;
-                        if (valid_channel(request.chan)) {
-                            auto *port = mavlink_comm_port[request.chan];
-                            if (port != nullptr && port->get_flow_control() != AP_HAL::UARTDriver::FLOW_CONTROL_ENABLE) {
-                                const uint32_t bw = port->bw_in_bytes_per_second();
-                                const uint16_t pkt_size = PAYLOAD_SIZE(request.chan, FILE_TRANSFER_PROTOCOL) - (sizeof(reply.data) - max_read);
-                                burst_delay_ms = 3000 * pkt_size / bw;
-                            }
-                        }
-
-                        // this transfer size is enough for a full parameter file with max parameters
-                        const uint32_t transfer_size = 500;
-                        for (uint32_t i = 0; (i < transfer_size); i++) {
-                            // fill the buffer
-                            const ssize_t read_bytes = AP::FS().read(ftp.fd, reply.data, MIN(sizeof(reply.data), max_read));
-                            if (read_bytes == -1) {
-                                ftp_error(reply, FTP_ERROR::FailErrno);
-                                break;
-                            }
-
-                            if (read_bytes != sizeof(reply.data)) {
-                                // don't send any old data
-                                memset(reply.data + read_bytes, 0, sizeof(reply.data) - read_bytes);
-                            }
-
-                            if (read_bytes == 0) {
-                                ftp_error(reply, FTP_ERROR::EndOfFile);
-                                break;
-                            }
-
-                            reply.opcode = FTP_OP::Ack;
-                            reply.offset = request.offset + i * max_read;
-                            reply.burst_complete = ((read_bytes < max_read) || (i == (transfer_size - 1)));
-                            reply.size = (uint8_t)read_bytes;
-
-                            ftp_push_replies(reply);
-
-                            if (read_bytes < max_read) {
-                                // ensure the NACK which we send next is at the right offset
-                                reply.offset += read_bytes;
-                            }
-
-                            // prep the reply to be used again
-                            reply.seq_number++;
-
-                            hal.scheduler->delay(burst_delay_ms);
-                        }
-
-                        if (reply.opcode != FTP_OP::Nack) {
-                            // prevent a duplicate packet send for
-                            // normal replies of burst reads
-                            skip_push_reply = true;
-                        }
+
+                    request.data[sizeof(request.data) - 1] = 0; // ensure the path is null terminated
+
+                    // actually make the directory
+                    if (AP::FS().mkdir((char *)request.data) == -1) {
+                        ftp_error(reply, FTP_ERROR::FailErrno);
                         break;
                     }
 
-                case FTP_OP::Rename: {
-                    // sanity check that the request looks well formed
-                    const char *filename1 = (char*)request.data;
-                    const size_t len1 = strnlen(filename1, sizeof(request.data)-2);
-                    const char *filename2 = (char*)&request.data[len1+1];
-                    const size_t len2 = strnlen(filename2, sizeof(request.data)-(len1+1));
-                    const bool is_req_size_consider_tnull = (request.size - (len1+len2) == 2 &&
-                                                             request.data[sizeof(request.data) - 1] == 0);
-                    if (filename1[len1] != 0 || ((len1+len2+1 != request.size) && !is_req_size_consider_tnull) || (request.size == 0)) {
+                    reply.opcode = FTP_OP::Ack;
+                    break;
+                }
+            case FTP_OP::RemoveDirectory:
+            case FTP_OP::RemoveFile:
+                {
+                    // sanity check that our the request looks well formed
+                    if (!ftp_check_name_len(request)) {
                         ftp_error(reply, FTP_ERROR::InvalidDataSize);
                         break;
                     }
-                    request.data[sizeof(request.data) - 1] = 0; // ensure the 2nd path is null terminated
+
+                    request.data[sizeof(request.data) - 1] = 0; // ensure the path is null terminated
+
                     // remove the file/dir
-                    if (AP::FS().rename(filename1, filename2) != 0) {
+                    if (AP::FS().unlink((char *)request.data) == -1) {
                         ftp_error(reply, FTP_ERROR::FailErrno);
                         break;
                     }
+
                     reply.opcode = FTP_OP::Ack;
                     break;
                 }
+            case FTP_OP::CalcFileCRC32:
+                {
+                    // sanity check that our the request looks well formed
+                    if (!ftp_check_name_len(request)) {
+                        ftp_error(reply, FTP_ERROR::InvalidDataSize);
+                        break;
+                    }
 
-                case FTP_OP::TruncateFile:
-                default:
-                    // this was bad data, just nack it
-                    GCS_SEND_TEXT(MAV_SEVERITY_DEBUG, "Unsupported FTP: %d", static_cast<int>(request.opcode));
-                    ftp_error(reply, FTP_ERROR::Fail);
+                    request.data[sizeof(request.data) - 1] = 0; // ensure the path is null terminated
+
+                    uint32_t checksum = 0;
+                    if (!AP::FS().crc32((char *)request.data, checksum)) {
+                        ftp_error(reply, FTP_ERROR::FailErrno);
+                        break;
+                    }
+
+                    // reset our scratch area so we don't leak data, and can leverage trimming
+                    memset(reply.data, 0, sizeof(reply.data));
+                    reply.size = sizeof(uint32_t);
+                    put_le32_ptr(reply.data, checksum);
+                    reply.opcode = FTP_OP::Ack;
                     break;
+                }
+            case FTP_OP::BurstReadFile:
+                {
+                    // must actually be working on a file
+                    if (session == nullptr) {
+                        ftp_no_session_error(reply);
+                        break;
+                    }
+
+                    // must have the file in read mode
+                    if ((session->mode != FTP_FILE_MODE::Read)) {
+                        ftp_error(reply, FTP_ERROR::Fail);
+                        break;
+                    }
+
+                    // the packets are sent by ftp_send_bursts(), along
+                    // with those of any other session's burst
+                    if (ftp_burst_start(*session, request, reply)) {
+                        skip_push_reply = true;
+                        have_reply = false;
+                    }
+                    break;
+                }
+
+            case FTP_OP::Rename: {
+                // sanity check that the request looks well formed
+                const char *filename1 = (char*)request.data;
+                const size_t len1 = strnlen(filename1, sizeof(request.data)-2);
+                const char *filename2 = (char*)&request.data[len1+1];
+                const size_t len2 = strnlen(filename2, sizeof(request.data)-(len1+1));
+                const bool is_req_size_consider_tnull = (request.size - (len1+len2) == 2 &&
+                                                         request.data[sizeof(request.data) - 1] == 0);
+                if (filename1[len1] != 0 || ((len1+len2+1 != request.size) && !is_req_size_consider_tnull) || (request.size == 0)) {
+                    ftp_error(reply, FTP_ERROR::InvalidDataSize);
+                    break;
+                }
+                request.data[sizeof(request.data) - 1] = 0; // ensure the 2nd path is null terminated
+                // remove the file/dir
+                if (AP::FS().rename(filename1, filename2) != 0) {
+                    ftp_error(reply, FTP_ERROR::FailErrno);
+                    break;
+                }
+                reply.opcode = FTP_OP::Ack;
+                break;
             }
+
+            case FTP_OP::TruncateFile:
+            default:
+                // this was bad data, just nack it
+                GCS_SEND_TEXT(MAV_SEVERITY_DEBUG, "Unsupported FTP: %d", static_cast<int>(request.opcode));
+                ftp_error(reply, FTP_ERROR::Fail);
+                break;
         }
 
         if (!skip_push_reply) {
             ftp_push_replies(reply);
         }
 
-        continue;
+        // keep burst reads going while requests are arriving
+        ftp_send_bursts();
     }
 }
 
@@ -86,6 +86,30 @@
 #define AP_MAVLINK_FTP_ENABLED HAL_GCS_ENABLED
 #endif
 
+// number of MAVFTP sessions which may have a file open at once
+#ifndef AP_MAVLINK_FTP_MAX_SESSIONS
+#if HAL_MEM_CLASS >= HAL_MEM_CLASS_500
+#define AP_MAVLINK_FTP_MAX_SESSIONS 4
+#else
+#define AP_MAVLINK_FTP_MAX_SESSIONS 1
+#endif
+#endif
+
+// read file data for MAVFTP burst reads on a separate thread, so slow
+// storage doesn't hold up sending
+#ifndef AP_MAVLINK_FTP_READAHEAD_THREAD_ENABLED
+#define AP_MAVLINK_FTP_READAHEAD_THREAD_ENABLED (HAL_MEM_CLASS >= HAL_MEM_CLASS_500)
+#endif
+
+// number of packets read ahead of sending for each MAVFTP burst read
+#ifndef AP_MAVLINK_FTP_READAHEAD_PACKETS
+#if AP_MAVLINK_FTP_READAHEAD_THREAD_ENABLED
+#define AP_MAVLINK_FTP_READAHEAD_PACKETS 8
+#else
+#define AP_MAVLINK_FTP_READAHEAD_PACKETS 1
+#endif
+#endif
+
 // GCS should be using MISSION_REQUEST_INT instead; this is a waste of
 // flash.  MISSION_REQUEST was deprecated in June 2020.  We started
 // sending warnings to the GCS in Sep 2022 if MISSION_REQUEST was used.
@@ -116,7 +116,7 @@ void ADSB::update_simulated_vehicles(const class Aircraft &aircraft)
         return;
     } else if (num_vehicles != _sitl->adsb_plane_count) {
         num_vehicles = _sitl->adsb_plane_count;
-        for (uint8_t i=0; i<num_vehicles_MAX; i++) {
+        for (uint16_t i=0; i<num_vehicles_MAX; i++) {
             vehicles[i].initialised = false;
         }
     }
@@ -130,7 +130,7 @@ void ADSB::update_simulated_vehicles(const class Aircraft &aircraft)
     // prune any aircraft which get too far away from our simulated vehicle:
     const Location &aircraft_loc = aircraft.get_location();
 
-    for (uint8_t i=0; i<num_vehicles; i++) {
+    for (uint16_t i=0; i<num_vehicles; i++) {
         auto &vehicle = vehicles[i];
         vehicle.update(aircraft, delta_t);
 
@@ -227,7 +227,7 @@ void ADSB::send_report(const class Aircraft &aircraft)
      */
     uint32_t now_us = AP_HAL::micros();
     if (now_us - last_report_us >= reporting_period_ms*1000UL) {
-        for (uint8_t i=0; i<num_vehicles; i++) {
+        for (uint16_t i=0; i<num_vehicles; i++) {
             const ADSB_Vehicle &vehicle = vehicles[i];
             if (!vehicle.initialised) {
                 continue;
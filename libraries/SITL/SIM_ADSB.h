@@ -61,8 +61,8 @@ public:
     ADSB() {};
     void update(const class Aircraft &aircraft);
 
-    uint8_t num_vehicles;
-    static const uint8_t num_vehicles_MAX = 200;
+    uint16_t num_vehicles;
+    static const uint16_t num_vehicles_MAX = 500;
     ADSB_Vehicle vehicles[num_vehicles_MAX];
 
 private:
@@ -21,6 +21,7 @@
 #if AP_SIM_ENABLED
 
 #include <AP_Math/AP_Math.h>
+#include <AP_Declination/AP_Declination.h>
 
 #include "SITL.h"
 #include "SITL_Input.h"
@@ -252,6 +253,7 @@ protected:
     float turbulence_vertical_speed;    // m/s
 
     Vector3f mag_bf;  // local earth magnetic field vector in Gauss, earth frame
+    AP_Declination::LocalField mag_field_model;  // field tables for the area around the vehicle
 
     uint64_t time_now_us;
 
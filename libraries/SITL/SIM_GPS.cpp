@@ -563,9 +563,11 @@ void GPS::update()
 
 void GPS_Backend::update_read()
 {
-    // swallow any config bytes
-    char c;
-    read_from_autopilot(&c, 1);
+    // swallow any config and injected bytes, draining the port so
+    // injected data isn't limited by the simulation rate
+    char buf[256];
+    while (read_from_autopilot(buf, sizeof(buf)) == sizeof(buf)) {
+    }
 }
 
 /*
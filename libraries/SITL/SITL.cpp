@@ -203,6 +203,7 @@ const AP_Param::GroupInfo SIM::var_info[] = {
     // @Param: ADSB_COUNT
     // @DisplayName: Number of ADSB aircrafts
     // @Description: Total number of ADSB simulated aircraft
+    // @Range: -1 499
     AP_GROUPINFO("ADSB_COUNT",    45, SIM,  adsb_plane_count, -1),
     // @Param: ADSB_RADIUS
     // @DisplayName: ADSB radius stddev of another aircraft